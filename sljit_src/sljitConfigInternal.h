@@ -874,6 +874,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_sw sljit_exec_offset(void *code);
 #define SLJIT_HAS_STATUS_FLAGS_STATE 1
 #endif
 
+#if (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) \
+	|| (defined SLJIT_CONFIG_RISCV && SLJIT_CONFIG_RISCV) \
+	|| (defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
+/* Status flags are emulated by general purpose registers. */
+#define SLJIT_HAS_FLAG_REGISTERS 1
+#endif
+
 /***************************************/
 /* Floating point register management. */
 /***************************************/
@@ -0,0 +1,170 @@
+/*
+ *    Stack-less Just-In-Time compiler
+ *
+ *    Copyright Zoltan Herczeg (hzmester@freemail.hu). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright notice, this list of
+ *      conditions and the following disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *      of conditions and the following disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND CONTRIBUTORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER(S) OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+static void ic_update_reg_count(struct sljit_compiler *compiler, struct sljit_ic_site *site, sljit_s32 reg)
+{
+	sljit_s32 count;
+
+	if (reg >= SLJIT_R0 && reg < SLJIT_R0 + compiler->scratches) {
+		count = reg - SLJIT_R0 + 1;
+		if (site->scratches < count)
+			site->scratches = count;
+		return;
+	}
+
+	count = SLJIT_S0 - reg + 1;
+	if (site->saveds < count)
+		site->saveds = count;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_ic_site* sljit_emit_ic_site(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_s32 tmp_reg)
+{
+	struct sljit_ic_site *site;
+
+	CHECK_ERROR_PTR();
+	CHECK_PTR(check_sljit_emit_ic_site(compiler, src, tmp_reg));
+
+	site = (struct sljit_ic_site*)ensure_abuf(compiler, sizeof(struct sljit_ic_site));
+	PTR_FAIL_IF(!site);
+
+	site->miss_label = NULL;
+	site->src = src;
+	site->tmp_reg = tmp_reg;
+	site->scratches = 0;
+	site->saveds = 0;
+	ic_update_reg_count(compiler, site, src);
+	ic_update_reg_count(compiler, site, tmp_reg);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	site->key = sljit_emit_const(compiler, SLJIT_MOV, tmp_reg, 0, SLJIT_IC_EMPTY_KEY);
+	PTR_FAIL_IF(!site->key);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	site->hit = sljit_emit_cmp(compiler, SLJIT_EQUAL | SLJIT_REWRITABLE_JUMP, src, 0, tmp_reg, 0);
+	PTR_FAIL_IF(!site->hit);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	site->miss = sljit_emit_jump(compiler, SLJIT_JUMP | SLJIT_REWRITABLE_JUMP);
+	PTR_FAIL_IF(!site->miss);
+	return site;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_ic_miss_label(struct sljit_ic_site *site, struct sljit_label *label)
+{
+	if (SLJIT_UNLIKELY(!site))
+		return;
+
+	site->miss_label = label;
+	/* The hit jump is not taken until a key is added. */
+	sljit_set_label(site->hit, label);
+	sljit_set_label(site->miss, label);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_init_ic(struct sljit_ic *ic, struct sljit_ic_site *site, struct sljit_compiler *compiler)
+{
+	SLJIT_ASSERT(compiler->error == SLJIT_ERR_COMPILED && site->miss_label != NULL);
+
+	ic->key_addr = sljit_get_const_addr(site->key);
+	ic->hit_addr = sljit_get_jump_addr(site->hit);
+	ic->miss_addr = sljit_get_jump_addr(site->miss);
+	ic->miss_target = sljit_get_label_addr(site->miss_label);
+	ic->miss_head = ic->miss_target;
+	ic->executable_offset = sljit_get_executable_offset(compiler);
+	ic->key = SLJIT_IC_EMPTY_KEY;
+	ic->src = site->src;
+	ic->tmp_reg = site->tmp_reg;
+	ic->scratches = site->scratches;
+	ic->saveds = site->saveds;
+	ic->stub_count = 0;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_add_ic_key(struct sljit_ic *ic, sljit_sw key, sljit_uw target, void *exec_allocator_data)
+{
+	struct sljit_compiler *compiler;
+	struct sljit_jump *jump;
+	void *code;
+	sljit_s32 error;
+
+	SLJIT_ASSERT(key != SLJIT_IC_EMPTY_KEY && key != ic->key);
+
+	if (ic->key == SLJIT_IC_EMPTY_KEY) {
+		/* The key is empty, so the hit jump is never taken. */
+		sljit_set_jump_addr(ic->hit_addr, target, ic->executable_offset);
+		sljit_set_const(ic->key_addr, SLJIT_MOV, key, ic->executable_offset);
+		ic->key = key;
+		return SLJIT_SUCCESS;
+	}
+
+	if (ic->stub_count >= SLJIT_IC_MAX_STUBS)
+		return SLJIT_ERR_UNSUPPORTED;
+
+	/* The new stub is inserted at the start of the chain. */
+	compiler = sljit_create_compiler(NULL);
+	if (SLJIT_UNLIKELY(!compiler))
+		return SLJIT_ERR_ALLOC_FAILED;
+
+	sljit_set_context(compiler, 0, SLJIT_ARGS0V(), ic->scratches, ic->saveds, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, ic->tmp_reg, 0, SLJIT_IMM, key);
+
+	jump = sljit_emit_cmp(compiler, SLJIT_EQUAL, ic->src, 0, ic->tmp_reg, 0);
+	sljit_set_target(jump, target);
+	jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+	sljit_set_target(jump, ic->miss_head);
+
+	code = sljit_generate_code(compiler, SLJIT_GENERATE_CODE_NO_CONTEXT, exec_allocator_data);
+
+	if (SLJIT_UNLIKELY(!code)) {
+		error = sljit_get_compiler_error(compiler);
+		sljit_free_compiler(compiler);
+		return error != SLJIT_SUCCESS ? error : SLJIT_ERR_ALLOC_FAILED;
+	}
+
+	sljit_free_compiler(compiler);
+
+	sljit_set_jump_addr(ic->miss_addr, (sljit_uw)code, ic->executable_offset);
+	ic->stubs[ic->stub_count++] = code;
+	ic->miss_head = (sljit_uw)code;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_reset_ic(struct sljit_ic *ic, void *exec_allocator_data)
+{
+	sljit_s32 i;
+
+	/* The stubs are unlinked before the key is removed. */
+	sljit_set_jump_addr(ic->miss_addr, ic->miss_target, ic->executable_offset);
+	sljit_set_const(ic->key_addr, SLJIT_MOV, SLJIT_IC_EMPTY_KEY, ic->executable_offset);
+	sljit_set_jump_addr(ic->hit_addr, ic->miss_target, ic->executable_offset);
+
+	for (i = 0; i < ic->stub_count; i++)
+		sljit_free_code(ic->stubs[i], exec_allocator_data);
+
+	ic->miss_head = ic->miss_target;
+	ic->key = SLJIT_IC_EMPTY_KEY;
+	ic->stub_count = 0;
+}
@@ -150,6 +150,9 @@
 #define SLJIT_SIMD_TYPE_MASK(m) ((sljit_s32)0xff000fff & ~(SLJIT_SIMD_FLOAT | SLJIT_SIMD_TEST | (m)))
 #define SLJIT_SIMD_TYPE_MASK2(m) ((sljit_s32)0xc0000fff & ~(SLJIT_SIMD_FLOAT | SLJIT_SIMD_TEST | (m)))
 
+/* Getter for sljit_emit_mem_block, which returns with log2(alignment). */
+#define SLJIT_MEM_BLOCK_GET_ALIGNMENT(type)	(((type) >> 8) & 0x7)
+
 /* Label definitions. */
 
 #define SLJIT_LABEL_ALIGNED ((~(sljit_uw)0) - 1)
@@ -160,6 +163,9 @@ struct sljit_extended_label {
 	sljit_uw data;
 };
 
+#define SLJIT_GET_LABEL_INDEX(label) \
+	((label)->u.index < SLJIT_LABEL_ALIGNED ? (label)->u.index : ((struct sljit_extended_label*)(label))->index)
+
 /* Jump definitions. */
 
 /* Jump flag bits. */
@@ -167,6 +173,9 @@ struct sljit_extended_label {
 #define JUMP_MOV_ADDR	0x2
 /* SLJIT_REWRITABLE_JUMP is 0x10000. */
 
+/* Branch prediction hints. */
+#define JUMP_HINT_MASK	(SLJIT_JUMP_LIKELY | SLJIT_JUMP_UNLIKELY)
+
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
 #	define PATCH_MB		0x04
 #	define PATCH_MW		0x08
@@ -592,6 +601,8 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_free_compiler(struct sljit_compiler *compile
 {
 	struct sljit_memory_fragment *buf;
 	struct sljit_memory_fragment *curr;
+	struct sljit_switch *switch_;
+	struct sljit_switch *curr_switch;
 	void *allocator_data = compiler->allocator_data;
 	SLJIT_UNUSED_ARG(allocator_data);
 
@@ -609,6 +620,13 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_free_compiler(struct sljit_compiler *compile
 		SLJIT_FREE(curr, allocator_data);
 	}
 
+	switch_ = compiler->switches;
+	while (switch_) {
+		curr_switch = switch_;
+		switch_ = switch_->next;
+		SLJIT_FREE(curr_switch, allocator_data);
+	}
+
 #if (defined SLJIT_CONFIG_ARM_V6 && SLJIT_CONFIG_ARM_V6)
 	SLJIT_FREE(compiler->cpool, allocator_data);
 #endif /* SLJIT_CONFIG_ARM_V6 */
@@ -644,6 +662,25 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_target(struct sljit_jump *jump, sljit_uw
 	}
 }
 
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_switch_label(struct sljit_switch *switch_, sljit_uw index, struct sljit_label *label)
+{
+	sljit_uw i;
+
+	if (SLJIT_UNLIKELY(!switch_))
+		return;
+
+	SLJIT_ASSERT(index <= switch_->case_count);
+	switch_->labels[index] = label;
+
+	if (index < switch_->case_count) {
+		sljit_set_label(switch_->jumps[index], label);
+		return;
+	}
+
+	for (i = 0; i < switch_->default_count; i++)
+		sljit_set_label(switch_->jumps[index + i], label);
+}
+
 #define SLJIT_CURRENT_FLAGS_ALL (SLJIT_CURRENT_FLAGS_32 | SLJIT_CURRENT_FLAGS_ADD \
 	| SLJIT_CURRENT_FLAGS_SUB | SLJIT_CURRENT_FLAGS_COMPARE | SLJIT_CURRENT_FLAGS_OP2CMPZ)
 
@@ -662,6 +699,10 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_current_flags(struct sljit_compiler *com
 	compiler->status_flags_state = current_flags;
 #endif /* SLJIT_HAS_STATUS_FLAGS_STATE */
 
+#if (defined SLJIT_HAS_FLAG_REGISTERS && SLJIT_HAS_FLAG_REGISTERS)
+	compiler->zero_flag_end = 0;
+#endif /* SLJIT_HAS_FLAG_REGISTERS */
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	compiler->last_flags = 0;
 	if ((current_flags & ~(ALL_STATUS_FLAGS_MASK | SLJIT_CURRENT_FLAGS_ALL)) == 0) {
@@ -916,6 +957,48 @@ static SLJIT_INLINE void set_const(struct sljit_const *const_, struct sljit_comp
 	compiler->last_const = const_;
 }
 
+#if (defined SLJIT_HAS_FLAG_REGISTERS && SLJIT_HAS_FLAG_REGISTERS)
+
+/* Flag liveness: when an operation only sets the zero flag and its result
+   is stored in a register, the zero flag register is set by a copy emitted
+   after the operation. Until other instructions are emitted, this copy is
+   removed when the zero flag is overwritten, or when a jump tests the
+   result register directly. */
+#define IS_LAZY_ZERO_FLAG_OP(op) \
+	(((op) & ALL_STATUS_FLAGS_MASK) == SLJIT_SET_Z \
+		&& GET_OPCODE(op) != SLJIT_ADDC && GET_OPCODE(op) != SLJIT_SUBC)
+
+static SLJIT_INLINE void set_zero_flag_copy(struct sljit_compiler *compiler, sljit_uw start, sljit_s32 reg)
+{
+	compiler->zero_flag_start = start;
+	compiler->zero_flag_end = compiler->size;
+	compiler->zero_flag_reg = reg;
+}
+
+/* Returns with the source register if the last instruction is
+   a removable zero flag copy, and removes it. Otherwise returns 0. */
+static sljit_s32 remove_zero_flag_copy(struct sljit_compiler *compiler)
+{
+	if (compiler->zero_flag_end == 0 || compiler->zero_flag_end != compiler->size)
+		return 0;
+
+	compiler->zero_flag_end = 0;
+
+	/* Labels must not be moved and fragments must not be emptied. */
+	if ((compiler->last_label != NULL && compiler->last_label->size == compiler->size)
+			|| compiler->buf->used_size <= sizeof(sljit_u32))
+		return 0;
+
+	compiler->size = compiler->zero_flag_start;
+	compiler->buf->used_size -= (sljit_uw)sizeof(sljit_u32);
+#if (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS)
+	compiler->delay_slot = UNMOVABLE_INS;
+#endif /* SLJIT_CONFIG_MIPS */
+	return compiler->zero_flag_reg;
+}
+
+#endif /* SLJIT_HAS_FLAG_REGISTERS */
+
 #define ADDRESSING_DEPENDS_ON(exp, reg) \
 	(((exp) & SLJIT_MEM) && (((exp) & REG_MASK) == reg || OFFS_REG(exp) == reg))
 
@@ -1287,14 +1370,16 @@ static const char* op1_names[] = {
 	"mov", "mov", "mov", "mov",
 	"mov", "mov", "mov", "mov",
 	"mov", "clz", "ctz", "rev",
-	"rev", "rev", "rev", "rev"
+	"rev", "rev", "rev", "rev",
+	"popcnt"
 };
 
 static const char* op1_types[] = {
 	"", ".u8", ".s8", ".u16",
 	".s16", ".u32", ".s32", "32",
 	".p", "", "", "",
-	".u16", ".s16", ".u32", ".s32"
+	".u16", ".s16", ".u32", ".s32",
+	""
 };
 
 static const char* op2_names[] = {
@@ -1305,20 +1390,29 @@ static const char* op2_names[] = {
 };
 
 static const char* op2r_names[] = {
-	"muladd"
+	"muladd", "pdep", "pext", "crc32c.u8",
+	"crc32c.u16", "crc32c.u32", "crc32c"
+};
+
+static const char* bitfield_names[] = {
+	"extract_u", "extract_s", "insert"
 };
 
 static const char* op_src_dst_names[] = {
 	"fast_return", "skip_frames_before_fast_return",
 	"prefetch_l1", "prefetch_l2",
 	"prefetch_l3", "prefetch_once",
-	"fast_enter", "get_return_address"
+	"fast_enter", "get_return_address",
+	"prefetch_write_l1", "prefetch_write_l2",
+	"prefetch_write_l3", "get_cycle_counter",
+	"get_thread_pointer"
 };
 
 static const char* fop1_names[] = {
 	"mov", "conv", "conv", "conv",
 	"conv", "conv", "conv", "conv",
-	"cmp", "neg", "abs",
+	"cmp", "neg", "abs", "sqrt",
+	"floor", "ceil", "trunc", "round",
 };
 
 static const char* fop1_conv_types[] = {
@@ -1327,11 +1421,12 @@ static const char* fop1_conv_types[] = {
 };
 
 static const char* fop2_names[] = {
-	"add", "sub", "mul", "div"
+	"add", "sub", "mul", "div",
+	"min", "max"
 };
 
 static const char* fop2r_names[] = {
-	"copysign"
+	"copysign", "muladd", "mulsub"
 };
 
 static const char* simd_op2_names[] = {
@@ -1369,6 +1464,9 @@ static const char* op_addr_types[] = {
 	"mov_addr", "mov_abs_addr", "add_abs_addr"
 };
 
+#define JUMP_HINT_NAME(type) \
+	(((type) & SLJIT_JUMP_LIKELY) ? ".likely" : (((type) & SLJIT_JUMP_UNLIKELY) ? ".unlikely" : ""))
+
 #endif /* SLJIT_VERBOSE */
 
 /* --------------------------------------------------------------------- */
@@ -1385,6 +1483,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_generate_code(struct sljit_com
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	struct sljit_jump *jump;
+	struct sljit_switch *switch_;
+	sljit_uw i;
 #endif /* SLJIT_ARGUMENT_CHECKS */
 
 	SLJIT_UNUSED_ARG(compiler);
@@ -1392,7 +1492,12 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_generate_code(struct sljit_com
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(compiler->size > 0);
-	CHECK_ARGUMENT((options & ~(SLJIT_GENERATE_CODE_BUFFER | SLJIT_GENERATE_CODE_NO_CONTEXT)) == 0);
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	CHECK_ARGUMENT((options & ~(SLJIT_GENERATE_CODE_BUFFER | SLJIT_GENERATE_CODE_NO_CONTEXT
+		| SLJIT_GENERATE_CODE_PEEPHOLE | SLJIT_GENERATE_CODE_PIC)) == 0);
+#else /* !SLJIT_CONFIG_X86_64 */
+	CHECK_ARGUMENT((options & ~(SLJIT_GENERATE_CODE_BUFFER | SLJIT_GENERATE_CODE_NO_CONTEXT | SLJIT_GENERATE_CODE_PEEPHOLE)) == 0);
+#endif /* SLJIT_CONFIG_X86_64 */
 
 	jump = compiler->jumps;
 	while (jump) {
@@ -1400,12 +1505,20 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_generate_code(struct sljit_com
 		CHECK_ARGUMENT((jump->flags & JUMP_ADDR) || jump->u.label != NULL);
 		jump = jump->next;
 	}
+
+	switch_ = compiler->switches;
+	while (switch_) {
+		/* All cases have label. */
+		for (i = 0; i <= switch_->case_count; i++)
+			CHECK_ARGUMENT(switch_->labels[i] != NULL);
+		switch_ = switch_->next;
+	}
 #endif /* SLJIT_ARGUMENT_CHECKS */
 	CHECK_RETURN_OK;
 }
 
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
-#define SLJIT_ENTER_CPU_SPECIFIC_OPTIONS (SLJIT_ENTER_USE_VEX)
+#define SLJIT_ENTER_CPU_SPECIFIC_OPTIONS (SLJIT_ENTER_USE_VEX | SLJIT_ENTER_CONCURRENT_PATCH)
 #else /* !SLJIT_CONFIG_X86 */
 #define SLJIT_ENTER_CPU_SPECIFIC_OPTIONS (0)
 #endif /* !SLJIT_CONFIG_X86 */
@@ -1655,6 +1768,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_return_to(struct sljit_co
 
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op0(struct sljit_compiler *compiler, sljit_s32 op)
 {
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT((op >= SLJIT_BREAKPOINT && op <= SLJIT_LMUL_SW)
 		|| ((op & ~SLJIT_32) >= SLJIT_DIVMOD_UW && (op & ~SLJIT_32) <= SLJIT_DIV_SW)
@@ -1676,6 +1794,23 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op0(struct sljit_compiler
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_div_imm(struct sljit_compiler *compiler, sljit_s32 op, sljit_sw divisor)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT((op & ~SLJIT_32) >= SLJIT_DIVMOD_UW && (op & ~SLJIT_32) <= SLJIT_DIV_SW);
+	CHECK_ARGUMENT(compiler->scratches >= 3);
+	CHECK_ARGUMENT((op & SLJIT_32) ? (sljit_s32)divisor != 0 : divisor != 0);
+	compiler->last_flags = 0;
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
+		fprintf(compiler->verbose, "  %s%s #%" SLJIT_PRINT_D "d\n", op0_names[GET_OPCODE(op) - SLJIT_OP0_BASE],
+			(op & SLJIT_32) ? "32" : "w", divisor);
+	}
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op1(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src, sljit_sw srcw)
@@ -1686,7 +1821,7 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op1(struct sljit_compiler
 	}
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_MOV && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_REV_S32);
+	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_MOV && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_POPCNT);
 
 	switch (GET_OPCODE(op)) {
 	case SLJIT_MOV:
@@ -1923,7 +2058,10 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op2r(struct sljit_compile
 	sljit_s32 src2, sljit_sw src2w)
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT((op | SLJIT_32) == SLJIT_MULADD32);
+	CHECK_ARGUMENT((op | SLJIT_32) == SLJIT_MULADD32
+		|| (((op | SLJIT_32) == SLJIT_PDEP32 || (op | SLJIT_32) == SLJIT_PEXT32)
+			&& sljit_has_cpu_feature(SLJIT_HAS_PDEP_PEXT) == 1)
+		|| (op >= SLJIT_CRC32C_U8 && op <= SLJIT_CRC32C));
 	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(dst_reg));
 	FUNCTION_CHECK_SRC(src1, src1w);
 	FUNCTION_CHECK_SRC(src2, src2w);
@@ -1978,6 +2116,32 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_shift_into(struct sljit_c
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT((op & ~SLJIT_32) >= SLJIT_EXTRACT_U && (op & ~SLJIT_32) <= SLJIT_INSERT);
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(dst_reg));
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(src_reg));
+	CHECK_ARGUMENT(start >= 0 && length > 0);
+	CHECK_ARGUMENT(start + length <= ((op & SLJIT_32) ? 32 : (sljit_s32)(8 * sizeof(sljit_sw))));
+	CHECK_ARGUMENT(GET_OPCODE(op) != SLJIT_INSERT || dst_reg != src_reg);
+	compiler->last_flags = 0;
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
+		fprintf(compiler->verbose, "  %s%s ", bitfield_names[GET_OPCODE(op) - SLJIT_BITFIELD_BASE], !(op & SLJIT_32) ? "" : "32");
+
+		sljit_verbose_reg(compiler, dst_reg);
+		fprintf(compiler->verbose, ", ");
+		sljit_verbose_reg(compiler, src_reg);
+		fprintf(compiler->verbose, ", #%d, #%d\n", start, length);
+	}
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op2_shift(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -2012,15 +2176,15 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op_src(struct sljit_compi
 	sljit_s32 src, sljit_sw srcw)
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(op >= SLJIT_FAST_RETURN && op <= SLJIT_PREFETCH_ONCE);
+	CHECK_ARGUMENT((op >= SLJIT_FAST_RETURN && op <= SLJIT_PREFETCH_ONCE)
+		|| (op >= SLJIT_PREFETCH_WRITE_L1 && op <= SLJIT_PREFETCH_WRITE_L3));
 	FUNCTION_CHECK_SRC(src, srcw);
 
 	if (op == SLJIT_FAST_RETURN || op == SLJIT_SKIP_FRAMES_BEFORE_FAST_RETURN) {
 		CHECK_ARGUMENT(src != SLJIT_IMM);
 		compiler->last_flags = 0;
-	} else if (op >= SLJIT_PREFETCH_L1 && op <= SLJIT_PREFETCH_ONCE) {
+	} else
 		CHECK_ARGUMENT(src & SLJIT_MEM);
-	}
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
 	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
@@ -2036,10 +2200,10 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op_dst(struct sljit_compi
 	sljit_s32 dst, sljit_sw dstw)
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(op >= SLJIT_FAST_ENTER && op <= SLJIT_GET_RETURN_ADDRESS);
+	CHECK_ARGUMENT((op >= SLJIT_FAST_ENTER && op <= SLJIT_GET_RETURN_ADDRESS) || op == SLJIT_GET_CYCLE_COUNTER || op == SLJIT_GET_THREAD_POINTER);
 	FUNCTION_CHECK_DST(dst, dstw);
 
-	if (op == SLJIT_FAST_ENTER)
+	if (op == SLJIT_FAST_ENTER || op == SLJIT_GET_CYCLE_COUNTER)
 		compiler->last_flags = 0;
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
@@ -2123,7 +2287,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fop1(struct sljit_compile
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_FPU));
-	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_MOV_F64 && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_ABS_F64);
+	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_MOV_F64 && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_ROUND_F64);
+	CHECK_ARGUMENT(GET_OPCODE(op) < SLJIT_FLOOR_F64 || sljit_has_cpu_feature(SLJIT_HAS_FROUND));
 	CHECK_ARGUMENT(!(op & ALL_STATUS_FLAGS_MASK));
 	FUNCTION_FCHECK(src, srcw, op & SLJIT_32);
 	FUNCTION_FCHECK(dst, dstw, op & SLJIT_32);
@@ -2254,7 +2419,7 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fop2(struct sljit_compile
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_FPU));
-	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_ADD_F64 && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_DIV_F64);
+	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_ADD_F64 && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_MAX_F64);
 	CHECK_ARGUMENT(!(op & ALL_STATUS_FLAGS_MASK));
 	FUNCTION_FCHECK(src1, src1w, op & SLJIT_32);
 	FUNCTION_FCHECK(src2, src2w, op & SLJIT_32);
@@ -2281,7 +2446,7 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fop2r(struct sljit_compil
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_FPU));
-	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) == SLJIT_COPYSIGN_F64);
+	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, 0) >= SLJIT_COPYSIGN_F64 && SLJIT_CHECK_OPCODE(op, 0) <= SLJIT_MULSUB_F64);
 	FUNCTION_FCHECK(src1, src1w, op & SLJIT_32);
 	FUNCTION_FCHECK(src2, src2w, op & SLJIT_32);
 	CHECK_ARGUMENT(FUNCTION_CHECK_IS_FREG(dst_freg, op & SLJIT_32));
@@ -2432,6 +2597,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_aligned_label(struct slji
 	SLJIT_UNUSED_ARG(compiler);
 	SLJIT_UNUSED_ARG(buffers);
 
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(alignment >= SLJIT_LABEL_ALIGN_1 && alignment <= SLJIT_LABEL_ALIGN_16);
 	compiler->last_flags = 0;
@@ -2457,6 +2627,24 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_aligned_label(struct slji
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_set_cold_region(struct sljit_compiler *compiler,
+	struct sljit_label *start_label, struct sljit_label *end_label)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT(start_label != NULL && end_label != NULL);
+	CHECK_ARGUMENT(SLJIT_GET_LABEL_INDEX(start_label) < SLJIT_GET_LABEL_INDEX(end_label));
+	/* Regions must be ordered and must not overlap. */
+	CHECK_ARGUMENT(compiler->last_cold_region == NULL
+		|| SLJIT_GET_LABEL_INDEX(compiler->last_cold_region->end) <= SLJIT_GET_LABEL_INDEX(start_label));
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose))
+		fprintf(compiler->verbose, "  cold_region #%ld, #%ld\n",
+			(long int)SLJIT_GET_LABEL_INDEX(start_label), (long int)SLJIT_GET_LABEL_INDEX(end_label));
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) \
 	|| (defined SLJIT_CONFIG_ARM && SLJIT_CONFIG_ARM)
@@ -2476,8 +2664,9 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_jump(struct sljit_compile
 	}
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP)));
+	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK)));
 	CHECK_ARGUMENT((type & 0xff) >= SLJIT_EQUAL && (type & 0xff) <= SLJIT_FAST_CALL);
+	CHECK_ARGUMENT(!(type & JUMP_HINT_MASK) || ((type & 0xff) < SLJIT_JUMP && (type & JUMP_HINT_MASK) != JUMP_HINT_MASK));
 
 	if ((type & 0xff) < SLJIT_JUMP) {
 		if ((type & 0xff) <= SLJIT_NOT_ZERO)
@@ -2492,8 +2681,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_jump(struct sljit_compile
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
 	if (SLJIT_UNLIKELY(!!compiler->verbose))
-		fprintf(compiler->verbose, "  jump%s %s\n", !(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r",
-			jump_names[type & 0xff]);
+		fprintf(compiler->verbose, "  jump%s%s %s\n", !(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r",
+			JUMP_HINT_NAME(type), jump_names[type & 0xff]);
 #endif /* SLJIT_VERBOSE */
 	CHECK_RETURN_OK;
 }
@@ -2549,7 +2738,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_cmp(struct sljit_compiler
 	}
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP | SLJIT_32)));
+	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP | SLJIT_32 | JUMP_HINT_MASK)));
+	CHECK_ARGUMENT((type & JUMP_HINT_MASK) != JUMP_HINT_MASK);
 	CHECK_ARGUMENT((type & 0xff) >= SLJIT_EQUAL && (type & 0xff) <= SLJIT_SIG_LESS_EQUAL);
 	FUNCTION_CHECK_SRC(src1, src1w);
 	FUNCTION_CHECK_SRC(src2, src2w);
@@ -2557,8 +2747,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_cmp(struct sljit_compiler
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
 	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
-		fprintf(compiler->verbose, "  cmp%s%s %s, ", (type & SLJIT_32) ? "32" : "",
-			!(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r", jump_names[type & 0xff]);
+		fprintf(compiler->verbose, "  cmp%s%s%s %s, ", (type & SLJIT_32) ? "32" : "",
+			!(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r", JUMP_HINT_NAME(type), jump_names[type & 0xff]);
 		sljit_verbose_param(compiler, src1, src1w);
 		fprintf(compiler->verbose, ", ");
 		sljit_verbose_param(compiler, src2, src2w);
@@ -2574,7 +2764,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fcmp(struct sljit_compile
 {
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_FPU));
-	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP | SLJIT_32)));
+	CHECK_ARGUMENT(!(type & ~(0xff | SLJIT_REWRITABLE_JUMP | SLJIT_32 | JUMP_HINT_MASK)));
+	CHECK_ARGUMENT((type & JUMP_HINT_MASK) != JUMP_HINT_MASK);
 	CHECK_ARGUMENT((type & 0xff) >= SLJIT_F_EQUAL && (type & 0xff) <= SLJIT_ORDERED_LESS_EQUAL);
 	FUNCTION_FCHECK(src1, src1w, type & SLJIT_32);
 	FUNCTION_FCHECK(src2, src2w, type & SLJIT_32);
@@ -2582,8 +2773,8 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fcmp(struct sljit_compile
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
 	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
-		fprintf(compiler->verbose, "  fcmp%s%s %s, ", (type & SLJIT_32) ? ".f32" : ".f64",
-			!(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r", jump_names[type & 0xff]);
+		fprintf(compiler->verbose, "  fcmp%s%s%s %s, ", (type & SLJIT_32) ? ".f32" : ".f64",
+			!(type & SLJIT_REWRITABLE_JUMP) ? "" : ".r", JUMP_HINT_NAME(type), jump_names[type & 0xff]);
 		sljit_verbose_fparam(compiler, src1, src1w);
 		fprintf(compiler->verbose, ", ");
 		sljit_verbose_fparam(compiler, src2, src2w);
@@ -2602,9 +2793,10 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op2cmpz(struct sljit_comp
 		incorrect_values_for_sljit_jump_zero_or_non_zero);
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
-	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, SLJIT_REWRITABLE_JUMP) >= SLJIT_ADD && SLJIT_CHECK_OPCODE(op, SLJIT_REWRITABLE_JUMP) <= SLJIT_ROTR);
+	CHECK_ARGUMENT(SLJIT_CHECK_OPCODE(op, SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK) >= SLJIT_ADD && SLJIT_CHECK_OPCODE(op, SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK) <= SLJIT_ROTR);
+	CHECK_ARGUMENT((op & JUMP_HINT_MASK) != JUMP_HINT_MASK);
 	/* Not all opcodes allow setting zero flags. */
-	CHECK_ARGUMENT(check_sljit_emit_op2_operation(compiler, ((op | SLJIT_SET_Z) & ~SLJIT_REWRITABLE_JUMP)));
+	CHECK_ARGUMENT(check_sljit_emit_op2_operation(compiler, ((op | SLJIT_SET_Z) & ~(SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK))));
 	FUNCTION_CHECK_DST(dst, dstw);
 	FUNCTION_CHECK_SRC(src1, src1w);
 	FUNCTION_CHECK_SRC(src2, src2w);
@@ -2612,10 +2804,10 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op2cmpz(struct sljit_comp
 #endif /* SLJIT_ARGUMENT_CHECKS */
 #if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
 	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
-		fprintf(compiler->verbose, "  cmp%sz.%s%s%s%s%s ", (op & SLJIT_JUMP_IF_ZERO) ? "" : "n",
+		fprintf(compiler->verbose, "  cmp%sz.%s%s%s%s%s%s ", (op & SLJIT_JUMP_IF_ZERO) ? "" : "n",
 			op2_names[GET_OPCODE(op) - SLJIT_OP2_BASE], !(op & SLJIT_32) ? "" : "32",
-			!(op & VARIABLE_FLAG_MASK) ? "" : ".", !(op & VARIABLE_FLAG_MASK) ? "" : jump_names[GET_FLAG_TYPE(op & ~SLJIT_REWRITABLE_JUMP)],
-			!(op & SLJIT_REWRITABLE_JUMP) ? "" : ".r");
+			!(op & VARIABLE_FLAG_MASK) ? "" : ".", !(op & VARIABLE_FLAG_MASK) ? "" : jump_names[GET_FLAG_TYPE(op & ~(SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK))],
+			!(op & SLJIT_REWRITABLE_JUMP) ? "" : ".r", JUMP_HINT_NAME(op));
 		sljit_verbose_param(compiler, dst, dstw);
 		fprintf(compiler->verbose, ", ");
 		sljit_verbose_param(compiler, src1, src1w);
@@ -2649,6 +2841,39 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_ijump(struct sljit_compil
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_switch(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_sw srcw, const sljit_sw *values, sljit_uw count)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
+		|| (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	sljit_uw i;
+#endif /* SLJIT_ARGUMENT_CHECKS || SLJIT_VERBOSE */
+
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(src) && !CHECK_IF_VIRTUAL_REGISTER(src));
+	CHECK_ARGUMENT(srcw == 0);
+	CHECK_ARGUMENT(values != NULL && count > 0);
+
+	for (i = 1; i < count; i++)
+		CHECK_ARGUMENT(values[i - 1] < values[i]);
+
+	compiler->last_flags = 0;
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
+		fprintf(compiler->verbose, "  switch ");
+		sljit_verbose_param(compiler, src, srcw);
+		fprintf(compiler->verbose, ", [%" SLJIT_PRINT_D "d", values[0]);
+
+		for (i = 1; i < count; i++)
+			fprintf(compiler->verbose, ", %" SLJIT_PRINT_D "d", values[i]);
+
+		fprintf(compiler->verbose, "]\n");
+	}
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_icall(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 arg_types,
 	sljit_s32 src, sljit_sw srcw)
@@ -2829,10 +3054,10 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_mem(struct sljit_compiler
 	} else if (type & SLJIT_MEM_ALIGNED_16) {
 		CHECK_ARGUMENT(!(type & SLJIT_MEM_ALIGNED_32));
 	} else {
-		CHECK_ARGUMENT((reg & REG_PAIR_MASK) || (type & SLJIT_MEM_ALIGNED_32));
+		CHECK_ARGUMENT((reg & REG_PAIR_MASK) || (type & (SLJIT_MEM_ALIGNED_32 | SLJIT_MEM_NON_TEMPORAL)));
 	}
 
-	allowed_flags = SLJIT_MEM_UNALIGNED;
+	allowed_flags = SLJIT_MEM_UNALIGNED | SLJIT_MEM_NON_TEMPORAL;
 
 	switch (type & 0xff) {
 	case SLJIT_MOV_P:
@@ -2878,6 +3103,9 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_mem(struct sljit_compiler
 		else if (type & SLJIT_MEM_ALIGNED_32)
 			fprintf(compiler->verbose, ".al32");
 
+		if (type & SLJIT_MEM_NON_TEMPORAL)
+			fprintf(compiler->verbose, ".nt");
+
 		if (reg & REG_PAIR_MASK) {
 			fprintf(compiler->verbose, " {");
 			sljit_verbose_reg(compiler, REG_PAIR_FIRST(reg));
@@ -3019,13 +3247,61 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_fmem_update(struct sljit_
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT((type & ~(SLJIT_MEM_BLOCK_FILL | (0x7 << 8))) == 0);
+	CHECK_ARGUMENT(SLJIT_MEM_BLOCK_GET_ALIGNMENT(type) <= 4);
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(dst_reg) && dst_reg < SLJIT_TMP_REGISTER_BASE);
+
+	if (type & SLJIT_MEM_BLOCK_FILL)
+		CHECK_ARGUMENT(src == SLJIT_IMM || (FUNCTION_CHECK_IS_REG(src) && src < SLJIT_TMP_REGISTER_BASE));
+	else
+		CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(src) && src < SLJIT_TMP_REGISTER_BASE);
+
+	CHECK_ARGUMENT(src != dst_reg);
+
+	if (len == SLJIT_IMM)
+		CHECK_ARGUMENT(lenw >= 0);
+	else
+		CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(len) && len < SLJIT_TMP_REGISTER_BASE && len != dst_reg && len != src);
+
+	compiler->last_flags = 0;
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
+		fprintf(compiler->verbose, "  mem_block.%s", (type & SLJIT_MEM_BLOCK_FILL) ? "fill" : "copy");
+
+		if (SLJIT_MEM_BLOCK_GET_ALIGNMENT(type) > 0)
+			fprintf(compiler->verbose, ".al%d", 8 << SLJIT_MEM_BLOCK_GET_ALIGNMENT(type));
+
+		fprintf(compiler->verbose, " ");
+		sljit_verbose_reg(compiler, dst_reg);
+		fprintf(compiler->verbose, ", ");
+		sljit_verbose_param(compiler, src, srcw);
+		fprintf(compiler->verbose, ", ");
+		sljit_verbose_param(compiler, len, lenw);
+		fprintf(compiler->verbose, "\n");
+	}
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_simd_mov(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 vreg,
 	sljit_s32 srcdst, sljit_sw srcdstw)
 {
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_SIMD));
-	CHECK_ARGUMENT((type & SLJIT_SIMD_TYPE_MASK2(SLJIT_SIMD_STORE)) == 0);
+	CHECK_ARGUMENT((type & SLJIT_SIMD_TYPE_MASK2(SLJIT_SIMD_STORE | SLJIT_SIMD_MEM_NON_TEMPORAL)) == 0);
 	CHECK_ARGUMENT(SLJIT_SIMD_CHECK_REG(type));
 	CHECK_ARGUMENT(SLJIT_SIMD_GET_ELEM_SIZE(type) <= SLJIT_SIMD_GET_REG_SIZE(type));
 	CHECK_ARGUMENT(SLJIT_SIMD_GET_ELEM2_SIZE(type) <= (srcdst & SLJIT_MEM) ? SLJIT_SIMD_GET_REG_SIZE(type) : 0);
@@ -3048,9 +3324,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_simd_mov(struct sljit_com
 			(8 << SLJIT_SIMD_GET_ELEM_SIZE(type)));
 
 		if ((type & 0x3f000000) == SLJIT_SIMD_MEM_UNALIGNED)
-			fprintf(compiler->verbose, ".unal ");
+			fprintf(compiler->verbose, ".unal");
 		else
-			fprintf(compiler->verbose, ".al%d ", (8 << SLJIT_SIMD_GET_ELEM2_SIZE(type)));
+			fprintf(compiler->verbose, ".al%d", (8 << SLJIT_SIMD_GET_ELEM2_SIZE(type)));
+
+		fprintf(compiler->verbose, (type & SLJIT_SIMD_MEM_NON_TEMPORAL) ? ".nt " : " ");
 
 		sljit_verbose_vreg(compiler, vreg);
 		fprintf(compiler->verbose, ", ");
@@ -3065,6 +3343,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_simd_replicate(struct slj
 	sljit_s32 vreg,
 	sljit_s32 src, sljit_sw srcw)
 {
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(sljit_has_cpu_feature(SLJIT_HAS_SIMD));
 	CHECK_ARGUMENT((type & SLJIT_SIMD_TYPE_MASK(0)) == 0);
@@ -3340,6 +3623,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_const(struct sljit_compil
 {
 	SLJIT_UNUSED_ARG(init_value);
 
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(op == SLJIT_MOV || op == SLJIT_MOV_S32
 		|| op == SLJIT_MOV32 || (op | SLJIT_32) == SLJIT_MOV32_U8);
@@ -3359,6 +3647,11 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_const(struct sljit_compil
 static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op_addr(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw)
 {
+	if (SLJIT_UNLIKELY(compiler->skip_checks)) {
+		compiler->skip_checks = 0;
+		CHECK_RETURN_OK;
+	}
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
 	CHECK_ARGUMENT(op == SLJIT_MOV_ADDR || op == SLJIT_MOV_ABS_ADDR || op == SLJIT_ADD_ABS_ADDR);
 	FUNCTION_CHECK_DST(dst, dstw);
@@ -3373,6 +3666,27 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op_addr(struct sljit_comp
 	CHECK_RETURN_OK;
 }
 
+static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_ic_site(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_s32 tmp_reg)
+{
+#if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS)
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(src) && !CHECK_IF_VIRTUAL_REGISTER(src));
+	CHECK_ARGUMENT(FUNCTION_CHECK_IS_REG(tmp_reg) && !CHECK_IF_VIRTUAL_REGISTER(tmp_reg));
+	CHECK_ARGUMENT(src < SLJIT_TMP_REGISTER_BASE && tmp_reg < SLJIT_TMP_REGISTER_BASE && src != tmp_reg);
+	compiler->last_flags = 0;
+#endif /* SLJIT_ARGUMENT_CHECKS */
+#if (defined SLJIT_VERBOSE && SLJIT_VERBOSE)
+	if (SLJIT_UNLIKELY(!!compiler->verbose)) {
+		fprintf(compiler->verbose, "  ic_site ");
+		sljit_verbose_reg(compiler, src);
+		fprintf(compiler->verbose, ", ");
+		sljit_verbose_reg(compiler, tmp_reg);
+		fprintf(compiler->verbose, "\n");
+	}
+#endif /* SLJIT_VERBOSE */
+	CHECK_RETURN_OK;
+}
+
 #else /* !SLJIT_ARGUMENT_CHECKS && !SLJIT_VERBOSE */
 
 #define SLJIT_SKIP_CHECKS(compiler)
@@ -3410,94 +3724,1147 @@ static SLJIT_INLINE CHECK_RETURN_TYPE check_sljit_emit_op_addr(struct sljit_comp
 	ADJUST_LOCAL_OFFSET(dst, dstw); \
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
-#if (!(defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) || (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6))
+/* Constant folding and algebraic simplification of integer operations.
+   Operations which set status flags are never simplified. */
 
-static sljit_s32 sljit_emit_mem_unaligned(struct sljit_compiler *compiler, sljit_s32 type,
-	sljit_s32 reg,
-	sljit_s32 mem, sljit_sw memw)
-{
-	SLJIT_SKIP_CHECKS(compiler);
+#define SLJIT_NOT_FOLDED (-1)
 
-	if (type & SLJIT_MEM_STORE)
-		return sljit_emit_op1(compiler, type & (0xff | SLJIT_32), mem, memw, reg, 0);
-	return sljit_emit_op1(compiler, type & (0xff | SLJIT_32), reg, 0, mem, memw);
+static sljit_uw fold_ashr(sljit_uw value, sljit_uw shift, sljit_uw sign_bit)
+{
+	if (!(value & sign_bit))
+		return value >> shift;
+	return ~(~value >> shift);
 }
 
-#endif /* (!SLJIT_CONFIG_MIPS || SLJIT_MIPS_REV >= 6) */
+static sljit_s32 sljit_fold_op1(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_sw dstw, sljit_sw srcw)
+{
+	sljit_uw value = (sljit_uw)srcw;
+	sljit_uw result = 0;
+	sljit_uw bit_length = (op & SLJIT_32) ? 32 : 8 * sizeof(sljit_sw);
+	sljit_uw bit;
+	sljit_uw i;
 
-#if (!(defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) || (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6)) \
-	&& !(defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32)
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	if (op & SLJIT_32)
+		value &= 0xffffffff;
+#endif /* SLJIT_64BIT_ARCHITECTURE */
 
-static sljit_s32 sljit_emit_fmem_unaligned(struct sljit_compiler *compiler, sljit_s32 type,
-	sljit_s32 freg,
-	sljit_s32 mem, sljit_sw memw)
-{
-	SLJIT_SKIP_CHECKS(compiler);
+	switch (GET_OPCODE(op)) {
+	case SLJIT_CLZ:
+		bit = (sljit_uw)1 << (bit_length - 1);
+		while (bit != 0 && !(value & bit)) {
+			result++;
+			bit >>= 1;
+		}
+		break;
+	case SLJIT_CTZ:
+		while (result < bit_length && !(value & ((sljit_uw)1 << result)))
+			result++;
+		break;
+	case SLJIT_REV:
+		for (i = 0; i < bit_length; i += 8)
+			result = (result << 8) | ((value >> i) & 0xff);
+		break;
+	case SLJIT_REV_U16:
+	case SLJIT_REV_S16:
+		result = ((value & 0xff) << 8) | ((value >> 8) & 0xff);
+		if (GET_OPCODE(op) == SLJIT_REV_S16 && (result & 0x8000))
+			result |= ~(sljit_uw)0xffff;
+		break;
+	case SLJIT_POPCNT:
+		while (value != 0) {
+			value &= value - 1;
+			result++;
+		}
+		break;
+	default:
+		SLJIT_ASSERT(GET_OPCODE(op) == SLJIT_REV_U32 || GET_OPCODE(op) == SLJIT_REV_S32);
+		for (i = 0; i < 32; i += 8)
+			result = (result << 8) | ((value >> i) & 0xff);
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+		if (GET_OPCODE(op) == SLJIT_REV_S32 && (result & 0x80000000))
+			result |= ~(sljit_uw)0xffffffff;
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+		break;
+	}
 
-	if (type & SLJIT_MEM_STORE)
-		return sljit_emit_fop1(compiler, type & (0xff | SLJIT_32), mem, memw, freg, 0);
-	return sljit_emit_fop1(compiler, type & (0xff | SLJIT_32), freg, 0, mem, memw);
-}
+	if (op & SLJIT_32)
+		result = (sljit_uw)(sljit_sw)(sljit_s32)result;
 
-#endif /* (!SLJIT_CONFIG_MIPS || SLJIT_MIPS_REV >= 6) && !SLJIT_CONFIG_ARM */
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op1(compiler, (op & SLJIT_32) ? SLJIT_MOV32 : SLJIT_MOV, dst, dstw, SLJIT_IMM, (sljit_sw)result);
+}
 
-static void sljit_reset_read_only_buffers(struct sljit_read_only_buffer *buffers)
+static sljit_s32 sljit_fold_op2(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_sw dstw,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
 {
-	while (buffers != NULL) {
-		buffers->u.label = NULL;
-		buffers = buffers->next;
+	sljit_s32 mov_op = (op & SLJIT_32) ? SLJIT_MOV32 : SLJIT_MOV;
+	sljit_uw mask = (op & SLJIT_32) ? 31 : (8 * sizeof(sljit_sw) - 1);
+	sljit_uw sign_bit = (sljit_uw)1 << mask;
+	sljit_uw all_ones = ~(sljit_uw)0 >> (8 * sizeof(sljit_sw) - 1 - mask);
+	sljit_uw value1 = (sljit_uw)src1w;
+	sljit_uw value2 = (sljit_uw)src2w;
+	sljit_uw result;
+	sljit_s32 src;
+	sljit_sw srcw;
+
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	if (op & SLJIT_32) {
+		value1 &= 0xffffffff;
+		value2 &= 0xffffffff;
 	}
-}
+#endif /* SLJIT_64BIT_ARCHITECTURE */
 
-/* CPU description section */
+	if (src1 == SLJIT_IMM && src2 == SLJIT_IMM) {
+		switch (GET_OPCODE(op)) {
+		case SLJIT_ADD:
+			result = value1 + value2;
+			break;
+		case SLJIT_SUB:
+			result = value1 - value2;
+			break;
+		case SLJIT_MUL:
+			result = value1 * value2;
+			break;
+		case SLJIT_AND:
+			result = value1 & value2;
+			break;
+		case SLJIT_OR:
+			result = value1 | value2;
+			break;
+		case SLJIT_XOR:
+			result = value1 ^ value2;
+			break;
+		case SLJIT_SHL:
+		case SLJIT_MSHL:
+			result = value1 << (value2 & mask);
+			break;
+		case SLJIT_LSHR:
+		case SLJIT_MLSHR:
+			result = value1 >> (value2 & mask);
+			break;
+		case SLJIT_ASHR:
+		case SLJIT_MASHR:
+			result = fold_ashr(value1, value2 & mask, sign_bit);
+			break;
+		case SLJIT_ROTL:
+		case SLJIT_ROTR:
+			value2 &= mask;
+			if (GET_OPCODE(op) == SLJIT_ROTR && value2 != 0)
+				value2 = mask + 1 - value2;
+			result = value1;
+			if (value2 != 0)
+				result = (value1 << value2) | (value1 >> (mask + 1 - value2));
+			break;
+		default:
+			/* SLJIT_ADDC and SLJIT_SUBC depend on the carry flag. */
+			return SLJIT_NOT_FOLDED;
+		}
 
-#if (defined SLJIT_32BIT_ARCHITECTURE && SLJIT_32BIT_ARCHITECTURE)
-#define SLJIT_CPUINFO_PART1 " 32bit ("
-#elif (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
-#define SLJIT_CPUINFO_PART1 " 64bit ("
-#else /* !SLJIT_32BIT_ARCHITECTURE && !SLJIT_64BIT_ARCHITECTURE */
-#error "Internal error: CPU type info missing"
-#endif /* SLJIT_32BIT_ARCHITECTURE */
+		if (op & SLJIT_32)
+			result = (sljit_uw)(sljit_sw)(sljit_s32)result;
 
-#if (defined SLJIT_LITTLE_ENDIAN && SLJIT_LITTLE_ENDIAN)
-#define SLJIT_CPUINFO_PART2 "little endian + "
-#elif (defined SLJIT_BIG_ENDIAN && SLJIT_BIG_ENDIAN)
-#define SLJIT_CPUINFO_PART2 "big endian + "
-#else /* !SLJIT_LITTLE_ENDIAN && !SLJIT_BIG_ENDIAN */
-#error "Internal error: CPU type info missing"
-#endif /* SLJIT_LITTLE_ENDIAN */
+		SLJIT_SKIP_CHECKS(compiler);
+		return sljit_emit_op1(compiler, mov_op, dst, dstw, SLJIT_IMM, (sljit_sw)result);
+	}
 
-#if (defined SLJIT_UNALIGNED && SLJIT_UNALIGNED)
-#define SLJIT_CPUINFO_PART3 "unaligned)"
-#else /* !SLJIT_UNALIGNED */
+	/* Exactly one of the operands is an immediate. */
+	if (src1 == SLJIT_IMM) {
+		src = src2;
+		srcw = src2w;
+	} else {
+		src = src1;
+		srcw = src1w;
+		value1 = value2;
+	}
+
+	/* The immediate is stored in value1 from now on. */
+	switch (GET_OPCODE(op)) {
+	case SLJIT_ADD:
+	case SLJIT_OR:
+	case SLJIT_XOR:
+		if (value1 == 0)
+			break;
+
+		if (GET_OPCODE(op) == SLJIT_OR && value1 == all_ones)
+			goto set_immediate;
+		return SLJIT_NOT_FOLDED;
+	case SLJIT_SUB:
+		if (src1 != SLJIT_IMM && value1 == 0)
+			break;
+		return SLJIT_NOT_FOLDED;
+	case SLJIT_MUL:
+		if (value1 == 1)
+			break;
+		if (value1 == 0)
+			goto set_immediate;
+		return SLJIT_NOT_FOLDED;
+	case SLJIT_AND:
+		if (value1 == 0)
+			goto set_immediate;
+		if (value1 == all_ones)
+			break;
+		return SLJIT_NOT_FOLDED;
+	case SLJIT_SHL:
+	case SLJIT_MSHL:
+	case SLJIT_LSHR:
+	case SLJIT_MLSHR:
+	case SLJIT_ASHR:
+	case SLJIT_MASHR:
+	case SLJIT_ROTL:
+	case SLJIT_ROTR:
+		if (src1 == SLJIT_IMM) {
+			/* Shifting or rotating zero produces zero. */
+			if (value1 == 0)
+				goto set_immediate;
+			return SLJIT_NOT_FOLDED;
+		}
+
+		if ((value1 & mask) == 0)
+			break;
+		return SLJIT_NOT_FOLDED;
+	default:
+		return SLJIT_NOT_FOLDED;
+	}
+
+	/* The result is the non-immediate operand. */
+	if (dst == src && dstw == srcw)
+		return SLJIT_SUCCESS;
+
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op1(compiler, mov_op, dst, dstw, src, srcw);
+
+set_immediate:
+	if (op & SLJIT_32)
+		value1 = (sljit_uw)(sljit_sw)(sljit_s32)value1;
+
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op1(compiler, mov_op, dst, dstw, SLJIT_IMM, (sljit_sw)value1);
+}
+
+/* Used by sljit_emit_op1 after the argument checks. Operations
+   with immediate source arguments are computed at compile time. */
+#define FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw) \
+	do { \
+		if ((src) == SLJIT_IMM && GET_OPCODE(op) >= SLJIT_CLZ) \
+			return sljit_fold_op1(compiler, op, dst, dstw, srcw); \
+	} while (0)
+
+/* Used by sljit_emit_op2 after the argument checks. */
+#define FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w) \
+	do { \
+		if (((src1) == SLJIT_IMM || (src2) == SLJIT_IMM) && !HAS_FLAGS(op)) { \
+			sljit_s32 fold_result = sljit_fold_op2(compiler, op, dst, dstw, src1, src1w, src2, src2w); \
+			if (fold_result != SLJIT_NOT_FOLDED) \
+				return fold_result; \
+		} \
+	} while (0)
+
+#if (!(defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) || (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6))
+
+static sljit_s32 sljit_emit_mem_unaligned(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 reg,
+	sljit_s32 mem, sljit_sw memw)
+{
+	SLJIT_SKIP_CHECKS(compiler);
+
+	if (type & SLJIT_MEM_STORE)
+		return sljit_emit_op1(compiler, type & (0xff | SLJIT_32), mem, memw, reg, 0);
+	return sljit_emit_op1(compiler, type & (0xff | SLJIT_32), reg, 0, mem, memw);
+}
+
+#endif /* (!SLJIT_CONFIG_MIPS || SLJIT_MIPS_REV >= 6) */
+
+#if (!(defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) || (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6)) \
+	&& !(defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32)
+
+static sljit_s32 sljit_emit_fmem_unaligned(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 freg,
+	sljit_s32 mem, sljit_sw memw)
+{
+	SLJIT_SKIP_CHECKS(compiler);
+
+	if (type & SLJIT_MEM_STORE)
+		return sljit_emit_fop1(compiler, type & (0xff | SLJIT_32), mem, memw, freg, 0);
+	return sljit_emit_fop1(compiler, type & (0xff | SLJIT_32), freg, 0, mem, memw);
+}
+
+#endif /* (!SLJIT_CONFIG_MIPS || SLJIT_MIPS_REV >= 6) && !SLJIT_CONFIG_ARM */
+
+static void sljit_reset_read_only_buffers(struct sljit_read_only_buffer *buffers)
+{
+	while (buffers != NULL) {
+		buffers->u.label = NULL;
+		buffers = buffers->next;
+	}
+}
+
+/* Fills the jump tables of the switches after the label addresses are computed. */
+static void sljit_write_switch_tables(struct sljit_compiler *compiler, sljit_sw executable_offset)
+{
+	struct sljit_switch *switch_ = compiler->switches;
+	sljit_uw *table;
+	sljit_uw i, default_addr;
+	SLJIT_UNUSED_ARG(executable_offset);
+
+	while (switch_ != NULL) {
+		if (switch_->table != NULL) {
+			table = (sljit_uw*)SLJIT_ADD_EXEC_OFFSET(sljit_get_label_abs_addr(switch_->table), -executable_offset);
+			default_addr = sljit_get_label_addr(switch_->labels[switch_->case_count]);
+
+			for (i = 0; i < switch_->table_size; i++)
+				table[i] = default_addr;
+
+			for (i = 0; i < switch_->case_count; i++)
+				table[(sljit_uw)switch_->values[i] - (sljit_uw)switch_->values[0]] = sljit_get_label_addr(switch_->labels[i]);
+		}
+
+		switch_ = switch_->next;
+	}
+}
+
+#if !(defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64)
+
+static sljit_s32 bitfield_op2(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg, sljit_sw imm)
+{
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op2(compiler, op, dst_reg, 0, src_reg, 0, SLJIT_IMM, imm);
+}
+
+/* Bit field operations built from shifts and rotates. Used by
+   the backends which have no (or limited) instruction support. */
+static sljit_s32 emit_bitfield_generic(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+	sljit_s32 op32 = op & SLJIT_32;
+	sljit_s32 bits = op32 ? 32 : (sljit_s32)(8 * sizeof(sljit_sw));
+
+	op = GET_OPCODE(op);
+
+	if (op == SLJIT_INSERT) {
+		if (length == bits) {
+			SLJIT_SKIP_CHECKS(compiler);
+			return sljit_emit_op1(compiler, op32 ? SLJIT_MOV32 : SLJIT_MOV, dst_reg, 0, src_reg, 0);
+		}
+
+		/* The bit field is rotated to the lowest bits, replaced by
+		   shifting src_reg into dst_reg, and rotated back. */
+		if (start != 0)
+			FAIL_IF(bitfield_op2(compiler, SLJIT_ROTR | op32, dst_reg, dst_reg, start));
+
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_shift_into(compiler, SLJIT_LSHR | op32, dst_reg, dst_reg, src_reg, SLJIT_IMM, length));
+
+		if (start + length == bits)
+			return SLJIT_SUCCESS;
+		return bitfield_op2(compiler, SLJIT_ROTL | op32, dst_reg, dst_reg, start + length);
+	}
+
+	if (start + length == bits) {
+		if (start == 0) {
+			SLJIT_SKIP_CHECKS(compiler);
+			return sljit_emit_op1(compiler, op32 ? SLJIT_MOV32 : SLJIT_MOV, dst_reg, 0, src_reg, 0);
+		}
+
+		return bitfield_op2(compiler, (op == SLJIT_EXTRACT_U ? SLJIT_LSHR : SLJIT_ASHR) | op32, dst_reg, src_reg, start);
+	}
+
+	if (start == 0) {
+		switch (length) {
+		case 8:
+			SLJIT_SKIP_CHECKS(compiler);
+			return sljit_emit_op1(compiler, (op == SLJIT_EXTRACT_U ? SLJIT_MOV_U8 : SLJIT_MOV_S8) | op32, dst_reg, 0, src_reg, 0);
+		case 16:
+			SLJIT_SKIP_CHECKS(compiler);
+			return sljit_emit_op1(compiler, (op == SLJIT_EXTRACT_U ? SLJIT_MOV_U16 : SLJIT_MOV_S16) | op32, dst_reg, 0, src_reg, 0);
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+		case 32:
+			SLJIT_SKIP_CHECKS(compiler);
+			return sljit_emit_op1(compiler, op == SLJIT_EXTRACT_U ? SLJIT_MOV_U32 : SLJIT_MOV_S32, dst_reg, 0, src_reg, 0);
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+		}
+
+		if (op == SLJIT_EXTRACT_U)
+			return bitfield_op2(compiler, SLJIT_AND | op32, dst_reg, src_reg, (sljit_sw)(((sljit_uw)1 << length) - 1));
+	}
+
+	FAIL_IF(bitfield_op2(compiler, SLJIT_SHL | op32, dst_reg, src_reg, bits - start - length));
+	return bitfield_op2(compiler, (op == SLJIT_EXTRACT_U ? SLJIT_LSHR : SLJIT_ASHR) | op32, dst_reg, dst_reg, bits - length);
+}
+
+#endif /* !SLJIT_CONFIG_ARM_64 */
+
+#if (defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32) \
+	|| (defined SLJIT_CONFIG_PPC && SLJIT_CONFIG_PPC) \
+	|| (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS && SLJIT_MIPS_REV < 6) \
+	|| (defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X)
+
+/* SLJIT_MIN_F64 and SLJIT_MAX_F64 built from compares. Must be
+   called before the local offsets of the arguments are adjusted. */
+static sljit_s32 emit_fminmax_generic(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_sw dstw,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	sljit_s32 op32 = op & SLJIT_32;
+	sljit_s32 tmp = (FAST_IS_REG(dst) && dst != src2) ? dst : SLJIT_TMP_FR0;
+	sljit_s32 type = (GET_OPCODE(op) == SLJIT_MIN_F64) ? SLJIT_ORDERED_GREATER : SLJIT_ORDERED_LESS;
+	struct sljit_jump *select_src2;
+	struct sljit_jump *select_src1;
+	struct sljit_label *label;
+
+	if (tmp != src1) {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_fop1(compiler, SLJIT_MOV_F64 | op32, tmp, 0, src1, src1w));
+	}
+
+	/* Src2 is selected when it is smaller (greater) than src1, or
+	   src1 is NaN. In all other cases src1 is kept. */
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_fop1(compiler, SLJIT_CMP_F64 | SLJIT_SET(type) | op32, tmp, 0, src2, src2w));
+	SLJIT_SKIP_CHECKS(compiler);
+	select_src2 = sljit_emit_jump(compiler, type);
+	FAIL_IF(!select_src2);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_fop1(compiler, SLJIT_CMP_F64 | SLJIT_SET_UNORDERED | op32, tmp, 0, tmp, 0));
+	SLJIT_SKIP_CHECKS(compiler);
+	select_src1 = sljit_emit_jump(compiler, SLJIT_ORDERED);
+	FAIL_IF(!select_src1);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	label = sljit_emit_label(compiler);
+	FAIL_IF(!label);
+	sljit_set_label(select_src2, label);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_fop1(compiler, SLJIT_MOV_F64 | op32, tmp, 0, src2, src2w));
+
+	SLJIT_SKIP_CHECKS(compiler);
+	label = sljit_emit_label(compiler);
+	FAIL_IF(!label);
+	sljit_set_label(select_src1, label);
+
+	if (tmp == dst)
+		return SLJIT_SUCCESS;
+
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_fop1(compiler, SLJIT_MOV_F64 | op32, dst, dstw, tmp, 0);
+}
+
+#endif /* SLJIT_CONFIG_ARM_32 || SLJIT_CONFIG_PPC || (SLJIT_CONFIG_MIPS && SLJIT_MIPS_REV < 6) || SLJIT_CONFIG_S390X */
+
+#if !(defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64 && defined __ARM_FEATURE_CRC32)
+
+/* Reflected CRC32C (0x1edc6f41 polynomial) lookup table. */
+static const sljit_u32 crc32c_table[256] = {
+	0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+	0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+	0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+	0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+	0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+	0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+	0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+	0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+	0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+	0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+	0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+	0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+	0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+	0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+	0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+	0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+	0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+	0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+	0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+	0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+	0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+	0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+	0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+	0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+	0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+	0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+	0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+	0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+	0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+	0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+	0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+	0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+	0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+	0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+	0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+	0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+	0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+	0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+	0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+	0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+	0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+	0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+	0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+static sljit_u32 crc32c_update(sljit_u32 crc, sljit_uw data, sljit_s32 size)
+{
+	do {
+		crc = crc32c_table[(crc ^ (sljit_u32)data) & 0xff] ^ (crc >> 8);
+		data >>= 8;
+	} while (--size > 0);
+
+	return crc;
+}
+
+/* CRC32C accumulate operations computed byte by byte using the lookup
+   table. Both temporary registers are overwritten. On 32 bit machines,
+   tmp2_reg can be 0, in which case the address of the table is used as
+   a memory offset. Must be called before the local offsets of the
+   arguments are adjusted. */
+static sljit_s32 emit_crc32c_generic(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w,
+	sljit_s32 tmp1_reg, sljit_s32 tmp2_reg)
+{
+	static const sljit_s32 mov_types[4] = { SLJIT_MOV_U8, SLJIT_MOV_U16, SLJIT_MOV_U32, SLJIT_MOV };
+	sljit_s32 size = GET_OPCODE(op) - SLJIT_CRC32C_U8;
+	sljit_sw table = (sljit_sw)crc32c_table;
+	sljit_s32 mov_type;
+
+#if (defined SLJIT_32BIT_ARCHITECTURE && SLJIT_32BIT_ARCHITECTURE)
+	if (size == 3)
+		size = 2;
+#endif /* SLJIT_32BIT_ARCHITECTURE */
+
+	mov_type = mov_types[size];
+	size = 1 << size;
+
+	if (src1 == SLJIT_IMM && src2 == SLJIT_IMM) {
+		SLJIT_SKIP_CHECKS(compiler);
+		return sljit_emit_op1(compiler, SLJIT_MOV, dst_reg, 0,
+			SLJIT_IMM, (sljit_sw)crc32c_update((sljit_u32)src1w, (sljit_uw)src2w, size));
+	}
+
+	if (tmp2_reg == 0) {
+		SLJIT_ASSERT(size <= 4);
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, mov_type, tmp1_reg, 0, src2, src2w));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_XOR, dst_reg, 0, src1, src1w, tmp1_reg, 0));
+	} else {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV, tmp2_reg, 0, src1, src1w));
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV_U32, tmp2_reg, 0, tmp2_reg, 0));
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, mov_type, tmp1_reg, 0, src2, src2w));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_XOR, dst_reg, 0, tmp1_reg, 0, tmp2_reg, 0));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV, tmp2_reg, 0, SLJIT_IMM, table));
+		table = 0;
+	}
+
+	do {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV_U8, tmp1_reg, 0, dst_reg, 0));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_SHL, tmp1_reg, 0, tmp1_reg, 0, SLJIT_IMM, 2));
+
+		if (tmp2_reg != 0) {
+			SLJIT_SKIP_CHECKS(compiler);
+			FAIL_IF(sljit_emit_op2(compiler, SLJIT_ADD, tmp1_reg, 0, tmp1_reg, 0, tmp2_reg, 0));
+		}
+
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV_U32, tmp1_reg, 0, SLJIT_MEM1(tmp1_reg), table));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_LSHR, dst_reg, 0, dst_reg, 0, SLJIT_IMM, 8));
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_XOR, dst_reg, 0, dst_reg, 0, tmp1_reg, 0));
+	} while (--size > 0);
+
+	return SLJIT_SUCCESS;
+}
+
+#endif /* !(SLJIT_CONFIG_ARM_64 && __ARM_FEATURE_CRC32) */
+
+/* Block copy and fill operations. */
+
+/* Moves size bytes starting from offset using general purpose registers.
+   The data_reg is the temporary register for copy, and the register
+   containing the replicated fill value for fill operations. */
+static sljit_s32 emit_mem_block_words(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg, sljit_s32 src_reg, sljit_s32 data_reg,
+	sljit_s32 max_shift, sljit_sw offset, sljit_sw size)
+{
+	static const sljit_s32 mov_types[4] = { SLJIT_MOV_U8, SLJIT_MOV_U16, SLJIT_MOV_U32, SLJIT_MOV };
+	sljit_s32 shift = max_shift;
+
+	while (size > 0) {
+		while ((SLJIT_W(1) << shift) > size)
+			shift--;
+
+		if (!(type & SLJIT_MEM_BLOCK_FILL)) {
+			SLJIT_SKIP_CHECKS(compiler);
+			FAIL_IF(sljit_emit_op1(compiler, mov_types[shift], data_reg, 0, SLJIT_MEM1(src_reg), offset));
+		}
+
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, mov_types[shift], SLJIT_MEM1(dst_reg), offset, data_reg, 0));
+
+		offset += SLJIT_W(1) << shift;
+		size -= SLJIT_W(1) << shift;
+	}
+
+	return SLJIT_SUCCESS;
+}
+
+/* Moves count * 16 bytes starting from offset using vreg. For fill
+   operations, vreg contains the replicated fill value. */
+static sljit_s32 emit_mem_block_vectors(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg, sljit_s32 src_reg, sljit_s32 vreg, sljit_s32 vtype,
+	sljit_sw offset, sljit_sw count)
+{
+	do {
+		if (!(type & SLJIT_MEM_BLOCK_FILL)) {
+			SLJIT_SKIP_CHECKS(compiler);
+			FAIL_IF(sljit_emit_simd_mov(compiler, vtype | SLJIT_SIMD_LOAD, vreg, SLJIT_MEM1(src_reg), offset));
+		}
+
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_simd_mov(compiler, vtype | SLJIT_SIMD_STORE, vreg, SLJIT_MEM1(dst_reg), offset));
+		offset += 16;
+	} while (--count > 0);
+
+	return SLJIT_SUCCESS;
+}
+
+/* Replicates the lowest byte of the fill value into a machine word,
+   and returns with the register containing the result. */
+static sljit_s32 emit_mem_block_fill_value(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_sw srcw, sljit_s32 tmp_reg)
+{
+	sljit_uw ones = ~(sljit_uw)0 / 0xff;
+
+	if (src == SLJIT_IMM) {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV, tmp_reg, 0, SLJIT_IMM, (sljit_sw)((sljit_uw)(srcw & 0xff) * ones)));
+		return SLJIT_SUCCESS;
+	}
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV_U8, src, 0, src, 0));
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op2(compiler, SLJIT_MUL, src, 0, src, 0, SLJIT_IMM, (sljit_sw)ones);
+}
+
+/* Replicates the lowest byte of the fill value into vreg. A fill value
+   stored in a register is replicated into a machine word first, since
+   byte replication might need a temporary vector register. */
+static sljit_s32 emit_mem_block_fill_vector(struct sljit_compiler *compiler,
+	sljit_s32 vreg, sljit_s32 src, sljit_sw srcw, sljit_s32 tmp_reg)
+{
+	sljit_s32 type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_8;
+
+	if (src != SLJIT_IMM) {
+		FAIL_IF(emit_mem_block_fill_value(compiler, src, srcw, tmp_reg));
+		type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_32;
+	}
+
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_simd_replicate(compiler, type, vreg, src, srcw);
+}
+
+/* Block copy and fill operations using general purpose registers, or
+   128 bit vector registers when vreg is non-zero. Small blocks with
+   immediate length are unrolled, otherwise a loop is emitted. The
+   data (or the fill value) is stored in tmp1_reg. When len is an
+   immediate, tmp2_reg is used as loop counter, and it can be 0 when
+   the block is unrolled. Vector memory accesses may use other internal
+   temporary registers, so tmp1_reg is not live across them. */
+static sljit_s32 emit_mem_block_generic(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw,
+	sljit_s32 tmp1_reg, sljit_s32 tmp2_reg, sljit_s32 vreg)
+{
+	sljit_s32 align_shift = SLJIT_MEM_BLOCK_GET_ALIGNMENT(type);
+	sljit_s32 max_shift = SLJIT_WORD_SHIFT;
+	sljit_s32 vtype = 0;
+	sljit_s32 fill_type;
+	sljit_s32 data_reg = tmp1_reg;
+	sljit_s32 cnt_reg = len;
+	sljit_sw unit, size, offset;
+	struct sljit_label *label;
+	struct sljit_jump *jump;
+	struct sljit_jump *skip_loop = NULL;
+
+#if !(defined SLJIT_UNALIGNED && SLJIT_UNALIGNED)
+	if (align_shift < max_shift)
+		max_shift = align_shift;
+#endif /* !SLJIT_UNALIGNED */
+
+	if (vreg != 0) {
+		vtype = SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_8 | ((align_shift < 4 ? align_shift : 4) << 24);
+
+		SLJIT_SKIP_CHECKS(compiler);
+		if (sljit_emit_simd_mov(compiler, vtype | SLJIT_SIMD_TEST, vreg, SLJIT_MEM1(dst_reg), 0) != SLJIT_SUCCESS)
+			vreg = 0;
+		else if (type & SLJIT_MEM_BLOCK_FILL) {
+			fill_type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_TEST | (src == SLJIT_IMM ? SLJIT_SIMD_ELEM_8 : SLJIT_SIMD_ELEM_32);
+
+			SLJIT_SKIP_CHECKS(compiler);
+			if (sljit_emit_simd_replicate(compiler, fill_type, vreg, src, srcw) != SLJIT_SUCCESS)
+				vreg = 0;
+		}
+	}
+
+	if ((type & SLJIT_MEM_BLOCK_FILL) && src != SLJIT_IMM)
+		data_reg = src;
+
+	if (len == SLJIT_IMM && lenw <= (vreg != 0 ? 16 : (SLJIT_W(1) << max_shift)) * 8) {
+		if (lenw == 0)
+			return SLJIT_SUCCESS;
+
+		offset = 0;
+
+		if (vreg != 0 && lenw >= 16) {
+			if (type & SLJIT_MEM_BLOCK_FILL)
+				FAIL_IF(emit_mem_block_fill_vector(compiler, vreg, src, srcw, tmp1_reg));
+
+			FAIL_IF(emit_mem_block_vectors(compiler, type, dst_reg, src, vreg, vtype, 0, lenw >> 4));
+			offset = lenw & ~(sljit_sw)0xf;
+
+			if (offset == lenw)
+				return SLJIT_SUCCESS;
+		}
+
+		/* A fill value stored in a register is already replicated
+		   into a machine word, when vector stores are emitted. */
+		if ((type & SLJIT_MEM_BLOCK_FILL) && (src == SLJIT_IMM || offset == 0))
+			FAIL_IF(emit_mem_block_fill_value(compiler, src, srcw, tmp1_reg));
+
+		return emit_mem_block_words(compiler, type, dst_reg, src, data_reg, max_shift, offset, lenw - offset);
+	}
+
+	unit = vreg != 0 ? 32 : (SLJIT_W(2) << max_shift);
+
+	if (type & SLJIT_MEM_BLOCK_FILL) {
+		if (vreg != 0)
+			FAIL_IF(emit_mem_block_fill_vector(compiler, vreg, src, srcw, tmp1_reg));
+		else
+			FAIL_IF(emit_mem_block_fill_value(compiler, src, srcw, tmp1_reg));
+	}
+
+	if (len == SLJIT_IMM) {
+		SLJIT_ASSERT(tmp2_reg != 0);
+		cnt_reg = tmp2_reg;
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op1(compiler, SLJIT_MOV, cnt_reg, 0, SLJIT_IMM, lenw / unit));
+	} else {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_LESS, cnt_reg, 0, cnt_reg, 0, SLJIT_IMM, unit));
+		SLJIT_SKIP_CHECKS(compiler);
+		skip_loop = sljit_emit_jump(compiler, SLJIT_LESS);
+		FAIL_IF(!skip_loop);
+	}
+
+	SLJIT_SKIP_CHECKS(compiler);
+	label = sljit_emit_label(compiler);
+	FAIL_IF(!label);
+
+	if (vreg != 0)
+		FAIL_IF(emit_mem_block_vectors(compiler, type, dst_reg, src, vreg, vtype, 0, 2));
+	else
+		FAIL_IF(emit_mem_block_words(compiler, type, dst_reg, src, data_reg, max_shift, 0, unit));
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_op2(compiler, SLJIT_ADD, dst_reg, 0, dst_reg, 0, SLJIT_IMM, unit));
+
+	if (!(type & SLJIT_MEM_BLOCK_FILL)) {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_ADD, src, 0, src, 0, SLJIT_IMM, unit));
+	}
+
+	SLJIT_SKIP_CHECKS(compiler);
+	if (len == SLJIT_IMM)
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_Z, cnt_reg, 0, cnt_reg, 0, SLJIT_IMM, 1));
+	else
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_LESS, cnt_reg, 0, cnt_reg, 0, SLJIT_IMM, unit));
+
+	SLJIT_SKIP_CHECKS(compiler);
+	jump = sljit_emit_jump(compiler, len == SLJIT_IMM ? SLJIT_NOT_ZERO : SLJIT_GREATER_EQUAL);
+	FAIL_IF(!jump);
+	sljit_set_label(jump, label);
+
+	if (len == SLJIT_IMM) {
+		size = lenw & (unit - 1);
+
+		if (size == 0)
+			return SLJIT_SUCCESS;
+
+		offset = 0;
+
+		if (vreg != 0 && size >= 16) {
+			FAIL_IF(emit_mem_block_vectors(compiler, type, dst_reg, src, vreg, vtype, 0, 1));
+			offset = 16;
+
+			if (size == 16)
+				return SLJIT_SUCCESS;
+		}
+
+		if (vreg != 0 && (type & SLJIT_MEM_BLOCK_FILL) && src == SLJIT_IMM)
+			FAIL_IF(emit_mem_block_fill_value(compiler, src, srcw, tmp1_reg));
+
+		return emit_mem_block_words(compiler, type, dst_reg, src, data_reg, max_shift, offset, size - offset);
+	}
+
+	/* The lowest bits of cnt_reg contain the remaining length. */
+	SLJIT_SKIP_CHECKS(compiler);
+	label = sljit_emit_label(compiler);
+	FAIL_IF(!label);
+	sljit_set_label(skip_loop, label);
+
+	for (size = unit >> 1; size > 0; size >>= 1) {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2u(compiler, SLJIT_AND | SLJIT_SET_Z, cnt_reg, 0, SLJIT_IMM, size));
+		SLJIT_SKIP_CHECKS(compiler);
+		jump = sljit_emit_jump(compiler, SLJIT_ZERO);
+		FAIL_IF(!jump);
+
+		if (vreg != 0 && size == 16)
+			FAIL_IF(emit_mem_block_vectors(compiler, type, dst_reg, src, vreg, vtype, 0, 1));
+		else {
+			/* The temporary register might be overwritten by sljit_emit_op2u. */
+			if (data_reg == tmp1_reg && (type & SLJIT_MEM_BLOCK_FILL))
+				FAIL_IF(emit_mem_block_fill_value(compiler, src, srcw, tmp1_reg));
+
+			FAIL_IF(emit_mem_block_words(compiler, type, dst_reg, src, data_reg, max_shift, 0, size));
+		}
+
+		if (size > 1) {
+			SLJIT_SKIP_CHECKS(compiler);
+			FAIL_IF(sljit_emit_op2(compiler, SLJIT_ADD, dst_reg, 0, dst_reg, 0, SLJIT_IMM, size));
+
+			if (!(type & SLJIT_MEM_BLOCK_FILL)) {
+				SLJIT_SKIP_CHECKS(compiler);
+				FAIL_IF(sljit_emit_op2(compiler, SLJIT_ADD, src, 0, src, 0, SLJIT_IMM, size));
+			}
+		}
+
+		SLJIT_SKIP_CHECKS(compiler);
+		label = sljit_emit_label(compiler);
+		FAIL_IF(!label);
+		sljit_set_label(jump, label);
+	}
+
+	return SLJIT_SUCCESS;
+}
+
+/* CPU description section */
+
+#if (defined SLJIT_32BIT_ARCHITECTURE && SLJIT_32BIT_ARCHITECTURE)
+#define SLJIT_CPUINFO_PART1 " 32bit ("
+#elif (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+#define SLJIT_CPUINFO_PART1 " 64bit ("
+#else /* !SLJIT_32BIT_ARCHITECTURE && !SLJIT_64BIT_ARCHITECTURE */
+#error "Internal error: CPU type info missing"
+#endif /* SLJIT_32BIT_ARCHITECTURE */
+
+#if (defined SLJIT_LITTLE_ENDIAN && SLJIT_LITTLE_ENDIAN)
+#define SLJIT_CPUINFO_PART2 "little endian + "
+#elif (defined SLJIT_BIG_ENDIAN && SLJIT_BIG_ENDIAN)
+#define SLJIT_CPUINFO_PART2 "big endian + "
+#else /* !SLJIT_LITTLE_ENDIAN && !SLJIT_BIG_ENDIAN */
+#error "Internal error: CPU type info missing"
+#endif /* SLJIT_LITTLE_ENDIAN */
+
+#if (defined SLJIT_UNALIGNED && SLJIT_UNALIGNED)
+#define SLJIT_CPUINFO_PART3 "unaligned)"
+#else /* !SLJIT_UNALIGNED */
 #define SLJIT_CPUINFO_PART3 "aligned)"
 #endif /* SLJIT_UNALIGNED */
 
-#define SLJIT_CPUINFO SLJIT_CPUINFO_PART1 SLJIT_CPUINFO_PART2 SLJIT_CPUINFO_PART3
+#define SLJIT_CPUINFO SLJIT_CPUINFO_PART1 SLJIT_CPUINFO_PART2 SLJIT_CPUINFO_PART3
+
+/* The code modifying functions of the backends (patch_jump_addr and
+   patch_const) update the write protection and flush the instruction
+   cache only when flush_cache is non-zero. Otherwise it is done by
+   the caller (see: sljit_set_patches). */
+#define PATCH_UPDATE_WX_FLAGS(from, to, enable_exec) \
+	do { \
+		if (flush_cache) { \
+			SLJIT_UPDATE_WX_FLAGS(from, to, enable_exec); \
+		} \
+	} while (0)
+
+#define PATCH_CACHE_FLUSH(from, to) \
+	do { \
+		if (flush_cache) { \
+			SLJIT_CACHE_FLUSH(from, to); \
+		} \
+	} while (0)
+
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
+#	include "sljitNativeX86_common.c"
+#elif (defined SLJIT_CONFIG_ARM_V6 && SLJIT_CONFIG_ARM_V6)
+#	include "sljitNativeARM_32.c"
+#elif (defined SLJIT_CONFIG_ARM_V7 && SLJIT_CONFIG_ARM_V7)
+#	include "sljitNativeARM_32.c"
+#elif (defined SLJIT_CONFIG_ARM_THUMB2 && SLJIT_CONFIG_ARM_THUMB2)
+#	include "sljitNativeARM_T2_32.c"
+#elif (defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64)
+#	include "sljitNativeARM_64.c"
+#elif (defined SLJIT_CONFIG_PPC && SLJIT_CONFIG_PPC)
+#	include "sljitNativePPC_common.c"
+#elif (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS)
+#	include "sljitNativeMIPS_common.c"
+#elif (defined SLJIT_CONFIG_RISCV && SLJIT_CONFIG_RISCV)
+#	include "sljitNativeRISCV_common.c"
+#elif (defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X)
+#	include "sljitNativeS390X.c"
+#elif (defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
+#	include "sljitNativeLOONGARCH_64.c"
+#endif /* SLJIT_CONFIG_X86 */
+
+#include "sljitSerialize.c"
+#include "sljitRegAlloc.c"
+#include "sljitInlineCache.c"
+
+/* --------------------------------------------------------------------- */
+/*  Batch patching                                                       */
+/* --------------------------------------------------------------------- */
+
+#define PATCH_PAGE_SIZE 4096
+
+/* Size of the modified code for jumps, word constants, and 32 bit
+   constants. The constant of SLJIT_MOV_U8 is always 4 bytes long. */
+#if (defined SLJIT_CONFIG_ARM_V6 && SLJIT_CONFIG_ARM_V6)
+/* Values might be stored in literal pools far from the address. */
+#define PATCH_NO_GROUPING 1
+#elif (defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64) \
+	|| (defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
+#define PATCH_JUMP_SIZE 16
+#define PATCH_CONST_SIZE 16
+#define PATCH_CONST32_SIZE 8
+#elif (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
+#define PATCH_JUMP_SIZE 20
+#define PATCH_CONST_SIZE 20
+#define PATCH_CONST32_SIZE 8
+#elif (defined SLJIT_CONFIG_MIPS_64 && SLJIT_CONFIG_MIPS_64) \
+	|| (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
+#define PATCH_JUMP_SIZE 24
+#define PATCH_CONST_SIZE 24
+#define PATCH_CONST32_SIZE 8
+#elif (defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X)
+/* The address of a jump points to its constant pool entry. */
+#define PATCH_JUMP_SIZE 8
+#define PATCH_CONST_SIZE 12
+#define PATCH_CONST32_SIZE 6
+#elif !(defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
+#define PATCH_JUMP_SIZE 8
+#define PATCH_CONST_SIZE 8
+#define PATCH_CONST32_SIZE 8
+#endif
+
+#if !(defined PATCH_NO_GROUPING && PATCH_NO_GROUPING)
+
+/* Computes the range of bytes modified by a patch. */
+static void patch_get_range(struct sljit_patch *patch, sljit_uw *start, sljit_uw *end)
+{
+	sljit_s32 op = GET_OPCODE(patch->kind);
+
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
+	if (patch->kind == SLJIT_PATCH_JUMP_ADDR) {
+		*start = patch->addr;
+		*end = patch->addr + (sljit_uw)sizeof(sljit_sw);
+		return;
+	}
+
+	/* The constant is stored before the address. */
+	*start = patch->addr - (sljit_uw)((patch->kind == SLJIT_MOV) ? sizeof(sljit_sw) : sizeof(sljit_s32));
+	*end = patch->addr;
+#else /* !SLJIT_CONFIG_X86 */
+	*start = patch->addr;
+
+	if (patch->kind == SLJIT_PATCH_JUMP_ADDR)
+		*end = patch->addr + PATCH_JUMP_SIZE;
+	else if (op == SLJIT_MOV_U8)
+		*end = patch->addr + 4;
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	else if (op == SLJIT_MOV32 || op == SLJIT_MOV_S32)
+		*end = patch->addr + PATCH_CONST32_SIZE;
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+	else
+		*end = patch->addr + PATCH_CONST_SIZE;
+#endif /* SLJIT_CONFIG_X86 */
+
+	SLJIT_UNUSED_ARG(op);
+}
+
+#endif /* !PATCH_NO_GROUPING */
+
+static void patch_apply(struct sljit_patch *patch, sljit_sw executable_offset, sljit_s32 flush_cache)
+{
+	if (patch->kind == SLJIT_PATCH_JUMP_ADDR)
+		patch_jump_addr(patch->addr, (sljit_uw)patch->value, executable_offset, flush_cache);
+	else
+		patch_const(patch->addr, patch->kind, patch->value, executable_offset, flush_cache);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_uw sljit_set_patches(struct sljit_patch *patches, sljit_uw count,
+	sljit_sw executable_offset, void *allocator_data)
+{
+	sljit_uw i, failed = 0;
+#if !(defined PATCH_NO_GROUPING && PATCH_NO_GROUPING)
+	sljit_uw *order;
+	sljit_uw j, k, gap, idx;
+	sljit_uw start, end, next_start, next_end;
+#endif /* !PATCH_NO_GROUPING */
+
+	SLJIT_UNUSED_ARG(allocator_data);
+
+	for (i = 0; i < count; i++) {
+		switch (patches[i].kind) {
+		case SLJIT_PATCH_JUMP_ADDR:
+		case SLJIT_MOV:
+		case SLJIT_MOV32:
+		case SLJIT_MOV_S32:
+		case SLJIT_MOV_U8:
+		case SLJIT_MOV32_U8:
+			patches[i].status = (patches[i].addr != 0) ? SLJIT_SUCCESS : SLJIT_ERR_BAD_ARGUMENT;
+			break;
+		default:
+			patches[i].status = SLJIT_ERR_BAD_ARGUMENT;
+			break;
+		}
+
+		if (patches[i].status != SLJIT_SUCCESS)
+			failed++;
+	}
+
+#if (defined PATCH_NO_GROUPING && PATCH_NO_GROUPING)
+	for (i = 0; i < count; i++)
+		if (patches[i].status == SLJIT_SUCCESS)
+			patch_apply(patches + i, executable_offset, 1);
+#else /* !PATCH_NO_GROUPING */
+	order = (sljit_uw*)SLJIT_MALLOC(count * sizeof(sljit_uw), allocator_data);
+
+	if (order != NULL) {
+		for (i = 0; i < count; i++)
+			order[i] = i;
+
+		/* Shell sort by address. */
+		for (gap = count >> 1; gap > 0; gap >>= 1) {
+			for (i = gap; i < count; i++) {
+				idx = order[i];
+
+				for (j = i; j >= gap && patches[order[j - gap]].addr > patches[idx].addr; j -= gap)
+					order[j] = order[j - gap];
+				order[j] = idx;
+			}
+		}
+	}
+
+	i = 0;
+	while (i < count) {
+		idx = (order != NULL) ? order[i] : i;
+
+		if (patches[idx].status != SLJIT_SUCCESS) {
+			i++;
+			continue;
+		}
+
+		patch_get_range(patches + idx, &start, &end);
 
-#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
-#	include "sljitNativeX86_common.c"
-#elif (defined SLJIT_CONFIG_ARM_V6 && SLJIT_CONFIG_ARM_V6)
-#	include "sljitNativeARM_32.c"
-#elif (defined SLJIT_CONFIG_ARM_V7 && SLJIT_CONFIG_ARM_V7)
-#	include "sljitNativeARM_32.c"
-#elif (defined SLJIT_CONFIG_ARM_THUMB2 && SLJIT_CONFIG_ARM_THUMB2)
-#	include "sljitNativeARM_T2_32.c"
-#elif (defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64)
-#	include "sljitNativeARM_64.c"
-#elif (defined SLJIT_CONFIG_PPC && SLJIT_CONFIG_PPC)
-#	include "sljitNativePPC_common.c"
-#elif (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS)
-#	include "sljitNativeMIPS_common.c"
-#elif (defined SLJIT_CONFIG_RISCV && SLJIT_CONFIG_RISCV)
-#	include "sljitNativeRISCV_common.c"
-#elif (defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X)
-#	include "sljitNativeS390X.c"
-#elif (defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
-#	include "sljitNativeLOONGARCH_64.c"
-#endif /* SLJIT_CONFIG_X86 */
+		/* Extend the range with the entries on the same or neighbouring pages. */
+		for (j = i + 1; j < count; j++) {
+			idx = (order != NULL) ? order[j] : j;
 
-#include "sljitSerialize.c"
+			if (patches[idx].status != SLJIT_SUCCESS)
+				continue;
+
+			patch_get_range(patches + idx, &next_start, &next_end);
+
+			if (next_end + PATCH_PAGE_SIZE <= (start & ~(sljit_uw)(PATCH_PAGE_SIZE - 1))
+					|| next_start >= ((end + PATCH_PAGE_SIZE - 1) & ~(sljit_uw)(PATCH_PAGE_SIZE - 1)) + PATCH_PAGE_SIZE)
+				break;
+
+			if (next_start < start)
+				start = next_start;
+			if (next_end > end)
+				end = next_end;
+		}
+
+		SLJIT_UPDATE_WX_FLAGS((void*)start, (void*)end, 0);
+
+		for (k = i; k < j; k++) {
+			idx = (order != NULL) ? order[k] : k;
+
+			if (patches[idx].status == SLJIT_SUCCESS)
+				patch_apply(patches + idx, executable_offset, 0);
+		}
+
+		SLJIT_UPDATE_WX_FLAGS((void*)start, (void*)end, 1);
+
+		SLJIT_CACHE_FLUSH((void*)SLJIT_ADD_EXEC_OFFSET(start, executable_offset), (void*)SLJIT_ADD_EXEC_OFFSET(end, executable_offset));
+		i = j;
+	}
+
+	if (order != NULL)
+		SLJIT_FREE(order, allocator_data);
+#endif /* PATCH_NO_GROUPING */
+
+	return failed;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_relocate_code(void *code, sljit_uw code_size,
+	sljit_uw old_addr, sljit_sw executable_offset)
+{
+	sljit_u8 *code_ptr = (sljit_u8*)code;
+	sljit_u8 *relocs;
+	sljit_u32 count, offset;
+	sljit_uw new_addr = (sljit_uw)SLJIT_ADD_EXEC_OFFSET(code_ptr, executable_offset);
+	sljit_uw value;
+	SLJIT_UNUSED_ARG(executable_offset);
+
+	SLJIT_ASSERT(code_size >= sizeof(sljit_u32));
+
+	/* The relocation table is stored at the end of the code:
+	   an array of 32 bit code offsets followed by their count. */
+	SLJIT_MEMCPY(&count, code_ptr + code_size - sizeof(sljit_u32), sizeof(sljit_u32));
+	relocs = code_ptr + code_size - (count + 1) * sizeof(sljit_u32);
+
+	if (count == 0 || new_addr == old_addr)
+		return;
+
+	SLJIT_UPDATE_WX_FLAGS(code_ptr, code_ptr + code_size, 0);
+
+	do {
+		SLJIT_MEMCPY(&offset, relocs, sizeof(sljit_u32));
+		relocs += sizeof(sljit_u32);
+
+		SLJIT_ASSERT(offset + sizeof(sljit_uw) <= code_size);
+		SLJIT_MEMCPY(&value, code_ptr + offset, sizeof(sljit_uw));
+
+		/* Only the addresses pointing into the original code are relocated. */
+		if (value - old_addr < code_size) {
+			value += new_addr - old_addr;
+			SLJIT_MEMCPY(code_ptr + offset, &value, sizeof(sljit_uw));
+		}
+	} while (--count > 0);
+
+	SLJIT_UPDATE_WX_FLAGS(code_ptr, code_ptr + code_size, 1);
+
+	SLJIT_CACHE_FLUSH((void*)SLJIT_ADD_EXEC_OFFSET(code_ptr, executable_offset),
+		(void*)SLJIT_ADD_EXEC_OFFSET(code_ptr + code_size, executable_offset));
+}
 
 static SLJIT_INLINE sljit_s32 emit_mov_before_return(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 src, sljit_sw srcw)
 {
@@ -3543,6 +4910,30 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_return(struct sljit_compiler *comp
 	return sljit_emit_return_void(compiler);
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_set_cold_region(struct sljit_compiler *compiler,
+	struct sljit_label *start_label, struct sljit_label *end_label)
+{
+	struct sljit_cold_region *region;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_set_cold_region(compiler, start_label, end_label));
+
+	region = (struct sljit_cold_region*)ensure_abuf(compiler, sizeof(struct sljit_cold_region));
+	FAIL_IF(!region);
+
+	region->next = NULL;
+	region->start = start_label;
+	region->end = end_label;
+
+	if (compiler->last_cold_region != NULL)
+		compiler->last_cold_region->next = region;
+	else
+		compiler->cold_regions = region;
+
+	compiler->last_cold_region = region;
+	return SLJIT_SUCCESS;
+}
+
 #if !(defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) \
 	&& !(defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X) \
 	&& !(defined(SLJIT_CONFIG_LOONGARCH_64) && SLJIT_CONFIG_LOONGARCH_64)
@@ -3563,6 +4954,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compi
 
 #endif /* !SLJIT_CONFIG_X86 && !SLJIT_CONFIG_S390X && !SLJIT_CONFIG_LOONGARCH_64 */
 
+#if !(defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) \
+	&& !(defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64) \
+	&& !(defined SLJIT_CONFIG_LOONGARCH_64 && SLJIT_CONFIG_LOONGARCH_64)
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_bitfield(compiler, op, dst_reg, src_reg, start, length));
+
+	return emit_bitfield_generic(compiler, op, dst_reg, src_reg, start, length);
+}
+
+#endif /* !SLJIT_CONFIG_X86 && !SLJIT_CONFIG_ARM_64 && !SLJIT_CONFIG_LOONGARCH_64 */
+
 #if !(defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS) \
 	&& !(defined SLJIT_CONFIG_RISCV && SLJIT_CONFIG_RISCV) \
 	&& !(defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
@@ -3621,7 +5028,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_cmp(struct sljit_compiler
 			break;
 		}
 
-		type = condition | (type & (SLJIT_32 | SLJIT_REWRITABLE_JUMP));
+		type = condition | (type & (SLJIT_32 | SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK));
 		tmp_src = src1;
 		src1 = src2;
 		src2 = tmp_src;
@@ -3640,7 +5047,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_cmp(struct sljit_compiler
 		SLJIT_SUB | flags | (type & SLJIT_32), src1, src1w, src2, src2w));
 
 	SLJIT_SKIP_CHECKS(compiler);
-	return sljit_emit_jump(compiler, condition | (type & (SLJIT_REWRITABLE_JUMP | SLJIT_32)));
+	return sljit_emit_jump(compiler, condition | (type & (SLJIT_REWRITABLE_JUMP | SLJIT_32 | JUMP_HINT_MASK)));
 }
 
 #endif /* !SLJIT_CONFIG_MIPS */
@@ -3687,10 +5094,10 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op2cmpz(struct sljit_comp
 	CHECK_PTR(check_sljit_emit_op2cmpz(compiler, op, dst, dstw, src1, src1w, src2, src2w));
 
 	SLJIT_SKIP_CHECKS(compiler);
-	PTR_FAIL_IF(sljit_emit_op2(compiler, ((op | SLJIT_SET_Z) & ~SLJIT_REWRITABLE_JUMP), dst, dstw, src1, src1w, src2, src2w));
+	PTR_FAIL_IF(sljit_emit_op2(compiler, ((op | SLJIT_SET_Z) & ~(SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK)), dst, dstw, src1, src1w, src2, src2w));
 
 	SLJIT_SKIP_CHECKS(compiler);
-	return sljit_emit_jump(compiler, ((op & SLJIT_JUMP_IF_ZERO) ? SLJIT_ZERO : SLJIT_NOT_ZERO) | (op & SLJIT_REWRITABLE_JUMP));
+	return sljit_emit_jump(compiler, ((op & SLJIT_JUMP_IF_ZERO) ? SLJIT_ZERO : SLJIT_NOT_ZERO) | (op & (SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK)));
 }
 
 #else /* SLJIT_CONFIG_RISCV || SLJIT_CONFIG_MIPS || SLJIT_CONFIG_LOONGARCH */
@@ -3706,17 +5113,523 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op2cmpz(struct sljit_comp
 	CHECK_PTR(check_sljit_emit_op2cmpz(compiler, op, dst, dstw, src1, src1w, src2, src2w));
 
 	SLJIT_SKIP_CHECKS(compiler);
-	PTR_FAIL_IF(sljit_emit_op2(compiler, (op & ~(SLJIT_SET_Z | SLJIT_REWRITABLE_JUMP)), dst, dstw, src1, src1w, src2, src2w));
+	PTR_FAIL_IF(sljit_emit_op2(compiler, (op & ~(SLJIT_SET_Z | SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK)), dst, dstw, src1, src1w, src2, src2w));
 
 	/* When dst is a memory operand, its value is stored in SLJIT_TMP_DEST_FREG. */
 	reg = FAST_IS_REG(dst) ? dst : SLJIT_TMP_DEST_REG;
 
 	SLJIT_SKIP_CHECKS(compiler);
-	return sljit_emit_cmp(compiler, ((op & SLJIT_JUMP_IF_ZERO) ? SLJIT_ZERO : SLJIT_NOT_ZERO) | (op & (SLJIT_32 | SLJIT_REWRITABLE_JUMP)), reg, 0, SLJIT_IMM, 0);
+	return sljit_emit_cmp(compiler, ((op & SLJIT_JUMP_IF_ZERO) ? SLJIT_ZERO : SLJIT_NOT_ZERO) | (op & (SLJIT_32 | SLJIT_REWRITABLE_JUMP | JUMP_HINT_MASK)), reg, 0, SLJIT_IMM, 0);
 }
 
 #endif /* !SLJIT_CONFIG_RISCV && !SLJIT_CONFIG_MIPS && !SLJIT_CONFIG_LOONGARCH */
 
+/* --------------------------------------------------------------------- */
+/*  Division by constant                                                 */
+/* --------------------------------------------------------------------- */
+
+struct sljit_div_magic {
+	sljit_uw multiplier;
+	sljit_s32 shift;
+	sljit_s32 add;
+};
+
+/* Computes the magic number of an unsigned division, see
+   "Hacker's Delight" (magicu2). The computation is done on bits wide values. */
+static void div_imm_unsigned_magic(sljit_uw divisor, sljit_s32 bits, struct sljit_div_magic *magic)
+{
+	sljit_uw mask = (bits == (sljit_s32)(8 * sizeof(sljit_uw))) ? ~(sljit_uw)0 : (((sljit_uw)1 << bits) - 1);
+	sljit_uw sign_bit = (sljit_uw)1 << (bits - 1);
+	sljit_uw max_signed = sign_bit - 1;
+	sljit_uw p_bits = 0;
+	sljit_uw q, r, delta;
+	sljit_s32 p = bits - 1;
+
+	magic->add = 0;
+	q = max_signed / divisor;
+	r = max_signed - q * divisor;
+
+	do {
+		p++;
+		p_bits = (p == bits) ? 1 : (p_bits << 1);
+
+		if (r + 1 >= divisor - r) {
+			if (q >= max_signed)
+				magic->add = 1;
+			q = ((q << 1) + 1) & mask;
+			r = (r << 1) + 1 - divisor;
+		} else {
+			if (q >= sign_bit)
+				magic->add = 1;
+			q = (q << 1) & mask;
+			r = (r << 1) + 1;
+		}
+		delta = divisor - 1 - r;
+	} while (p < 2 * bits && p_bits < delta);
+
+	magic->multiplier = (q + 1) & mask;
+	magic->shift = p - bits;
+}
+
+/* Computes the magic number of a signed division, see
+   "Hacker's Delight" (magic). The absolute value of
+   the divisor must be greater than 1 and not a power of 2. */
+static void div_imm_signed_magic(sljit_sw divisor, sljit_s32 bits, struct sljit_div_magic *magic)
+{
+	sljit_uw mask = (bits == (sljit_s32)(8 * sizeof(sljit_uw))) ? ~(sljit_uw)0 : (((sljit_uw)1 << bits) - 1);
+	sljit_uw sign_bit = (sljit_uw)1 << (bits - 1);
+	sljit_uw abs_divisor = (divisor < 0) ? ((sljit_uw)0 - (sljit_uw)divisor) : (sljit_uw)divisor;
+	sljit_uw t = sign_bit + ((divisor < 0) ? 1 : 0);
+	sljit_uw abs_nc = t - 1 - t % abs_divisor;
+	sljit_uw quot1, rem1, quot2, rem2, delta;
+	sljit_s32 p = bits - 1;
+
+	quot1 = sign_bit / abs_nc;
+	rem1 = sign_bit - quot1 * abs_nc;
+	quot2 = sign_bit / abs_divisor;
+	rem2 = sign_bit - quot2 * abs_divisor;
+
+	do {
+		p++;
+		quot1 = (quot1 << 1) & mask;
+		rem1 <<= 1;
+		if (rem1 >= abs_nc) {
+			quot1++;
+			rem1 -= abs_nc;
+		}
+
+		quot2 = (quot2 << 1) & mask;
+		rem2 <<= 1;
+		if (rem2 >= abs_divisor) {
+			quot2++;
+			rem2 -= abs_divisor;
+		}
+		delta = abs_divisor - rem2;
+	} while (quot1 < delta || (quot1 == delta && rem1 == 0));
+
+	magic->multiplier = (quot2 + 1) & mask;
+	if (divisor < 0)
+		magic->multiplier = ((sljit_uw)0 - magic->multiplier) & mask;
+	magic->shift = p - bits;
+	magic->add = 0;
+}
+
+static sljit_s32 div_imm_op1(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src, sljit_sw srcw)
+{
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op1(compiler, op, dst, 0, src, srcw);
+}
+
+static sljit_s32 div_imm_op2(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src1, sljit_sw src1w, sljit_s32 src2, sljit_sw src2w)
+{
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op2(compiler, op, dst, 0, src1, src1w, src2, src2w);
+}
+
+/* Computes the high part of SLJIT_R0 * multiplier into SLJIT_R1. Since
+   the original value of SLJIT_R0 is needed later, it is copied into
+   SLJIT_R2 by the caller. */
+static sljit_s32 div_imm_mul_high(struct sljit_compiler *compiler, sljit_s32 op32, sljit_s32 is_signed, sljit_uw multiplier)
+{
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	if (op32) {
+		/* A single 64 bit multiplication is enough. */
+		if (is_signed) {
+			FAIL_IF(div_imm_op1(compiler, SLJIT_MOV_S32, SLJIT_R1, SLJIT_R0, 0));
+			FAIL_IF(div_imm_op2(compiler, SLJIT_MUL, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, (sljit_sw)(sljit_s32)multiplier));
+			return div_imm_op2(compiler, SLJIT_ASHR, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, 32);
+		}
+
+		FAIL_IF(div_imm_op1(compiler, SLJIT_MOV_U32, SLJIT_R1, SLJIT_R0, 0));
+		FAIL_IF(div_imm_op2(compiler, SLJIT_MUL, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, (sljit_sw)multiplier));
+		return div_imm_op2(compiler, SLJIT_LSHR, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, 32);
+	}
+#else /* !SLJIT_64BIT_ARCHITECTURE */
+	SLJIT_UNUSED_ARG(op32);
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+
+	FAIL_IF(div_imm_op1(compiler, SLJIT_MOV, SLJIT_R1, SLJIT_IMM, (sljit_sw)multiplier));
+	SLJIT_SKIP_CHECKS(compiler);
+	return sljit_emit_op0(compiler, is_signed ? SLJIT_LMUL_SW : SLJIT_LMUL_UW);
+}
+
+static sljit_s32 div_imm_unsigned(struct sljit_compiler *compiler, sljit_s32 op32, sljit_s32 is_mod, sljit_s32 bits, sljit_uw divisor)
+{
+	struct sljit_div_magic magic;
+	sljit_s32 shift;
+
+	if (divisor == 1)
+		return is_mod ? div_imm_op1(compiler, SLJIT_MOV, SLJIT_R1, SLJIT_IMM, 0) : SLJIT_SUCCESS;
+
+	if ((divisor & (divisor - 1)) == 0) {
+		if (is_mod)
+			FAIL_IF(div_imm_op2(compiler, SLJIT_AND | op32, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, (sljit_sw)(divisor - 1)));
+
+		shift = 0;
+		while (divisor > 1) {
+			divisor >>= 1;
+			shift++;
+		}
+		return div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R0, SLJIT_R0, 0, SLJIT_IMM, shift);
+	}
+
+	div_imm_unsigned_magic(divisor, bits, &magic);
+
+	FAIL_IF(div_imm_op1(compiler, SLJIT_MOV, SLJIT_R2, SLJIT_R0, 0));
+	FAIL_IF(div_imm_mul_high(compiler, op32, 0, magic.multiplier));
+
+	if (!magic.add) {
+		if (magic.shift > 0)
+			FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R0, SLJIT_R1, 0, SLJIT_IMM, magic.shift));
+		else
+			FAIL_IF(div_imm_op1(compiler, SLJIT_MOV, SLJIT_R0, SLJIT_R1, 0));
+	} else {
+		/* The multiplier does not fit into bits, the overflow is added back. */
+		FAIL_IF(div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R0, SLJIT_R2, 0, SLJIT_R1, 0));
+		FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R0, SLJIT_R0, 0, SLJIT_IMM, 1));
+		FAIL_IF(div_imm_op2(compiler, SLJIT_ADD | op32, SLJIT_R0, SLJIT_R0, 0, SLJIT_R1, 0));
+		if (magic.shift > 1)
+			FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R0, SLJIT_R0, 0, SLJIT_IMM, magic.shift - 1));
+	}
+
+	if (!is_mod)
+		return SLJIT_SUCCESS;
+
+	FAIL_IF(div_imm_op2(compiler, SLJIT_MUL | op32, SLJIT_R1, SLJIT_R0, 0,
+		SLJIT_IMM, op32 ? (sljit_sw)(sljit_s32)divisor : (sljit_sw)divisor));
+	return div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R1, SLJIT_R2, 0, SLJIT_R1, 0);
+}
+
+static sljit_s32 div_imm_signed(struct sljit_compiler *compiler, sljit_s32 op32, sljit_s32 is_mod, sljit_s32 bits, sljit_sw divisor)
+{
+	sljit_uw sign_bit = (sljit_uw)1 << (bits - 1);
+	sljit_uw abs_divisor = (divisor < 0) ? ((sljit_uw)0 - (sljit_uw)divisor) : (sljit_uw)divisor;
+	struct sljit_div_magic magic;
+	sljit_s32 shift;
+
+	if (divisor == 1)
+		return is_mod ? div_imm_op1(compiler, SLJIT_MOV, SLJIT_R1, SLJIT_IMM, 0) : SLJIT_SUCCESS;
+
+	if (divisor == -1) {
+		FAIL_IF(div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R0, SLJIT_IMM, 0, SLJIT_R0, 0));
+		return is_mod ? div_imm_op1(compiler, SLJIT_MOV, SLJIT_R1, SLJIT_IMM, 0) : SLJIT_SUCCESS;
+	}
+
+	if ((abs_divisor & (abs_divisor - 1)) == 0) {
+		shift = 0;
+		while ((abs_divisor >> shift) > 1)
+			shift++;
+
+		if (is_mod)
+			FAIL_IF(div_imm_op1(compiler, SLJIT_MOV, SLJIT_R2, SLJIT_R0, 0));
+
+		/* Negative values are biased by abs_divisor - 1 to round towards zero. */
+		if (shift > 1) {
+			FAIL_IF(div_imm_op2(compiler, SLJIT_ASHR | op32, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, shift - 1));
+			FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, bits - shift));
+		} else
+			FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, bits - 1));
+
+		FAIL_IF(div_imm_op2(compiler, SLJIT_ADD | op32, SLJIT_R1, SLJIT_R1, 0, SLJIT_R0, 0));
+		FAIL_IF(div_imm_op2(compiler, SLJIT_ASHR | op32, SLJIT_R0, SLJIT_R1, 0, SLJIT_IMM, shift));
+
+		if (is_mod) {
+			FAIL_IF(div_imm_op2(compiler, SLJIT_AND | op32, SLJIT_R1, SLJIT_R1, 0,
+				SLJIT_IMM, op32 ? (sljit_sw)(sljit_s32)(sljit_u32)~(abs_divisor - 1) : (sljit_sw)~(abs_divisor - 1)));
+			FAIL_IF(div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R1, SLJIT_R2, 0, SLJIT_R1, 0));
+		}
+
+		if (divisor < 0)
+			return div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R0, SLJIT_IMM, 0, SLJIT_R0, 0);
+		return SLJIT_SUCCESS;
+	}
+
+	div_imm_signed_magic(divisor, bits, &magic);
+
+	FAIL_IF(div_imm_op1(compiler, SLJIT_MOV, SLJIT_R2, SLJIT_R0, 0));
+	FAIL_IF(div_imm_mul_high(compiler, op32, 1, magic.multiplier));
+
+	if (divisor > 0 && (magic.multiplier & sign_bit))
+		FAIL_IF(div_imm_op2(compiler, SLJIT_ADD | op32, SLJIT_R1, SLJIT_R1, 0, SLJIT_R2, 0));
+	else if (divisor < 0 && !(magic.multiplier & sign_bit))
+		FAIL_IF(div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R1, SLJIT_R1, 0, SLJIT_R2, 0));
+
+	if (magic.shift > 0)
+		FAIL_IF(div_imm_op2(compiler, SLJIT_ASHR | op32, SLJIT_R1, SLJIT_R1, 0, SLJIT_IMM, magic.shift));
+
+	/* Adds one to negative results. */
+	FAIL_IF(div_imm_op2(compiler, SLJIT_LSHR | op32, SLJIT_R0, SLJIT_R1, 0, SLJIT_IMM, bits - 1));
+	FAIL_IF(div_imm_op2(compiler, SLJIT_ADD | op32, SLJIT_R0, SLJIT_R0, 0, SLJIT_R1, 0));
+
+	if (!is_mod)
+		return SLJIT_SUCCESS;
+
+	FAIL_IF(div_imm_op2(compiler, SLJIT_MUL | op32, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, divisor));
+	return div_imm_op2(compiler, SLJIT_SUB | op32, SLJIT_R1, SLJIT_R2, 0, SLJIT_R1, 0);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_div_imm(struct sljit_compiler *compiler, sljit_s32 op, sljit_sw divisor)
+{
+	sljit_s32 op32 = op & SLJIT_32;
+	sljit_s32 is_mod, bits;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_div_imm(compiler, op, divisor));
+
+	op = GET_OPCODE(op);
+	is_mod = (op == SLJIT_DIVMOD_UW || op == SLJIT_DIVMOD_SW);
+	bits = op32 ? 32 : (sljit_s32)(8 * sizeof(sljit_sw));
+
+	if (op == SLJIT_DIVMOD_UW || op == SLJIT_DIV_UW)
+		return div_imm_unsigned(compiler, op32, is_mod, bits, op32 ? (sljit_uw)(sljit_u32)divisor : (sljit_uw)divisor);
+
+	return div_imm_signed(compiler, op32, is_mod, bits, op32 ? (sljit_sw)(sljit_s32)divisor : divisor);
+}
+
+/* --------------------------------------------------------------------- */
+/*  Switch statement                                                     */
+/* --------------------------------------------------------------------- */
+
+/* Minimum number of cases for a jump table. */
+#define SWITCH_MIN_TABLE_CASES 4
+/* Maximum number of cases compared by a leaf of the compare tree. */
+#define SWITCH_MAX_LEAF_CASES 3
+
+static sljit_s32 switch_emit_tree(struct sljit_compiler *compiler, struct sljit_switch *switch_,
+	sljit_s32 src, sljit_uw start, sljit_uw end)
+{
+	struct sljit_jump *jump;
+	struct sljit_label *label;
+	sljit_uw mid;
+
+	if (end - start <= SWITCH_MAX_LEAF_CASES) {
+		do {
+			SLJIT_SKIP_CHECKS(compiler);
+			jump = sljit_emit_cmp(compiler, SLJIT_EQUAL, src, 0, SLJIT_IMM, switch_->values[start]);
+			FAIL_IF(!jump);
+			switch_->jumps[start] = jump;
+		} while (++start < end);
+
+		SLJIT_SKIP_CHECKS(compiler);
+		jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+		FAIL_IF(!jump);
+		switch_->jumps[switch_->case_count + switch_->default_count++] = jump;
+		return SLJIT_SUCCESS;
+	}
+
+	mid = start + ((end - start) >> 1);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	jump = sljit_emit_cmp(compiler, SLJIT_SIG_GREATER_EQUAL, src, 0, SLJIT_IMM, switch_->values[mid]);
+	FAIL_IF(!jump);
+
+	FAIL_IF(switch_emit_tree(compiler, switch_, src, start, mid));
+
+	SLJIT_SKIP_CHECKS(compiler);
+	label = sljit_emit_label(compiler);
+	FAIL_IF(!label);
+	sljit_set_label(jump, label);
+
+	return switch_emit_tree(compiler, switch_, src, mid, end);
+}
+
+static sljit_s32 switch_emit_table(struct sljit_compiler *compiler, struct sljit_switch *switch_, sljit_s32 src)
+{
+	struct sljit_read_only_buffer buffer;
+	struct sljit_jump *jump;
+
+	if (switch_->values[0] != 0) {
+		SLJIT_SKIP_CHECKS(compiler);
+		FAIL_IF(sljit_emit_op2(compiler, SLJIT_SUB, src, 0, src, 0, SLJIT_IMM, switch_->values[0]));
+	}
+
+	SLJIT_SKIP_CHECKS(compiler);
+	jump = sljit_emit_cmp(compiler, SLJIT_GREATER, src, 0, SLJIT_IMM, (sljit_sw)(switch_->table_size - 1));
+	FAIL_IF(!jump);
+	switch_->jumps[switch_->case_count] = jump;
+	switch_->default_count = 1;
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_op2(compiler, SLJIT_SHL, src, 0, src, 0, SLJIT_IMM, SLJIT_WORD_SHIFT));
+
+	SLJIT_SKIP_CHECKS(compiler);
+	jump = sljit_emit_op_addr(compiler, SLJIT_ADD_ABS_ADDR, src, 0);
+	FAIL_IF(!jump);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	FAIL_IF(sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_MEM1(src), 0));
+
+	buffer.next = NULL;
+	buffer.size = switch_->table_size * (sljit_uw)sizeof(sljit_uw);
+
+	SLJIT_SKIP_CHECKS(compiler);
+	switch_->table = sljit_emit_aligned_label(compiler, SLJIT_LABEL_ALIGN_W, &buffer);
+	FAIL_IF(!switch_->table);
+
+	sljit_set_label(jump, switch_->table);
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_switch* sljit_emit_switch(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_sw srcw, const sljit_sw *values, sljit_uw count)
+{
+	struct sljit_switch *switch_;
+	sljit_uw size, range;
+
+	CHECK_ERROR_PTR();
+	CHECK_PTR(check_sljit_emit_switch(compiler, src, srcw, values, count));
+	SLJIT_UNUSED_ARG(srcw);
+
+	/* The jumps array has space for a default jump after each leaf. */
+	size = (sljit_uw)sizeof(struct sljit_switch) + count * (sljit_uw)sizeof(sljit_sw)
+		+ (count + 1) * (sljit_uw)sizeof(struct sljit_label*) + (2 * count + 1) * (sljit_uw)sizeof(struct sljit_jump*);
+
+	switch_ = (struct sljit_switch*)SLJIT_MALLOC(size, compiler->allocator_data);
+	PTR_FAIL_IF_NULL(switch_);
+	SLJIT_ZEROMEM(switch_, size);
+
+	switch_->next = compiler->switches;
+	compiler->switches = switch_;
+
+	switch_->case_count = count;
+	switch_->values = (sljit_sw*)(switch_ + 1);
+	switch_->labels = (struct sljit_label**)(switch_->values + count);
+	switch_->jumps = (struct sljit_jump**)(switch_->labels + count + 1);
+	SLJIT_MEMCPY(switch_->values, values, count * sizeof(sljit_sw));
+
+	range = (sljit_uw)values[count - 1] - (sljit_uw)values[0];
+
+	/* Jump tables are used when at least half of their entries are cases. */
+	if (count >= SWITCH_MIN_TABLE_CASES && range < 2 * count) {
+		switch_->table_size = range + 1;
+		PTR_FAIL_IF(switch_emit_table(compiler, switch_, src));
+		return switch_;
+	}
+
+	PTR_FAIL_IF(switch_emit_tree(compiler, switch_, src, 0, count));
+	return switch_;
+}
+
+/* --------------------------------------------------------------------- */
+/*  Modules                                                              */
+/* --------------------------------------------------------------------- */
+
+/* Function entry points are aligned to 16 bytes, which
+   is the usual function alignment of C compilers. */
+#define SLJIT_FUNCTION_ALIGN SLJIT_LABEL_ALIGN_16
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_function(struct sljit_compiler *compiler,
+	sljit_s32 options, sljit_s32 arg_types,
+	sljit_s32 scratches, sljit_s32 saveds, sljit_s32 local_size)
+{
+	struct sljit_label *label;
+
+	CHECK_ERROR_PTR();
+
+	/* The checks (and verbose output) of both operations are performed. */
+	label = sljit_emit_aligned_label(compiler, SLJIT_FUNCTION_ALIGN, NULL);
+	PTR_FAIL_IF(!label);
+
+	PTR_FAIL_IF(sljit_emit_enter(compiler, options, arg_types, scratches, saveds, local_size));
+	return label;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_call_stub* sljit_get_call_stub(struct sljit_compiler *compiler, sljit_uw target)
+{
+	struct sljit_call_stub *stub;
+
+	CHECK_ERROR_PTR();
+
+	stub = compiler->call_stubs;
+	while (stub != NULL) {
+		if (stub->target == target)
+			return stub;
+		stub = stub->next;
+	}
+
+	stub = (struct sljit_call_stub*)ensure_abuf(compiler, sizeof(struct sljit_call_stub));
+	PTR_FAIL_IF(!stub);
+
+	stub->next = compiler->call_stubs;
+	stub->target = target;
+	stub->label = NULL;
+	stub->jump = NULL;
+	stub->calls = NULL;
+	compiler->call_stubs = stub;
+	return stub;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_stub_call(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 arg_types, struct sljit_call_stub *stub)
+{
+	struct sljit_jump *call;
+#if !(defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+	struct sljit_call_stub_ref *ref;
+#endif /* !SLJIT_INDIRECT_CALL */
+
+	CHECK_ERROR_PTR();
+	SLJIT_ASSERT(stub != NULL && !(type & SLJIT_REWRITABLE_JUMP));
+
+	/* The checks (and verbose output) of the call are performed. */
+	call = sljit_emit_call(compiler, type, arg_types);
+	PTR_FAIL_IF(!call);
+
+#if (defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+	sljit_set_target(call, stub->target);
+#else /* !SLJIT_INDIRECT_CALL */
+	if (stub->label != NULL) {
+		sljit_set_label(call, stub->label);
+		return call;
+	}
+
+	ref = (struct sljit_call_stub_ref*)ensure_abuf(compiler, sizeof(struct sljit_call_stub_ref));
+	PTR_FAIL_IF(!ref);
+
+	ref->next = stub->calls;
+	ref->call = call;
+	stub->calls = ref;
+#endif /* SLJIT_INDIRECT_CALL */
+	return call;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_call_stubs(struct sljit_compiler *compiler)
+{
+	struct sljit_call_stub *stub;
+	struct sljit_call_stub_ref *ref;
+
+	CHECK_ERROR();
+
+	stub = compiler->call_stubs;
+	while (stub != NULL) {
+		if (stub->calls != NULL) {
+			SLJIT_ASSERT(stub->label == NULL);
+
+			stub->label = sljit_emit_label(compiler);
+			FAIL_IF(!stub->label);
+
+			/* Rewritable jumps can reach any address, and they
+			   do not modify the argument registers. */
+			stub->jump = sljit_emit_jump(compiler, SLJIT_JUMP | SLJIT_REWRITABLE_JUMP);
+			FAIL_IF(!stub->jump);
+			sljit_set_target(stub->jump, stub->target);
+
+			ref = stub->calls;
+			do {
+				sljit_set_label(ref->call, stub->label);
+				ref = ref->next;
+			} while (ref != NULL);
+
+			stub->calls = NULL;
+		}
+
+		stub = stub->next;
+	}
+
+	return SLJIT_SUCCESS;
+}
+
 #if !(defined SLJIT_CONFIG_ARM && SLJIT_CONFIG_ARM) \
 	&& !(defined SLJIT_CONFIG_PPC && SLJIT_CONFIG_PPC)
 
@@ -497,6 +497,55 @@ struct sljit_const {
 	sljit_uw addr;
 };
 
+struct sljit_cold_region {
+	struct sljit_cold_region *next;
+	struct sljit_label *start;
+	struct sljit_label *end;
+};
+
+struct sljit_switch {
+	struct sljit_switch *next;
+	/* Jump table label, or NULL if a compare tree is emitted. */
+	struct sljit_label *table;
+	/* Number of jump table entries. */
+	sljit_uw table_size;
+	/* Number of cases, the default case is not included. */
+	sljit_uw case_count;
+	/* Number of jumps to the default case. */
+	sljit_uw default_count;
+	/* Case values (case_count items). */
+	sljit_sw *values;
+	/* Case labels (case_count + 1 items), the last one is the default. */
+	struct sljit_label **labels;
+	/* Jumps to the case labels (case_count items, NULL for table entries)
+	   followed by the jumps to the default label (default_count items). */
+	struct sljit_jump **jumps;
+};
+
+struct sljit_call_stub_ref {
+	struct sljit_call_stub_ref *next;
+	struct sljit_jump *call;
+};
+
+struct sljit_call_stub {
+	struct sljit_call_stub *next;
+	/* Address of the called function. */
+	sljit_uw target;
+	/* Entry label of the stub, NULL before the stub is emitted. */
+	struct sljit_label *label;
+	/* Rewritable jump to the target, NULL before the stub is emitted. */
+	struct sljit_jump *jump;
+	/* Calls emitted before the stub. */
+	struct sljit_call_stub_ref *calls;
+};
+
+struct sljit_const_pool_entry {
+	struct sljit_const_pool_entry *next;
+	sljit_uw value;
+	/* Offset of the value in the constant pool. */
+	sljit_uw offset;
+};
+
 struct sljit_generate_code_buffer {
 	void *buffer;
 	sljit_uw size;
@@ -513,6 +562,20 @@ struct sljit_read_only_buffer {
 	} u;
 };
 
+/* Rules of the peephole optimizer (see SLJIT_GENERATE_CODE_PEEPHOLE). */
+
+/* Register to register move, where the source and destination are the same. */
+#define SLJIT_PEEPHOLE_SELF_MOVE	0
+/* A register is stored into memory, and the same memory is loaded
+   immediately after the store. The load is removed or replaced by
+   a register to register move. */
+#define SLJIT_PEEPHOLE_RELOAD		1
+/* A register is set by a move, and overwritten by
+   the next move without reading its value. */
+#define SLJIT_PEEPHOLE_DEAD_MOVE	2
+/* Number of peephole rules. */
+#define SLJIT_PEEPHOLE_RULE_COUNT	3
+
 struct sljit_compiler {
 	sljit_s32 error;
 	sljit_s32 options;
@@ -523,6 +586,10 @@ struct sljit_compiler {
 	struct sljit_label *last_label;
 	struct sljit_jump *last_jump;
 	struct sljit_const *last_const;
+	struct sljit_cold_region *cold_regions;
+	struct sljit_cold_region *last_cold_region;
+	struct sljit_switch *switches;
+	struct sljit_call_stub *call_stubs;
 
 	void *allocator_data;
 	void *user_data;
@@ -556,16 +623,29 @@ struct sljit_compiler {
 	sljit_sw executable_offset;
 	/* Executable size for statistical purposes. */
 	sljit_uw executable_size;
+	/* Number of changes made by each peephole rule. */
+	sljit_uw peephole_counts[SLJIT_PEEPHOLE_RULE_COUNT];
 
 #if (defined SLJIT_HAS_STATUS_FLAGS_STATE && SLJIT_HAS_STATUS_FLAGS_STATE)
 	sljit_s32 status_flags_state;
 #endif /* SLJIT_HAS_STATUS_FLAGS_STATE */
 
+#if (defined SLJIT_HAS_FLAG_REGISTERS && SLJIT_HAS_FLAG_REGISTERS)
+	/* The instruction between zero_flag_start and zero_flag_end
+	   copies zero_flag_reg into the zero flag register. */
+	sljit_uw zero_flag_start;
+	sljit_uw zero_flag_end;
+	sljit_s32 zero_flag_reg;
+#endif /* SLJIT_HAS_FLAG_REGISTERS */
+
 #if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
 	sljit_s32 args_size;
 #endif /* SLJIT_CONFIG_X86_32 */
 
 #if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	/* Constant pool placed after the generated code. */
+	struct sljit_const_pool_entry *const_pool;
+	sljit_uw const_pool_size;
 	/* Temporary fields. */
 	sljit_s32 mode32;
 #endif /* SLJIT_CONFIG_X86_64 */
@@ -721,6 +801,26 @@ so the returned pointer cannot be directly called from C code.
 The flag is ignored when SLJIT_INDIRECT_CALL is not defined. */
 #define SLJIT_GENERATE_CODE_NO_CONTEXT		0x2
 
+/* Run a peephole optimizer over the instruction stream before the
+machine code is generated. The optimizer removes redundant moves
+(see the SLJIT_PEEPHOLE_* rules), which is useful for front-ends
+producing naive code. The number of changes made by each rule can
+be retrieved by sljit_get_peephole_count. The flag is currently
+ignored by all targets except x86. */
+#define SLJIT_GENERATE_CODE_PEEPHOLE		0x4
+
+/* Generate position independent code, which can be copied to another
+address by a memory copy followed by sljit_relocate_code. All intra-function
+references are PC-relative (e.g. SLJIT_MOV_ADDR with a label target
+is a PC-relative address computation), and jumps or calls to absolute
+targets are never encoded as PC-relative instructions. The words which
+may contain absolute addresses of the generated code (targets of
+rewritable jumps and switch jump tables) are collected into a relocation
+table, which is appended to the end of the generated code. The contents
+of read-only buffers and constants are not relocated. Only supported
+by x86-64 at the moment. */
+#define SLJIT_GENERATE_CODE_PIC			0x8
+
 /* Create executable code from the instruction stream. This is the final step
    of the code generation, and no more instructions can be emitted after this call.
 
@@ -751,6 +851,12 @@ static SLJIT_INLINE sljit_sw sljit_get_executable_offset(struct sljit_compiler *
    Before a successful code generation, this function returns with 0. */
 static SLJIT_INLINE sljit_uw sljit_get_generated_code_size(struct sljit_compiler *compiler) { return compiler->executable_size; }
 
+/* Returns with the number of instructions changed or removed by the
+   peephole rule (see SLJIT_PEEPHOLE_* rules) during code generation.
+
+   Before a successful code generation, this function returns with 0. */
+static SLJIT_INLINE sljit_uw sljit_get_peephole_count(struct sljit_compiler *compiler, sljit_s32 rule) { return compiler->peephole_counts[rule]; }
+
 /* Returns with non-zero if the feature or limitation type passed as its
    argument is present on the current CPU. The return value is one, if a
    feature is fully supported, and it is two, if partially supported.
@@ -800,6 +906,35 @@ static SLJIT_INLINE sljit_uw sljit_get_generated_code_size(struct sljit_compiler
 #define SLJIT_HAS_ATOMIC		14
 /* [Not emulated] Memory barrier support is available. */
 #define SLJIT_HAS_MEMORY_BARRIER		15
+/* [Emulated] Population count (SLJIT_POPCNT) is supported. */
+#define SLJIT_HAS_POPCNT		16
+/* [Not emulated] Parallel bit deposit and extract
+   (SLJIT_PDEP and SLJIT_PEXT) is supported. */
+#define SLJIT_HAS_PDEP_PEXT		17
+/* [Emulated] Fused multiply-add (SLJIT_MULADD_F64 and SLJIT_MULSUB_F64)
+   is supported. When emulated, the result of the multiplication is
+   rounded before the addition or subtraction. */
+#define SLJIT_HAS_FMA			18
+/* [Not emulated] Rounding operations (SLJIT_FLOOR_F64, SLJIT_CEIL_F64,
+   SLJIT_TRUNC_F64 and SLJIT_ROUND_F64) are supported. */
+#define SLJIT_HAS_FROUND		19
+/* [Emulated] CRC32C accumulate operations (SLJIT_CRC32C_U8,
+   SLJIT_CRC32C_U16, SLJIT_CRC32C_U32 and SLJIT_CRC32C) are
+   supported by the CPU. When emulated, a lookup table is used. */
+#define SLJIT_HAS_CRC32C		20
+/* [Emulated] Prefetch with write intent (SLJIT_PREFETCH_WRITE_L1,
+   SLJIT_PREFETCH_WRITE_L2 and SLJIT_PREFETCH_WRITE_L3) is supported.
+   When emulated, the corresponding read prefetch is emitted. */
+#define SLJIT_HAS_PREFETCH_WRITE	21
+/* [Emulated] Reading a cycle or timer counter (SLJIT_GET_CYCLE_COUNTER)
+   is supported. The return value is one, if the counter is incremented
+   at a constant rate, which is independent from the current frequency of
+   the cpu, and two, if the counter counts cpu cycles (its rate might be
+   changed by power management). When emulated, zero is stored. */
+#define SLJIT_HAS_CYCLE_COUNTER		22
+/* [Not emulated] Reading the thread pointer (SLJIT_GET_THREAD_POINTER)
+   is supported. */
+#define SLJIT_HAS_THREAD_POINTER	23
 
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
 /* [Not emulated] AVX support is available on x86. */
@@ -919,6 +1054,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_cmp_info(sljit_s32 type);
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
 /* Use VEX prefix for all SIMD operations on x86. */
 #define SLJIT_ENTER_USE_VEX		0x00010000
+/* The rewritable jumps and constants of the function can be patched
+   by sljit_set_jump_addr and sljit_set_const while other threads are
+   executing the code. The patched fields are naturally aligned (NOPs
+   are inserted before the instructions when needed), so a patch is a
+   single atomic store which never crosses a cache line, and a thread
+   sees either the old or the new value. Other architectures load wide
+   immediates with instruction sequences, hence this option is only
+   available on x86. Since the SLJIT_WX_EXECUTABLE_ALLOCATOR switches
+   the page permissions during patching, it cannot be used with this
+   option. */
+#define SLJIT_ENTER_CONCURRENT_PATCH	0x00020000
 #endif /* !SLJIT_CONFIG_X86 */
 
 /* Macros for other sljit_emit_enter arguments. */
@@ -955,6 +1101,30 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_set_context(struct sljit_compiler *comp
 	sljit_s32 options, sljit_s32 arg_types,
 	sljit_s32 scratches, sljit_s32 saveds, sljit_s32 local_size);
 
+/* A compiler can hold several functions, which form a module. Each function
+   starts with an sljit_emit_enter, and all functions of a module share the
+   same executable memory, constant pool and instruction cache flush. Any
+   function can call another function of the module (including the ones
+   emitted later) by setting the target of an sljit_emit_call to the entry
+   label of the callee with sljit_set_label. These calls are resolved to
+   direct, PC-relative calls when the code is generated, so the callees
+   do not need to be generated first.
+
+   The sljit_emit_function emits a label aligned for a function entry
+   point followed by an sljit_emit_enter with the given arguments, and
+   returns with the label. The previous function must be finished before
+   (e.g. by sljit_emit_return), since the label is preceded by padding.
+   The address of a function can be retrieved by sljit_get_label_addr after
+   the code is generated. When SLJIT_INDIRECT_CALL is defined, a function
+   context must be created for the functions called from C code (see
+   sljit_set_function_context), except the first one.
+
+   Returns with the entry label, or NULL if an error is occurred. */
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_function(struct sljit_compiler *compiler,
+	sljit_s32 options, sljit_s32 arg_types,
+	sljit_s32 scratches, sljit_s32 saveds, sljit_s32 local_size);
+
 /* Return to the caller function. The sljit_emit_return_void function
    does not return with any value. The sljit_emit_return function returns
    with a single value loaded from its source operand. The load operation
@@ -1213,7 +1383,8 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_return_to(struct sljit_compiler *c
 /* Flags: - (does not modify flags)
    May return with SLJIT_ERR_UNSUPPORTED if SLJIT_HAS_MEMORY_BARRIER
    feature is not supported (calling sljit_has_cpu_feature() with
-   this feature option returns with 0). */
+   this feature option returns with 0). The barrier also orders
+   the non-temporal stores (see SLJIT_MEM_NON_TEMPORAL). */
 #define SLJIT_MEMORY_BARRIER		(SLJIT_OP0_BASE + 8)
 /* Flags: - (does not modify flags)
    ENDBR32 instruction for x86-32 and ENDBR64 instruction for x86-64
@@ -1228,6 +1399,25 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_return_to(struct sljit_compiler *c
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op0(struct sljit_compiler *compiler, sljit_s32 op);
 
+/* Divides SLJIT_R0 by a constant divisor. The division is replaced by a
+   multiplication with a "magic" number followed by shifts, which is much
+   faster than a hardware divide on most cpus. Division by a power of two
+   only needs shifts.
+
+   op must be SLJIT_DIVMOD_UW, SLJIT_DIVMOD_SW, SLJIT_DIV_UW or SLJIT_DIV_SW
+     (or their 32 bit variants), see sljit_emit_op0. The quotient is placed
+     into SLJIT_R0, and the remainder is placed into SLJIT_R1 by the
+     SLJIT_DIVMOD_* operations.
+   divisor must not be 0. For 32 bit operations, only its low 32 bit is used.
+
+   Flags: - (may destroy flags)
+   Note: unlike sljit_emit_op0, the value of SLJIT_R1 is destroyed
+         by the SLJIT_DIV_* operations, and the value of SLJIT_R2 is
+         destroyed by all operations, so at least three scratch
+         registers must be available.
+   Note: signed division of integer min (0x800..00) by -1 is undefined. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_div_imm(struct sljit_compiler *compiler, sljit_s32 op, sljit_sw divisor);
+
 /* Starting index of opcodes for sljit_emit_op1. */
 #define SLJIT_OP1_BASE			32
 
@@ -1272,42 +1462,50 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op0(struct sljit_compiler *compile
 #define SLJIT_MOV_P			(SLJIT_OP1_BASE + 8)
 /* Count leading zeroes
    Flags: - (may destroy flags)
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_CLZ			(SLJIT_OP1_BASE + 9)
 #define SLJIT_CLZ32			(SLJIT_CLZ | SLJIT_32)
 /* Count trailing zeroes
    Flags: - (may destroy flags)
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_CTZ			(SLJIT_OP1_BASE + 10)
 #define SLJIT_CTZ32			(SLJIT_CTZ | SLJIT_32)
 /* Reverse the order of bytes
    Flags: - (may destroy flags)
    Note: converts between little and big endian formats
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_REV			(SLJIT_OP1_BASE + 11)
 #define SLJIT_REV32			(SLJIT_REV | SLJIT_32)
 /* Reverse the order of bytes in the lower 16 bit and extend as unsigned
    Flags: - (may destroy flags)
    Note: converts between little and big endian formats
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_REV_U16			(SLJIT_OP1_BASE + 12)
 #define SLJIT_REV32_U16			(SLJIT_REV_U16 | SLJIT_32)
 /* Reverse the order of bytes in the lower 16 bit and extend as signed
    Flags: - (may destroy flags)
    Note: converts between little and big endian formats
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_REV_S16			(SLJIT_OP1_BASE + 13)
 #define SLJIT_REV32_S16			(SLJIT_REV_S16 | SLJIT_32)
 /* Reverse the order of bytes in the lower 32 bit and extend as unsigned
    Flags: - (may destroy flags)
    Note: converts between little and big endian formats
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_REV_U32			(SLJIT_OP1_BASE + 14)
 /* Reverse the order of bytes in the lower 32 bit and extend as signed
    Flags: - (may destroy flags)
    Note: converts between little and big endian formats
-   Note: immediate source argument is not supported */
+   Note: immediate source argument is computed at compile time */
 #define SLJIT_REV_S32			(SLJIT_OP1_BASE + 15)
+/* Count the number of set bits (population count)
+   Flags: - (may destroy flags)
+   Note: the operation is emulated by a short instruction
+         sequence if the cpu has no population count
+         instruction (see SLJIT_HAS_POPCNT)
+   Note: immediate source argument is computed at compile time */
+#define SLJIT_POPCNT			(SLJIT_OP1_BASE + 16)
+#define SLJIT_POPCNT32			(SLJIT_POPCNT | SLJIT_32)
 
 /* The following unary operations are supported by using sljit_emit_op2:
      - binary not: SLJIT_XOR with immedate -1 as src1 or src2
@@ -1396,6 +1594,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 #define SLJIT_ROTR			(SLJIT_OP2_BASE + 15)
 #define SLJIT_ROTR32			(SLJIT_ROTR | SLJIT_32)
 
+/* When no status flags are requested, operations with two immediate
+   arguments are computed at compile time, and operations with an
+   identity (e.g. adding 0 or multiplying by 1) or absorbing (e.g.
+   binary and with 0) immediate argument are replaced by moves. */
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -1414,6 +1617,33 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2u(struct sljit_compiler *compil
 /* Flags: - (may destroy flags) */
 #define SLJIT_MULADD			(SLJIT_OP2R_BASE + 0)
 #define SLJIT_MULADD32			(SLJIT_MULADD | SLJIT_32)
+/* Parallel bit deposit: the lowest bits of src1 are copied
+   to the bit positions selected by the mask in src2, and
+   all other bits of the result are cleared.
+   Note: only available if sljit_has_cpu_feature(SLJIT_HAS_PDEP_PEXT) returns 1
+   Flags: - (may destroy flags) */
+#define SLJIT_PDEP			(SLJIT_OP2R_BASE + 1)
+#define SLJIT_PDEP32			(SLJIT_PDEP | SLJIT_32)
+/* Parallel bit extract: the bits of src1 selected by the
+   mask in src2 are packed into the lowest bits of the
+   result, and all other bits of the result are cleared.
+   Note: only available if sljit_has_cpu_feature(SLJIT_HAS_PDEP_PEXT) returns 1
+   Flags: - (may destroy flags) */
+#define SLJIT_PEXT			(SLJIT_OP2R_BASE + 2)
+#define SLJIT_PEXT32			(SLJIT_PEXT | SLJIT_32)
+/* CRC32C (Castagnoli polynomial) accumulate: the lowest 32 bit of
+   src1 contains the current checksum, which is updated with the
+   lowest 8 / 16 / 32 bit of src2 or with the whole machine word
+   of src2. When src2 is a memory operand, only the data is loaded
+   from memory. The checksum is not inverted before or after the
+   update, and the 32 bit result is zero extended to the machine word.
+   Note: SLJIT_32 is not allowed, and SLJIT_CRC32C is the same
+         as SLJIT_CRC32C_U32 on 32 bit machines
+   Flags: - (may destroy flags) */
+#define SLJIT_CRC32C_U8			(SLJIT_OP2R_BASE + 3)
+#define SLJIT_CRC32C_U16		(SLJIT_OP2R_BASE + 4)
+#define SLJIT_CRC32C_U32		(SLJIT_OP2R_BASE + 5)
+#define SLJIT_CRC32C			(SLJIT_OP2R_BASE + 6)
 
 /* Similar to sljit_emit_fop2, except the destination is always a register. */
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compiler, sljit_s32 op,
@@ -1466,6 +1696,40 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_shift_into(struct sljit_compiler *
 	sljit_s32 src2_reg,
 	sljit_s32 src3, sljit_sw src3w);
 
+/* Starting index of opcodes for sljit_emit_bitfield. */
+#define SLJIT_BITFIELD_BASE		104
+
+/* Flags: - (may destroy flags)
+   dst_reg = (src_reg >> start) & ((1 << length) - 1) */
+#define SLJIT_EXTRACT_U			(SLJIT_BITFIELD_BASE + 0)
+#define SLJIT_EXTRACT_U32		(SLJIT_EXTRACT_U | SLJIT_32)
+/* Flags: - (may destroy flags)
+   Same as SLJIT_EXTRACT_U, except the result is sign
+   extended (the highest bit of the bit field is the sign bit). */
+#define SLJIT_EXTRACT_S			(SLJIT_BITFIELD_BASE + 1)
+#define SLJIT_EXTRACT_S32		(SLJIT_EXTRACT_S | SLJIT_32)
+/* Flags: - (may destroy flags)
+   The length number of bits of dst_reg starting from start are
+   replaced by the lowest length number of bits of src_reg. The
+   other bits of dst_reg are unchanged.
+   Note: dst_reg and src_reg must be different registers */
+#define SLJIT_INSERT			(SLJIT_BITFIELD_BASE + 2)
+#define SLJIT_INSERT32			(SLJIT_INSERT | SLJIT_32)
+
+/* Emit a bit field extract or insert operation. The bit field is
+   described by its lowest bit (start) and its size in bits (length),
+   where start + length cannot be greater than the size of the
+   operation (32 for 32 bit operations, word size otherwise), and
+   length must be greater than 0.
+
+   op must be one of the SLJIT_EXTRACT_U, SLJIT_EXTRACT_S or SLJIT_INSERT
+     operations, optionally combined with SLJIT_32
+
+   Flags: - (may destroy flags) */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length);
+
 /* The following options are used by sljit_emit_op2_shift. */
 
 /* The src2 argument is shifted left by an immedate value. */
@@ -1521,6 +1785,27 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *c
    Flags: - (does not modify flags) */
 #define SLJIT_PREFETCH_ONCE		(SLJIT_OP_SRC_DST_BASE + 5)
 
+/* Prefetch value into the level 1 data cache, and the cache line is
+   going to be written soon (the cpu may request exclusive ownership
+   of the cache line in advance, see SLJIT_HAS_PREFETCH_WRITE)
+   Note: same as SLJIT_PREFETCH_L1 if the target CPU
+         does not support this instruction form.
+   Note: this instruction never fails, even if the memory address is invalid.
+   Flags: - (does not modify flags) */
+#define SLJIT_PREFETCH_WRITE_L1		(SLJIT_OP_SRC_DST_BASE + 8)
+/* Same as SLJIT_PREFETCH_WRITE_L1, except the value is prefetched
+   into the level 2 data cache
+   Note: same as SLJIT_PREFETCH_WRITE_L1 (or SLJIT_PREFETCH_L2) if
+         the target CPU does not support this instruction form.
+   Flags: - (does not modify flags) */
+#define SLJIT_PREFETCH_WRITE_L2		(SLJIT_OP_SRC_DST_BASE + 9)
+/* Same as SLJIT_PREFETCH_WRITE_L1, except the value is prefetched
+   into the level 3 data cache
+   Note: same as SLJIT_PREFETCH_WRITE_L2 (or SLJIT_PREFETCH_L3) if
+         the target CPU does not support this instruction form.
+   Flags: - (does not modify flags) */
+#define SLJIT_PREFETCH_WRITE_L3		(SLJIT_OP_SRC_DST_BASE + 10)
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 src, sljit_sw srcw);
 
@@ -1533,6 +1818,25 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
    returns (see: sljit_emit_return / sljit_emit_return_void).
    Flags: - (does not modify flags) */
 #define SLJIT_GET_RETURN_ADDRESS	(SLJIT_OP_SRC_DST_BASE + 7)
+/* Copies the current value of the cheapest cycle or timer counter of
+   the cpu into dst (e.g. rdtsc on x86, cntvct_el0 on ARM64, rdtime on
+   RISC-V, mftb on PowerPC and stckf on s390x). The counter is not
+   guaranteed to be synchronized across cpus. The frequency of the
+   counter is target dependent, see SLJIT_HAS_CYCLE_COUNTER.
+   Note: only the low 32 bit of the counter is stored on 32 bit cpus,
+         and the cycle counter of MIPS cpus is always 32 bit wide
+   Flags: may destroy flags */
+#define SLJIT_GET_CYCLE_COUNTER		(SLJIT_OP_SRC_DST_BASE + 11)
+/* Copies the thread pointer of the current thread into dst. The
+   thread pointer is the base address of the thread control block,
+   which is used by the C runtime to access thread local variables
+   (e.g. fs:[0] on x86-64 Linux, tpidr_el0 on ARM64, tp on RISC-V,
+   r13 on PowerPC 64). The offset of a thread local variable from
+   this address can be computed by sljit_get_thread_local_offset.
+   Note: the thread control block is pointed by gs:[0x30] (x86-64)
+         and fs:[0x18] (x86-32) on Windows
+   Flags: - (does not modify flags) */
+#define SLJIT_GET_THREAD_POINTER	(SLJIT_OP_SRC_DST_BASE + 12)
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw);
@@ -1577,6 +1881,31 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 /* Flags: - (may destroy flags) */
 #define SLJIT_ABS_F64			(SLJIT_FOP1_BASE + 10)
 #define SLJIT_ABS_F32			(SLJIT_ABS_F64 | SLJIT_32)
+/* Square root, the result of a negative source is NaN.
+   Flags: - (may destroy flags) */
+#define SLJIT_SQRT_F64			(SLJIT_FOP1_BASE + 11)
+#define SLJIT_SQRT_F32			(SLJIT_SQRT_F64 | SLJIT_32)
+/* Rounding opcodes: the result is an integral value of the same
+   floating point type. NaN and infinity sources are returned unchanged,
+   and the sign of a zero result is the sign of the source (e.g. the
+   SLJIT_CEIL_F64 of -0.5 is -0.0). These opcodes are only available
+   when sljit_has_cpu_feature(SLJIT_HAS_FROUND) returns with non-zero. */
+/* Round towards negative infinity (same as C floor).
+   Flags: - (may destroy flags) */
+#define SLJIT_FLOOR_F64			(SLJIT_FOP1_BASE + 12)
+#define SLJIT_FLOOR_F32			(SLJIT_FLOOR_F64 | SLJIT_32)
+/* Round towards positive infinity (same as C ceil).
+   Flags: - (may destroy flags) */
+#define SLJIT_CEIL_F64			(SLJIT_FOP1_BASE + 13)
+#define SLJIT_CEIL_F32			(SLJIT_CEIL_F64 | SLJIT_32)
+/* Round towards zero (same as C trunc).
+   Flags: - (may destroy flags) */
+#define SLJIT_TRUNC_F64			(SLJIT_FOP1_BASE + 14)
+#define SLJIT_TRUNC_F32			(SLJIT_TRUNC_F64 | SLJIT_32)
+/* Round to nearest, ties away from zero (same as C round).
+   Flags: - (may destroy flags) */
+#define SLJIT_ROUND_F64			(SLJIT_FOP1_BASE + 15)
+#define SLJIT_ROUND_F32			(SLJIT_ROUND_F64 | SLJIT_32)
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
@@ -1597,6 +1926,16 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 /* Flags: - (may destroy flags) */
 #define SLJIT_DIV_F64			(SLJIT_FOP2_BASE + 3)
 #define SLJIT_DIV_F32			(SLJIT_DIV_F64 | SLJIT_32)
+/* Minimum and maximum with the NaN handling of C fmin / fmax: when
+   one of the sources is NaN, the other source is returned, and the
+   result is NaN only when both sources are NaN. Since +0.0 and -0.0
+   compare equal, either of them can be returned when they are compared.
+   Flags: - (may destroy flags) */
+#define SLJIT_MIN_F64			(SLJIT_FOP2_BASE + 4)
+#define SLJIT_MIN_F32			(SLJIT_MIN_F64 | SLJIT_32)
+/* Flags: - (may destroy flags) */
+#define SLJIT_MAX_F64			(SLJIT_FOP2_BASE + 5)
+#define SLJIT_MAX_F32			(SLJIT_MAX_F64 | SLJIT_32)
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
@@ -1609,6 +1948,16 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 /* Flags: - (may destroy flags) */
 #define SLJIT_COPYSIGN_F64		(SLJIT_FOP2R_BASE + 0)
 #define SLJIT_COPYSIGN_F32		(SLJIT_COPYSIGN_F64 | SLJIT_32)
+/* Flags: - (may destroy flags)
+   dst_freg = src1 * src2 + dst_freg
+   The result is rounded once, see SLJIT_HAS_FMA. */
+#define SLJIT_MULADD_F64		(SLJIT_FOP2R_BASE + 1)
+#define SLJIT_MULADD_F32		(SLJIT_MULADD_F64 | SLJIT_32)
+/* Flags: - (may destroy flags)
+   dst_freg = src1 * src2 - dst_freg
+   The result is rounded once, see SLJIT_HAS_FMA. */
+#define SLJIT_MULSUB_F64		(SLJIT_FOP2R_BASE + 2)
+#define SLJIT_MULSUB_F32		(SLJIT_MULSUB_F64 | SLJIT_32)
 
 /* Similar to sljit_emit_fop2, except the destination is always a register. */
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compiler, sljit_s32 op,
@@ -1710,6 +2059,21 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_label(struct sljit_compi
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_aligned_label(struct sljit_compiler *compiler,
 	sljit_s32 alignment, struct sljit_read_only_buffer *buffers);
 
+/* Marks the code between start_label and end_label as cold, i.e. rarely
+   executed code such as error handlers or slow paths. The region contains
+   start_label, but it does not contain end_label. When the code is generated,
+   cold regions may be moved after all other code, so the frequently executed
+   (hot) paths form a dense instruction stream. The lengths of the jumps are
+   computed after the regions are moved. Currently only the x86 backend moves
+   the code, other architectures ignore this hint.
+
+   Since a region can be moved, the instruction before start_label and the
+   last instruction of the region must not fall through: they must be jumps,
+   returns, or other control transfer instructions. Furthermore the regions
+   must be specified in increasing label order and they cannot overlap. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_set_cold_region(struct sljit_compiler *compiler,
+	struct sljit_label *start_label, struct sljit_label *end_label);
+
 /* The SLJIT_FAST_CALL is a calling method for creating lightweight function
    calls. This type of calls preserve the values of all registers and stack
    frame. Unlike normal function calls, the enter and return operations must
@@ -1847,9 +2211,19 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_aligned_label(struct slj
    arguments and the return address must be stored on the stack as well. */
 #define SLJIT_CALL_RETURN		0x20000
 
+/* Static branch prediction hints for conditional jumps. SLJIT_JUMP_LIKELY
+   tells that the jump is usually taken, SLJIT_JUMP_UNLIKELY tells that it
+   is usually not taken. The hints never change the behaviour of the code,
+   and architectures without hint encodings ignore them. Currently they are
+   encoded into the conditional branch instructions on PowerPC. Unlikely
+   targets can be moved out of line by sljit_set_cold_region. */
+#define SLJIT_JUMP_LIKELY		0x40000
+#define SLJIT_JUMP_UNLIKELY		0x80000
+
 /* Emit a jump instruction. The destination is not set, only the type of the jump.
     type must be between SLJIT_JUMP and SLJIT_FAST_CALL
-    type can be combined (or'ed) with SLJIT_REWRITABLE_JUMP
+    type can be combined (or'ed) with SLJIT_REWRITABLE_JUMP, and conditional
+      jumps can also be combined with SLJIT_JUMP_LIKELY or SLJIT_JUMP_UNLIKELY
 
    Flags: does not modify flags. */
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compiler *compiler, sljit_s32 type);
@@ -1868,7 +2242,8 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_call(struct sljit_compile
    may optimize the generated code further. It is suggested to use this
    comparison form when appropriate.
     type must be between SLJIT_EQUAL and SLJIT_SIG_LESS_EQUAL
-    type can be combined (or'ed) with SLJIT_32 or SLJIT_REWRITABLE_JUMP
+    type can be combined (or'ed) with SLJIT_32, SLJIT_REWRITABLE_JUMP,
+      and SLJIT_JUMP_LIKELY or SLJIT_JUMP_UNLIKELY
 
    Flags: may destroy flags. */
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_cmp(struct sljit_compiler *compiler, sljit_s32 type,
@@ -1881,7 +2256,8 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_cmp(struct sljit_compiler
    (e.g: MIPS) may optimize the generated code further. It is suggested
    to use this comparison form when appropriate.
     type must be between SLJIT_F_EQUAL and SLJIT_ORDERED_LESS_EQUAL
-    type can be combined (or'ed) with SLJIT_32 or SLJIT_REWRITABLE_JUMP
+    type can be combined (or'ed) with SLJIT_32, SLJIT_REWRITABLE_JUMP,
+      and SLJIT_JUMP_LIKELY or SLJIT_JUMP_UNLIKELY
 
    Flags: destroy flags.
    Note: when any operand is NaN the behaviour depends on the comparison type. */
@@ -1901,7 +2277,8 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_fcmp(struct sljit_compile
 
    op must be an sljit_emit_op2 operation where zero flag can be set,
    op can be combined with SLJIT_SET_* status flag setters except
-     SLJIT_SET_Z, SLJIT_REWRITABLE_JUMP or SLJIT_JUMP_IF_* option bits.
+     SLJIT_SET_Z, SLJIT_REWRITABLE_JUMP, SLJIT_JUMP_LIKELY,
+     SLJIT_JUMP_UNLIKELY or SLJIT_JUMP_IF_* option bits.
 
    Note: SLJIT_JUMP_IF_NON_ZERO is the default operation if neither
       SLJIT_JUMP_IF_ZERO or SLJIT_JUMP_IF_NON_ZERO is specified.
@@ -1925,6 +2302,34 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_target(struct sljit_jump *jump, sljit_uw
    Flags: does not modify flags. */
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_ijump(struct sljit_compiler *compiler, sljit_s32 type, sljit_s32 src, sljit_sw srcw);
 
+/* Emit a multi-way branch (switch statement). The value of src is compared
+   to the case values, and the execution continues at the label of the
+   matching case, or at the default label if none of them matches. When
+   the cases are dense, a bounds check followed by an indirect jump through
+   a jump table is emitted. The table is stored in a read-only buffer placed
+   after the indirect jump (see sljit_emit_aligned_label), and filled by
+   sljit_generate_code. Otherwise a binary tree of compare and branch
+   instructions is emitted.
+
+   src must be a register (not a virtual register on x86-32),
+     and its value is undefined after the operation
+   values is an array of count case values in strictly increasing order,
+     the values are copied, so the array can be freed after the call
+   count must be greater than 0
+
+   The case labels are specified by sljit_set_switch_label after the
+   labels are emitted. All labels must be specified before the code
+   is generated.
+
+   Flags: destroy flags. */
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_switch* sljit_emit_switch(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_sw srcw, const sljit_sw *values, sljit_uw count);
+
+/* Set the label of a case of a switch. The index refers to the position
+   of the case value in the values array passed to sljit_emit_switch, and
+   index equal to count represents the default case. */
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_switch_label(struct sljit_switch *switch_, sljit_uw index, struct sljit_label *label);
+
 /* Emit a C compiler (ABI) compatible function call.
    Direct form: set src to SLJIT_IMM() and srcw to the address
    Indirect form: any other valid addressing mode
@@ -1935,6 +2340,43 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_ijump(struct sljit_compiler *compi
    Flags: destroy all flags. */
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_icall(struct sljit_compiler *compiler, sljit_s32 type, sljit_s32 arg_types, sljit_s32 src, sljit_sw srcw);
 
+/* Call stubs are shared trampolines for calling far functions. Calling
+   a function with an absolute address usually requires loading the
+   address into a register followed by an indirect call. When the
+   same function is called from many places, the calls can be
+   redirected to a stub, which contains a single jump to the
+   function, and the call sites use short, direct calls.
+
+   The sljit_get_call_stub returns with the stub of the target
+   address. Only one stub is created for each distinct target
+   address of a compiler. Returns NULL if an error is occurred.
+
+   The sljit_emit_stub_call emits a call to the stub, and it has the
+   same arguments and flags as sljit_emit_call, except the type cannot
+   be combined with SLJIT_REWRITABLE_JUMP. Returns NULL if an error is
+   occurred. Note: when SLJIT_INDIRECT_CALL is defined, the function is
+   called directly, since the stubs cannot set up the function context.
+
+   The sljit_emit_call_stubs emits the stubs which has been used by a
+   call since its last invocation, and the calls emitted before are
+   redirected to these stubs. It must be called after the last stub
+   call is emitted, at a location which is not reachable by the control
+   flow (e.g. after an sljit_emit_return). It may be called several
+   times, e.g. once for each function to keep the stubs near to their
+   callers. Calls emitted after a stub is emitted use the same stub.
+
+   The target of a stub can be changed after the code is generated by
+   sljit_set_jump_addr, where the address is returned by the
+   sljit_get_call_stub_addr function. This updates all calls of
+   the stub at once.
+
+   Note: compilers using call stubs cannot be serialized. */
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_call_stub* sljit_get_call_stub(struct sljit_compiler *compiler, sljit_uw target);
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_stub_call(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 arg_types, struct sljit_call_stub *stub);
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_call_stubs(struct sljit_compiler *compiler);
+
 /* Perform an operation using the conditional flags as the second argument.
    Type must always be between SLJIT_EQUAL and SLJIT_ORDERED_LESS_EQUAL.
    The value represented by the type is 1, if the condition represented
@@ -2032,6 +2474,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 #define SLJIT_MEM_ALIGNED_16	0x000800
 /* Load or stora data from a 32 bit aligned address. */
 #define SLJIT_MEM_ALIGNED_32	0x001000
+/* Non-temporal access hint: the data is not accessed again soon,
+   so the cpu should avoid polluting the caches with it. This flag
+   is a hint, which is ignored when the cpu has no suitable
+   instruction. When none of the SLJIT_MEM_UNALIGNED /
+   SLJIT_MEM_ALIGNED_* flags are specified together with this
+   flag, the address must be aligned to the size of the data. */
+#define SLJIT_MEM_NON_TEMPORAL	0x002000
 
 /* The following flags are used by sljit_emit_mem_update(),
    and sljit_emit_fmem_update(). */
@@ -2068,6 +2517,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
      be SLJIT_MOV. The SLJIT_MEM_UNALIGNED / SLJIT_MEM_ALIGNED_*
      options are allowed for this operation.
 
+   When SLJIT_MEM_NON_TEMPORAL is set in type argument:
+     Emit non-temporal (streaming) loads or stores if the cpu supports
+     them. Non-temporal stores are weakly ordered on some cpus (e.g.
+     x86), so an SLJIT_MEMORY_BARRIER is needed before the stored data
+     is made visible to other threads (e.g. before releasing a lock).
+
    type must be between SLJIT_MOV and SLJIT_MOV_P and can be
      combined (or'ed) with SLJIT_MEM_* flags
    reg is a register or register pair, which is the source or
@@ -2130,6 +2585,51 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fmem_update(struct sljit_compiler
 	sljit_s32 freg,
 	sljit_s32 mem, sljit_sw memw);
 
+/* The following options are used by sljit_emit_mem_block(). */
+
+/* Copy a memory block (non-overlapping memcpy). This is the default. */
+#define SLJIT_MEM_BLOCK_COPY		0x000000
+/* Fill a memory block with a byte value (memset). */
+#define SLJIT_MEM_BLOCK_FILL		0x000001
+
+/* Both the source and destination addresses are 16 bit aligned. */
+#define SLJIT_MEM_BLOCK_ALIGNED_16	(1 << 8)
+/* Both the source and destination addresses are 32 bit aligned. */
+#define SLJIT_MEM_BLOCK_ALIGNED_32	(2 << 8)
+/* Both the source and destination addresses are 64 bit aligned. */
+#define SLJIT_MEM_BLOCK_ALIGNED_64	(3 << 8)
+/* Both the source and destination addresses are 128 bit aligned. */
+#define SLJIT_MEM_BLOCK_ALIGNED_128	(4 << 8)
+
+/* Emit instructions which copy or fill a memory block without calling
+   a library function. Small blocks with an immediate length are copied
+   by unrolled general purpose or vector register moves. Otherwise a
+   loop is emitted, or a string instruction (rep movsb / rep stosb) is
+   used on x86 cpus with fast string operations.
+
+   type must be SLJIT_MEM_BLOCK_COPY or SLJIT_MEM_BLOCK_FILL, and can
+     be combined (or'ed) with one of the SLJIT_MEM_BLOCK_ALIGNED_* flags.
+     The alignment flags are hints, but the addresses must be aligned
+     when they are specified.
+   dst_reg is a register, which contains the destination address
+   src is a register, which contains the source address when
+     SLJIT_MEM_BLOCK_COPY is specified, and it is an immediate or a
+     register containing the fill value (only the lowest 8 bit is used)
+     when SLJIT_MEM_BLOCK_FILL is specified
+   len is an immediate or a register, which contains the length
+     of the block in bytes
+
+   Note: the dst_reg, src and len registers must be different, and
+         their values are undefined after the operation, all other
+         registers are preserved
+   Note: temporary registers cannot be passed as arguments
+
+   Flags: - (may destroy flags) */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw);
+
 /* The following options are used by several simd operations. */
 
 /* Load data into a vector register, this is the default */
@@ -2179,6 +2679,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fmem_update(struct sljit_compiler
 /* Memory address is 512 bit aligned */
 #define SLJIT_SIMD_MEM_ALIGNED_512	(6 << 24)
 
+/* The following options are used by sljit_emit_simd_mov(). */
+
+/* Non-temporal access hint, see SLJIT_MEM_NON_TEMPORAL. Non-temporal
+   instructions are only used when the memory address is aligned to
+   the size of the vector register, otherwise the hint is ignored. */
+#define SLJIT_SIMD_MEM_NON_TEMPORAL	0x000002
+
 /* Moves data between a vector register and memory.
 
    If the operation is not supported, it returns with
@@ -2485,18 +2992,168 @@ static SLJIT_INLINE sljit_uw sljit_get_label_abs_addr(struct sljit_label *label)
 
 static SLJIT_INLINE sljit_uw sljit_get_jump_addr(struct sljit_jump *jump) { return jump->addr; }
 static SLJIT_INLINE sljit_uw sljit_get_const_addr(struct sljit_const *const_) { return const_->addr; }
+static SLJIT_INLINE sljit_uw sljit_get_call_stub_addr(struct sljit_call_stub *stub) { return stub->jump->addr; }
 
 /* Only the address and executable offset are required to perform dynamic
-   code modifications. See sljit_get_executable_offset function. */
+   code modifications. See sljit_get_executable_offset function.
+
+   Note: patching code which is executed by other threads at the same
+         time is only safe when the code is compiled with the
+         SLJIT_ENTER_CONCURRENT_PATCH option. */
 SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset);
 /* The op opcode must be set to the same value that was passed to sljit_emit_const. */
 SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset);
 
+/* The kind of a patch which updates a jump target. */
+#define SLJIT_PATCH_JUMP_ADDR	0
+
+/* Describes a single code modification for sljit_set_patches. */
+struct sljit_patch {
+	/* Returned by sljit_get_jump_addr or sljit_get_const_addr. */
+	sljit_uw addr;
+	/* SLJIT_PATCH_JUMP_ADDR for jumps, otherwise the
+	   op passed to sljit_emit_const. */
+	sljit_s32 kind;
+	/* Set to SLJIT_SUCCESS or an error code by sljit_set_patches. */
+	sljit_s32 status;
+	/* New jump target or constant value. */
+	sljit_sw value;
+};
+
+/* Performs many sljit_set_jump_addr and sljit_set_const operations at
+   once. The entries are sorted by their address, and the entries on the
+   same or neighbouring pages are grouped into address ranges. The write
+   protection is changed and the instruction cache is flushed only once
+   for each range. The order of the entries in the array is not changed,
+   and the entries are applied in address order. The allocator_data is
+   passed to SLJIT_MALLOC for a temporary buffer used by sorting. When
+   the allocation fails, only neighbouring entries of the array are
+   grouped together.
+
+   The status of an entry is set to SLJIT_ERR_BAD_ARGUMENT when its
+   address is zero, or its kind is invalid, and such entries are
+   ignored. Otherwise the status is set to SLJIT_SUCCESS.
+
+   Returns with the number of failed entries. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_uw sljit_set_patches(struct sljit_patch *patches, sljit_uw count,
+	sljit_sw executable_offset, void *allocator_data);
+
+/* Relocates a copy of a code generated with SLJIT_GENERATE_CODE_PIC option.
+   The code must be copied before it is executed or modified, and the
+   copy must contain the whole generated code (see sljit_get_generated_code_size).
+   The absolute addresses in the relocation table which point into the
+   original code are moved to the copy, other addresses (e.g. targets of
+   rewritable jumps which were set to external functions) are unchanged.
+
+   code is the writable address of the copy
+   code_size is the size returned by sljit_get_generated_code_size
+   old_addr is the address returned by sljit_generate_code
+   executable_offset is the executable offset of the copy
+     (see sljit_get_executable_offset) */
+SLJIT_API_FUNC_ATTRIBUTE void sljit_relocate_code(void *code, sljit_uw code_size,
+	sljit_uw old_addr, sljit_sw executable_offset);
+
 /* Only a single buffer is writable at a time, so sljit_read_only_buffer_end_writing()
    must be called before sljit_read_only_buffer_start_writing() is called again. */
 SLJIT_API_FUNC_ATTRIBUTE void* sljit_read_only_buffer_start_writing(sljit_uw addr, sljit_uw size, sljit_sw executable_offset);
 SLJIT_API_FUNC_ATTRIBUTE void sljit_read_only_buffer_end_writing(sljit_uw addr, sljit_uw size, sljit_sw executable_offset);
 
+/* --------------------------------------------------------------------- */
+/*  Inline caches                                                        */
+/* --------------------------------------------------------------------- */
+
+/*
+   An inline cache (IC) site is a guarded dispatch point, which compares
+   a key (e.g. the type of an object) to the cached keys and jumps to the
+   code belonging to the matching key. When no keys match, the execution
+   continues on the miss path, which usually looks up the target and
+   adds it to the cache. The first key is stored in the site itself
+   (monomorphic state), further keys are stored in a chain of small code
+   stubs generated on demand (polymorphic state). The number of stubs is
+   limited by SLJIT_IC_MAX_STUBS, and the cache refuses new keys when
+   this limit is reached (megamorphic state).
+
+   The site is patched by sljit_set_const / sljit_set_jump_addr, which
+   honour the W^X requirements of the executable allocator, and the
+   updates are ordered such a way that the site never jumps to a target
+   which does not belong to the key:
+     - the target of a free slot is set before its key
+     - a new stub is fully generated before it is linked into the chain
+   However, the patching itself is not synchronized with other threads,
+   so concurrent updates of the same cache must be serialized by the
+   caller, and stubs can only be freed when no threads execute them.
+
+   Note: the key value SLJIT_IC_EMPTY_KEY marks free slots, so it must
+         never be passed as a key, and the compared value must never be
+         equal to it either.
+*/
+
+/* Value of the free key slots. */
+#define SLJIT_IC_EMPTY_KEY	0
+/* Maximum number of stubs. */
+#define SLJIT_IC_MAX_STUBS	8
+
+struct sljit_ic_site {
+	struct sljit_const *key;
+	struct sljit_jump *hit;
+	struct sljit_jump *miss;
+	struct sljit_label *miss_label;
+	sljit_s32 src;
+	sljit_s32 tmp_reg;
+	/* Minimum number of registers required by the stubs. */
+	sljit_s32 scratches;
+	sljit_s32 saveds;
+};
+
+struct sljit_ic {
+	sljit_uw key_addr;
+	sljit_uw hit_addr;
+	sljit_uw miss_addr;
+	/* Address of the miss path. */
+	sljit_uw miss_target;
+	/* First item of the stub chain (or the miss path). */
+	sljit_uw miss_head;
+	sljit_sw executable_offset;
+	/* Key stored in the site. */
+	sljit_sw key;
+	sljit_s32 src;
+	sljit_s32 tmp_reg;
+	sljit_s32 scratches;
+	sljit_s32 saveds;
+	sljit_s32 stub_count;
+	void *stubs[SLJIT_IC_MAX_STUBS];
+};
+
+/* Emits an inline cache site. The key is compared to the cached keys,
+   and the value of tmp_reg is destroyed by the comparison. The site
+   always jumps away, so the code after the site is only reachable
+   through labels. The miss path must be set by sljit_set_ic_miss_label.
+
+   src and tmp_reg must be registers (not virtual registers on x86-32)
+
+   Flags: destroy flags. */
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_ic_site* sljit_emit_ic_site(struct sljit_compiler *compiler,
+	sljit_s32 src, sljit_s32 tmp_reg);
+
+/* Sets the label of the miss path. */
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_ic_miss_label(struct sljit_ic_site *site, struct sljit_label *label);
+
+/* Initializes an inline cache after sljit_generate_code is called, and
+   before the compiler is freed by sljit_free_compiler. The ic structure
+   is allocated by the caller, and it must be kept until the generated
+   code is freed. */
+SLJIT_API_FUNC_ATTRIBUTE void sljit_init_ic(struct sljit_ic *ic, struct sljit_ic_site *site, struct sljit_compiler *compiler);
+
+/* Adds a new key to the inline cache. When the site is matched with the
+   key, the execution continues at target, which must be suitable for a
+   jump target (e.g. the value returned by sljit_get_label_addr). Keys
+   cannot be added twice. Returns SLJIT_ERR_UNSUPPORTED when the cache
+   is full, or with an allocation error if the stub cannot be generated. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_add_ic_key(struct sljit_ic *ic, sljit_sw key, sljit_uw target, void *exec_allocator_data);
+
+/* Removes all keys from the inline cache, and frees the stubs. */
+SLJIT_API_FUNC_ATTRIBUTE void sljit_reset_ic(struct sljit_ic *ic, void *exec_allocator_data);
+
 /* --------------------------------------------------------------------- */
 /*  CPU specific functions                                               */
 /* --------------------------------------------------------------------- */
@@ -2625,6 +3282,9 @@ Notes:
     The SLJIT_FREE() macro is suitable for this purpose:
     SLJIT_FREE(returned_buffer, sljit_get_allocator_data(compiler))
   - Memory allocated by sljit_alloc_memory() is not serialized.
+  - Compilers containing switches (see sljit_emit_switch) or
+    call stubs (see sljit_get_call_stub) cannot be serialized,
+    and NULL is returned.
   - The type of the returned buffer is sljit_uw* to emphasize that
     the buffer is word aligned. However, the 'size' output argument
     contains the byte size, so this value is always divisible by
@@ -2660,6 +3320,83 @@ Notes:
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_compiler *sljit_deserialize_compiler(sljit_uw* buffer, sljit_uw size,
 	sljit_s32 options, void *allocator_data);
 
+/* --------------------------------------------------------------------- */
+/*  Virtual register layer                                               */
+/* --------------------------------------------------------------------- */
+
+/* The virtual register layer records a function which uses an unbounded
+   number of virtual registers, and maps these registers onto the SLJIT_R
+   and SLJIT_S registers of a compiler using linear scan register allocation.
+   Virtual registers which cannot be kept in a machine register are stored
+   in the local stack area for their whole live range (spilled), and accessed
+   by memory operands. Only real machine registers are used, so the emulated
+   registers of x86-32 are avoided.
+
+   Virtual registers are identified by non-negative integers. Destination
+   arguments are always virtual registers, while source arguments are
+   either virtual registers (src is SLJIT_VIRT_REG and srcw is the index
+   of the register), or immediates (src is SLJIT_IMM).
+
+   The recorded function receives arg_count (0 - 4) machine word arguments
+   in virtual registers 0 to arg_count - 1, and returns a machine word.
+   Calls and status flags are not supported: conditional control flow is
+   expressed by sljit_virt_cmp. The live ranges of the virtual registers
+   are extended over loops formed by backward jumps.
+
+   The sljit_virt_generate function emits the recorded function into the
+   compiler passed to sljit_create_virt_compiler, starting with a call to
+   sljit_emit_enter. The compiler can be used normally afterwards, e.g. by
+   calling sljit_generate_code.
+
+   All functions return with an error code. After the first error, all
+   further calls return with the same error code. */
+
+struct sljit_virt_compiler;
+
+/* Source argument type of the virtual register layer. */
+#define SLJIT_VIRT_REG		0x100
+
+/* Creates a virtual register compiler. Returns NULL if unsuccessful. */
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_virt_compiler* sljit_create_virt_compiler(struct sljit_compiler *compiler, sljit_s32 arg_count);
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_virt_compiler(struct sljit_virt_compiler *virt_compiler);
+
+/* Same as sljit_emit_op1 / sljit_emit_op2 except the argument types.
+   The op argument must not set status flags. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_op1(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src, sljit_sw srcw);
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_op2(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src1, sljit_sw src1w, sljit_s32 src2, sljit_sw src2w);
+
+/* Loads a value from / stores a value to the base + offset address,
+   where base is a virtual register. The op argument must be a move
+   operation (see sljit_emit_op1), which specifies the data type. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_load(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 base, sljit_sw offset);
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_store(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 base, sljit_sw offset, sljit_s32 src, sljit_sw srcw);
+
+/* Labels are identified by integers returned by sljit_virt_new_label.
+   Each label must be placed exactly once by sljit_virt_emit_label, and
+   jumps may refer to labels before or after they are placed. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_new_label(struct sljit_virt_compiler *virt_compiler);
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_emit_label(struct sljit_virt_compiler *virt_compiler, sljit_s32 label);
+
+/* Unconditional jump, and compare and jump (see sljit_emit_cmp). */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_jump(struct sljit_virt_compiler *virt_compiler, sljit_s32 label);
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_cmp(struct sljit_virt_compiler *virt_compiler, sljit_s32 type,
+	sljit_s32 src1, sljit_sw src1w, sljit_s32 src2, sljit_sw src2w, sljit_s32 label);
+
+/* Return from the function (see sljit_emit_return). */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_return(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 src, sljit_sw srcw);
+
+/* Allocates the registers and emits the recorded function. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_generate(struct sljit_virt_compiler *virt_compiler);
+
+/* Number of virtual registers stored on the stack by
+   the last successful sljit_virt_generate call. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_get_spill_count(struct sljit_virt_compiler *virt_compiler);
+
 /* --------------------------------------------------------------------- */
 /*  Miscellaneous utility functions                                      */
 /* --------------------------------------------------------------------- */
@@ -2673,6 +3410,19 @@ SLJIT_API_FUNC_ATTRIBUTE const char* sljit_get_platform_name(void);
    Same as offsetof() macro defined in stddef.h */
 #define SLJIT_OFFSETOF(base, member) ((sljit_sw)(&((base*)0x10)->member) - 0x10)
 
+/* Returns with the offset of a thread local variable (e.g. a C variable
+   declared with the __thread storage class) from the thread pointer of
+   the current thread (see SLJIT_GET_THREAD_POINTER). The offset is the
+   same for all threads when the variable is part of the static thread
+   local storage block, which is true for the variables of the executable
+   and the libraries loaded at startup (initial-exec model). Hence the
+   offset can be passed as an immediate to the generated code. Returns
+   with zero, if the offset cannot be computed on the current platform.
+   Note: the thread local variables of dynamically loaded libraries are
+         usually allocated elsewhere, and their offset might be different
+         in each thread */
+SLJIT_API_FUNC_ATTRIBUTE sljit_sw sljit_get_thread_local_offset(void *address);
+
 #if (defined SLJIT_UTIL_STACK && SLJIT_UTIL_STACK)
 
 /* The sljit_stack structure and its manipulation functions provides
@@ -123,6 +123,7 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define LDREXH		0xe1f00f9f
 #define MLA		0xe0200090
 #define MOV		0xe1a00000
+#define MRC_TPIDRURO	0xee1d0f70
 #define MUL		0xe0000090
 #define MVN		0xe1e00000
 #define NOP		0xe1a00000
@@ -162,6 +163,8 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define VLD1_r		0xf4a00c00
 #define VLD1_s		0xf4a00000
 #define VLDR_F32	0xed100a00
+#define VFMA_F32	0xeea00a00
+#define VFNMS_F32	0xee900a00
 #define VMOV_F32	0xeeb00a40
 #define VMOV		0xee000a10
 #define VMOV2		0xec400a10
@@ -174,8 +177,13 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define VORR		0xf2200110
 #define VPOP		0xecbd0b00
 #define VPUSH		0xed2d0b00
+#define VRINTA_F32	0xfeb80a40
+#define VRINTM_F32	0xfebb0a40
+#define VRINTP_F32	0xfeba0a40
+#define VRINTZ_F32	0xeeb60ac0
 #define VSHLL		0xf2800a10
 #define VSHR		0xf2800010
+#define VSQRT_F32	0xeeb10ac0
 #define VSRA		0xf2800110
 #define VST1		0xf4000000
 #define VST1_s		0xf4800000
@@ -1149,6 +1157,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 
 	SLJIT_ASSERT(code_ptr - code <= (sljit_s32)compiler->size);
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_uw);
@@ -1195,6 +1205,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_ATOMIC:
 #if (defined SLJIT_CONFIG_ARM_V7 && SLJIT_CONFIG_ARM_V7)
 	case SLJIT_HAS_MEMORY_BARRIER:
+	case SLJIT_HAS_THREAD_POINTER:
 #endif /* SLJIT_CONFIG_ARM_V7 */
 		return 1;
 
@@ -1205,6 +1216,23 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 		return 1;
 #endif /* SLJIT_CONFIG_ARM_V6 */
 
+	case SLJIT_HAS_POPCNT:
+	case SLJIT_HAS_CRC32C:
+	case SLJIT_HAS_PREFETCH_WRITE:
+		return 2;
+
+	case SLJIT_HAS_FMA:
+#if defined(__ARM_FEATURE_FMA) && __ARM_FEATURE_FMA
+		return 1;
+#else /* !__ARM_FEATURE_FMA */
+		return 2;
+#endif /* __ARM_FEATURE_FMA */
+
+#if defined(__ARM_FEATURE_DIRECTED_ROUNDING) && __ARM_FEATURE_DIRECTED_ROUNDING
+	case SLJIT_HAS_FROUND:
+		return 1;
+#endif /* __ARM_FEATURE_DIRECTED_ROUNDING */
+
 	default:
 		return 0;
 	}
@@ -1727,6 +1755,27 @@ static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sl
 		return push_inst(compiler, CLZ | RD(dst) | RM(dst));
 #endif /* SLJIT_CONFIG_ARM_V6 */
 
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(!(flags & INV_IMM) && !(src2 & SRC2_IMM));
+		SLJIT_ASSERT(src1 == TMP_REG1 && src2 != TMP_REG2 && !(flags & ARGS_SWAPPED));
+		/* dst = src2 - ((src2 & 0xaaaaaaaa) >> 1) */
+		FAIL_IF(load_immediate(compiler, TMP_REG2, 0xaaaaaaaa));
+		FAIL_IF(push_inst(compiler, AND | RD(TMP_REG2) | RN(src2) | RM(TMP_REG2)));
+		FAIL_IF(push_inst(compiler, SUB | RD(dst) | RN(src2) | RM(TMP_REG2) | (1 << 5) | (1 << 7)));
+		/* dst = dst - 3 * ((dst & 0xcccccccc) >> 2) */
+		FAIL_IF(load_immediate(compiler, TMP_REG1, 0xcccccccc));
+		FAIL_IF(push_inst(compiler, AND | RD(TMP_REG1) | RN(dst) | RM(TMP_REG1)));
+		FAIL_IF(push_inst(compiler, SUB | RD(dst) | RN(dst) | RM(TMP_REG1) | (1 << 5) | (2 << 7)));
+		FAIL_IF(push_inst(compiler, SUB | RD(dst) | RN(dst) | RM(TMP_REG1) | (1 << 5) | (1 << 7)));
+		/* dst = (dst + (dst >> 4)) & 0x0f0f0f0f */
+		FAIL_IF(push_inst(compiler, ADD | RD(dst) | RN(dst) | RM(dst) | (1 << 5) | (4 << 7)));
+		FAIL_IF(load_immediate(compiler, TMP_REG1, 0x0f0f0f0f));
+		FAIL_IF(push_inst(compiler, AND | RD(dst) | RN(dst) | RM(TMP_REG1)));
+		/* Sum the byte counters into the most significant byte. */
+		FAIL_IF(push_inst(compiler, ADD | RD(dst) | RN(dst) | RM(dst) | (8 << 7)));
+		FAIL_IF(push_inst(compiler, ADD | RD(dst) | RN(dst) | RM(dst) | (16 << 7)));
+		return push_inst(compiler, MOV | RD(dst) | RM(dst) | (1 << 5) | (24 << 7));
+
 	case SLJIT_REV:
 	case SLJIT_REV_U32:
 	case SLJIT_REV_S32:
@@ -2461,6 +2510,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 {
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2486,6 +2536,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
+	case SLJIT_POPCNT:
 	case SLJIT_REV:
 	case SLJIT_REV_U32:
 	case SLJIT_REV_S32:
@@ -2508,6 +2559,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2573,6 +2625,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 {
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2r(compiler, op, dst_reg, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) >= SLJIT_CRC32C_U8 && GET_OPCODE(op) <= SLJIT_CRC32C)
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
+
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
 
@@ -2705,6 +2761,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 		SLJIT_ASSERT(src & SLJIT_MEM);
 		return emit_op_mem(compiler, PRELOAD | LOAD_DATA, TMP_PC, src, srcw, TMP_REG1);
 	}
@@ -2747,6 +2806,16 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
 		FAIL_IF(emit_op_mem(compiler, WORD_SIZE | LOAD_DATA, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size + size, TMP_REG1));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		/* The generic timer might not be accessible from user mode. */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(load_immediate(compiler, dst_r, 0));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		/* The user read-only thread id register (ARMv6K or later). */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst(compiler, MRC_TPIDRURO | RD(dst_r)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2956,6 +3025,23 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VCVT_F64_F32, op & SLJIT_32, dst_r, src, 0)));
 		op ^= SLJIT_32;
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VSQRT_F32, op & SLJIT_32, dst_r, src, 0)));
+		break;
+#if defined(__ARM_FEATURE_DIRECTED_ROUNDING) && __ARM_FEATURE_DIRECTED_ROUNDING
+	case SLJIT_FLOOR_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VRINTM_F32, op & SLJIT_32, dst_r, src, 0)));
+		break;
+	case SLJIT_CEIL_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VRINTP_F32, op & SLJIT_32, dst_r, src, 0)));
+		break;
+	case SLJIT_TRUNC_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VRINTZ_F32, op & SLJIT_32, dst_r, src, 0)));
+		break;
+	case SLJIT_ROUND_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VRINTA_F32, op & SLJIT_32, dst_r, src, 0)));
+		break;
+#endif /* __ARM_FEATURE_DIRECTED_ROUNDING */
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2972,6 +3058,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2(compiler, op, dst, dstw, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) == SLJIT_MIN_F64 || GET_OPCODE(op) == SLJIT_MAX_F64)
+		return emit_fminmax_generic(compiler, op, dst, dstw, src1, src1w, src2, src2w);
+
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -3008,6 +3098,19 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VABS_F32, op & SLJIT_32, dst_r, src1, 0)));
 		FAIL_IF(push_inst(compiler, CMP | SET_FLAGS | RN(TMP_REG1) | SRC2_IMM | 0));
 		return push_inst(compiler, EMIT_FPU_OPERATION((VNEG_F32 & ~COND_MASK) | 0xb0000000, op & SLJIT_32, dst_r, dst_r, 0));
+#if defined(__ARM_FEATURE_FMA) && __ARM_FEATURE_FMA
+	case SLJIT_MULADD_F64:
+		return push_inst(compiler, EMIT_FPU_OPERATION(VFMA_F32, op & SLJIT_32, dst_r, src2, src1));
+	case SLJIT_MULSUB_F64:
+		return push_inst(compiler, EMIT_FPU_OPERATION(VFNMS_F32, op & SLJIT_32, dst_r, src2, src1));
+#else /* !__ARM_FEATURE_FMA */
+	case SLJIT_MULADD_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VMUL_F32, op & SLJIT_32, TMP_FREG1, src2, src1)));
+		return push_inst(compiler, EMIT_FPU_OPERATION(VADD_F32, op & SLJIT_32, dst_r, dst_r, TMP_FREG1));
+	case SLJIT_MULSUB_F64:
+		FAIL_IF(push_inst(compiler, EMIT_FPU_OPERATION(VMUL_F32, op & SLJIT_32, TMP_FREG1, src2, src1)));
+		return push_inst(compiler, EMIT_FPU_OPERATION(VSUB_F32, op & SLJIT_32, dst_r, dst_r, TMP_FREG1));
+#endif /* __ARM_FEATURE_FMA */
 	}
 
 	if (dst_r != dst)
@@ -3906,6 +4009,17 @@ static sljit_s32 update_mem_addr(struct sljit_compiler *compiler, sljit_s32 *mem
 	return push_inst(compiler, ADD | RD(TMP_REG1) | RN(TMP_REG1) | RM(arg));
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -4925,26 +5039,36 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
+static SLJIT_INLINE void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
+{
+	set_jump_addr(addr, executable_offset, new_target, flush_cache);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
 {
 	set_jump_addr(addr, executable_offset, new_target, 1);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins *inst;
 
 	if (GET_OPCODE(op) != SLJIT_MOV_U8) {
-		set_const_value(addr, executable_offset, (sljit_uw)new_constant, 1);
+		set_const_value(addr, executable_offset, (sljit_uw)new_constant, flush_cache);
 		return;
 	}
 
 	inst = (sljit_ins*)addr;
 	SLJIT_ASSERT((inst[0] & 0xfff00000) == (MOV | SRC2_IMM) || (inst[0] & 0xfff00000) == (MVN | SRC2_IMM));
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 0);
 	*inst = SLJIT_EMIT_CONST_U8(new_constant) | (*inst & 0xf000);
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 1);
 	inst = (sljit_ins*)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 1);
+	PATCH_CACHE_FLUSH(inst, inst + 1);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
 }
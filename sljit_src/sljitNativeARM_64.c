@@ -77,6 +77,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define ADD		0x8b000000
 #define ADDE		0x8b200000
 #define ADDI		0x91000000
+#define ADDV		0x0e31b800
 #define ADR		0x10000000
 #define ADRP		0x90000000
 #define AND		0x8a000000
@@ -85,6 +86,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define ASRV		0x9ac02800
 #define B		0x14000000
 #define B_CC		0x54000000
+#define BFM		0xb3400000
 #define BL		0x94000000
 #define BLR		0xd63f0000
 #define BR		0xd61f0000
@@ -95,6 +97,11 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define CBZ		0xb4000000
 #define CCMPI		0xfa400800
 #define CLZ		0xdac01000
+#define CNT		0x0e205800
+#define CRC32CB		0x1ac05000
+#define CRC32CH		0x1ac05400
+#define CRC32CW		0x1ac05800
+#define CRC32CX		0x9ac05c00
 #define CSEL		0x9a800000
 #define CSINC		0x9a800400
 #define CSINV		0xda800000
@@ -113,11 +120,20 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define FCVTL		0x0e217800
 #define FCVTZS		0x9e780000
 #define FDIV		0x1e601800
+#define FMADD		0x1f400000
+#define FMAXNM		0x1e606800
+#define FMINNM		0x1e607800
 #define FMOV		0x1e604000
 #define FMOV_R		0x9e660000
 #define FMOV_I		0x1e601000
 #define FMUL		0x1e600800
 #define FNEG		0x1e614000
+#define FNMSUB		0x1f608000
+#define FRINTA		0x1e664000
+#define FRINTM		0x1e654000
+#define FRINTP		0x1e64c000
+#define FRINTZ		0x1e65c000
+#define FSQRT		0x1e61c000
 #define FSUB		0x1e603800
 #define INS		0x4e001c00
 #define INS_e		0x6e000400
@@ -127,6 +143,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define LDRI		0xf9400000
 #define LDRI_F64	0xfd400000
 #define LDRI_POST	0xf8400400
+#define LDNP		0xa8400000
 #define LDP		0xa9400000
 #define LDP_F64		0x6d400000
 #define LDP_POST	0xa8c00000
@@ -141,6 +158,12 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define MOVK		0xf2800000
 #define MOVN		0x92800000
 #define MOVZ		0xd2800000
+#define MRS_CNTVCT	0xd53be040
+#ifdef __APPLE__
+#define MRS_TPIDR	0xd53bd060
+#else /* !__APPLE__ */
+#define MRS_TPIDR	0xd53bd040
+#endif /* __APPLE__ */
 #define NOP		0xd503201f
 #define ORN		0xaa200000
 #define ORR		0xaa000000
@@ -161,6 +184,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define SSHLL		0x0f00a400
 #define ST1		0x0c007000
 #define ST1_s		0x0d000000
+#define STNP		0xa8000000
 #define STP		0xa9000000
 #define STP_F64		0x6d000000
 #define STP_PRE		0xa9800000
@@ -602,6 +626,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_ins);
@@ -630,14 +656,27 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_CTZ:
 	case SLJIT_HAS_REV:
 	case SLJIT_HAS_ROT:
+	case SLJIT_HAS_FMA:
+	case SLJIT_HAS_FROUND:
+	case SLJIT_HAS_POPCNT:
 	case SLJIT_HAS_CMOV:
 	case SLJIT_HAS_PREFETCH:
+	case SLJIT_HAS_PREFETCH_WRITE:
+	case SLJIT_HAS_CYCLE_COUNTER:
+	case SLJIT_HAS_THREAD_POINTER:
 	case SLJIT_HAS_COPY_F32:
 	case SLJIT_HAS_COPY_F64:
 	case SLJIT_HAS_ATOMIC:
 	case SLJIT_HAS_MEMORY_BARRIER:
 		return 1;
 
+	case SLJIT_HAS_CRC32C:
+#ifdef __ARM_FEATURE_CRC32
+		return 1;
+#else /* !__ARM_FEATURE_CRC32 */
+		return 2;
+#endif /* __ARM_FEATURE_CRC32 */
+
 	default:
 		return 0;
 	}
@@ -890,6 +929,7 @@ static sljit_s32 emit_op_imm(struct sljit_compiler *compiler, sljit_s32 flags, s
 		case SLJIT_REV_S16:
 		case SLJIT_REV_U32:
 		case SLJIT_REV_S32:
+		case SLJIT_POPCNT:
 		case SLJIT_ADDC:
 		case SLJIT_SUBC:
 		case SLJIT_MUL:
@@ -1093,6 +1133,13 @@ static sljit_s32 emit_op_imm(struct sljit_compiler *compiler, sljit_s32 flags, s
 		if (op == SLJIT_REV_U32 || dst == TMP_REG1)
 			return SLJIT_SUCCESS;
 		return push_inst(compiler, SBFM | (1 << 22) | RD(dst) | RN(dst) | (31 << 10));
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(arg1 == TMP_REG1);
+		/* The bits are counted by the SIMD unit. */
+		FAIL_IF(push_inst(compiler, (FMOV_R ^ (inv_bits ? (W_OP | (1 << 22)) : 0)) | RN(arg2) | VD(TMP_FREG1) | (1 << 16)));
+		FAIL_IF(push_inst(compiler, CNT | VD(TMP_FREG1) | VN(TMP_FREG1)));
+		FAIL_IF(push_inst(compiler, ADDV | VD(TMP_FREG1) | VN(TMP_FREG1)));
+		return push_inst(compiler, FMOV_R | RD(dst) | VN(TMP_FREG1));
 	case SLJIT_ADD:
 		compiler->status_flags_state = SLJIT_CURRENT_FLAGS_ADD;
 		CHECK_FLAGS(1 << 29);
@@ -1164,6 +1211,8 @@ set_flags:
 
 #define STORE		0x10
 #define SIGNED		0x20
+/* Turns a prefetch (signed word load) into a prefetch for store. */
+#define PRFM_PST	0x40
 
 #define BYTE_SIZE	0x0
 #define HALF_SIZE	0x1
@@ -1181,6 +1230,9 @@ static sljit_s32 emit_op_mem(struct sljit_compiler *compiler, sljit_s32 flags, s
 	if (!(flags & STORE))
 		type |= (flags & SIGNED) ? 0x00800000 : 0x00400000;
 
+	if (flags & PRFM_PST)
+		type |= 0x10;
+
 	SLJIT_ASSERT(arg & SLJIT_MEM);
 
 	if (SLJIT_UNLIKELY(arg & OFFS_REG_MASK)) {
@@ -1629,6 +1681,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -1736,6 +1789,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -1790,6 +1844,41 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2u(struct sljit_compiler *compil
 	return sljit_emit_op2(compiler, op, TMP_REG2, 0, src1, src1w, src2, src2w);
 }
 
+#ifdef __ARM_FEATURE_CRC32
+
+static sljit_s32 emit_crc32c(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	static const sljit_ins crc32c_ins[4] = { CRC32CB, CRC32CH, CRC32CW, CRC32CX };
+	static const sljit_s32 mem_flags[4] = { BYTE_SIZE, HALF_SIZE, INT_SIZE, WORD_SIZE };
+	sljit_s32 size = GET_OPCODE(op) - SLJIT_CRC32C_U8;
+
+	ADJUST_LOCAL_OFFSET(src1, src1w);
+	ADJUST_LOCAL_OFFSET(src2, src2w);
+
+	if (src2 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, mem_flags[size], TMP_REG2, src2, src2w, TMP_REG2));
+		src2 = TMP_REG2;
+	} else if (src2 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG2, src2w));
+		src2 = TMP_REG2;
+	}
+
+	if (src1 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, WORD_SIZE, TMP_REG1, src1, src1w, TMP_REG1));
+		src1 = TMP_REG1;
+	} else if (src1 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG1, src1w));
+		src1 = TMP_REG1;
+	}
+
+	return push_inst(compiler, crc32c_ins[size] | RD(dst_reg) | RN(src1) | RM(src2));
+}
+
+#endif /* __ARM_FEATURE_CRC32 */
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst_reg,
 	sljit_s32 src1, sljit_sw src1w,
@@ -1802,6 +1891,15 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 	case SLJIT_MULADD:
 		SLJIT_SKIP_CHECKS(compiler);
 		return sljit_emit_op2(compiler, op, dst_reg, 0, src1, src1w, src2, src2w);
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+#ifdef __ARM_FEATURE_CRC32
+		return emit_crc32c(compiler, op, dst_reg, src1, src1w, src2, src2w);
+#else /* !__ARM_FEATURE_CRC32 */
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG2, TMP_REG1);
+#endif /* __ARM_FEATURE_CRC32 */
 	}
 
 	return SLJIT_SUCCESS;
@@ -1876,6 +1974,37 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_shift_into(struct sljit_compiler *
 	return push_inst(compiler, (ORR ^ inv_bits) | RD(dst_reg) | RN(dst_reg) | RM(TMP_REG1));
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+	sljit_ins inv_bits, ins;
+	sljit_s32 mask;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_bitfield(compiler, op, dst_reg, src_reg, start, length));
+
+	inv_bits = (op & SLJIT_32) ? (W_OP | (1 << 22)) : 0;
+	mask = (op & SLJIT_32) ? 0x1f : 0x3f;
+
+	switch (GET_OPCODE(op)) {
+	case SLJIT_EXTRACT_U:
+		/* UBFX alias. */
+		ins = UBFM | ((sljit_ins)start << 16) | ((sljit_ins)(start + length - 1) << 10);
+		break;
+	case SLJIT_EXTRACT_S:
+		/* SBFX alias. */
+		ins = SBFM | ((sljit_ins)start << 16) | ((sljit_ins)(start + length - 1) << 10);
+		break;
+	default:
+		/* BFI alias. */
+		ins = BFM | ((sljit_ins)(-start & mask) << 16) | ((sljit_ins)(length - 1) << 10);
+		break;
+	}
+
+	return push_inst(compiler, (ins ^ inv_bits) | RD(dst_reg) | RN(src_reg));
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -1927,6 +2056,8 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *c
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 src, sljit_sw srcw)
 {
+	sljit_s32 mem_flags;
+
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op_src(compiler, op, src, srcw));
 	ADJUST_LOCAL_OFFSET(src, srcw);
@@ -1946,8 +2077,19 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 		SLJIT_ASSERT(reg_map[1] == 0 && reg_map[3] == 2 && reg_map[5] == 4);
 
+		/* Signed word sized load is the prefetch instruction. */
+		mem_flags = WORD_SIZE | SIGNED;
+
+		if (op >= SLJIT_PREFETCH_WRITE_L1) {
+			mem_flags |= PRFM_PST;
+			op -= SLJIT_PREFETCH_WRITE_L1 - SLJIT_PREFETCH_L1;
+		}
+
 		/* The reg_map[op] should provide the appropriate constant. */
 		if (op == SLJIT_PREFETCH_L1)
 			op = 1;
@@ -1958,8 +2100,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 		else
 			op = 2;
 
-		/* Signed word sized load is the prefetch instruction. */
-		return emit_op_mem(compiler, WORD_SIZE | SIGNED, op, src, srcw, TMP_REG1);
+		return emit_op_mem(compiler, mem_flags, op, src, srcw, TMP_REG1);
 	}
 
 	return SLJIT_SUCCESS;
@@ -1986,6 +2127,14 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
 		FAIL_IF(emit_op_mem(compiler, WORD_SIZE, dst_r, SLJIT_MEM1(SLJIT_SP), 0x8, TMP_REG2));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
+		FAIL_IF(push_inst(compiler, MRS_CNTVCT | RT(dst_r)));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
+		FAIL_IF(push_inst(compiler, MRS_TPIDR | RT(dst_r)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2209,6 +2358,21 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	case SLJIT_CONV_F64_FROM_F32:
 		FAIL_IF(push_inst(compiler, FCVT | (sljit_ins)((op & SLJIT_32) ? (1 << 22) : (1 << 15)) | VD(dst_r) | VN(src)));
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst(compiler, (FSQRT ^ inv_bits) | VD(dst_r) | VN(src)));
+		break;
+	case SLJIT_FLOOR_F64:
+		FAIL_IF(push_inst(compiler, (FRINTM ^ inv_bits) | VD(dst_r) | VN(src)));
+		break;
+	case SLJIT_CEIL_F64:
+		FAIL_IF(push_inst(compiler, (FRINTP ^ inv_bits) | VD(dst_r) | VN(src)));
+		break;
+	case SLJIT_TRUNC_F64:
+		FAIL_IF(push_inst(compiler, (FRINTZ ^ inv_bits) | VD(dst_r) | VN(src)));
+		break;
+	case SLJIT_ROUND_F64:
+		FAIL_IF(push_inst(compiler, (FRINTA ^ inv_bits) | VD(dst_r) | VN(src)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2253,11 +2417,21 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 	case SLJIT_DIV_F64:
 		FAIL_IF(push_inst(compiler, (FDIV ^ inv_bits) | VD(dst_r) | VN(src1) | VM(src2)));
 		break;
+	case SLJIT_MIN_F64:
+		FAIL_IF(push_inst(compiler, (FMINNM ^ inv_bits) | VD(dst_r) | VN(src1) | VM(src2)));
+		break;
+	case SLJIT_MAX_F64:
+		FAIL_IF(push_inst(compiler, (FMAXNM ^ inv_bits) | VD(dst_r) | VN(src1) | VM(src2)));
+		break;
 	case SLJIT_COPYSIGN_F64:
 		FAIL_IF(push_inst(compiler, (FMOV_R ^ ((op & SLJIT_32) ? (W_OP | (1 << 22)) : 0)) | VN(src2) | RD(TMP_REG1)));
 		FAIL_IF(push_inst(compiler, (FABS ^ inv_bits) | VD(dst_r) | VN(src1)));
 		FAIL_IF(push_inst(compiler, TBZ | ((op & SLJIT_32) ? 0 : ((sljit_ins)1 << 31)) | (0x1f << 19) | (2 << 5) | RT(TMP_REG1)));
 		return push_inst(compiler, (FNEG ^ inv_bits) | VD(dst_r) | VN(dst_r));
+	case SLJIT_MULADD_F64:
+		return push_inst(compiler, (FMADD ^ inv_bits) | VD(dst_r) | VN(src1) | VM(src2) | VT2(dst_r));
+	case SLJIT_MULSUB_F64:
+		return push_inst(compiler, (FNMSUB ^ inv_bits) | VD(dst_r) | VN(src1) | VM(src2) | VT2(dst_r));
 	}
 
 	if (!(dst & SLJIT_MEM))
@@ -2760,6 +2934,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 	return push_inst(compiler, (FCSEL ^ inv_bits) | (cc << 12) | VD(dst_freg) | VN(src2_freg) | VM(src1));
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG2, TMP_REG1, TMP_FREG1);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -2791,7 +2976,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 			/* Remains negative for integer min. */
 			memw = -memw;
 			inst = SUBI;
-		} else if ((memw & 0x7) == 0 && memw <= 0x7ff0) {
+		} else if ((memw & 0x7) == 0 && memw <= 0x7ff0 && !(type & SLJIT_MEM_NON_TEMPORAL)) {
 			if (!(type & SLJIT_MEM_STORE) && (mem & REG_MASK) == REG_PAIR_FIRST(reg)) {
 				FAIL_IF(push_inst(compiler, LDRI | RD(REG_PAIR_SECOND(reg)) | RN(mem & REG_MASK) | ((sljit_ins)memw << 7)));
 				return push_inst(compiler, LDRI | RD(REG_PAIR_FIRST(reg)) | RN(mem & REG_MASK) | ((sljit_ins)(memw + 0x8) << 7));
@@ -2828,7 +3013,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 	}
 
 	SLJIT_ASSERT((memw & 0x7) == 0 && memw <= 0x1f8 && memw >= -0x200);
-	return push_inst(compiler, ((type & SLJIT_MEM_STORE) ? STP : LDP) | RT(REG_PAIR_FIRST(reg)) | RT2(REG_PAIR_SECOND(reg)) | RN(mem & REG_MASK) | (sljit_ins)((memw & 0x3f8) << 12));
+
+	if (type & SLJIT_MEM_NON_TEMPORAL)
+		inst = (type & SLJIT_MEM_STORE) ? STNP : LDNP;
+	else
+		inst = (type & SLJIT_MEM_STORE) ? STP : LDP;
+
+	return push_inst(compiler, inst | RT(REG_PAIR_FIRST(reg)) | RT2(REG_PAIR_SECOND(reg)) | RN(mem & REG_MASK) | (sljit_ins)((memw & 0x3f8) << 12));
 }
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_update(struct sljit_compiler *compiler, sljit_s32 type,
@@ -3744,13 +3935,13 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins* inst = (sljit_ins*)addr;
 	sljit_u32 dst;
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 0);
 
 	dst = inst[0] & 0x1f;
 	SLJIT_ASSERT((inst[0] & 0xffe00000) == MOVZ && (inst[1] & 0xffe00000) == (MOVK | (1 << 21)));
@@ -3759,12 +3950,17 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	inst[2] = MOVK | dst | (((sljit_u32)(new_target >> 32) & 0xffff) << 5) | (2 << 21);
 	inst[3] = MOVK | dst | ((sljit_u32)(new_target >> 48) << 5) | (3 << 21);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 1);
 	inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 4);
+	PATCH_CACHE_FLUSH(inst, inst + 4);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
+}
+
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins* inst;
 
@@ -3773,11 +3969,11 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst = (sljit_ins*)addr;
 		SLJIT_ASSERT((inst[0] & 0xffe00000) == MOVZ || (inst[0] & 0xffe00000) == MOVN);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 0);
 		inst[0] = SLJIT_EMIT_CONST_U8(new_constant) | (inst[0] & 0x1f);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 1);
+		PATCH_CACHE_FLUSH(inst, inst + 1);
 		return;
 
 	case SLJIT_MOV32:
@@ -3790,16 +3986,21 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst = (sljit_ins*)addr;
 		SLJIT_ASSERT(((inst[0] & 0xffe00000) == MOVZ || (inst[0] & 0xffe00000) == MOVN) && (inst[1] & 0xffe00000) == (MOVK | (1 << 21)));
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[0] = SLJIT_EMIT_CONST_S32(new_constant) | (inst[0] & 0x1f);
 		inst[1] = MOVK | (1 << 21) | (sljit_ins)((new_constant >> 11) & 0x1fffe0) | (inst[1] & 0x1f);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 
 	default:
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 }
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
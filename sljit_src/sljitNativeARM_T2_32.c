@@ -165,6 +165,7 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define MOVSI		0x2000
 #define MOVT		0xf2c00000
 #define MOVW		0xf2400000
+#define MRC_TPIDRURO	0xee1d0f70
 #define MOV_W		0xea4f0000
 #define MOV_WI		0xf04f0000
 #define MUL		0xfb00f000
@@ -236,6 +237,8 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define VLD1_r		0xf9a00c00
 #define VLD1_s		0xf9a00000
 #define VLDR_F32	0xed100a00
+#define VFMA_F32	0xeea00a00
+#define VFNMS_F32	0xee900a00
 #define VMOV_F32	0xeeb00a40
 #define VMOV		0xee000a10
 #define VMOV2		0xec400a10
@@ -248,8 +251,13 @@ static const sljit_u8 freg_ebit_map[((SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2) << 1)
 #define VORR		0xef200110
 #define VPOP		0xecbd0b00
 #define VPUSH		0xed2d0b00
+#define VRINTA_F32	0xfeb80a40
+#define VRINTM_F32	0xfebb0a40
+#define VRINTP_F32	0xfeba0a40
+#define VRINTZ_F32	0xeeb60ac0
 #define VSHLL		0xef800a10
 #define VSHR		0xef800010
+#define VSQRT_F32	0xeeb10ac0
 #define VSRA		0xef800110
 #define VST1		0xf9000000
 #define VST1_s		0xf9800000
@@ -716,6 +724,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_u16);
@@ -754,8 +764,26 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_COPY_F64:
 	case SLJIT_HAS_ATOMIC:
 	case SLJIT_HAS_MEMORY_BARRIER:
+	case SLJIT_HAS_THREAD_POINTER:
 		return 1;
 
+	case SLJIT_HAS_POPCNT:
+	case SLJIT_HAS_CRC32C:
+	case SLJIT_HAS_PREFETCH_WRITE:
+		return 2;
+
+	case SLJIT_HAS_FMA:
+#if defined(__ARM_FEATURE_FMA) && __ARM_FEATURE_FMA
+		return 1;
+#else /* !__ARM_FEATURE_FMA */
+		return 2;
+#endif /* __ARM_FEATURE_FMA */
+
+#if defined(__ARM_FEATURE_DIRECTED_ROUNDING) && __ARM_FEATURE_DIRECTED_ROUNDING
+	case SLJIT_HAS_FROUND:
+		return 1;
+#endif /* __ARM_FEATURE_DIRECTED_ROUNDING */
+
 	default:
 		return 0;
 	}
@@ -870,6 +898,7 @@ static sljit_s32 emit_op_imm(struct sljit_compiler *compiler, sljit_s32 flags, s
 		switch (flags & 0xffff) {
 		case SLJIT_CLZ:
 		case SLJIT_CTZ:
+		case SLJIT_POPCNT:
 		case SLJIT_REV:
 		case SLJIT_REV_U16:
 		case SLJIT_REV_S16:
@@ -1103,6 +1132,24 @@ static sljit_s32 emit_op_imm(struct sljit_compiler *compiler, sljit_s32 flags, s
 		SLJIT_ASSERT(arg1 == TMP_REG2);
 		FAIL_IF(push_inst32(compiler, RBIT | RN4(arg2) | RD4(dst) | RM4(arg2)));
 		return push_inst32(compiler, CLZ | RN4(dst) | RD4(dst) | RM4(dst));
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(arg1 == TMP_REG2);
+		/* When dst is the same as arg2, TMP_REG1 is not used by arg2. */
+		reg = (dst == (sljit_s32)arg2) ? TMP_REG1 : dst;
+		/* dst = arg2 - ((arg2 & 0xaaaaaaaa) >> 1) */
+		FAIL_IF(push_inst32(compiler, ANDI | RD4(reg) | RN4(arg2) | get_imm(0xaaaaaaaa)));
+		FAIL_IF(push_inst32(compiler, SUB_W | RD4(dst) | RN4(arg2) | RM4(reg) | 0x10 | IMM5(1)));
+		/* dst = dst - 3 * ((dst & 0xcccccccc) >> 2) */
+		FAIL_IF(push_inst32(compiler, ANDI | RD4(TMP_REG1) | RN4(dst) | get_imm(0xcccccccc)));
+		FAIL_IF(push_inst32(compiler, SUB_W | RD4(dst) | RN4(dst) | RM4(TMP_REG1) | 0x10 | IMM5(2)));
+		FAIL_IF(push_inst32(compiler, SUB_W | RD4(dst) | RN4(dst) | RM4(TMP_REG1) | 0x10 | IMM5(1)));
+		/* dst = (dst + (dst >> 4)) & 0x0f0f0f0f */
+		FAIL_IF(push_inst32(compiler, ADD_W | RD4(dst) | RN4(dst) | RM4(dst) | 0x10 | IMM5(4)));
+		FAIL_IF(push_inst32(compiler, ANDI | RD4(dst) | RN4(dst) | get_imm(0x0f0f0f0f)));
+		/* Sum the byte counters into the most significant byte. */
+		FAIL_IF(push_inst32(compiler, ADD_W | RD4(dst) | RN4(dst) | RM4(dst) | IMM5(8)));
+		FAIL_IF(push_inst32(compiler, ADD_W | RD4(dst) | RN4(dst) | RM4(dst) | IMM5(16)));
+		return push_inst32(compiler, LSR_WI | RD4(dst) | RM4(dst) | IMM5(24));
 	case SLJIT_REV:
 	case SLJIT_REV_U32:
 	case SLJIT_REV_S32:
@@ -1995,6 +2042,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2081,6 +2129,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2138,6 +2187,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 	case SLJIT_MULADD:
 		SLJIT_SKIP_CHECKS(compiler);
 		return sljit_emit_op2(compiler, op, dst_reg, 0, src1, src1w, src2, src2w);
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2272,6 +2326,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 		return emit_op_mem(compiler, PRELOAD, TMP_PC, src, srcw, TMP_REG1);
 	}
 
@@ -2313,6 +2370,16 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
 		FAIL_IF(emit_op_mem(compiler, WORD_SIZE, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size + size, TMP_REG1));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		/* The generic timer might not be accessible from user mode. */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(load_immediate(compiler, dst_r, 0));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		/* The user read-only thread id register. */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst32(compiler, MRC_TPIDRURO | RT4(dst_r)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2525,6 +2592,23 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 		FAIL_IF(push_inst32(compiler, VCVT_F64_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
 		op ^= SLJIT_32;
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst32(compiler, VSQRT_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
+		break;
+#if defined(__ARM_FEATURE_DIRECTED_ROUNDING) && __ARM_FEATURE_DIRECTED_ROUNDING
+	case SLJIT_FLOOR_F64:
+		FAIL_IF(push_inst32(compiler, VRINTM_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
+		break;
+	case SLJIT_CEIL_F64:
+		FAIL_IF(push_inst32(compiler, VRINTP_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
+		break;
+	case SLJIT_TRUNC_F64:
+		FAIL_IF(push_inst32(compiler, VRINTZ_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
+		break;
+	case SLJIT_ROUND_F64:
+		FAIL_IF(push_inst32(compiler, VRINTA_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(src)));
+		break;
+#endif /* __ARM_FEATURE_DIRECTED_ROUNDING */
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2541,6 +2625,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2(compiler, op, dst, dstw, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) == SLJIT_MIN_F64 || GET_OPCODE(op) == SLJIT_MAX_F64)
+		return emit_fminmax_generic(compiler, op, dst, dstw, src1, src1w, src2, src2w);
+
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2576,6 +2664,19 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 		FAIL_IF(push_inst32(compiler, CMPI_W | RN4(TMP_REG1) | 0));
 		FAIL_IF(push_inst16(compiler, IT | (0xb << 4) | 0x8));
 		return push_inst32(compiler, VNEG_F32 | (op & SLJIT_32) | VD4(dst_r) | VM4(dst_r));
+#if defined(__ARM_FEATURE_FMA) && __ARM_FEATURE_FMA
+	case SLJIT_MULADD_F64:
+		return push_inst32(compiler, VFMA_F32 | (op & SLJIT_32) | VD4(dst_r) | VN4(src1) | VM4(src2));
+	case SLJIT_MULSUB_F64:
+		return push_inst32(compiler, VFNMS_F32 | (op & SLJIT_32) | VD4(dst_r) | VN4(src1) | VM4(src2));
+#else /* !__ARM_FEATURE_FMA */
+	case SLJIT_MULADD_F64:
+		FAIL_IF(push_inst32(compiler, VMUL_F32 | (op & SLJIT_32) | VD4(TMP_FREG1) | VN4(src1) | VM4(src2)));
+		return push_inst32(compiler, VADD_F32 | (op & SLJIT_32) | VD4(dst_r) | VN4(dst_r) | VM4(TMP_FREG1));
+	case SLJIT_MULSUB_F64:
+		FAIL_IF(push_inst32(compiler, VMUL_F32 | (op & SLJIT_32) | VD4(TMP_FREG1) | VN4(src1) | VM4(src2)));
+		return push_inst32(compiler, VSUB_F32 | (op & SLJIT_32) | VD4(dst_r) | VN4(TMP_FREG1) | VM4(dst_r));
+#endif /* __ARM_FEATURE_FMA */
 	}
 
 	if (!(dst & SLJIT_MEM))
@@ -3421,6 +3522,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 	return push_inst32(compiler, VMOV_F32 | (type & SLJIT_32) | VD4(dst_freg) | VM4(src1));
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -4586,31 +4698,36 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst = (sljit_u16*)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 0);
 	modify_imm32_const(inst, new_target);
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 1);
 	inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 4);
+	PATCH_CACHE_FLUSH(inst, inst + 4);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
+}
+
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst;
 
 	if (GET_OPCODE(op) != SLJIT_MOV_U8) {
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 
 	inst = (sljit_u16*)addr;
 	SLJIT_ASSERT(inst[0] == (MOV_WI >> 16) || inst[0] == (MVN_WI >> 16));
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 
 	if ((new_constant & 0x100) != 0) {
 		inst[0] = (sljit_u16)(MVN_WI >> 16);
@@ -4619,7 +4736,12 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst[0] = (sljit_u16)(MOV_WI >> 16);
 
 	inst[1] = (sljit_u16)((new_constant & 0xff) | (inst[1] & 0xf00));
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 	inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst + 1, inst + 2);
+	PATCH_CACHE_FLUSH(inst + 1, inst + 2);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
 }
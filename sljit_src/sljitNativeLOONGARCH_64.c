@@ -150,6 +150,12 @@ lower parts in the instruction word, denoted by the "L" and "H" suffixes. */
 #define DIV_DU OPC_3R(0x46)
 #define MOD_DU OPC_3R(0x47)
 
+/* CRC instructions */
+#define CRCC_W_B_W OPC_3R(0x4c)
+#define CRCC_W_H_W OPC_3R(0x4d)
+#define CRCC_W_W_W OPC_3R(0x4e)
+#define CRCC_W_D_W OPC_3R(0x4f)
+
 /* Bit-shift instructions */
 #define SLL_W OPC_3R(0x2e)
 #define SRL_W OPC_3R(0x2f)
@@ -181,6 +187,7 @@ lower parts in the instruction word, denoted by the "L" and "H" suffixes. */
 #define REVB_4H OPC_2R(0xd)
 #define REVB_2W OPC_2R(0xe)
 #define REVB_D OPC_2R(0xf)
+#define RDTIME_D OPC_2R(0x1a)
 #define REVH_2W OPC_2R(0x10)
 #define REVH_D OPC_2R(0x11)
 #define BITREV_4B OPC_2R(0x12)
@@ -269,6 +276,14 @@ lower parts in the instruction word, denoted by the "L" and "H" suffixes. */
 #define FMUL_D  OPC_3R(0x20a)
 #define FDIV_S  OPC_3R(0x20d)
 #define FDIV_D  OPC_3R(0x20e)
+#define FMAX_S  OPC_3R(0x211)
+#define FMAX_D  OPC_3R(0x212)
+#define FMIN_S  OPC_3R(0x215)
+#define FMIN_D  OPC_3R(0x216)
+#define FMADD_S  OPC_4R(0x81)
+#define FMADD_D  OPC_4R(0x82)
+#define FMSUB_S  OPC_4R(0x85)
+#define FMSUB_D  OPC_4R(0x86)
 #define FCMP_COND_S  OPC_4R(0xc1)
 #define FCMP_COND_D  OPC_4R(0xc2)
 #define FCOPYSIGN_S  OPC_3R(0x225)
@@ -278,6 +293,8 @@ lower parts in the instruction word, denoted by the "L" and "H" suffixes. */
 #define FABS_D  OPC_2R(0x4502)
 #define FNEG_S  OPC_2R(0x4505)
 #define FNEG_D  OPC_2R(0x4506)
+#define FSQRT_S  OPC_2R(0x4511)
+#define FSQRT_D  OPC_2R(0x4512)
 #define FMOV_S  OPC_2R(0x4525)
 #define FMOV_D  OPC_2R(0x4526)
 
@@ -343,6 +360,7 @@ lower parts in the instruction word, denoted by the "L" and "H" suffixes. */
 #define VFCVTL_D_S OPC_2R(0x1ca77c)
 
 /* Vector Bit Manipulate Instructions */
+#define VPCNT OPC_2R(0x1ca708)
 #define VSLLWIL OPC_2R(0x1cc200)
 
 /* Vector Move And Shuffle Instructions */
@@ -384,6 +402,7 @@ static sljit_u32 cfg2_feature_list = 0;
 
 #define LOONGARCH_HWCAP_LSX		(1 << 4)
 #define LOONGARCH_HWCAP_LASX	(1 << 5)
+#define LOONGARCH_HWCAP_CRC32	(1 << 6)
 
 static sljit_u32 hwcap_feature_list = 0;
 
@@ -811,6 +830,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_ins);
@@ -841,11 +862,21 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_SIMD:
 		return (LOONGARCH_HWCAP_LSX & get_cpu_features(GET_HWCAP));
 
+	case SLJIT_HAS_POPCNT:
+		return (LOONGARCH_HWCAP_LSX & get_cpu_features(GET_HWCAP)) ? 1 : 2;
+
+	case SLJIT_HAS_CRC32C:
+		return (LOONGARCH_HWCAP_CRC32 & get_cpu_features(GET_HWCAP)) ? 1 : 2;
+
 	case SLJIT_HAS_CLZ:
 	case SLJIT_HAS_CTZ:
 	case SLJIT_HAS_REV:
 	case SLJIT_HAS_ROT:
+	case SLJIT_HAS_FMA:
 	case SLJIT_HAS_PREFETCH:
+	case SLJIT_HAS_PREFETCH_WRITE:
+	case SLJIT_HAS_CYCLE_COUNTER:
+	case SLJIT_HAS_THREAD_POINTER:
 	case SLJIT_HAS_COPY_F32:
 	case SLJIT_HAS_COPY_F64:
 	case SLJIT_HAS_ATOMIC:
@@ -897,6 +928,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_cmp_info(sljit_s32 type)
 #define SLOW_SRC2	0x10000
 #define SLOW_DEST	0x20000
 #define MEM_USE_TMP2	0x40000
+#define LAZY_ZERO_FLAG	0x80000
 
 #define STACK_STORE	ST_D
 #define STACK_LOAD	LD_D
@@ -1363,6 +1395,54 @@ static SLJIT_INLINE sljit_s32 emit_op_mem2(struct sljit_compiler *compiler, slji
 	op_imm = (imm); \
 	op_reg = (reg)
 
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 dst, sljit_sw src)
+{
+	sljit_uw all_ones = ~(sljit_uw)0;
+	sljit_ins word_size = 64;
+	sljit_ins shift;
+
+	SLJIT_ASSERT(dst != TMP_REG1 && src != TMP_REG1);
+
+	if (LOONGARCH_HWCAP_LSX & get_cpu_features(GET_HWCAP)) {
+		/* The bits are counted by the vector unit. */
+		FAIL_IF(push_inst(compiler, INST(MOVGR2FR, op) | FRD(TMP_FREG1) | RJ(src)));
+		FAIL_IF(push_inst(compiler, VPCNT | ((op & SLJIT_32) ? (2 << 10) : (3 << 10)) | FRD(TMP_FREG1) | FRJ(TMP_FREG1)));
+		return push_inst(compiler, ((op & SLJIT_32) ? MOVFR2GR_S : MOVFR2GR_D) | RD(dst) | FRJ(TMP_FREG1));
+	}
+
+	if (op & SLJIT_32) {
+		all_ones = 0xffffffff;
+		word_size = 32;
+		FAIL_IF(push_inst(compiler, BSTRPICK_D | RD(dst) | RJ(src) | (31 << 16)));
+		src = dst;
+	}
+
+	/* The number of bits are summed in 2, 4 and 8 bit wide fields,
+	   and the bytes are added together. The OTHER_FLAG is the mask. */
+	FAIL_IF(push_inst(compiler, SRLI_D | RD(TMP_REG1) | RJ(src) | IMM_I12(1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 3)));
+	FAIL_IF(push_inst(compiler, AND | RD(TMP_REG1) | RJ(TMP_REG1) | RK(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, SUB_D | RD(dst) | RJ(src) | RK(TMP_REG1)));
+
+	FAIL_IF(push_inst(compiler, SRLI_D | RD(TMP_REG1) | RJ(dst) | IMM_I12(2)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 5)));
+	FAIL_IF(push_inst(compiler, AND | RD(TMP_REG1) | RJ(TMP_REG1) | RK(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, AND | RD(dst) | RJ(dst) | RK(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, ADD_D | RD(dst) | RJ(dst) | RK(TMP_REG1)));
+
+	FAIL_IF(push_inst(compiler, SRLI_D | RD(TMP_REG1) | RJ(dst) | IMM_I12(4)));
+	FAIL_IF(push_inst(compiler, ADD_D | RD(dst) | RJ(dst) | RK(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 17)));
+	FAIL_IF(push_inst(compiler, AND | RD(dst) | RJ(dst) | RK(OTHER_FLAG)));
+
+	for (shift = 8; shift < word_size; shift <<= 1) {
+		FAIL_IF(push_inst(compiler, SRLI_D | RD(TMP_REG1) | RJ(dst) | IMM_I12(shift)));
+		FAIL_IF(push_inst(compiler, ADD_D | RD(dst) | RJ(dst) | RK(TMP_REG1)));
+	}
+
+	return push_inst(compiler, ANDI | RD(dst) | RJ(dst) | IMM_I12(0x7f));
+}
+
 static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 flags,
 	sljit_s32 dst, sljit_s32 src1, sljit_sw src2)
 {
@@ -1451,6 +1531,10 @@ static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sl
 		FAIL_IF(push_inst(compiler, REVB_2W | RD(dst) | RJ(src2)));
 		return push_inst(compiler, BSTRPICK_D | RD(dst) | RJ(dst) | (31 << 16));
 
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(src1 == TMP_ZERO && !(flags & SRC2_IMM));
+		return emit_popcnt(compiler, op, dst, src2);
+
 	case SLJIT_ADD:
 		/* Overflow computation (both add and sub): overflow = src1_sign ^ src2_sign ^ result_sign ^ carry_flag */
 		is_overflow = GET_FLAG_TYPE(op) == SLJIT_OVERFLOW;
@@ -1796,12 +1880,16 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 	sljit_s32 src1_r;
 	sljit_sw src2_r = 0;
 	sljit_s32 src2_tmp_reg = (GET_OPCODE(op) >= SLJIT_OP2_BASE && FAST_IS_REG(src1)) ? TMP_REG1 : TMP_REG2;
+	sljit_uw zero_flag_start;
 
 	if (!(flags & ALT_KEEP_CACHE)) {
 		compiler->cache_arg = 0;
 		compiler->cache_argw = 0;
 	}
 
+	if (!(flags & MOVE_OP))
+		remove_zero_flag_copy(compiler);
+
 	if (dst == 0) {
 		SLJIT_ASSERT(HAS_FLAGS(op));
 		flags |= UNUSED_DEST;
@@ -1811,6 +1899,10 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 		flags |= REG_DEST;
 		if (flags & MOVE_OP)
 			src2_tmp_reg = dst_r;
+		else if (IS_LAZY_ZERO_FLAG_OP(op)) {
+			op &= ~SLJIT_SET_Z;
+			flags |= LAZY_ZERO_FLAG;
+		}
 	} else if ((dst & SLJIT_MEM) && !getput_arg_fast(compiler, flags | ARG_TEST, TMP_REG1, dst, dstw))
 		flags |= SLOW_DEST;
 
@@ -1896,6 +1988,13 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 
 	FAIL_IF(emit_single_op(compiler, op, flags, dst_r, src1_r, src2_r));
 
+	if (flags & LAZY_ZERO_FLAG) {
+		zero_flag_start = compiler->size;
+		FAIL_IF(push_inst(compiler, ADDI_D | RD(EQUAL_FLAG) | RJ(dst_r) | IMM_I12(0)));
+		set_zero_flag_copy(compiler, zero_flag_start, dst_r);
+		return SLJIT_SUCCESS;
+	}
+
 	if (dst & SLJIT_MEM) {
 		if (!(flags & SLOW_DEST)) {
 			getput_arg_fast(compiler, flags, dst_r, dst, dstw);
@@ -1956,6 +2055,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -1990,6 +2090,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
 	case SLJIT_REV:
+	case SLJIT_POPCNT:
 		return emit_op(compiler, op, flags, dst, dstw, TMP_ZERO, 0, src, srcw);
 
 	case SLJIT_REV_U16:
@@ -2014,6 +2115,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2080,6 +2182,39 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2u(struct sljit_compiler *compil
 	return sljit_emit_op2(compiler, op, 0, 0, src1, src1w, src2, src2w);
 }
 
+static sljit_s32 emit_crc32c(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	static const sljit_ins crc32c_ins[4] = { CRCC_W_B_W, CRCC_W_H_W, CRCC_W_W_W, CRCC_W_D_W };
+	static const sljit_s32 mem_flags[4] = { BYTE_DATA, HALF_DATA, INT_DATA, WORD_DATA };
+	sljit_s32 size = GET_OPCODE(op) - SLJIT_CRC32C_U8;
+
+	ADJUST_LOCAL_OFFSET(src1, src1w);
+	ADJUST_LOCAL_OFFSET(src2, src2w);
+
+	if (src2 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, mem_flags[size] | LOAD_DATA, TMP_REG2, src2, src2w));
+		src2 = TMP_REG2;
+	} else if (src2 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG2, src2w));
+		src2 = TMP_REG2;
+	}
+
+	if (src1 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, TMP_REG1, src1, src1w));
+		src1 = TMP_REG1;
+	} else if (src1 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG1, src1w));
+		src1 = TMP_REG1;
+	}
+
+	/* The result is sign extended. */
+	FAIL_IF(push_inst(compiler, crc32c_ins[size] | RD(dst_reg) | RJ(src2) | RK(src1)));
+	return push_inst(compiler, BSTRPICK_D | RD(dst_reg) | RJ(dst_reg) | (31 << 16));
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst_reg,
 	sljit_s32 src1, sljit_sw src1w,
@@ -2093,6 +2228,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		SLJIT_SKIP_CHECKS(compiler);
 		FAIL_IF(sljit_emit_op2(compiler, SLJIT_MUL | (op & SLJIT_32), TMP_REG2, 0, src1, src1w, src2, src2w));
 		return push_inst(compiler, ADD_D | RD(dst_reg) | RJ(dst_reg) | RK(TMP_REG2));
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		if (LOONGARCH_HWCAP_CRC32 & get_cpu_features(GET_HWCAP))
+			return emit_crc32c(compiler, op, dst_reg, src1, src1w, src2, src2w);
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2174,6 +2316,27 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_shift_into(struct sljit_compiler *
 	return push_inst(compiler, OR | RD(dst_reg) | RJ(dst_reg) | RK(TMP_REG1));
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+	sljit_ins bits;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_bitfield(compiler, op, dst_reg, src_reg, start, length));
+
+	bits = ((sljit_ins)(start + length - 1) << 16) | ((sljit_ins)start << 10);
+
+	switch (GET_OPCODE(op)) {
+	case SLJIT_EXTRACT_U:
+		return push_inst(compiler, INST(BSTRPICK, op) | RD(dst_reg) | RJ(src_reg) | bits);
+	case SLJIT_INSERT:
+		return push_inst(compiler, INST(BSTRINS, op) | RD(dst_reg) | RJ(src_reg) | bits);
+	}
+
+	return emit_bitfield_generic(compiler, op, dst_reg, src_reg, start, length);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -2227,6 +2390,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	sljit_s32 src, sljit_sw srcw)
 {
 	sljit_s32 base = src & REG_MASK;
+	sljit_ins hint;
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op_src(compiler, op, src, srcw));
@@ -2247,6 +2411,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
+		/* Hint 0 is load to L1, hint 8 is store to L1. */
+		hint = RD(op >= SLJIT_PREFETCH_WRITE_L1 ? 8 : 0);
+
 		if (SLJIT_UNLIKELY(src & OFFS_REG_MASK)) {
 			srcw &= 0x3;
 			if (SLJIT_UNLIKELY(srcw))
@@ -2254,13 +2424,13 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 			FAIL_IF(push_inst(compiler, ADD_D | RD(TMP_REG1) | RJ(base) | RK(TMP_REG1)));
 		} else {
 			if (base && srcw <= I12_MAX && srcw >= I12_MIN)
-				return push_inst(compiler,PRELD | RJ(base) | IMM_I12(srcw));
+				return push_inst(compiler, PRELD | hint | RJ(base) | IMM_I12(srcw));
 
 			FAIL_IF(load_immediate(compiler, TMP_REG1, srcw));
 			if (base != 0)
 				FAIL_IF(push_inst(compiler, ADD_D | RD(TMP_REG1) | RJ(base) | RK(TMP_REG1)));
 		}
-		return push_inst(compiler, PRELD | RD(0) | RJ(TMP_REG1));
+		return push_inst(compiler, PRELD | hint | RJ(TMP_REG1));
 	}
 	return SLJIT_SUCCESS;
 }
@@ -2288,6 +2458,16 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
 		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size - SSIZE_OF(sw)));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		/* The counter id (written into rj) is discarded. */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst(compiler, RDTIME_D | RD(dst_r) | RJ(TMP_ZERO)));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		/* The thread pointer is stored in r2 (tp). */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst(compiler, ADDI_D | RD(dst_r) | ((sljit_ins)2 << 5)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2562,6 +2742,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	case SLJIT_ABS_F64:
 		FAIL_IF(push_inst(compiler, FINST(FABS, op) | FRD(dst_r) | FRJ(src)));
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst(compiler, FINST(FSQRT, op) | FRD(dst_r) | FRJ(src)));
+		break;
 	case SLJIT_CONV_F64_FROM_F32:
 		/* The SLJIT_32 bit is inverted because sljit_f32 needs to be loaded from the memory. */
 		FAIL_IF(push_inst(compiler, ((op & SLJIT_32) ? FCVT_D_S : FCVT_S_D) | FRD(dst_r) | FRJ(src)));
@@ -2640,6 +2823,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 	case SLJIT_DIV_F64:
 		FAIL_IF(push_inst(compiler, FINST(FDIV, op) | FRD(dst_r) | FRJ(src1) | FRK(src2)));
 		break;
+	case SLJIT_MIN_F64:
+		FAIL_IF(push_inst(compiler, FINST(FMIN, op) | FRD(dst_r) | FRJ(src1) | FRK(src2)));
+		break;
+	case SLJIT_MAX_F64:
+		FAIL_IF(push_inst(compiler, FINST(FMAX, op) | FRD(dst_r) | FRJ(src1) | FRK(src2)));
+		break;
 	}
 
 	if (dst_r != dst)
@@ -2665,11 +2854,19 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compi
 	}
 
 	if (src1 & SLJIT_MEM) {
-		reg = (dst_freg == src2) ? TMP_FREG1 : dst_freg;
+		/* The multiply-add forms also read dst_freg. */
+		reg = (dst_freg == src2 || GET_OPCODE(op) != SLJIT_COPYSIGN_F64) ? TMP_FREG2 : dst_freg;
 		FAIL_IF(emit_op_mem2(compiler, FLOAT_DATA(op) | LOAD_DATA, reg, src1, src1w, 0, 0));
 		src1 = reg;
 	}
 
+	switch (GET_OPCODE(op)) {
+	case SLJIT_MULADD_F64:
+		return push_inst(compiler, FINST(FMADD, op) | FRD(dst_freg) | FRJ(src1) | FRK(src2) | FRA(dst_freg));
+	case SLJIT_MULSUB_F64:
+		return push_inst(compiler, FINST(FMSUB, op) | FRD(dst_freg) | FRJ(src1) | FRK(src2) | FRA(dst_freg));
+	}
+
 	return push_inst(compiler, FINST(FCOPYSIGN, op) | FRD(dst_freg) | FRJ(src1) | FRK(src2));
 }
 
@@ -2857,16 +3054,23 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 {
 	struct sljit_jump *jump;
 	sljit_ins inst;
+	sljit_s32 zero_flag_reg = 0;
 
 	CHECK_ERROR_PTR();
 	CHECK_PTR(check_sljit_emit_jump(compiler, type));
 
+	if ((type & 0xff) == SLJIT_EQUAL || (type & 0xff) == SLJIT_NOT_EQUAL)
+		zero_flag_reg = remove_zero_flag_copy(compiler);
+
 	jump = (struct sljit_jump*)ensure_abuf(compiler, sizeof(struct sljit_jump));
 	PTR_FAIL_IF(!jump);
 	set_jump(jump, compiler, type & SLJIT_REWRITABLE_JUMP);
 	type &= 0xff;
 
-	inst = get_jump_instruction(type);
+	if (zero_flag_reg != 0)
+		inst = (type == SLJIT_EQUAL ? BNE : BEQ) | RJ(zero_flag_reg) | RD(TMP_ZERO);
+	else
+		inst = get_jump_instruction(type);
 
 	if (inst != 0) {
 		PTR_FAIL_IF(push_inst(compiler, inst));
@@ -3278,6 +3482,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 
 #undef FLOAT_DATA
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	sljit_s32 vreg = 0;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	if (get_cpu_features(GET_HWCAP) & LOONGARCH_HWCAP_LSX)
+		vreg = TMP_FREG1;
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, vreg);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -3967,12 +4187,12 @@ static SLJIT_INLINE sljit_s32 emit_const(struct sljit_compiler *compiler, sljit_
 	return push_inst(compiler, ORI | RD(dst) | RJ(dst) | IMM_I12(init_value));
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins *inst = (sljit_ins*)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 0);
 
 	SLJIT_ASSERT((inst[0] & OPC_1RI20(0x7f)) == LU12I_W);
 	inst[0] = (inst[0] & (OPC_1RI20(0x7f) | 0x1f)) | (sljit_ins)(((new_target & 0xffffffff) >> 12) << 5);
@@ -3989,10 +4209,15 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	else
 		inst[3] = (inst[3] & (OPC_2RI16(0x3f) | 0x3ff)) | IMM_I12((new_target & 0xfff) >> 2);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 1);
 
 	inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 4);
+	PATCH_CACHE_FLUSH(inst, inst + 4);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
 }
 
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compiler *compiler, sljit_s32 op,
@@ -4082,7 +4307,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins* inst;
 
@@ -4096,11 +4321,11 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		else
 			new_constant &= 0xff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 0);
 		inst[0] = (inst[0] & 0xffc003ff) | (sljit_ins)((new_constant & 0xfff) << 10);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 1);
+		PATCH_CACHE_FLUSH(inst, inst + 1);
 		return;
 
 	case SLJIT_MOV32:
@@ -4108,16 +4333,21 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst = (sljit_ins *)addr;
 		SLJIT_ASSERT((inst[0] & OPC_1RI20(0xa)) == LU12I_W && (inst[1] & OPC_2RI12(0xe)) == ORI);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[0] = (inst[0] & (OPC_1RI20(0xa) | 0x1f)) | (sljit_ins)((new_constant >> 7) & 0x1ffffe0);
 		inst[1] = (inst[1] & (OPC_2RI12(0xe) | 0x3ff)) | (sljit_ins)((new_constant & 0xfff) << 10);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 
 	default:
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 }
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
@@ -280,12 +280,17 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 4] = {
 #define MULT		(HI(0) | LO(24))
 #define MULTU		(HI(0) | LO(25))
 #endif /* SLJIT_MIPS_REV >= 6 */
+#if (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6)
+#define MAX_S		(HI(17) | FMT_S | LO(30))
+#define MIN_S		(HI(17) | FMT_S | LO(28))
+#endif /* SLJIT_MIPS_REV >= 6 */
 #define MUL_S		(HI(17) | FMT_S | LO(2))
 #define NEG_S		(HI(17) | FMT_S | LO(7))
 #define NOP		(HI(0) | LO(0))
 #define NOR		(HI(0) | LO(39))
 #define OR		(HI(0) | LO(37))
 #define ORI		(HI(13))
+#define RDHWR		(HI(31) | LO(59))
 #if defined(SLJIT_MIPS_REV) && SLJIT_MIPS_REV >= 2
 #define ROTR		(HI(0) | (1 << 21) | LO(2))
 #define ROTRV		(HI(0) | (1 << 6) | LO(6))
@@ -306,6 +311,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 4] = {
 #define SRLV		(HI(0) | LO(6))
 #define SRA		(HI(0) | LO(3))
 #define SRAV		(HI(0) | LO(7))
+#define SQRT_S		(HI(17) | FMT_S | LO(4))
 #define SUB_S		(HI(17) | FMT_S | LO(1))
 #define SUBU		(HI(0) | LO(35))
 #define SW		(HI(43))
@@ -845,6 +851,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_ins);
@@ -886,6 +894,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_CLZ:
 	case SLJIT_HAS_CMOV:
 	case SLJIT_HAS_PREFETCH:
+	case SLJIT_HAS_PREFETCH_WRITE:
 	case SLJIT_HAS_ATOMIC:
 	case SLJIT_HAS_MEMORY_BARRIER:
 		return 1;
@@ -897,7 +906,15 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_REV:
 	case SLJIT_HAS_ROT:
 		return 1;
+	case SLJIT_HAS_CYCLE_COUNTER:
+		return 2;
 #endif /* SLJIT_MIPS_REV >= 2 */
+	case SLJIT_HAS_THREAD_POINTER:
+		return 1;
+	case SLJIT_HAS_POPCNT:
+	case SLJIT_HAS_FMA:
+	case SLJIT_HAS_CRC32C:
+		return 2;
 	default:
 		return 0;
 	}
@@ -942,6 +959,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_cmp_info(sljit_s32 type)
 #define SLOW_SRC1	0x10000
 #define SLOW_SRC2	0x20000
 #define SLOW_DEST	0x40000
+#define LAZY_ZERO_FLAG	0x80000
 
 static sljit_s32 emit_op_mem(struct sljit_compiler *compiler, sljit_s32 flags, sljit_s32 reg_ar, sljit_s32 arg, sljit_sw argw);
 static sljit_s32 emit_stack_frame_release(struct sljit_compiler *compiler, sljit_s32 frame_size, sljit_ins *ins_ptr);
@@ -1734,6 +1752,55 @@ static sljit_s32 emit_rev16(struct sljit_compiler *compiler, sljit_s32 op, sljit
 #endif /* SLJIT_MIPS_REV >= 2 */
 }
 
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 dst, sljit_sw src)
+{
+	sljit_uw all_ones = ~(sljit_uw)0;
+
+#if (defined SLJIT_CONFIG_MIPS_64 && SLJIT_CONFIG_MIPS_64)
+	if (op & SLJIT_32) {
+		all_ones = 0xffffffff;
+		FAIL_IF(push_inst(compiler, DSLL32 | T(src) | D(dst) | SH_IMM(0), DR(dst)));
+		FAIL_IF(push_inst(compiler, DSRL32 | T(dst) | D(dst) | SH_IMM(0), DR(dst)));
+		src = dst;
+		op &= ~SLJIT_32;
+	}
+#else /* !SLJIT_CONFIG_MIPS_64 */
+	SLJIT_UNUSED_ARG(op);
+#endif /* SLJIT_CONFIG_MIPS_64 */
+
+	/* The number of bits are summed in 2, 4 and 8 bit wide fields,
+	   and the bytes are added together. The OTHER_FLAG is the mask. */
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSRL, SRL) | T(src) | D(TMP_REG1) | SH_IMM(1), DR(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 3)));
+	FAIL_IF(push_inst(compiler, AND | S(TMP_REG1) | TA(OTHER_FLAG) | D(TMP_REG1), DR(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSUBU, SUBU) | S(src) | T(TMP_REG1) | D(dst), DR(dst)));
+
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSRL, SRL) | T(dst) | D(TMP_REG1) | SH_IMM(2), DR(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 5)));
+	FAIL_IF(push_inst(compiler, AND | S(TMP_REG1) | TA(OTHER_FLAG) | D(TMP_REG1), DR(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, AND | S(dst) | TA(OTHER_FLAG) | D(dst), DR(dst)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DADDU, ADDU) | S(dst) | T(TMP_REG1) | D(dst), DR(dst)));
+
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSRL, SRL) | T(dst) | D(TMP_REG1) | SH_IMM(4), DR(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DADDU, ADDU) | S(dst) | T(TMP_REG1) | D(dst), DR(dst)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 17)));
+	FAIL_IF(push_inst(compiler, AND | S(dst) | TA(OTHER_FLAG) | D(dst), DR(dst)));
+
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSRL, SRL) | T(dst) | D(TMP_REG1) | SH_IMM(8), DR(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DADDU, ADDU) | S(dst) | T(TMP_REG1) | D(dst), DR(dst)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DSRL, SRL) | T(dst) | D(TMP_REG1) | SH_IMM(16), DR(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SELECT_OP(DADDU, ADDU) | S(dst) | T(TMP_REG1) | D(dst), DR(dst)));
+
+#if (defined SLJIT_CONFIG_MIPS_64 && SLJIT_CONFIG_MIPS_64)
+	if (all_ones != 0xffffffff) {
+		FAIL_IF(push_inst(compiler, DSRL32 | T(dst) | D(TMP_REG1) | SH_IMM(0), DR(TMP_REG1)));
+		FAIL_IF(push_inst(compiler, DADDU | S(dst) | T(TMP_REG1) | D(dst), DR(dst)));
+	}
+#endif /* SLJIT_CONFIG_MIPS_64 */
+
+	return push_inst(compiler, ANDI | S(dst) | T(dst) | IMM(0x7f), DR(dst));
+}
+
 static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 flags,
 	sljit_s32 dst, sljit_s32 src1, sljit_sw src2)
 {
@@ -1869,6 +1936,10 @@ static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sl
 		SLJIT_ASSERT(src1 == TMP_REG1 && !(flags & SRC2_IMM));
 		return emit_rev16(compiler, op, dst, src2);
 
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(src1 == TMP_REG1 && !(flags & SRC2_IMM) && src2 != TMP_REG1 && dst != TMP_REG1);
+		return emit_popcnt(compiler, op, dst, src2);
+
 	case SLJIT_ADD:
 		/* Overflow computation (both add and sub): overflow = src1_sign ^ src2_sign ^ result_sign ^ carry_flag */
 		is_overflow = GET_FLAG_TYPE(op) == SLJIT_OVERFLOW;
@@ -2311,12 +2382,16 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 	sljit_s32 src1_r;
 	sljit_sw src2_r = 0;
 	sljit_s32 src2_tmp_reg = (GET_OPCODE(op) >= SLJIT_OP2_BASE && FAST_IS_REG(src1)) ? TMP_REG1 : TMP_REG2;
+	sljit_uw zero_flag_start;
 
 	if (!(flags & ALT_KEEP_CACHE)) {
 		compiler->cache_arg = 0;
 		compiler->cache_argw = 0;
 	}
 
+	if (!(flags & MOVE_OP))
+		remove_zero_flag_copy(compiler);
+
 	if (dst == 0) {
 		SLJIT_ASSERT(HAS_FLAGS(op));
 		flags |= UNUSED_DEST;
@@ -2327,6 +2402,10 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 		flags |= REG_DEST;
 		if (flags & MOVE_OP)
 			src2_tmp_reg = dst_r;
+		else if (IS_LAZY_ZERO_FLAG_OP(op)) {
+			op &= ~SLJIT_SET_Z;
+			flags |= LAZY_ZERO_FLAG;
+		}
 	}
 	else if ((dst & SLJIT_MEM) && !getput_arg_fast(compiler, flags | ARG_TEST, DR(TMP_REG1), dst, dstw))
 		flags |= SLOW_DEST;
@@ -2418,6 +2497,13 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 
 	FAIL_IF(emit_single_op(compiler, op, flags, dst_r, src1_r, src2_r));
 
+	if (flags & LAZY_ZERO_FLAG) {
+		zero_flag_start = compiler->size;
+		FAIL_IF(push_inst(compiler, OR | S(dst_r) | TA(0) | DA(EQUAL_FLAG), EQUAL_FLAG));
+		set_zero_flag_copy(compiler, zero_flag_start, dst_r);
+		return SLJIT_SUCCESS;
+	}
+
 	if (dst & SLJIT_MEM) {
 		if (!(flags & SLOW_DEST)) {
 			getput_arg_fast(compiler, flags, DR(dst_r), dst, dstw);
@@ -2519,25 +2605,26 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op0(struct sljit_compiler *compile
 }
 
 #if (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 1)
-static sljit_s32 emit_prefetch(struct sljit_compiler *compiler,
+/* The hint is 0 for load and 1 for store. */
+static sljit_s32 emit_prefetch(struct sljit_compiler *compiler, sljit_ins hint,
         sljit_s32 src, sljit_sw srcw)
 {
 	if (!(src & OFFS_REG_MASK)) {
 		if (srcw <= SIMM_MAX && srcw >= SIMM_MIN)
-			return push_inst(compiler, PREF | S(src & REG_MASK) | IMM(srcw), MOVABLE_INS);
+			return push_inst(compiler, PREF | (hint << 16) | S(src & REG_MASK) | IMM(srcw), MOVABLE_INS);
 
 		FAIL_IF(load_immediate(compiler, DR(TMP_REG1), srcw));
-		return push_inst(compiler, PREFX | S(src & REG_MASK) | T(TMP_REG1), MOVABLE_INS);
+		return push_inst(compiler, PREFX | (hint << 11) | S(src & REG_MASK) | T(TMP_REG1), MOVABLE_INS);
 	}
 
 	srcw &= 0x3;
 
 	if (SLJIT_UNLIKELY(srcw != 0)) {
 		FAIL_IF(push_inst(compiler, SLL_W | T(OFFS_REG(src)) | D(TMP_REG1) | SH_IMM(srcw), DR(TMP_REG1)));
-		return push_inst(compiler, PREFX | S(src & REG_MASK) | T(TMP_REG1), MOVABLE_INS);
+		return push_inst(compiler, PREFX | (hint << 11) | S(src & REG_MASK) | T(TMP_REG1), MOVABLE_INS);
 	}
 
-	return push_inst(compiler, PREFX | S(src & REG_MASK) | T(OFFS_REG(src)), MOVABLE_INS);
+	return push_inst(compiler, PREFX | (hint << 11) | S(src & REG_MASK) | T(OFFS_REG(src)), MOVABLE_INS);
 }
 #endif /* SLJIT_MIPS_REV >= 1 */
 
@@ -2549,6 +2636,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2591,6 +2679,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
 	case SLJIT_REV:
+	case SLJIT_POPCNT:
 		return emit_op(compiler, op, flags, dst, dstw, TMP_REG1, 0, src, srcw);
 
 	case SLJIT_REV_U16:
@@ -2615,6 +2704,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2709,6 +2799,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		SLJIT_SKIP_CHECKS(compiler);
 		FAIL_IF(sljit_emit_op2(compiler, SLJIT_MUL | (op & SLJIT_32), TMP_REG2, 0, src1, src1w, src2, src2w));
 		return push_inst(compiler, SELECT_OP(DADDU, ADDU) | S(dst_reg) | T(TMP_REG2) | D(dst_reg), DR(dst_reg));
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2872,8 +2967,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 #if (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 1)
-		return emit_prefetch(compiler, src, srcw);
+		return emit_prefetch(compiler, op >= SLJIT_PREFETCH_WRITE_L1 ? 1 : 0, src, srcw);
 #else /* SLJIT_MIPS_REV < 1 */
 		return SLJIT_SUCCESS;
 #endif /* SLJIT_MIPS_REV >= 1 */
@@ -2903,6 +3001,25 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_ar = DR(FAST_IS_REG(dst) ? dst : TMP_REG2);
 		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, dst_ar, SLJIT_MEM1(SLJIT_SP), compiler->local_size - SSIZE_OF(sw)));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		dst_ar = DR(FAST_IS_REG(dst) ? dst : TMP_REG2);
+#if (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 2)
+		/* Hardware register 2 is the cycle counter. */
+		FAIL_IF(push_inst(compiler, RDHWR | TA(dst_ar) | DA(2), dst_ar));
+#if (defined SLJIT_CONFIG_MIPS_64 && SLJIT_CONFIG_MIPS_64)
+		FAIL_IF(push_inst(compiler, DSLL32 | TA(dst_ar) | DA(dst_ar) | SH_IMM(0), dst_ar));
+		FAIL_IF(push_inst(compiler, DSRL32 | TA(dst_ar) | DA(dst_ar) | SH_IMM(0), dst_ar));
+#endif /* SLJIT_CONFIG_MIPS_64 */
+#else /* SLJIT_MIPS_REV < 2 */
+		FAIL_IF(push_inst(compiler, ADDU_W | SA(0) | TA(0) | DA(dst_ar), dst_ar));
+#endif /* SLJIT_MIPS_REV >= 2 */
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		/* Hardware register 29 is the user local register, which
+		   is emulated by the kernel on cpus before release 2. */
+		dst_ar = DR(FAST_IS_REG(dst) ? dst : TMP_REG2);
+		FAIL_IF(push_inst(compiler, RDHWR | TA(dst_ar) | DA(29), dst_ar));
+		break;
 	}
 
 	if (dst & SLJIT_MEM) {
@@ -3220,6 +3337,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	case SLJIT_ABS_F64:
 		FAIL_IF(push_inst(compiler, ABS_S | FMT(op) | FS(src) | FD(dst_r), MOVABLE_INS));
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst(compiler, SQRT_S | FMT(op) | FS(src) | FD(dst_r), MOVABLE_INS));
+		break;
 	case SLJIT_CONV_F64_FROM_F32:
 		/* The SLJIT_32 bit is inverted because sljit_f32 needs to be loaded from the memory. */
 		FAIL_IF(push_inst(compiler, CVT_S_S | (sljit_ins)((op & SLJIT_32) ? 1 : (1 << 21)) | FS(src) | FD(dst_r), MOVABLE_INS));
@@ -3241,6 +3361,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2(compiler, op, dst, dstw, src1, src1w, src2, src2w));
+
+#if !(defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6)
+	if (GET_OPCODE(op) == SLJIT_MIN_F64 || GET_OPCODE(op) == SLJIT_MAX_F64)
+		return emit_fminmax_generic(compiler, op, dst, dstw, src1, src1w, src2, src2w);
+#endif /* SLJIT_MIPS_REV < 6 */
+
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -3298,8 +3424,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 	case SLJIT_DIV_F64:
 		FAIL_IF(push_inst(compiler, DIV_S | FMT(op) | FT(src2) | FS(src1) | FD(dst_r), MOVABLE_INS));
 		break;
+#if (defined SLJIT_MIPS_REV && SLJIT_MIPS_REV >= 6)
+	case SLJIT_MIN_F64:
+		FAIL_IF(push_inst(compiler, MIN_S | FMT(op) | FT(src2) | FS(src1) | FD(dst_r), MOVABLE_INS));
+		break;
+	case SLJIT_MAX_F64:
+		FAIL_IF(push_inst(compiler, MAX_S | FMT(op) | FT(src2) | FS(src1) | FD(dst_r), MOVABLE_INS));
+		break;
+#endif /* SLJIT_MIPS_REV >= 6 */
 	case SLJIT_COPYSIGN_F64:
 		return emit_copysign(compiler, op, src1, src2, dst_r);
+	case SLJIT_MULADD_F64:
+		FAIL_IF(push_inst(compiler, MUL_S | FMT(op) | FT(src2) | FS(src1) | FD(TMP_FREG1), MOVABLE_INS));
+		return push_inst(compiler, ADD_S | FMT(op) | FT(TMP_FREG1) | FS(dst_r) | FD(dst_r), MOVABLE_INS);
+	case SLJIT_MULSUB_F64:
+		FAIL_IF(push_inst(compiler, MUL_S | FMT(op) | FT(src2) | FS(src1) | FD(TMP_FREG1), MOVABLE_INS));
+		return push_inst(compiler, SUB_S | FMT(op) | FT(dst_r) | FS(TMP_FREG1) | FD(dst_r), MOVABLE_INS);
 	}
 
 	if (dst_r == TMP_FREG2)
@@ -3449,10 +3589,16 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 	sljit_ins inst;
 	sljit_u32 flags = 0;
 	sljit_s32 delay_check = UNMOVABLE_INS;
+	sljit_s32 zero_flag_reg = EQUAL_FLAG;
 
 	CHECK_ERROR_PTR();
 	CHECK_PTR(check_sljit_emit_jump(compiler, type));
 
+	if ((type & 0xff) == SLJIT_EQUAL || (type & 0xff) == SLJIT_NOT_EQUAL) {
+		zero_flag_reg = remove_zero_flag_copy(compiler);
+		zero_flag_reg = (zero_flag_reg != 0) ? DR(zero_flag_reg) : EQUAL_FLAG;
+	}
+
 	jump = (struct sljit_jump*)ensure_abuf(compiler, sizeof(struct sljit_jump));
 	PTR_FAIL_IF(!jump);
 	set_jump(jump, compiler, type & SLJIT_REWRITABLE_JUMP);
@@ -3460,10 +3606,10 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 
 	switch (type) {
 	case SLJIT_EQUAL:
-		BR_NZ(EQUAL_FLAG);
+		BR_NZ(zero_flag_reg);
 		break;
 	case SLJIT_NOT_EQUAL:
-		BR_Z(EQUAL_FLAG);
+		BR_Z(zero_flag_reg);
 		break;
 	case SLJIT_LESS:
 	case SLJIT_GREATER:
@@ -4125,6 +4271,17 @@ static sljit_s32 update_mem_addr(struct sljit_compiler *compiler, sljit_s32 *mem
 #define MEM_CHECK_UNALIGNED(type) ((type) & (SLJIT_MEM_UNALIGNED | SLJIT_MEM_ALIGNED_16 | SLJIT_MEM_ALIGNED_32))
 #endif /* SLJIT_CONFIG_MIPS_32 */
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -4554,7 +4711,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins *inst;
 
@@ -4568,11 +4725,11 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		else
 			new_constant &= 0xff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 0);
 		inst[0] = (inst[0] & 0xffff0000) | IMM(new_constant);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 1);
+		PATCH_CACHE_FLUSH(inst, inst + 1);
 		return;
 
 #if (defined(SLJIT_CONFIG_MIPS_64) && SLJIT_CONFIG_MIPS_64)
@@ -4581,17 +4738,22 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst = (sljit_ins *)addr;
 		SLJIT_ASSERT((inst[0] & 0xffe00000) == LUI && (inst[1] & 0xfc000000) == ORI);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[0] = (inst[0] & 0xffff0000) | IMM(new_constant >> 16);
 		inst[1] = (inst[1] & 0xffff0000) | IMM(new_constant);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 #endif /* SLJIT_CONFIG_MIPS_64 */
 
 	default:
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 }
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
@@ -217,6 +217,10 @@ static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sl
 		FAIL_IF(push_inst(compiler, ((flags & ALT_FORM1) ? SRWI(27) : SRDI(58)) | S(TMP_REG1) | A(TMP_REG1)));
 		return push_inst(compiler, XOR | S(dst) | A(dst) | B(TMP_REG1));
 
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(src1 == TMP_REG1);
+		return emit_popcnt(compiler, flags & ALT_FORM1, dst, src2);
+
 	case SLJIT_ADD:
 		if (flags & ALT_FORM1) {
 			if (flags & ALT_SIGN_EXT) {
@@ -703,17 +707,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fcopy(struct sljit_compiler *compi
 	return push_inst(compiler, ((op & SLJIT_32) ? LWZ : LD) | S(reg) | A(SLJIT_SP) | TMP_MEM_OFFSET);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins *inst = (sljit_ins*)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 5, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 5, 0);
 	inst[0] = (inst[0] & 0xffff0000u) | IMM(new_target >> 48);
 	inst[1] = (inst[1] & 0xffff0000u) | IMM(new_target >> 32);
 	inst[3] = (inst[3] & 0xffff0000u) | IMM(new_target >> 16);
 	inst[4] = (inst[4] & 0xffff0000u) | IMM(new_target);
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 5, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 5, 1);
 	inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 5);
+	PATCH_CACHE_FLUSH(inst, inst + 5);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
 }
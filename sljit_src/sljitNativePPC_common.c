@@ -101,6 +101,13 @@ static void ppc_cache_flush(sljit_ins *from, sljit_ins *to)
 #define TMP_CALL_REG	TMP_REG1
 #endif
 
+/* Thread pointer register of the ABI, not used by the compiler. */
+#if (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
+#define TP_REG_INDEX	13
+#else /* !SLJIT_CONFIG_PPC_64 */
+#define TP_REG_INDEX	2
+#endif /* SLJIT_CONFIG_PPC_64 */
+
 #define TMP_FREG1	(SLJIT_NUMBER_OF_FLOAT_REGISTERS + 1)
 #define TMP_FREG2	(SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2)
 
@@ -161,6 +168,7 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define CMPLI		(HI(10))
 #define CROR		(HI(19) | LO(449))
 #define DCBT		(HI(31) | LO(278))
+#define DCBTST		(HI(31) | LO(246))
 #define DIVD		(HI(31) | LO(489))
 #define DIVDU		(HI(31) | LO(457))
 #define DIVW		(HI(31) | LO(491))
@@ -177,11 +185,23 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define FCTIWZ		(HI(63) | LO(15))
 #define FDIV		(HI(63) | LO(18))
 #define FDIVS		(HI(59) | LO(18))
+#define FMADD		(HI(63) | LO(29))
+#define FMADDS		(HI(59) | LO(29))
 #define FMR		(HI(63) | LO(72))
+#define FMSUB		(HI(63) | LO(28))
+#define FMSUBS		(HI(59) | LO(28))
 #define FMUL		(HI(63) | LO(25))
 #define FMULS		(HI(59) | LO(25))
 #define FNEG		(HI(63) | LO(40))
+#if defined(_ARCH_PWR5X) && _ARCH_PWR5X
+#define FRIM		(HI(63) | LO(488))
+#define FRIN		(HI(63) | LO(392))
+#define FRIP		(HI(63) | LO(456))
+#define FRIZ		(HI(63) | LO(424))
+#endif /* POWER5+ */
 #define FRSP		(HI(63) | LO(12))
+#define FSQRT		(HI(63) | LO(22))
+#define FSQRTS		(HI(59) | LO(22))
 #define FSUB		(HI(63) | LO(20))
 #define FSUBS		(HI(59) | LO(20))
 #define LD		(HI(58) | 0)
@@ -198,6 +218,8 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define MFCR		(HI(31) | LO(19))
 #define MFLR		(HI(31) | LO(339) | 0x80000)
 #define MFXER		(HI(31) | LO(339) | 0x10000)
+/* Same as mfspr rD, 268 (TBL). */
+#define MFTB		(HI(31) | LO(339) | 0xc4000)
 #define MTCTR		(HI(31) | LO(467) | 0x90000)
 #define MTLR		(HI(31) | LO(467) | 0x80000)
 #define MTXER		(HI(31) | LO(467) | 0x10000)
@@ -214,6 +236,8 @@ static const sljit_u8 freg_map[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 3] = {
 #define OR		(HI(31) | LO(444))
 #define ORI		(HI(24))
 #define ORIS		(HI(25))
+#define POPCNTD		(HI(31) | LO(506))
+#define POPCNTW		(HI(31) | LO(378))
 #define RLDCL		(HI(30) | LO(8))
 #define RLDICL		(HI(30) | LO(0 << 1))
 #define RLDICR		(HI(30) | LO(1 << 1))
@@ -372,7 +396,8 @@ static SLJIT_INLINE sljit_ins* detect_jump_type(struct sljit_jump *jump, sljit_i
 		if (!(jump->flags & IS_COND))
 			return code_ptr;
 
-		code_ptr[0] = BCx | (2 << 2) | ((code_ptr[0] ^ (8 << 21)) & 0x03ff0001);
+		/* The branch condition is inverted, so the prediction hint (if any) must be inverted as well. */
+		code_ptr[0] = BCx | (2 << 2) | ((code_ptr[0] ^ ((code_ptr[0] & (2 << 21)) ? (9 << 21) : (8 << 21))) & 0x03ff0001);
 		code_ptr[1] = Bx;
 		jump->addr += sizeof(sljit_ins);
 		jump->flags -= IS_COND;
@@ -738,6 +763,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 
@@ -789,13 +816,30 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_ZERO_REGISTER:
 	case SLJIT_HAS_CLZ:
 	case SLJIT_HAS_ROT:
+	case SLJIT_HAS_FMA:
 	case SLJIT_HAS_PREFETCH:
+	case SLJIT_HAS_PREFETCH_WRITE:
+	case SLJIT_HAS_CYCLE_COUNTER:
+	case SLJIT_HAS_THREAD_POINTER:
 	case SLJIT_HAS_ATOMIC:
 	case SLJIT_HAS_MEMORY_BARRIER:
 		return 1;
 
 	case SLJIT_HAS_CTZ:
+	case SLJIT_HAS_CRC32C:
+		return 2;
+
+	case SLJIT_HAS_POPCNT:
+#if defined(_ARCH_PWR7) && _ARCH_PWR7
+		return 1;
+#else /* !POWER7 */
 		return 2;
+#endif /* POWER7 */
+
+#if defined(_ARCH_PWR5X) && _ARCH_PWR5X
+	case SLJIT_HAS_FROUND:
+		return 1;
+#endif /* POWER5+ */
 
 	default:
 		return 0;
@@ -866,6 +910,8 @@ ALT_FORM5		0x010000 */
 static sljit_s32 emit_op_mem(struct sljit_compiler *compiler, sljit_s32 inp_flags, sljit_s32 reg,
 	sljit_s32 arg, sljit_sw argw, sljit_s32 tmp_reg);
 
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler, sljit_s32 is_32, sljit_s32 dst, sljit_s32 src);
+
 #if (defined SLJIT_CONFIG_PPC_32 && SLJIT_CONFIG_PPC_32)
 #include "sljitNativePPC_32.c"
 #else
@@ -1462,6 +1508,72 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op0(struct sljit_compiler *compile
 	return SLJIT_SUCCESS;
 }
 
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler, sljit_s32 is_32, sljit_s32 dst, sljit_s32 src)
+{
+#if defined(_ARCH_PWR7) && _ARCH_PWR7
+#if (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
+	if (!is_32)
+		return push_inst(compiler, POPCNTD | S(src) | A(dst));
+
+	/* The bits of the upper word are counted separately. */
+	FAIL_IF(push_inst(compiler, POPCNTW | S(src) | A(dst)));
+	return push_inst(compiler, CLRLDI(dst, dst, 32));
+#else /* !SLJIT_CONFIG_PPC_64 */
+	SLJIT_UNUSED_ARG(is_32);
+	return push_inst(compiler, POPCNTW | S(src) | A(dst));
+#endif /* SLJIT_CONFIG_PPC_64 */
+#else /* !POWER7 */
+	sljit_uw all_ones = ~(sljit_uw)0;
+	sljit_s32 word_size = 8 * (sljit_s32)sizeof(sljit_sw);
+	sljit_s32 shift;
+
+	SLJIT_ASSERT(dst != TMP_REG1 && src != TMP_REG1);
+
+#if (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
+	if (is_32) {
+		all_ones = 0xffffffff;
+		word_size = 32;
+		FAIL_IF(push_inst(compiler, CLRLDI(dst, src, 32)));
+		src = dst;
+	}
+#define POPCNT_SHR(shift) SRDI(shift)
+#else /* !SLJIT_CONFIG_PPC_64 */
+	SLJIT_UNUSED_ARG(is_32);
+#define POPCNT_SHR(shift) SRWI(shift)
+#endif /* SLJIT_CONFIG_PPC_64 */
+
+	/* The number of bits are summed in 2, 4 and 8 bit wide fields, and
+	   the bytes are added together. Since TMP_REG1 is the only temporary
+	   register, x - ((x >> 1) & 0x55..) is computed as x - ((x & 0xaa..) >> 1),
+	   and (x & 0x33..) + ((x >> 2) & 0x33..) as x - 3 * ((x & 0xcc..) >> 2). */
+	FAIL_IF(load_immediate(compiler, TMP_REG1, (sljit_sw)(all_ones / 3 * 2)));
+	FAIL_IF(push_inst(compiler, AND | S(src) | A(TMP_REG1) | B(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, POPCNT_SHR(1) | S(TMP_REG1) | A(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SUBF | D(dst) | A(TMP_REG1) | B(src)));
+
+	FAIL_IF(load_immediate(compiler, TMP_REG1, (sljit_sw)(all_ones / 5 * 4)));
+	FAIL_IF(push_inst(compiler, AND | S(dst) | A(TMP_REG1) | B(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, POPCNT_SHR(2) | S(TMP_REG1) | A(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SUBF | D(dst) | A(TMP_REG1) | B(dst)));
+	FAIL_IF(push_inst(compiler, ADD | D(TMP_REG1) | A(TMP_REG1) | B(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, SUBF | D(dst) | A(TMP_REG1) | B(dst)));
+
+	FAIL_IF(push_inst(compiler, POPCNT_SHR(4) | S(dst) | A(TMP_REG1)));
+	FAIL_IF(push_inst(compiler, ADD | D(dst) | A(dst) | B(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, TMP_REG1, (sljit_sw)(all_ones / 17)));
+	FAIL_IF(push_inst(compiler, AND | S(dst) | A(dst) | B(TMP_REG1)));
+
+	for (shift = 8; shift < word_size; shift <<= 1) {
+		FAIL_IF(push_inst(compiler, POPCNT_SHR(shift) | S(dst) | A(TMP_REG1)));
+		FAIL_IF(push_inst(compiler, ADD | D(dst) | A(dst) | B(TMP_REG1)));
+	}
+
+#undef POPCNT_SHR
+
+	return push_inst(compiler, ANDI | S(dst) | A(dst) | 0x7f);
+#endif /* POWER7 */
+}
+
 static sljit_s32 emit_rev(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src, sljit_sw srcw)
@@ -1627,6 +1739,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -1694,6 +1807,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
+	case SLJIT_POPCNT:
 #if (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
 		if (op_flags & SLJIT_32)
 			flags |= ALT_FORM1;
@@ -1770,6 +1884,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2031,6 +2146,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		SLJIT_SKIP_CHECKS(compiler);
 		FAIL_IF(sljit_emit_op2(compiler, SLJIT_MUL | (op & SLJIT_32), TMP_REG2, 0, src1, src1w, src2, src2w));
 		return push_inst(compiler, ADD | D(dst_reg) | A(dst_reg) | B(TMP_REG2));
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2174,25 +2294,25 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *c
 	return SLJIT_SUCCESS;
 }
 
-static sljit_s32 emit_prefetch(struct sljit_compiler *compiler,
+static sljit_s32 emit_prefetch(struct sljit_compiler *compiler, sljit_ins ins,
         sljit_s32 src, sljit_sw srcw)
 {
 	if (!(src & OFFS_REG_MASK)) {
 		if (srcw == 0 && (src & REG_MASK))
-			return push_inst(compiler, DCBT | A(0) | B(src & REG_MASK));
+			return push_inst(compiler, ins | A(0) | B(src & REG_MASK));
 
 		FAIL_IF(load_immediate(compiler, TMP_REG1, srcw));
 		/* Works with SLJIT_MEM0() case as well. */
-		return push_inst(compiler, DCBT | A(src & REG_MASK) | B(TMP_REG1));
+		return push_inst(compiler, ins | A(src & REG_MASK) | B(TMP_REG1));
 	}
 
 	srcw &= 0x3;
 
 	if (srcw == 0)
-		return push_inst(compiler, DCBT | A(src & REG_MASK) | B(OFFS_REG(src)));
+		return push_inst(compiler, ins | A(src & REG_MASK) | B(OFFS_REG(src)));
 
 	FAIL_IF(push_inst(compiler, SLWI_W(srcw) | S(OFFS_REG(src)) | A(TMP_REG1)));
-	return push_inst(compiler, DCBT | A(src & REG_MASK) | B(TMP_REG1));
+	return push_inst(compiler, ins | A(src & REG_MASK) | B(TMP_REG1));
 }
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *compiler, sljit_s32 op,
@@ -2218,7 +2338,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
-		return emit_prefetch(compiler, src, srcw);
+		return emit_prefetch(compiler, DCBT, src, srcw);
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
+		return emit_prefetch(compiler, DCBTST, src, srcw);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2244,6 +2368,18 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
 		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size + LR_SAVE_OFFSET, TMP_REG2));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		if (FAST_IS_REG(dst))
+			return push_inst(compiler, MFTB | D(dst));
+
+		FAIL_IF(push_inst(compiler, MFTB | D(TMP_REG1)));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		if (FAST_IS_REG(dst))
+			return push_inst(compiler, OR | A(dst) | ((sljit_ins)TP_REG_INDEX << 21) | ((sljit_ins)TP_REG_INDEX << 11));
+
+		FAIL_IF(push_inst(compiler, OR | A(TMP_REG1) | ((sljit_ins)TP_REG_INDEX << 21) | ((sljit_ins)TP_REG_INDEX << 11)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2408,6 +2544,24 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	case SLJIT_ABS_F64:
 		FAIL_IF(push_inst(compiler, FABS | FD(dst_r) | FB(src)));
 		break;
+	case SLJIT_SQRT_F64:
+		/* Optional on some 32 bit cores, but available on all POWER and 64 bit cores. */
+		FAIL_IF(push_inst(compiler, SELECT_FOP(op, FSQRTS, FSQRT) | FD(dst_r) | FB(src)));
+		break;
+#if defined(_ARCH_PWR5X) && _ARCH_PWR5X
+	case SLJIT_FLOOR_F64:
+		FAIL_IF(push_inst(compiler, FRIM | FD(dst_r) | FB(src)));
+		break;
+	case SLJIT_CEIL_F64:
+		FAIL_IF(push_inst(compiler, FRIP | FD(dst_r) | FB(src)));
+		break;
+	case SLJIT_TRUNC_F64:
+		FAIL_IF(push_inst(compiler, FRIZ | FD(dst_r) | FB(src)));
+		break;
+	case SLJIT_ROUND_F64:
+		FAIL_IF(push_inst(compiler, FRIN | FD(dst_r) | FB(src)));
+		break;
+#endif /* POWER5+ */
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2424,6 +2578,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2(compiler, op, dst, dstw, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) == SLJIT_MIN_F64 || GET_OPCODE(op) == SLJIT_MAX_F64)
+		return emit_fminmax_generic(compiler, op, dst, dstw, src1, src1w, src2, src2w);
+
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2468,6 +2626,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 #endif /* SLJIT_CONFIG_PPC_32 */
 		FAIL_IF(push_inst(compiler, BCx | (4 << 21) | (0 << 16) | 8));
 		return push_inst(compiler, FNEG | FD(dst_r) | FB(dst_r));
+	case SLJIT_MULADD_F64:
+		return push_inst(compiler, SELECT_FOP(op, FMADDS, FMADD) | FD(dst_r) | FA(src1) | FC(src2) | FB(dst_r));
+	case SLJIT_MULSUB_F64:
+		return push_inst(compiler, SELECT_FOP(op, FMSUBS, FMSUB) | FD(dst_r) | FA(src1) | FC(src2) | FB(dst_r));
 	}
 
 	if (dst & SLJIT_MEM)
@@ -2669,6 +2831,12 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 	if (!bo_bi_flags)
 		return NULL;
 
+	/* The "at" field of the BO operand: 0b11 - likely taken, 0b10 - unlikely taken. */
+	if (type & SLJIT_JUMP_LIKELY)
+		bo_bi_flags |= (3 << 21);
+	else if (type & SLJIT_JUMP_UNLIKELY)
+		bo_bi_flags |= (2 << 21);
+
 	jump = (struct sljit_jump*)ensure_abuf(compiler, sizeof(struct sljit_jump));
 	PTR_FAIL_IF(!jump);
 	set_jump(jump, compiler, (sljit_u32)type & SLJIT_REWRITABLE_JUMP);
@@ -3106,6 +3274,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 
 #endif /* SLJIT_CONFIG_PPC_32 */
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -3470,7 +3649,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_ins *inst;
 
@@ -3484,11 +3663,11 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		else
 			new_constant &= 0xff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 0);
 		inst[0] = (inst[0] & 0xffff0000) | IMM(new_constant);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 1, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 1, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 1);
+		PATCH_CACHE_FLUSH(inst, inst + 1);
 		return;
 
 #if (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
@@ -3497,17 +3676,22 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		inst = (sljit_ins *)addr;
 		SLJIT_ASSERT((inst[0] & 0xfc1f0000) == ADDIS && (inst[1] & 0xfc000000) == ORI);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[0] = (inst[0] & 0xffff0000) | IMM(new_constant >> 16);
 		inst[1] = (inst[1] & 0xffff0000) | IMM(new_constant);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_ins *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 #endif /* SLJIT_CONFIG_PPC_64 */
 
 	default:
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 }
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
@@ -132,7 +132,7 @@ static SLJIT_INLINE sljit_s32 emit_const(struct sljit_compiler *compiler, sljit_
 	return push_inst(compiler, last_ins | RS1(dst) | IMM_I(init_value));
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst = (sljit_u16*)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
@@ -140,7 +140,7 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	if ((new_target & 0x800) != 0)
 		new_target += 0x1000;
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 0);
 
 	SLJIT_ASSERT((inst[0] & 0x7f) == LUI);
 	inst[0] = (sljit_u16)((inst[0] & 0xfff) | (new_target & 0xf000));
@@ -148,7 +148,12 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	SLJIT_ASSERT((inst[2] & 0x707f) == ADDI || (inst[2] & 0x707f) == JALR);
 	inst[3] = (sljit_u16)((inst[3] & 0xf) | (new_target << 4));
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 1);
 	inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 4);
+	PATCH_CACHE_FLUSH(inst, inst + 4);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
 }
@@ -260,7 +260,7 @@ static SLJIT_INLINE sljit_s32 emit_const(struct sljit_compiler *compiler, sljit_
 	return push_inst(compiler, last_ins | RS1(dst) | IMM_I(init_value));
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst = (sljit_u16*)addr;
 	sljit_sw high;
@@ -277,7 +277,7 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	if ((high & 0x800) != 0)
 		high += 0x1000;
 
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 12, 0);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 12, 0);
 
 	SLJIT_ASSERT((inst[0] & 0x7f) == LUI);
 	inst[0] = (sljit_u16)((inst[0] & 0xfff) | (high & 0xf000));
@@ -289,8 +289,13 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_ta
 	inst[5] = (sljit_u16)(new_target >> 16);
 	SLJIT_ASSERT((inst[10] & 0x707f) == ADDI || (inst[10] & 0x707f) == JALR);
 	inst[11] = (sljit_u16)((inst[11] & 0xf) | (new_target << 4));
-	SLJIT_UPDATE_WX_FLAGS(inst, inst + 12, 1);
+	PATCH_UPDATE_WX_FLAGS(inst, inst + 12, 1);
 
 	inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-	SLJIT_CACHE_FLUSH(inst, inst + 12);
+	PATCH_CACHE_FLUSH(inst, inst + 12);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
 }
@@ -126,6 +126,26 @@
 #define RISCV_BITMANIP_B_INFO ""
 #endif /* SLJIT_CONFIG_RISCV_BITMANIP_B && SLJIT_CONFIG_RISCV_BITMANIP_B != 0 */
 
+#if !(defined SLJIT_CONFIG_RISCV_BITMANIP_C) && defined(__riscv_zbc)
+/* Auto detect bit manipulation extension C instruction support. */
+#define SLJIT_CONFIG_RISCV_BITMANIP_C 93
+#endif /* !SLJIT_CONFIG_RISCV_BITMANIP_C && __riscv_zbc */
+
+/* SLJIT_CONFIG_RISCV_BITMANIP_C enables/disables bit manipulation extension C
+   (carry-less multiplication) instruction support. Non-zero values represents
+   the highest version of the feature that is supported by the CPU.
+   Allowed values: 0 - disabled, 93 - 0.93 */
+#if (defined SLJIT_CONFIG_RISCV_BITMANIP_C && SLJIT_CONFIG_RISCV_BITMANIP_C != 0)
+#if SLJIT_CONFIG_RISCV_BITMANIP_C != 93
+#error "Unsupported value for SLJIT_CONFIG_RISCV_BITMANIP_C"
+#endif
+#define RISCV_HAS_BITMANIP_C(x) ((SLJIT_CONFIG_RISCV_BITMANIP_C) >= (x))
+#define RISCV_BITMANIP_C_INFO "_zbc"
+#else /* !SLJIT_CONFIG_RISCV_BITMANIP_C || SLJIT_CONFIG_RISCV_BITMANIP_C == 0 */
+#define RISCV_HAS_BITMANIP_C(x) 0
+#define RISCV_BITMANIP_C_INFO ""
+#endif /* SLJIT_CONFIG_RISCV_BITMANIP_C && SLJIT_CONFIG_RISCV_BITMANIP_C != 0 */
+
 #if !(defined SLJIT_CONFIG_RISCV_ICOND) && defined(__riscv_zicond)
 /* Auto detect integer conditional instruction support. */
 #define SLJIT_CONFIG_RISCV_ICOND 100
@@ -158,9 +178,9 @@ SLJIT_API_FUNC_ATTRIBUTE const char* sljit_get_platform_name(void)
 {
 	/* The arch string is not entirely correct since 'g' contains 'a'. */
 #if (defined SLJIT_CONFIG_RISCV_32 && SLJIT_CONFIG_RISCV_32)
-	return "RISCV (rv32g" RISCV_ATOMIC_INFO RISCV_COMPRESSED_INFO RISCV_VECTOR_INFO RISCV_BITMANIP_A_INFO RISCV_BITMANIP_B_INFO RISCV_ICOND_INFO ")" SLJIT_CPUINFO;
+	return "RISCV (rv32g" RISCV_ATOMIC_INFO RISCV_COMPRESSED_INFO RISCV_VECTOR_INFO RISCV_BITMANIP_A_INFO RISCV_BITMANIP_B_INFO RISCV_BITMANIP_C_INFO RISCV_ICOND_INFO ")" SLJIT_CPUINFO;
 #else /* !SLJIT_CONFIG_RISCV_32 */
-	return "RISCV (rv64g" RISCV_ATOMIC_INFO RISCV_COMPRESSED_INFO RISCV_VECTOR_INFO RISCV_BITMANIP_A_INFO RISCV_BITMANIP_B_INFO RISCV_ICOND_INFO ")" SLJIT_CPUINFO;
+	return "RISCV (rv64g" RISCV_ATOMIC_INFO RISCV_COMPRESSED_INFO RISCV_VECTOR_INFO RISCV_BITMANIP_A_INFO RISCV_BITMANIP_B_INFO RISCV_BITMANIP_C_INFO RISCV_ICOND_INFO ")" SLJIT_CPUINFO;
 #endif /* SLJIT_CONFIG_RISCV_32 */
 }
 
@@ -206,6 +226,7 @@ static const sljit_u8 vreg_map[SLJIT_NUMBER_OF_VECTOR_REGISTERS + 3] = {
 #define FRD(rd)		((sljit_ins)freg_map[rd] << 7)
 #define FRS1(rs1)	((sljit_ins)freg_map[rs1] << 15)
 #define FRS2(rs2)	((sljit_ins)freg_map[rs2] << 20)
+#define FRS3(rs3)	((sljit_ins)freg_map[rs3] << 27)
 #define VRD(rd)		((sljit_ins)vreg_map[rd] << 7)
 #define VRS1(rs1)	((sljit_ins)vreg_map[rs1] << 15)
 #define VRS2(rs2)	((sljit_ins)vreg_map[rs2] << 20)
@@ -297,9 +318,13 @@ static const sljit_u8 vreg_map[SLJIT_NUMBER_OF_VECTOR_REGISTERS + 3] = {
 #define C_SW		(C_OPC(0x0, 0x6))
 #define C_SWSP		(C_OPC(0x2, 0x6))
 #define C_XOR		(C_OPC(0x1, 0x4) | (sljit_u16)(3 << 10) | (sljit_u16)(1 << 5))
+/* CLMUL / CLMULR: zbc */
+#define CLMUL		(F7(0x5) | F3(0x1) | OPC(0x33))
+#define CLMULR		(F7(0x5) | F3(0x2) | OPC(0x33))
 /* CLZ / CTZ: zbb */
 #define CLZ		(F7(0x30) | F3(0x1) | OPC(0x13))
 #define CTZ		(F7(0x30) | F12(0x1) | F3(0x1) | OPC(0x13))
+#define CPOP		(F7(0x30) | F12(0x2) | F3(0x1) | OPC(0x13))
 #define CZERO_EQZ	(F7(0x7) | F3(0x5) | OPC(0x33))
 #define CZERO_NEZ	(F7(0x7) | F3(0x7) | OPC(0x33))
 #define DIV		(F7(0x1) | F3(0x4) | OPC(0x33))
@@ -317,6 +342,10 @@ static const sljit_u8 vreg_map[SLJIT_NUMBER_OF_VECTOR_REGISTERS + 3] = {
 #define FCVT_S_W	(F7(0x68) | OPC(0x53))
 #define FCVT_S_WU	(F7(0x68) | F12(0x1) | OPC(0x53))
 #define FCVT_W_S	(F7(0x60) | F3(0x1) | OPC(0x53))
+#define FMADD_S		(F3(0x7) | OPC(0x43))
+#define FMAX_S		(F7(0x14) | F3(0x1) | OPC(0x53))
+#define FMIN_S		(F7(0x14) | F3(0x0) | OPC(0x53))
+#define FMSUB_S		(F3(0x7) | OPC(0x47))
 #define FMUL_S		(F7(0x8) | F3(0x7) | OPC(0x53))
 #define FMV_X_W		(F7(0x70) | F3(0x0) | OPC(0x53))
 #define FMV_W_X		(F7(0x78) | F3(0x0) | OPC(0x53))
@@ -324,6 +353,7 @@ static const sljit_u8 vreg_map[SLJIT_NUMBER_OF_VECTOR_REGISTERS + 3] = {
 #define FSGNJ_S		(F7(0x10) | F3(0x0) | OPC(0x53))
 #define FSGNJN_S	(F7(0x10) | F3(0x1) | OPC(0x53))
 #define FSGNJX_S	(F7(0x10) | F3(0x2) | OPC(0x53))
+#define FSQRT_S		(F7(0x2c) | F3(0x7) | OPC(0x53))
 #define FSUB_S		(F7(0x4) | F3(0x7) | OPC(0x53))
 #define FSW		(F3(0x2) | OPC(0x27))
 #define JAL		(OPC(0x6f))
@@ -343,6 +373,7 @@ static const sljit_u8 vreg_map[SLJIT_NUMBER_OF_VECTOR_REGISTERS + 3] = {
 #define NOP		ADDI
 #define OR		(F7(0x0) | F3(0x6) | OPC(0x33))
 #define ORI		(F3(0x6) | OPC(0x13))
+#define RDTIME		(F12(0xc01) | F3(0x2) | OPC(0x73))
 #define REM		(F7(0x1) | F3(0x6) | OPC(0x33))
 #define REMU		(F7(0x1) | F3(0x7) | OPC(0x33))
 /* REV8 / ROL / ROR / RORI: zbb */
@@ -1064,6 +1095,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code) * sizeof(sljit_ins);
@@ -1095,12 +1128,24 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_ATOMIC:
 		return RISCV_HAS_ATOMIC(200) ? 1 : 0;
 	case SLJIT_HAS_MEMORY_BARRIER:
+	case SLJIT_HAS_CYCLE_COUNTER:
+	case SLJIT_HAS_THREAD_POINTER:
 		return 1;
 	case SLJIT_HAS_CLZ:
 	case SLJIT_HAS_CTZ:
 	case SLJIT_HAS_REV:
 	case SLJIT_HAS_ROT:
 		return RISCV_HAS_BITMANIP_B(93) ? 1 : 0;
+	case SLJIT_HAS_POPCNT:
+		return RISCV_HAS_BITMANIP_B(93) ? 1 : 2;
+	case SLJIT_HAS_FMA:
+		return 1;
+	case SLJIT_HAS_CRC32C:
+#if (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
+		return RISCV_HAS_BITMANIP_C(93) ? 1 : 2;
+#else /* !SLJIT_CONFIG_RISCV_64 */
+		return 2;
+#endif /* SLJIT_CONFIG_RISCV_64 */
 	case SLJIT_HAS_CMOV:
 		return RISCV_HAS_ICOND(100) ? 2 : 0;
 	case SLJIT_HAS_SIMD:
@@ -1158,6 +1203,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_cmp_info(sljit_s32 type)
 #define SLOW_SRC2	0x10000
 #define SLOW_DEST	0x20000
 #define MEM_USE_TMP2	0x40000
+#define LAZY_ZERO_FLAG	0x80000
 
 #if (defined SLJIT_CONFIG_RISCV_32 && SLJIT_CONFIG_RISCV_32)
 #define STACK_STORE	SW
@@ -1823,6 +1869,52 @@ static sljit_s32 emit_clz_ctz(struct sljit_compiler *compiler, sljit_s32 op, slj
 	return push_inst(compiler, ADDI | WORD | RD(dst) | RS1(OTHER_FLAG) | IMM_I(0));
 }
 
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 dst, sljit_sw src)
+{
+	sljit_uw all_ones = ~(sljit_uw)0;
+	sljit_ins word_size = 8 * sizeof(sljit_sw);
+	sljit_ins shift;
+
+	SLJIT_ASSERT(dst != TMP_REG1 && src != TMP_REG1);
+
+#if (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
+	if (op & SLJIT_32) {
+		all_ones = 0xffffffff;
+		word_size = 32;
+		FAIL_IF(push_inst(compiler, SLLI | RD(dst) | RS1(src) | IMM_I(32)));
+		FAIL_IF(push_inst(compiler, SRLI | RD(dst) | RS1(dst) | IMM_I(32)));
+		src = dst;
+	}
+#else /* !SLJIT_CONFIG_RISCV_64 */
+	SLJIT_UNUSED_ARG(op);
+#endif /* SLJIT_CONFIG_RISCV_64 */
+
+	/* The number of bits are summed in 2, 4 and 8 bit wide fields,
+	   and the bytes are added together. The OTHER_FLAG is the mask. */
+	FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG1) | RS1(src) | IMM_I(1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 3), TMP_REG3));
+	FAIL_IF(push_inst(compiler, AND | RD(TMP_REG1) | RS1(TMP_REG1) | RS2(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, SUB | RD(dst) | RS1(src) | RS2(TMP_REG1)));
+
+	FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG1) | RS1(dst) | IMM_I(2)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 5), TMP_REG3));
+	FAIL_IF(push_inst(compiler, AND | RD(TMP_REG1) | RS1(TMP_REG1) | RS2(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, AND | RD(dst) | RS1(dst) | RS2(OTHER_FLAG)));
+	FAIL_IF(push_inst(compiler, ADD | RD(dst) | RS1(dst) | RS2(TMP_REG1)));
+
+	FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG1) | RS1(dst) | IMM_I(4)));
+	FAIL_IF(push_inst(compiler, ADD | RD(dst) | RS1(dst) | RS2(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, OTHER_FLAG, (sljit_sw)(all_ones / 17), TMP_REG3));
+	FAIL_IF(push_inst(compiler, AND | RD(dst) | RS1(dst) | RS2(OTHER_FLAG)));
+
+	for (shift = 8; shift < word_size; shift <<= 1) {
+		FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG1) | RS1(dst) | IMM_I(shift)));
+		FAIL_IF(push_inst(compiler, ADD | RD(dst) | RS1(dst) | RS2(TMP_REG1)));
+	}
+
+	return push_inst(compiler, ANDI | RD(dst) | RS1(dst) | IMM_I(0x7f));
+}
+
 static sljit_s32 emit_rev(struct sljit_compiler *compiler, sljit_s32 op, sljit_s32 dst, sljit_sw src)
 {
 	SLJIT_UNUSED_ARG(op);
@@ -2011,6 +2103,13 @@ static SLJIT_INLINE sljit_s32 emit_single_op(struct sljit_compiler *compiler, sl
 
 		return emit_clz_ctz(compiler, op, dst, src2);
 
+	case SLJIT_POPCNT:
+		SLJIT_ASSERT(src1 == TMP_ZERO && !(flags & SRC2_IMM));
+		if (RISCV_HAS_BITMANIP_B(93))
+			return push_inst(compiler, CPOP | WORD | RD(dst) | RS1(src2));
+
+		return emit_popcnt(compiler, op, dst, src2);
+
 	case SLJIT_REV:
 	case SLJIT_REV_S32:
 	case SLJIT_REV_U32:
@@ -2480,12 +2579,16 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 	sljit_s32 src1_r;
 	sljit_sw src2_r = 0;
 	sljit_s32 src2_tmp_reg = (GET_OPCODE(op) >= SLJIT_OP2_BASE && FAST_IS_REG(src1)) ? TMP_REG1 : TMP_REG2;
+	sljit_uw zero_flag_start;
 
 	if (!(flags & ALT_KEEP_CACHE)) {
 		compiler->cache_arg = 0;
 		compiler->cache_argw = 0;
 	}
 
+	if (!(flags & MOVE_OP))
+		remove_zero_flag_copy(compiler);
+
 	if (dst == 0) {
 		SLJIT_ASSERT(HAS_FLAGS(op));
 		flags |= UNUSED_DEST;
@@ -2496,6 +2599,10 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 		flags |= REG_DEST;
 		if (flags & MOVE_OP)
 			src2_tmp_reg = dst_r;
+		else if (IS_LAZY_ZERO_FLAG_OP(op)) {
+			op &= ~SLJIT_SET_Z;
+			flags |= LAZY_ZERO_FLAG;
+		}
 	}
 	else if ((dst & SLJIT_MEM) && !getput_arg_fast(compiler, flags | ARG_TEST, TMP_REG1, dst, dstw))
 		flags |= SLOW_DEST;
@@ -2582,6 +2689,13 @@ static sljit_s32 emit_op(struct sljit_compiler *compiler, sljit_s32 op, sljit_s3
 
 	FAIL_IF(emit_single_op(compiler, op, flags, dst_r, src1_r, src2_r));
 
+	if (flags & LAZY_ZERO_FLAG) {
+		zero_flag_start = compiler->size;
+		FAIL_IF(push_inst(compiler, ADDI | RD(EQUAL_FLAG) | RS1(dst_r) | IMM_I(0)));
+		set_zero_flag_copy(compiler, zero_flag_start, dst_r);
+		return SLJIT_SUCCESS;
+	}
+
 	if (dst & SLJIT_MEM) {
 		if (!(flags & SLOW_DEST)) {
 			getput_arg_fast(compiler, flags, dst_r, dst, dstw);
@@ -2651,6 +2765,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2694,6 +2809,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
 	case SLJIT_REV:
+	case SLJIT_POPCNT:
 		return emit_op(compiler, op, flags, dst, dstw, TMP_ZERO, 0, src, srcw);
 
 	case SLJIT_REV_U16:
@@ -2718,6 +2834,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2789,6 +2906,82 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2u(struct sljit_compiler *compil
 	return sljit_emit_op2(compiler, op, 0, 0, src1, src1w, src2, src2w);
 }
 
+#if (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
+
+static sljit_s32 emit_crc32c(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	sljit_s32 mem_flags;
+	sljit_sw bits;
+
+	switch (GET_OPCODE(op)) {
+	case SLJIT_CRC32C_U8:
+		mem_flags = BYTE_DATA;
+		bits = 8;
+		break;
+	case SLJIT_CRC32C_U16:
+		mem_flags = HALF_DATA;
+		bits = 16;
+		break;
+	case SLJIT_CRC32C_U32:
+		mem_flags = INT_DATA;
+		bits = 32;
+		break;
+	default:
+		mem_flags = WORD_DATA;
+		bits = 64;
+		break;
+	}
+
+	if (src2 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, mem_flags | LOAD_DATA, TMP_REG1, src2, src2w));
+		src2 = TMP_REG1;
+	} else if (src2 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG1, src2w, TMP_REG3));
+		src2 = TMP_REG1;
+	}
+
+	if (src1 & SLJIT_MEM) {
+		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, TMP_REG2, src1, src1w));
+		src1 = TMP_REG2;
+	} else if (src1 == SLJIT_IMM) {
+		FAIL_IF(load_immediate(compiler, TMP_REG2, src1w, TMP_REG3));
+		src1 = TMP_REG2;
+	}
+
+	/* The data bits are reflected into the upper bits of a 64 bit value,
+	   and the remainder is computed by a Barrett reduction. */
+	if (bits == 64) {
+		FAIL_IF(push_inst(compiler, SLLI | RD(TMP_REG2) | RS1(src1) | IMM_I(32)));
+		FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG2) | RS1(TMP_REG2) | IMM_I(32)));
+		FAIL_IF(push_inst(compiler, XOR | RD(TMP_REG1) | RS1(TMP_REG2) | RS2(src2)));
+	} else {
+		FAIL_IF(push_inst(compiler, XOR | RD(TMP_REG1) | RS1(src1) | RS2(src2)));
+		FAIL_IF(push_inst(compiler, SLLI | RD(TMP_REG1) | RS1(TMP_REG1) | IMM_I(64 - bits)));
+
+		/* The unused bits of the checksum are shifted into dst_reg. */
+		if (bits < 32)
+			FAIL_IF(push_inst(compiler, SRLI | 0x8 | RD(dst_reg) | RS1(src1) | IMM_I(bits)));
+	}
+
+	FAIL_IF(load_immediate(compiler, TMP_REG2, (sljit_sw)0xa434f61c6f5389f8, TMP_REG3));
+	FAIL_IF(push_inst(compiler, CLMUL | RD(TMP_REG2) | RS1(TMP_REG1) | RS2(TMP_REG2)));
+	FAIL_IF(push_inst(compiler, SLLI | RD(TMP_REG2) | RS1(TMP_REG2) | IMM_I(1)));
+	FAIL_IF(push_inst(compiler, XOR | RD(TMP_REG2) | RS1(TMP_REG2) | RS2(TMP_REG1)));
+	FAIL_IF(load_immediate(compiler, TMP_REG1, (sljit_sw)0x82f63b7800000000, TMP_REG3));
+	FAIL_IF(push_inst(compiler, CLMULR | RD(TMP_REG2) | RS1(TMP_REG2) | RS2(TMP_REG1)));
+
+	if (bits >= 32)
+		return push_inst(compiler, SRLI | RD(dst_reg) | RS1(TMP_REG2) | IMM_I(32));
+
+	FAIL_IF(push_inst(compiler, SRLI | RD(TMP_REG2) | RS1(TMP_REG2) | IMM_I(32)));
+	return push_inst(compiler, XOR | RD(dst_reg) | RS1(dst_reg) | RS2(TMP_REG2));
+}
+
+#endif /* SLJIT_CONFIG_RISCV_64 */
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst_reg,
 	sljit_s32 src1, sljit_sw src1w,
@@ -2808,6 +3001,18 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		SLJIT_SKIP_CHECKS(compiler);
 		FAIL_IF(sljit_emit_op2(compiler, SLJIT_MUL | (op & SLJIT_32), TMP_REG2, 0, src1, src1w, src2, src2w));
 		return push_inst(compiler, ADD | WORD | RD(dst_reg) | RS1(dst_reg) | RS2(TMP_REG2));
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+#if (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
+		if (RISCV_HAS_BITMANIP_C(93)) {
+			ADJUST_LOCAL_OFFSET(src1, src1w);
+			ADJUST_LOCAL_OFFSET(src2, src2w);
+			return emit_crc32c(compiler, op, dst_reg, src1, src1w, src2, src2w);
+		}
+#endif /* SLJIT_CONFIG_RISCV_64 */
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, TMP_REG2);
 	}
 
 	return SLJIT_SUCCESS;
@@ -2988,6 +3193,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 		return SLJIT_SUCCESS;
 	}
 
@@ -3017,6 +3225,15 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
 		FAIL_IF(emit_op_mem(compiler, WORD_DATA | LOAD_DATA, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size - SSIZE_OF(sw)));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst(compiler, RDTIME | RD(dst_r)));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		/* The thread pointer is stored in x4 (tp). */
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_REG2;
+		FAIL_IF(push_inst(compiler, ADDI | RD(dst_r) | ((sljit_ins)4 << 15)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -3253,6 +3470,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	case SLJIT_ABS_F64:
 		FAIL_IF(push_inst(compiler, FSGNJX_S | FMT(op) | FRD(dst_r) | FRS1(src) | FRS2(src)));
 		break;
+	case SLJIT_SQRT_F64:
+		FAIL_IF(push_inst(compiler, FSQRT_S | FMT(op) | FRD(dst_r) | FRS1(src)));
+		break;
 	case SLJIT_CONV_F64_FROM_F32:
 		/* The SLJIT_32 bit is inverted because sljit_f32 needs to be loaded from the memory. */
 		FAIL_IF(push_inst(compiler, FCVT_S_D | ((op & SLJIT_32) ? (1 << 25) : ((1 << 20) | F3(7))) | FRD(dst_r) | FRS1(src)));
@@ -3335,8 +3555,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 		FAIL_IF(push_inst(compiler, FDIV_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2)));
 		break;
 
+	case SLJIT_MIN_F64:
+		FAIL_IF(push_inst(compiler, FMIN_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2)));
+		break;
+
+	case SLJIT_MAX_F64:
+		FAIL_IF(push_inst(compiler, FMAX_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2)));
+		break;
+
 	case SLJIT_COPYSIGN_F64:
 		return push_inst(compiler, FSGNJ_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2));
+
+	case SLJIT_MULADD_F64:
+		return push_inst(compiler, FMADD_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2) | FRS3(dst_r));
+
+	case SLJIT_MULSUB_F64:
+		return push_inst(compiler, FMSUB_S | FMT(op) | FRD(dst_r) | FRS1(src1) | FRS2(src2) | FRS3(dst_r));
 	}
 
 	if (dst_r != dst)
@@ -3514,16 +3748,23 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 {
 	struct sljit_jump *jump;
 	sljit_ins inst;
+	sljit_s32 zero_flag_reg = 0;
 
 	CHECK_ERROR_PTR();
 	CHECK_PTR(check_sljit_emit_jump(compiler, type));
 
+	if ((type & 0xff) == SLJIT_EQUAL || (type & 0xff) == SLJIT_NOT_EQUAL)
+		zero_flag_reg = remove_zero_flag_copy(compiler);
+
 	jump = (struct sljit_jump*)ensure_abuf(compiler, sizeof(struct sljit_jump));
 	PTR_FAIL_IF(!jump);
 	set_jump(jump, compiler, type & SLJIT_REWRITABLE_JUMP);
 	type &= 0xff;
 
-	inst = get_jump_instruction(type);
+	if (zero_flag_reg != 0)
+		inst = (type == SLJIT_EQUAL ? BNE : BEQ) | RS1(zero_flag_reg) | RS2(TMP_ZERO);
+	else
+		inst = get_jump_instruction(type);
 
 	if (inst != 0) {
 		PTR_FAIL_IF(push_inst(compiler, inst | BRANCH_LENGTH));
@@ -4084,6 +4325,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 #undef FLOAT_DATA
 #undef FMT
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -4821,7 +5073,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst;
 
@@ -4835,11 +5087,11 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		else
 			new_constant &= 0xff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[1] = (sljit_u16)(new_constant << 4) | (inst[1] & 0xf);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 
 #if (defined SLJIT_CONFIG_RISCV_64 && SLJIT_CONFIG_RISCV_64)
@@ -4851,18 +5103,23 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		if ((new_constant & 0x800) != 0)
 			new_constant ^= ~(sljit_sw)0xfff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 0);
 		inst[0] = (sljit_u16)((inst[0] & 0xfff) | (new_constant & 0xf000));
 		inst[1] = (sljit_u16)(new_constant >> 16);
 		inst[3] = (sljit_u16)(new_constant << 4) | (inst[3] & 0xf);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 4, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 4, 1);
 		inst = (sljit_u16 *)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 4);
+		PATCH_CACHE_FLUSH(inst, inst + 4);
 		return;
 #endif /* SLJIT_CONFIG_RISCV_64 */
 
 	default:
-		sljit_set_jump_addr(addr, (sljit_uw)new_constant, executable_offset);
+		patch_jump_addr(addr, (sljit_uw)new_constant, executable_offset, flush_cache);
 		return;
 	}
 }
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
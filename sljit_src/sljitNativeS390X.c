@@ -394,6 +394,7 @@ HAVE_FACILITY(have_genext,  GENERAL_INSTRUCTION_EXTENSION_FACILITY)
 HAVE_FACILITY(have_lscond1, LOAD_STORE_ON_CONDITION_1_FACILITY)
 HAVE_FACILITY(have_lscond2, LOAD_STORE_ON_CONDITION_2_FACILITY)
 HAVE_FACILITY(have_misc2,   MISCELLANEOUS_INSTRUCTION_EXTENSIONS_2_FACILITY)
+HAVE_FACILITY(have_popcnt,  POPULATION_COUNT_FACILITY)
 #undef HAVE_FACILITY
 
 #define is_u12(d)	(0 <= (d) && (d) <= 0x00000fffL)
@@ -1634,6 +1635,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = ins_size;
@@ -1661,7 +1664,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_CLZ:
 	case SLJIT_HAS_REV:
 	case SLJIT_HAS_ROT:
+	case SLJIT_HAS_FMA:
+	case SLJIT_HAS_FROUND:
 	case SLJIT_HAS_PREFETCH:
+	case SLJIT_HAS_PREFETCH_WRITE:
+	case SLJIT_HAS_CYCLE_COUNTER:
+	case SLJIT_HAS_THREAD_POINTER:
 	case SLJIT_HAS_COPY_F32:
 	case SLJIT_HAS_COPY_F64:
 	case SLJIT_HAS_SIMD:
@@ -1672,6 +1680,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 	case SLJIT_HAS_CTZ:
 		return 2;
 
+	case SLJIT_HAS_POPCNT:
+		return have_popcnt() ? 1 : 2;
+
+	case SLJIT_HAS_CRC32C:
+		return 2;
+
 	case SLJIT_HAS_CMOV:
 		return have_lscond1() ? 1 : 0;
 	}
@@ -2042,6 +2056,52 @@ static sljit_s32 sljit_emit_clz_ctz(struct sljit_compiler *compiler, sljit_s32 o
 	return push_inst(compiler, ((op & SLJIT_32) ? 0x1800 /* lr */ : 0xb9040000 /* lgr */) | R4A(dst_r) | R0A(tmp0));
 }
 
+static sljit_s32 sljit_emit_popcnt(struct sljit_compiler *compiler, sljit_s32 op, sljit_gpr dst_r, sljit_gpr src_r)
+{
+	sljit_s32 shift;
+
+	if (op & SLJIT_32) {
+		FAIL_IF(push_inst(compiler, 0xb9160000 /* llgfr */ | R4A(tmp0) | R0A(src_r)));
+		src_r = tmp0;
+	}
+
+	if (have_popcnt()) {
+		/* Counts the bits of each byte separately. */
+		FAIL_IF(push_inst(compiler, 0xb9e10000 /* popcnt */ | R4A(tmp0) | R0A(src_r)));
+	} else {
+		if (src_r != tmp0)
+			FAIL_IF(push_inst(compiler, 0xb9040000 /* lgr */ | R4A(tmp0) | R0A(src_r)));
+
+		/* x - ((x & 0xaa..) >> 1) */
+		FAIL_IF(push_load_imm_inst(compiler, tmp1, (sljit_sw)0xaaaaaaaaaaaaaaaa));
+		FAIL_IF(push_inst(compiler, 0xb9800000 /* ngr */ | R4A(tmp1) | R0A(tmp0)));
+		FAIL_IF(push_inst(compiler, 0xeb000000000c /* srlg */ | R36A(tmp1) | R32A(tmp1) | disp_s20(1)));
+		FAIL_IF(push_inst(compiler, 0xb9090000 /* sgr */ | R4A(tmp0) | R0A(tmp1)));
+
+		/* x - 3 * ((x & 0xcc..) >> 2) */
+		FAIL_IF(push_load_imm_inst(compiler, tmp1, (sljit_sw)0xcccccccccccccccc));
+		FAIL_IF(push_inst(compiler, 0xb9800000 /* ngr */ | R4A(tmp1) | R0A(tmp0)));
+		FAIL_IF(push_inst(compiler, 0xeb000000000c /* srlg */ | R36A(tmp1) | R32A(tmp1) | disp_s20(2)));
+		FAIL_IF(push_inst(compiler, 0xb9090000 /* sgr */ | R4A(tmp0) | R0A(tmp1)));
+		FAIL_IF(push_inst(compiler, 0xb9080000 /* agr */ | R4A(tmp1) | R0A(tmp1)));
+		FAIL_IF(push_inst(compiler, 0xb9090000 /* sgr */ | R4A(tmp0) | R0A(tmp1)));
+
+		/* (x + (x >> 4)) & 0x0f.. */
+		FAIL_IF(push_inst(compiler, 0xeb000000000c /* srlg */ | R36A(tmp1) | R32A(tmp0) | disp_s20(4)));
+		FAIL_IF(push_inst(compiler, 0xb9080000 /* agr */ | R4A(tmp0) | R0A(tmp1)));
+		FAIL_IF(push_load_imm_inst(compiler, tmp1, (sljit_sw)0x0f0f0f0f0f0f0f0f));
+		FAIL_IF(push_inst(compiler, 0xb9800000 /* ngr */ | R4A(tmp0) | R0A(tmp1)));
+	}
+
+	/* Sum the byte counters into the most significant byte. */
+	for (shift = 32; shift >= 8; shift >>= 1) {
+		FAIL_IF(push_inst(compiler, sllg(tmp1, tmp0, shift, 0)));
+		FAIL_IF(push_inst(compiler, 0xb9080000 /* agr */ | R4A(tmp0) | R0A(tmp1)));
+	}
+
+	return push_inst(compiler, 0xeb000000000c /* srlg */ | R36A(dst_r) | R32A(tmp0) | disp_s20(56));
+}
+
 static sljit_s32 sljit_emit_rev(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src, sljit_sw srcw)
@@ -2130,6 +2190,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2358,6 +2419,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 		FAIL_IF(sljit_emit_clz_ctz(compiler, op, dst_r, src_r));
 		break;
+	case SLJIT_POPCNT:
+		if (src & SLJIT_MEM)
+			FAIL_IF(load_unsigned_word(compiler, src_r, src, srcw, op & SLJIT_32));
+
+		FAIL_IF(sljit_emit_popcnt(compiler, op, dst_r, src_r));
+		break;
 	case SLJIT_REV_U32:
 	case SLJIT_REV_S32:
 		op |= SLJIT_32;
@@ -2933,6 +3000,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 {
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -3022,6 +3090,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		SLJIT_SKIP_CHECKS(compiler);
 		FAIL_IF(sljit_emit_op2(compiler, SLJIT_MUL | (op & SLJIT_32), 0 /* tmp0 */, 0, src1, src1w, src2, src2w));
 		return push_inst(compiler, ((op & SLJIT_32) ? 0x1a00 /* ar */ : 0xb9080000 /* agr */) | R4A(gpr(dst_reg)) | R0A(tmp0));
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG2, TMP_REG1);
 	}
 
 	return SLJIT_SUCCESS;
@@ -3242,6 +3315,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_ONCE:
 		FAIL_IF(make_addr_bxy(compiler, &addr, src, srcw, tmp1));
 		return push_inst(compiler, 0xe31000000036 /* pfd */ | R32A(addr.index) | R28A(addr.base) | disp_s20(addr.offset));
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
+		FAIL_IF(make_addr_bxy(compiler, &addr, src, srcw, tmp1));
+		return push_inst(compiler, 0xe32000000036 /* pfd */ | R32A(addr.index) | R28A(addr.base) | disp_s20(addr.offset));
 	default:
 		return SLJIT_SUCCESS;
 	}
@@ -3275,6 +3353,21 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		size = GET_SAVED_REGISTERS_SIZE(compiler->scratches, compiler->saveds - SLJIT_KEPT_SAVEDS_COUNT(compiler->options), 2);
 		FAIL_IF(load_word(compiler, dst_r, SLJIT_MEM1(SLJIT_SP), compiler->local_size + size, 0));
 		break;
+	case SLJIT_GET_CYCLE_COUNTER:
+		dst_r = FAST_IS_REG(dst) ? gpr(dst) : tmp0;
+
+		/* The register save area of the callees is used as a temporary storage. */
+		FAIL_IF(push_inst(compiler, 0xb27c0000 /* stckf */ | R12A(r15)));
+		FAIL_IF(push_inst(compiler, lg(dst_r, 0, 0, r15)));
+		break;
+	case SLJIT_GET_THREAD_POINTER:
+		dst_r = FAST_IS_REG(dst) ? gpr(dst) : tmp0;
+
+		/* The high and low words are stored in access registers 0 and 1. */
+		FAIL_IF(push_inst(compiler, 0xb24f0000 /* ear */ | R4A(dst_r) | R0A(0)));
+		FAIL_IF(push_inst(compiler, sllg(dst_r, dst_r, 32, 0)));
+		FAIL_IF(push_inst(compiler, 0xb24f0000 /* ear */ | R4A(dst_r) | R0A(1)));
+		break;
 	}
 
 	if (dst & SLJIT_MEM)
@@ -3501,6 +3594,21 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 		case SLJIT_NEG_F64:
 			ins = (op & SLJIT_32) ? 0xb3030000 /* lcebr */ : 0xb3130000 /* lcdbr */;
 			break;
+		case SLJIT_SQRT_F64:
+			ins = (op & SLJIT_32) ? 0xb3140000 /* sqebr */ : 0xb3150000 /* sqdbr */;
+			break;
+		case SLJIT_FLOOR_F64:
+			ins = ((op & SLJIT_32) ? 0xb3570000 /* fiebr */ : 0xb35f0000 /* fidbr */) | (7 << 12);
+			break;
+		case SLJIT_CEIL_F64:
+			ins = ((op & SLJIT_32) ? 0xb3570000 /* fiebr */ : 0xb35f0000 /* fidbr */) | (6 << 12);
+			break;
+		case SLJIT_TRUNC_F64:
+			ins = ((op & SLJIT_32) ? 0xb3570000 /* fiebr */ : 0xb35f0000 /* fidbr */) | (5 << 12);
+			break;
+		case SLJIT_ROUND_F64:
+			ins = ((op & SLJIT_32) ? 0xb3570000 /* fiebr */ : 0xb35f0000 /* fidbr */) | (1 << 12);
+			break;
 		default:
 			SLJIT_ASSERT(GET_OPCODE(op) == SLJIT_ABS_F64);
 			ins = (op & SLJIT_32) ? 0xb3000000 /* lpebr */ : 0xb3100000 /* lpdbr */;
@@ -3529,6 +3637,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2(compiler, op, dst, dstw, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) == SLJIT_MIN_F64 || GET_OPCODE(op) == SLJIT_MAX_F64)
+		return emit_fminmax_generic(compiler, op, dst, dstw, src1, src1w, src2, src2w);
+
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -3593,12 +3705,32 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compi
 	sljit_s32 src2, sljit_sw src2w)
 {
 	sljit_s32 reg;
+	sljit_ins ins_r, ins;
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fop2r(compiler, op, dst_freg, src1, src1w, src2, src2w));
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
 
+	if (GET_OPCODE(op) != SLJIT_COPYSIGN_F64) {
+		if (src1 & SLJIT_MEM) {
+			FAIL_IF(float_mem(compiler, FLOAT_LOAD | (op & SLJIT_32), TMP_FREG1, src1, src1w));
+			src1 = TMP_FREG1;
+		}
+
+		/* The multiplier is encoded in the R3 field, the
+		   accumulator (dst_freg) in the R1 field. */
+		if (GET_OPCODE(op) == SLJIT_MULADD_F64) {
+			ins_r = (op & SLJIT_32) ? 0xb30e0000 /* maebr */ : 0xb31e0000 /* madbr */;
+			ins = (op & SLJIT_32) ? 0xed000000000e /* maeb */ : 0xed000000001e /* madb */;
+		} else {
+			ins_r = (op & SLJIT_32) ? 0xb30f0000 /* msebr */ : 0xb31f0000 /* msdbr */;
+			ins = (op & SLJIT_32) ? 0xed000000000f /* mseb */ : 0xed000000001f /* msdb */;
+		}
+
+		return emit_float(compiler, ins_r | F12(dst_freg), ins | F12(dst_freg), src1, src2, src2w);
+	}
+
 	if (src2 & SLJIT_MEM) {
 		FAIL_IF(float_mem(compiler, FLOAT_LOAD | (op & SLJIT_32), TMP_FREG1, src2, src2w));
 		src2 = TMP_FREG1;
@@ -4082,6 +4214,17 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 	return SLJIT_SUCCESS;
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG2, TMP_REG1, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 reg,
 	sljit_s32 mem, sljit_sw memw)
@@ -4714,19 +4857,24 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compi
 	return (struct sljit_const*)const_;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	/* Update the constant pool. */
 	sljit_uw *ptr = (sljit_uw *)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS(ptr, ptr + 1, 0);
+	PATCH_UPDATE_WX_FLAGS(ptr, ptr + 1, 0);
 	*ptr = new_target;
-	SLJIT_UPDATE_WX_FLAGS(ptr, ptr + 1, 1);
-	SLJIT_CACHE_FLUSH(ptr, ptr + 1);
+	PATCH_UPDATE_WX_FLAGS(ptr, ptr + 1, 1);
+	PATCH_CACHE_FLUSH(ptr, ptr + 1);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
+}
+
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	sljit_u16 *inst = (sljit_u16*)addr;
 	SLJIT_UNUSED_ARG(executable_offset);
@@ -4740,40 +4888,45 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 		else
 			new_constant &= 0xff;
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 0);
 		inst[1] = (sljit_u16)new_constant;
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 2, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 2, 1);
 		inst = (sljit_u16*)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 2);
+		PATCH_CACHE_FLUSH(inst, inst + 2);
 		return;
 
 	case SLJIT_MOV32:
 	case SLJIT_MOV_S32:
 		SLJIT_ASSERT((inst[0] & 0xff0f) == 0xc001 /* lgfi */);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 3, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 3, 0);
 		inst[1] = (sljit_u16)(new_constant >> 16);
 		inst[2] = (sljit_u16)new_constant;
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 3, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 3, 1);
 		inst = (sljit_u16*)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 3);
+		PATCH_CACHE_FLUSH(inst, inst + 3);
 		return;
 
 	default:
 		SLJIT_ASSERT((inst[0] & 0xff0f) == 0xc00f /* llilf */ && (inst[3] & 0xff0f) == 0xc008 /* iihf */);
 
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 6, 0);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 6, 0);
 		inst[1] = (sljit_u16)(new_constant >> 16);
 		inst[2] = (sljit_u16)new_constant;
 		inst[4] = (sljit_u16)(new_constant >> 48);
 		inst[5] = (sljit_u16)(new_constant >> 32);
-		SLJIT_UPDATE_WX_FLAGS(inst, inst + 6, 1);
+		PATCH_UPDATE_WX_FLAGS(inst, inst + 6, 1);
 		inst = (sljit_u16*)SLJIT_ADD_EXEC_OFFSET(inst, executable_offset);
-		SLJIT_CACHE_FLUSH(inst, inst + 6);
+		PATCH_CACHE_FLUSH(inst, inst + 6);
 		return;
 	}
 }
 
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw)
 {
@@ -1246,6 +1246,59 @@ static sljit_s32 sljit_emit_get_return_address(struct sljit_compiler *compiler,
 	return emit_mov(compiler, dst, dstw, SLJIT_MEM1(SLJIT_SP), compiler->local_size + saveds);
 }
 
+static sljit_s32 emit_get_cycle_counter(struct sljit_compiler *compiler, sljit_s32 dst, sljit_sw dstw)
+{
+	sljit_u8 *inst;
+
+	/* The rdtsc instruction overwrites eax and edx, and the stack
+	   pointer is restored before dst is written. */
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 4);
+	FAIL_IF(!inst);
+	INC_SIZE(4);
+	PUSH_REG(reg_map[SLJIT_R1]);
+	PUSH_REG(reg_map[SLJIT_R0]);
+	*inst++ = GROUP_0F;
+	*inst = RDTSC;
+
+	EMIT_MOV(compiler, TMP_REG1, 0, SLJIT_R0, 0);
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 2);
+	FAIL_IF(!inst);
+	INC_SIZE(2);
+	POP_REG(reg_map[SLJIT_R0]);
+	POP_REG(reg_map[SLJIT_R1]);
+
+	return emit_mov(compiler, dst, dstw, TMP_REG1, 0);
+}
+
+static sljit_s32 emit_get_thread_pointer(struct sljit_compiler *compiler, sljit_s32 dst, sljit_sw dstw)
+{
+	sljit_s32 dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
+	sljit_u8 *inst;
+
+	/* The thread control block is accessed through a segment register. */
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 7);
+	FAIL_IF(!inst);
+	INC_SIZE(7);
+#ifdef _WIN32
+	inst[0] = GROUP_FS;
+#else /* !_WIN32 */
+	inst[0] = GROUP_GS;
+#endif /* _WIN32 */
+	inst[1] = MOV_r_rm;
+	/* Absolute address. */
+	inst[2] = U8((reg_map[dst_r] << 3) | 0x5);
+#ifdef _WIN32
+	sljit_unaligned_store_s32(inst + 3, 0x18);
+#else /* !_WIN32 */
+	sljit_unaligned_store_s32(inst + 3, 0);
+#endif /* _WIN32 */
+
+	if (dst_r == TMP_REG1)
+		return emit_mov(compiler, dst, dstw, TMP_REG1, 0);
+	return SLJIT_SUCCESS;
+}
+
 /* --------------------------------------------------------------------- */
 /*  Other operations                                                     */
 /* --------------------------------------------------------------------- */
@@ -1335,14 +1388,36 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 	sljit_s32 mem, sljit_sw memw)
 {
 	sljit_u8* inst;
-	sljit_s32 i, next, reg_idx, offset;
+	sljit_s32 i, next, reg_idx, offset, non_temporal;
 	sljit_u8 regs[2];
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_mem(compiler, type, reg, mem, memw));
 
-	if (!(reg & REG_PAIR_MASK))
-		return sljit_emit_mem_unaligned(compiler, type, reg, mem, memw);
+	/* Only stores have a non-temporal form for general purpose registers. */
+	non_temporal = (type & (SLJIT_MEM_NON_TEMPORAL | SLJIT_MEM_STORE)) == (SLJIT_MEM_NON_TEMPORAL | SLJIT_MEM_STORE);
+
+	if (non_temporal) {
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		if (!(cpu_feature_list & CPU_FEATURE_SSE2))
+			non_temporal = 0;
+	}
+
+	if (!(reg & REG_PAIR_MASK)) {
+		if (!non_temporal || ((type & 0xff) >= SLJIT_MOV_U8 && (type & 0xff) <= SLJIT_MOV_S16))
+			return sljit_emit_mem_unaligned(compiler, type, reg, mem, memw);
+
+		ADJUST_LOCAL_OFFSET(mem, memw);
+
+		if (reg >= SLJIT_R3 && reg <= SLJIT_S3) {
+			EMIT_MOV(compiler, TMP_REG1, 0, reg, 0);
+			reg = TMP_REG1;
+		}
+
+		return emit_groupf(compiler, MOVNTI_m_r, reg, mem, memw);
+	}
 
 	ADJUST_LOCAL_OFFSET(mem, memw);
 
@@ -1383,15 +1458,22 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 		}
 
 		if ((mem & OFFS_REG_MASK) && (reg_idx == 1)) {
-			inst = (sljit_u8*)ensure_buf(compiler, (sljit_uw)(1 + 4));
+			inst = (sljit_u8*)ensure_buf(compiler, (sljit_uw)(1 + 4 + non_temporal));
 			FAIL_IF(!inst);
 
-			INC_SIZE(4);
+			INC_SIZE(4 + (sljit_uw)non_temporal);
+
+			if (non_temporal) {
+				*inst++ = GROUP_0F;
+				*inst++ = MOVNTI_m_r;
+			} else
+				*inst++ = (type & SLJIT_MEM_STORE) ? MOV_rm_r : MOV_r_rm;
 
-			inst[0] = (type & SLJIT_MEM_STORE) ? MOV_rm_r : MOV_r_rm;
-			inst[1] = 0x44 | U8(reg_map[reg] << 3);
-			inst[2] = U8(memw << 6) | U8(reg_map[OFFS_REG(mem)] << 3) | reg_map[mem & REG_MASK];
-			inst[3] = sizeof(sljit_sw);
+			inst[0] = 0x44 | U8(reg_map[reg] << 3);
+			inst[1] = U8(memw << 6) | U8(reg_map[OFFS_REG(mem)] << 3) | reg_map[mem & REG_MASK];
+			inst[2] = sizeof(sljit_sw);
+		} else if (non_temporal) {
+			FAIL_IF(emit_groupf(compiler, MOVNTI_m_r, reg, mem, memw));
 		} else if (type & SLJIT_MEM_STORE) {
 			EMIT_MOV(compiler, mem, memw, reg, 0);
 		} else {
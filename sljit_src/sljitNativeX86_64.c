@@ -30,7 +30,7 @@
 /*  Operators                                                            */
 /* --------------------------------------------------------------------- */
 
-static sljit_s32 emit_load_imm64(struct sljit_compiler *compiler, sljit_s32 reg, sljit_sw imm)
+static sljit_s32 emit_mov_imm64(struct sljit_compiler *compiler, sljit_s32 reg, sljit_sw imm)
 {
 	sljit_u8 *inst;
 
@@ -43,6 +43,159 @@ static sljit_s32 emit_load_imm64(struct sljit_compiler *compiler, sljit_s32 reg,
 	return SLJIT_SUCCESS;
 }
 
+/* Number of recently added constants searched for a duplicate. */
+#define CONST_POOL_SEARCH_LIMIT	128
+/* Offset of constants which are not in the pool yet. */
+#define CONST_POOL_UNUSED	SLJIT_MAX_ADDRESS
+
+/* Sets offset to the offset of value in the constant pool, or to CONST_POOL_UNUSED
+   if the value should be loaded by instructions. A value is moved into the pool
+   when it is requested min_uses times. */
+static sljit_s32 const_pool_get_offset(struct sljit_compiler *compiler, sljit_uw value, sljit_s32 min_uses, sljit_uw *offset)
+{
+	struct sljit_const_pool_entry *entry = compiler->const_pool;
+	sljit_s32 limit = CONST_POOL_SEARCH_LIMIT;
+
+	while (entry != NULL && limit > 0) {
+		if (entry->value == value)
+			break;
+		entry = entry->next;
+		limit--;
+	}
+
+	if (entry == NULL || limit == 0) {
+		entry = (struct sljit_const_pool_entry*)ensure_abuf(compiler, sizeof(struct sljit_const_pool_entry));
+		FAIL_IF(!entry);
+
+		entry->next = compiler->const_pool;
+		entry->value = value;
+		entry->offset = CONST_POOL_UNUSED;
+		compiler->const_pool = entry;
+
+		if (min_uses > 1) {
+			*offset = CONST_POOL_UNUSED;
+			return SLJIT_SUCCESS;
+		}
+	}
+
+	if (entry->offset == CONST_POOL_UNUSED) {
+		entry->offset = compiler->const_pool_size;
+		compiler->const_pool_size += sizeof(sljit_uw);
+	}
+
+	*offset = entry->offset;
+	return SLJIT_SUCCESS;
+}
+
+/* Emits an instruction with a RIP relative memory operand, which is
+   resolved to the address of the data at offset in the constant pool.
+   Instructions with non-zero prefix are two byte (0x0f) opcodes. */
+static sljit_s32 emit_const_pool_load(struct sljit_compiler *compiler, sljit_uw offset,
+	sljit_u8 prefix, sljit_u8 rex, sljit_u8 opcode, sljit_u8 reg)
+{
+	sljit_u8 *inst;
+	sljit_uw size = 2 + sizeof(sljit_s32);
+
+	if (prefix != 0)
+		size += 2;
+	if (rex != 0)
+		size++;
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + size);
+	FAIL_IF(!inst);
+	INC_SIZE(size);
+
+	if (prefix != 0)
+		*inst++ = prefix;
+	if (rex != 0)
+		*inst++ = rex;
+	if (prefix != 0)
+		*inst++ = GROUP_0F;
+
+	inst[0] = opcode;
+	inst[1] = U8(0x5 | (reg << 3));
+	/* Replaced by the displacement during code generation. */
+	sljit_unaligned_store_s32(inst + 2, (sljit_s32)offset);
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1);
+	FAIL_IF(!inst);
+
+	inst[0] = SLJIT_INST_CONST_POOL;
+	return SLJIT_SUCCESS;
+}
+
+static sljit_s32 emit_load_imm64(struct sljit_compiler *compiler, sljit_s32 reg, sljit_sw imm)
+{
+	sljit_uw offset;
+
+	/* A repeated constant is loaded from the pool, which is shorter than
+	   the 10 byte immediate move and shared by all uses. */
+	FAIL_IF(const_pool_get_offset(compiler, (sljit_uw)imm, 2, &offset));
+
+	if (offset == CONST_POOL_UNUSED)
+		return emit_mov_imm64(compiler, reg, imm);
+
+	return emit_const_pool_load(compiler, offset, 0, U8(REX_W | ((reg_map[reg] <= 7) ? 0 : REX_R)), MOV_r_rm, reg_lmap[reg]);
+}
+
+static void const_pool_write(struct sljit_compiler *compiler, sljit_u8 *pool)
+{
+	struct sljit_const_pool_entry *entry = compiler->const_pool;
+
+	while (entry != NULL) {
+		if (entry->offset != CONST_POOL_UNUSED)
+			*(sljit_uw*)(pool + entry->offset) = entry->value;
+		entry = entry->next;
+	}
+}
+
+static sljit_uw get_relocation_count(struct sljit_compiler *compiler)
+{
+	struct sljit_jump *jump = compiler->jumps;
+	struct sljit_switch *switch_ = compiler->switches;
+	sljit_uw count = 0;
+
+	while (jump != NULL) {
+		if (jump->flags & SLJIT_REWRITABLE_JUMP)
+			count++;
+		jump = jump->next;
+	}
+
+	while (switch_ != NULL) {
+		if (switch_->table != NULL)
+			count += switch_->table_size;
+		switch_ = switch_->next;
+	}
+
+	return count;
+}
+
+static void relocation_table_write(struct sljit_compiler *compiler, sljit_u8 *code, sljit_u8 *relocs, sljit_uw count)
+{
+	struct sljit_jump *jump = compiler->jumps;
+	struct sljit_switch *switch_ = compiler->switches;
+	sljit_u32 *ptr = (sljit_u32*)relocs;
+	sljit_uw i;
+
+	/* Rewritable jumps always use the 64 bit immediate form. */
+	while (jump != NULL) {
+		if (jump->flags & SLJIT_REWRITABLE_JUMP)
+			*ptr++ = (sljit_u32)(jump->addr - (sljit_uw)code);
+		jump = jump->next;
+	}
+
+	while (switch_ != NULL) {
+		if (switch_->table != NULL) {
+			for (i = 0; i < switch_->table_size; i++)
+				*ptr++ = (sljit_u32)(switch_->table->size + i * sizeof(sljit_uw));
+		}
+		switch_ = switch_->next;
+	}
+
+	SLJIT_ASSERT(ptr == (sljit_u32*)relocs + count);
+	*ptr = (sljit_u32)count;
+}
+
 static sljit_s32 emit_do_imm32(struct sljit_compiler *compiler, sljit_u8 rex, sljit_u8 opcode, sljit_sw imm)
 {
 	sljit_u8 *inst;
@@ -395,7 +548,7 @@ static sljit_u8* detect_far_jump_type(struct sljit_jump *jump, sljit_u8 *code_pt
 	return code_ptr + 3;
 }
 
-static sljit_u8* generate_mov_addr_code(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_u8 *code, sljit_sw executable_offset)
+static sljit_u8* generate_mov_addr_code(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_u8 *code, sljit_sw executable_offset, sljit_s32 is_pic)
 {
 	sljit_uw addr;
 	sljit_sw diff;
@@ -407,7 +560,8 @@ static sljit_u8* generate_mov_addr_code(struct sljit_jump *jump, sljit_u8 *code_
 	else
 		addr = (sljit_uw)SLJIT_ADD_EXEC_OFFSET(code, executable_offset) + jump->u.label->size;
 
-	if (addr > 0xffffffffl) {
+	/* Position independent code uses PC-relative addressing for labels. */
+	if (addr > 0xffffffffl || (is_pic && !(jump->flags & JUMP_ADDR))) {
 		diff = (sljit_sw)addr - (sljit_sw)SLJIT_ADD_EXEC_OFFSET(code_ptr, executable_offset);
 
 		if (diff <= HALFWORD_MAX && diff >= HALFWORD_MIN) {
@@ -1020,6 +1174,71 @@ static sljit_s32 sljit_emit_get_return_address(struct sljit_compiler *compiler,
 	return emit_mov(compiler, dst, dstw, SLJIT_MEM1(SLJIT_SP), compiler->local_size + saved_regs_size);
 }
 
+static sljit_s32 emit_get_cycle_counter(struct sljit_compiler *compiler, sljit_s32 dst, sljit_sw dstw)
+{
+	sljit_u8 *inst;
+
+	/* The rdtsc instruction overwrites rax and rdx. */
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 11);
+	FAIL_IF(!inst);
+	INC_SIZE(11);
+	PUSH_REG(2);
+	PUSH_REG(0);
+	inst[0] = GROUP_0F;
+	inst[1] = RDTSC;
+	/* shl rdx, 32 */
+	inst[2] = REX_W;
+	inst[3] = GROUP_SHIFT_N;
+	inst[4] = U8(MOD_REG | SHL | 2);
+	inst[5] = 32;
+	/* or rax, rdx */
+	inst[6] = REX_W;
+	inst[7] = OR_rm_r;
+	inst[8] = U8(MOD_REG | (2 << 3) | 0);
+
+	SLJIT_ASSERT(reg_map[SLJIT_R0] == 0 && reg_map[TMP_REG2] >= 8);
+	compiler->mode32 = 0;
+	EMIT_MOV(compiler, TMP_REG2, 0, SLJIT_R0, 0);
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 2);
+	FAIL_IF(!inst);
+	INC_SIZE(2);
+	POP_REG(0);
+	POP_REG(2);
+
+	return emit_mov(compiler, dst, dstw, TMP_REG2, 0);
+}
+
+static sljit_s32 emit_get_thread_pointer(struct sljit_compiler *compiler, sljit_s32 dst, sljit_sw dstw)
+{
+	sljit_s32 dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
+	sljit_u8 *inst;
+
+	/* The first word of the thread control block points to itself. */
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 9);
+	FAIL_IF(!inst);
+	INC_SIZE(9);
+#if defined(_WIN64) || defined(__APPLE__)
+	inst[0] = GROUP_GS;
+#else /* !_WIN64 && !__APPLE__ */
+	inst[0] = GROUP_FS;
+#endif /* _WIN64 || __APPLE__ */
+	inst[1] = U8(REX_W | ((reg_map[dst_r] <= 7) ? 0 : REX_R));
+	inst[2] = MOV_r_rm;
+	/* Absolute address (no base and index registers). */
+	inst[3] = U8((reg_lmap[dst_r] << 3) | 0x4);
+	inst[4] = 0x25;
+#ifdef _WIN64
+	sljit_unaligned_store_s32(inst + 5, 0x30);
+#else /* !_WIN64 */
+	sljit_unaligned_store_s32(inst + 5, 0);
+#endif /* _WIN64 */
+
+	if (dst_r == TMP_REG1)
+		return emit_mov(compiler, dst, dstw, TMP_REG1, 0);
+	return SLJIT_SUCCESS;
+}
+
 /* --------------------------------------------------------------------- */
 /*  Other operations                                                     */
 /* --------------------------------------------------------------------- */
@@ -1084,14 +1303,24 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 	sljit_s32 mem, sljit_sw memw)
 {
 	sljit_u8* inst;
-	sljit_s32 i, next, reg_idx;
+	sljit_s32 i, next, reg_idx, non_temporal;
 	sljit_u8 regs[2];
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_mem(compiler, type, reg, mem, memw));
 
-	if (!(reg & REG_PAIR_MASK))
-		return sljit_emit_mem_unaligned(compiler, type, reg, mem, memw);
+	/* Only stores have a non-temporal form for general purpose registers. */
+	non_temporal = (type & (SLJIT_MEM_NON_TEMPORAL | SLJIT_MEM_STORE)) == (SLJIT_MEM_NON_TEMPORAL | SLJIT_MEM_STORE);
+
+	if (!(reg & REG_PAIR_MASK)) {
+		if (!non_temporal || ((type & 0xff) >= SLJIT_MOV_U8 && (type & 0xff) <= SLJIT_MOV_S16))
+			return sljit_emit_mem_unaligned(compiler, type, reg, mem, memw);
+
+		ADJUST_LOCAL_OFFSET(mem, memw);
+
+		compiler->mode32 = (type & 0xff) != SLJIT_MOV && (type & 0xff) != SLJIT_MOV_P;
+		return emit_groupf(compiler, MOVNTI_m_r, reg, mem, memw);
+	}
 
 	ADJUST_LOCAL_OFFSET(mem, memw);
 
@@ -1136,16 +1365,24 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem(struct sljit_compiler *compile
 		reg = regs[reg_idx];
 
 		if ((mem & OFFS_REG_MASK) && (reg_idx == 1)) {
-			inst = (sljit_u8*)ensure_buf(compiler, (sljit_uw)(1 + 5));
+			inst = (sljit_u8*)ensure_buf(compiler, (sljit_uw)(1 + 5 + non_temporal));
 			FAIL_IF(!inst);
 
-			INC_SIZE(5);
+			INC_SIZE(5 + (sljit_uw)non_temporal);
+
+			*inst++ = U8(REX_W | ((reg_map[reg] >= 8) ? REX_R : 0) | ((reg_map[mem & REG_MASK] >= 8) ? REX_B : 0) | ((reg_map[OFFS_REG(mem)] >= 8) ? REX_X : 0));
 
-			inst[0] = U8(REX_W | ((reg_map[reg] >= 8) ? REX_R : 0) | ((reg_map[mem & REG_MASK] >= 8) ? REX_B : 0) | ((reg_map[OFFS_REG(mem)] >= 8) ? REX_X : 0));
-			inst[1] = (type & SLJIT_MEM_STORE) ? MOV_rm_r : MOV_r_rm;
-			inst[2] = 0x44 | U8(reg_lmap[reg] << 3);
-			inst[3] = U8(memw << 6) | U8(reg_lmap[OFFS_REG(mem)] << 3) | reg_lmap[mem & REG_MASK];
-			inst[4] = sizeof(sljit_sw);
+			if (non_temporal) {
+				*inst++ = GROUP_0F;
+				*inst++ = MOVNTI_m_r;
+			} else
+				*inst++ = (type & SLJIT_MEM_STORE) ? MOV_rm_r : MOV_r_rm;
+
+			inst[0] = 0x44 | U8(reg_lmap[reg] << 3);
+			inst[1] = U8(memw << 6) | U8(reg_lmap[OFFS_REG(mem)] << 3) | reg_lmap[mem & REG_MASK];
+			inst[2] = sizeof(sljit_sw);
+		} else if (non_temporal) {
+			FAIL_IF(emit_groupf(compiler, MOVNTI_m_r, reg, mem, memw));
 		} else if (type & SLJIT_MEM_STORE) {
 			EMIT_MOV(compiler, mem, memw, reg, 0);
 		} else {
@@ -1296,22 +1533,11 @@ static SLJIT_INLINE sljit_s32 sljit_emit_fop1_conv_f64_from_uw(struct sljit_comp
 	return SLJIT_SUCCESS;
 }
 
-static sljit_s32 sljit_emit_fset(struct sljit_compiler *compiler,
-	sljit_s32 freg, sljit_u8 rex, sljit_s32 is_zero)
+static sljit_s32 emit_fset_zero(struct sljit_compiler *compiler, sljit_s32 freg)
 {
 	sljit_u8 *inst;
-	sljit_u32 size;
-
-	if (is_zero) {
-		rex = freg_map[freg] >= 8 ? (REX_R | REX_B) : 0;
-	} else {
-		if (freg_map[freg] >= 8)
-			rex |= REX_R;
-		if (reg_map[TMP_REG1] >= 8)
-			rex |= REX_B;
-	}
-
-	size = (rex != 0) ? 5 : 4;
+	sljit_u8 rex = freg_map[freg] >= 8 ? (REX_R | REX_B) : 0;
+	sljit_u32 size = (rex != 0) ? 5 : 4;
 
 	inst = (sljit_u8*)ensure_buf(compiler, 1 + size);
 	FAIL_IF(!inst);
@@ -1321,15 +1547,8 @@ static sljit_s32 sljit_emit_fset(struct sljit_compiler *compiler,
 	if (rex != 0)
 		*inst++ = rex;
 	inst[0] = GROUP_0F;
-
-	if (is_zero) {
-		inst[1] = PXOR_x_xm;
-		inst[2] = U8(freg_lmap[freg] | (freg_lmap[freg] << 3) | MOD_REG);
-	} else {
-		inst[1] = MOVD_x_rm;
-		inst[2] = U8(reg_lmap[TMP_REG1] | (freg_lmap[freg] << 3) | MOD_REG);
-	}
-
+	inst[1] = PXOR_x_xm;
+	inst[2] = U8(freg_lmap[freg] | (freg_lmap[freg] << 3) | MOD_REG);
 	return SLJIT_SUCCESS;
 }
 
@@ -1340,6 +1559,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fset32(struct sljit_compiler *comp
 		sljit_s32 imm;
 		sljit_f32 value;
 	} u;
+	sljit_uw offset;
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fset32(compiler, freg, value));
@@ -1347,11 +1567,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fset32(struct sljit_compiler *comp
 	u.value = value;
 
 	if (u.imm != 0) {
-		compiler->mode32 = 1;
-		EMIT_MOV(compiler, TMP_REG1, 0, SLJIT_IMM, u.imm);
+		/* Loading from memory avoids the transfer through a general purpose register. */
+		FAIL_IF(const_pool_get_offset(compiler, (sljit_u32)u.imm, 1, &offset));
+		return emit_const_pool_load(compiler, offset, GROUP_F3, freg_map[freg] >= 8 ? REX_R : 0, MOVSD_x_xm, freg_lmap[freg]);
 	}
 
-	return sljit_emit_fset(compiler, freg, 0, u.imm == 0);
+	return emit_fset_zero(compiler, freg);
 }
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fset64(struct sljit_compiler *compiler,
@@ -1361,6 +1582,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fset64(struct sljit_compiler *comp
 		sljit_sw imm;
 		sljit_f64 value;
 	} u;
+	sljit_uw offset;
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_fset64(compiler, freg, value));
@@ -1368,11 +1590,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fset64(struct sljit_compiler *comp
 	u.value = value;
 
 	if (u.imm != 0) {
-		compiler->mode32 = 0;
-		EMIT_MOV(compiler, TMP_REG1, 0, SLJIT_IMM, u.imm);
+		FAIL_IF(const_pool_get_offset(compiler, (sljit_uw)u.imm, 1, &offset));
+		return emit_const_pool_load(compiler, offset, GROUP_F2, freg_map[freg] >= 8 ? REX_R : 0, MOVSD_x_xm, freg_lmap[freg]);
 	}
 
-	return sljit_emit_fset(compiler, freg, REX_W, u.imm == 0);
+	return emit_fset_zero(compiler, freg);
 }
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fcopy(struct sljit_compiler *compiler, sljit_s32 op,
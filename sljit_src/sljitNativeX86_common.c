@@ -184,6 +184,7 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define AND_r_rm		0x23
 #define AND_rm_r		0x21
 #define ANDPD_x_xm		0x54
+#define BEXTR_r_rm_r		(/* VEX_OP_0F38 */ 0xf7)
 #define BSR_r_rm		(/* GROUP_0F */ 0xbd)
 #define BSF_r_rm		(/* GROUP_0F */ 0xbc)
 #define BSWAP_r			(/* GROUP_0F */ 0xc8)
@@ -197,6 +198,8 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define CMP_rm_r		0x39
 #define CMPS_x_xm		0xc2
 #define CMPXCHG_rm_r		0xb1
+#define CRC32_r_rm		(/* GROUP_0F38 */ 0xf1)
+#define CRC32_r_rm8		(/* GROUP_0F38 */ 0xf0)
 #define CMPXCHG_rm8_r		0xb0
 #define CVTPD2PS_x_xm		0x5a
 #define CVTPS2PD_x_xm		0x5a
@@ -220,6 +223,7 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define JE_i8			0x74
 #define JNC_i8			0x73
 #define JNE_i8			0x75
+#define JNP_i8			0x7b
 #define JMP_i8			0xeb
 #define JMP_i32			0xe9
 #define JMP_rm			(/* GROUP_FF */ 4 << 3)
@@ -236,6 +240,8 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define MOVAPS_xm_x		0x29
 #define MOVD_x_rm		0x6e
 #define MOVD_rm_x		0x7e
+#define MAXSD_x_xm		0x5f
+#define MINSD_x_xm		0x5d
 #define MOVDDUP_x_xm		0x12
 #define MOVDQA_x_xm		0x6f
 #define MOVDQA_xm_x		0x7f
@@ -247,7 +253,12 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define MOVLPD_m_x		0x13
 #define MOVLPD_x_m		0x12
 #define MOVMSKPS_r_x		(/* GROUP_0F */ 0x50)
+#define MOVNTDQ_m_x		0xe7
+#define MOVNTDQA_x_m		(/* VEX_OP_0F38 */ 0x2a)
+#define MOVNTI_m_r		(/* GROUP_0F */ 0xc3)
+#define MOVNTPS_m_x		0x2b
 #define MOVQ_x_xm		(/* GROUP_0F */ 0x7e)
+#define MOVS_B			0xa4
 #define MOVSD_x_xm		0x10
 #define MOVSD_xm_x		0x11
 #define MOVSHDUP_x_xm		0x16
@@ -271,6 +282,8 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define PACKSSWB_x_xm		(/* GROUP_0F */ 0x63)
 #define PAND_x_xm		0xdb
 #define PCMPEQD_x_xm		0x76
+#define PDEP_r_r_rm		(/* VEX_OP_0F38 */ 0xf5)
+#define PEXT_r_r_rm		(/* VEX_OP_0F38 */ 0xf5)
 #define PINSRB_x_rm_i8		0x20
 #define PINSRW_x_rm_i8		0xc4
 #define PINSRD_x_rm_i8		0x22
@@ -292,9 +305,11 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define PMOVZXWQ_x_xm		0x34
 #define POP_r			0x58
 #define POP_rm			0x8f
+#define POPCNT_r_rm		(/* GROUP_F3 */ /* GROUP_0F */ 0xb8)
 #define POPF			0x9d
 #define POR_x_xm		0xeb
 #define PREFETCH		0x18
+#define PREFETCHW		(/* GROUP_0F */ 0x0d)
 #define PSHUFB_x_xm		0x00
 #define PSHUFD_x_xm		0x70
 #define PSHUFLW_x_xm		0x70
@@ -308,6 +323,9 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define PXOR_x_xm		0xef
 #define ROL			(/* SHIFT */ 0 << 3)
 #define ROR			(/* SHIFT */ 1 << 3)
+#define ROUNDSD_x_xm_i8		0x0b
+#define ROUNDSS_x_xm_i8		0x0a
+#define RDTSC			(/* GROUP_0F */ 0x31)
 #define RET_near		0xc3
 #define RET_i16			0xc2
 #define SBB			(/* BINARY */ 3 << 3)
@@ -319,7 +337,9 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define SHLD			(/* GROUP_0F */ 0xa5)
 #define SHRD			(/* GROUP_0F */ 0xad)
 #define SHR			(/* SHIFT */ 5 << 3)
+#define SQRTSD_x_xm		0x51
 #define SHUFPS_x_xm		0xc6
+#define STOS_B			0xaa
 #define SUB			(/* BINARY */ 5 << 3)
 #define SUB_EAX_i32		0x2d
 #define SUB_r_rm		0x2b
@@ -335,6 +355,8 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define VBROADCASTSS_x_xm	0x18
 #define VEXTRACTF128_x_ym	0x19
 #define VEXTRACTI128_x_ym	0x39
+#define VFMADD231SD_x_x_xm	0xb9
+#define VFMSUB231SD_x_x_xm	0xbb
 #define VINSERTF128_y_y_xm	0x18
 #define VINSERTI128_y_y_xm	0x38
 #define VPBROADCASTB_x_xm	0x78
@@ -353,9 +375,12 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 
 #define GROUP_0F		0x0f
 #define GROUP_66		0x66
+#define GROUP_F2		0xf2
 #define GROUP_F3		0xf3
 #define GROUP_F7		0xf7
 #define GROUP_FF		0xff
+#define GROUP_FS		0x64
+#define GROUP_GS		0x65
 #define GROUP_BINARY_81		0x81
 #define GROUP_BINARY_83		0x83
 #define GROUP_SHIFT_1		0xd1
@@ -377,6 +402,10 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define SLJIT_INST_JUMP		254
 #define SLJIT_INST_MOV_ADDR	253
 #define SLJIT_INST_CONST	252
+#define SLJIT_INST_CONST_POOL	251
+/* Followed by two bytes: the offset of a patchable field from the end
+   of the record, and the alignment mask of the field. */
+#define SLJIT_INST_PATCH_ALIGN	250
 
 /* Multithreading does not affect these static variables, since they store
    built-in CPU features. Therefore they can be overwritten by different threads
@@ -392,6 +421,14 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 2] = {
 #define CPU_FEATURE_AVX			0x040
 #define CPU_FEATURE_AVX2		0x080
 #define CPU_FEATURE_OSXSAVE		0x100
+#define CPU_FEATURE_POPCNT		0x200
+#define CPU_FEATURE_BMI2		0x400
+#define CPU_FEATURE_FMA			0x800
+#define CPU_FEATURE_SSE42		0x1000
+#define CPU_FEATURE_PREFETCHW		0x2000
+#define CPU_FEATURE_ERMS		0x4000
+#define CPU_FEATURE_FSRM		0x8000
+#define CPU_FEATURE_INVARIANT_TSC	0x10000
 
 static sljit_u32 cpu_feature_list = 0;
 
@@ -556,6 +593,12 @@ static void get_cpu_features(void)
 			feature_list |= CPU_FEATURE_TZCNT;
 		if (info[1] & 0x20)
 			feature_list |= CPU_FEATURE_AVX2;
+		if (info[1] & 0x100)
+			feature_list |= CPU_FEATURE_BMI2;
+		if (info[1] & 0x200)
+			feature_list |= CPU_FEATURE_ERMS;
+		if (info[3] & 0x10)
+			feature_list |= CPU_FEATURE_FSRM;
 	}
 
 	if (max_id >= 1) {
@@ -566,8 +609,14 @@ static void get_cpu_features(void)
 #endif
 		execute_cpu_id(info);
 
+		if (info[2] & 0x1000)
+			feature_list |= CPU_FEATURE_FMA;
 		if (info[2] & 0x80000)
 			feature_list |= CPU_FEATURE_SSE41;
+		if (info[2] & 0x100000)
+			feature_list |= CPU_FEATURE_SSE42;
+		if (info[2] & 0x800000)
+			feature_list |= CPU_FEATURE_POPCNT;
 		if (info[2] & 0x8000000)
 			feature_list |= CPU_FEATURE_OSXSAVE;
 		if (info[2] & 0x10000000)
@@ -590,10 +639,20 @@ static void get_cpu_features(void)
 
 		if (info[2] & 0x20)
 			feature_list |= CPU_FEATURE_LZCNT;
+		if (info[2] & 0x100)
+			feature_list |= CPU_FEATURE_PREFETCHW;
+	}
+
+	if (max_id >= 0x80000007) {
+		info[0] = 0x80000007;
+		execute_cpu_id(info);
+
+		if (info[3] & 0x100)
+			feature_list |= CPU_FEATURE_INVARIANT_TSC;
 	}
 
 	if ((feature_list & CPU_FEATURE_OSXSAVE) && (execute_get_xcr0_low() & 0x4) == 0)
-		feature_list &= ~(sljit_u32)(CPU_FEATURE_AVX | CPU_FEATURE_AVX2);
+		feature_list &= ~(sljit_u32)(CPU_FEATURE_AVX | CPU_FEATURE_AVX2 | CPU_FEATURE_FMA);
 
 	cpu_feature_list = feature_list;
 }
@@ -672,7 +731,10 @@ static sljit_u8 get_jump_code(sljit_uw type)
 static sljit_u8* detect_far_jump_type(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_sw executable_offset);
 #else /* !SLJIT_CONFIG_X86_32 */
 static sljit_u8* detect_far_jump_type(struct sljit_jump *jump, sljit_u8 *code_ptr);
-static sljit_u8* generate_mov_addr_code(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_u8 *code, sljit_sw executable_offset);
+static sljit_u8* generate_mov_addr_code(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_u8 *code, sljit_sw executable_offset, sljit_s32 is_pic);
+static void const_pool_write(struct sljit_compiler *compiler, sljit_u8 *pool);
+static sljit_uw get_relocation_count(struct sljit_compiler *compiler);
+static void relocation_table_write(struct sljit_compiler *compiler, sljit_u8 *code, sljit_u8 *relocs, sljit_uw count);
 #endif /* SLJIT_CONFIG_X86_32 */
 
 static sljit_u8* detect_near_jump_type(struct sljit_jump *jump, sljit_u8 *code_ptr, sljit_u8 *code, sljit_sw executable_offset)
@@ -800,6 +862,685 @@ static sljit_u8 *process_extended_label(sljit_u8 *code_ptr, struct sljit_extende
 	return code_ptr;
 }
 
+static sljit_u8 *process_patch_align(sljit_u8 *code_ptr, sljit_u8 *buf_ptr)
+{
+	sljit_uw mask = buf_ptr[1];
+
+	while (((sljit_uw)code_ptr + buf_ptr[0]) & mask)
+		*code_ptr++ = NOP;
+
+	return code_ptr;
+}
+
+struct sljit_code_chain {
+	struct sljit_memory_fragment *first_buf;
+	struct sljit_memory_fragment *last_buf;
+	struct sljit_label *first_label;
+	struct sljit_label *last_label;
+	struct sljit_jump *first_jump;
+	struct sljit_jump *last_jump;
+	struct sljit_const *first_const;
+	struct sljit_const *last_const;
+	sljit_uw size;
+};
+
+static sljit_u8 *code_chain_append(struct sljit_compiler *compiler, struct sljit_code_chain *chain, sljit_u8 *data, sljit_uw size)
+{
+	struct sljit_memory_fragment *buf = chain->last_buf;
+	sljit_u8 *ptr;
+
+	if (buf == NULL || buf->used_size + size > (BUF_SIZE - (sljit_uw)SLJIT_OFFSETOF(struct sljit_memory_fragment, memory))) {
+		buf = (struct sljit_memory_fragment*)SLJIT_MALLOC(BUF_SIZE, compiler->allocator_data);
+		PTR_FAIL_IF_NULL(buf);
+		buf->next = NULL;
+		buf->used_size = 0;
+
+		if (chain->last_buf != NULL)
+			chain->last_buf->next = buf;
+		else
+			chain->first_buf = buf;
+		chain->last_buf = buf;
+	}
+
+	ptr = buf->memory + buf->used_size;
+	buf->used_size += size;
+	SLJIT_MEMCPY(ptr, data, size);
+	return ptr;
+}
+
+static void free_buf_chain(struct sljit_compiler *compiler, struct sljit_memory_fragment *buf)
+{
+	struct sljit_memory_fragment *curr;
+	SLJIT_UNUSED_ARG(compiler);
+
+	while (buf) {
+		curr = buf;
+		buf = buf->next;
+		SLJIT_FREE(curr, compiler->allocator_data);
+	}
+}
+
+/* Moves the cold regions after the hot code. The buffers
+   must be in the original order (see: reverse_buf). */
+static sljit_s32 move_cold_regions(struct sljit_compiler *compiler)
+{
+	struct sljit_memory_fragment *buf;
+	struct sljit_cold_region *region = compiler->cold_regions;
+	struct sljit_label *label = compiler->labels;
+	struct sljit_label *next_label;
+	struct sljit_jump *jump = compiler->jumps;
+	struct sljit_jump *next_jump;
+	struct sljit_const *const_ = compiler->consts;
+	struct sljit_const *next_const;
+	struct sljit_code_chain chains[2];
+	struct sljit_code_chain *chain = chains;
+	sljit_u8 *buf_ptr;
+	sljit_u8 *buf_end;
+	sljit_uw size = 0;
+	sljit_uw len;
+
+	SLJIT_ZEROMEM(chains, sizeof(chains));
+
+	/* The offsets of labels, jumps and consts are recomputed relative
+	   to the start of their chain. Cold offsets are adjusted later. */
+	buf = compiler->buf;
+	do {
+		buf_ptr = buf->memory;
+		buf_end = buf_ptr + buf->used_size;
+
+		while (buf_ptr < buf_end) {
+			len = *buf_ptr;
+
+			if (len < SLJIT_INST_PATCH_ALIGN) {
+				if (!code_chain_append(compiler, chain, buf_ptr, len + 1))
+					goto alloc_failed;
+
+				size += len;
+				chain->size += len;
+				buf_ptr += len + 1;
+				continue;
+			}
+
+			if (len == SLJIT_INST_PATCH_ALIGN) {
+				if (!code_chain_append(compiler, chain, buf_ptr, 3))
+					goto alloc_failed;
+
+				size += buf_ptr[2];
+				chain->size += buf_ptr[2];
+				buf_ptr += 3;
+				continue;
+			}
+
+			if (len == SLJIT_INST_LABEL) {
+				if (chain != chains && label == region->end) {
+					region = region->next;
+					chain = chains;
+				}
+
+				if (chain == chains && region != NULL && label == region->start)
+					chain = chains + 1;
+
+				if (label->u.index >= SLJIT_LABEL_ALIGNED) {
+					size += ((struct sljit_extended_label*)label)->data;
+					chain->size += ((struct sljit_extended_label*)label)->data;
+				}
+			}
+
+			if (!code_chain_append(compiler, chain, buf_ptr, 1))
+				goto alloc_failed;
+			buf_ptr++;
+
+			switch (len) {
+			case SLJIT_INST_LABEL:
+				next_label = label->next;
+				label->next = NULL;
+				label->size = chain->size;
+
+				if (chain->last_label != NULL)
+					chain->last_label->next = label;
+				else
+					chain->first_label = label;
+				chain->last_label = label;
+				label = next_label;
+				break;
+			case SLJIT_INST_JUMP:
+			case SLJIT_INST_MOV_ADDR:
+				next_jump = jump->next;
+				jump->next = NULL;
+				jump->addr = chain->size - (size - jump->addr);
+
+				if (len == SLJIT_INST_JUMP) {
+					len = ((jump->flags >> TYPE_SHIFT) >= SLJIT_JUMP) ? JUMP_MAX_SIZE : CJUMP_MAX_SIZE;
+					size += len;
+					chain->size += len;
+				}
+
+				if (chain->last_jump != NULL)
+					chain->last_jump->next = jump;
+				else
+					chain->first_jump = jump;
+				chain->last_jump = jump;
+				jump = next_jump;
+				break;
+			case SLJIT_INST_CONST_POOL:
+				break;
+			default:
+				SLJIT_ASSERT(len == SLJIT_INST_CONST);
+				next_const = const_->next;
+				const_->next = NULL;
+				const_->addr = chain->size - (size - const_->addr);
+
+				if (chain->last_const != NULL)
+					chain->last_const->next = const_;
+				else
+					chain->first_const = const_;
+				chain->last_const = const_;
+				const_ = next_const;
+				break;
+			}
+		}
+
+		buf = buf->next;
+	} while (buf);
+
+	SLJIT_ASSERT(!label && !jump && !const_);
+	SLJIT_ASSERT(size == compiler->size && chains[0].size + chains[1].size == size);
+
+	free_buf_chain(compiler, compiler->buf);
+
+	size = chains[0].size;
+	compiler->buf = chains[0].first_buf;
+	compiler->labels = chains[0].first_label;
+	compiler->last_label = chains[0].last_label;
+	compiler->jumps = chains[0].first_jump;
+	compiler->last_jump = chains[0].last_jump;
+	compiler->consts = chains[0].first_const;
+	compiler->last_const = chains[0].last_const;
+
+	if (chains[1].first_buf == NULL)
+		return SLJIT_SUCCESS;
+
+	if (compiler->buf == NULL)
+		compiler->buf = chains[1].first_buf;
+	else
+		chains[0].last_buf->next = chains[1].first_buf;
+
+	label = chains[1].first_label;
+	if (label != NULL) {
+		if (compiler->last_label != NULL)
+			compiler->last_label->next = label;
+		else
+			compiler->labels = label;
+		compiler->last_label = chains[1].last_label;
+
+		do {
+			label->size += size;
+			label = label->next;
+		} while (label);
+	}
+
+	jump = chains[1].first_jump;
+	if (jump != NULL) {
+		if (compiler->last_jump != NULL)
+			compiler->last_jump->next = jump;
+		else
+			compiler->jumps = jump;
+		compiler->last_jump = chains[1].last_jump;
+
+		do {
+			jump->addr += size;
+			jump = jump->next;
+		} while (jump);
+	}
+
+	const_ = chains[1].first_const;
+	if (const_ != NULL) {
+		if (compiler->last_const != NULL)
+			compiler->last_const->next = const_;
+		else
+			compiler->consts = const_;
+		compiler->last_const = chains[1].last_const;
+
+		do {
+			const_->addr += size;
+			const_ = const_->next;
+		} while (const_);
+	}
+
+	return SLJIT_SUCCESS;
+
+alloc_failed:
+	free_buf_chain(compiler, chains[0].first_buf);
+	free_buf_chain(compiler, chains[1].first_buf);
+	return compiler->error;
+}
+
+/* Peephole optimizer. */
+
+#define PEEPHOLE_MOV_RR		1
+#define PEEPHOLE_MOV_RI		2
+#define PEEPHOLE_LOAD		3
+#define PEEPHOLE_STORE		4
+
+#define PEEPHOLE_NONE		0
+#define PEEPHOLE_REMOVE_PREV	1
+#define PEEPHOLE_REMOVE_CURR	2
+#define PEEPHOLE_REPLACE_CURR	3
+
+/* A simple move instruction recognized by the peephole optimizer. */
+struct peephole_inst {
+	sljit_u8 *inst;
+	sljit_uw len;
+	sljit_u8 type;
+	sljit_u8 rex;
+	/* Destination register, except for stores, where it is the source register. */
+	sljit_u8 reg;
+	/* Source register of register to register moves. */
+	sljit_u8 src_reg;
+	/* Offset of the modrm byte of memory operands. */
+	sljit_u8 mem_offset;
+	/* Registers used by the address of memory operands. */
+	sljit_u32 mem_regs;
+};
+
+/* Returns with non-zero, if the buffered record contains exactly one
+   32 or 64 bit move instruction which does not use RIP relative addressing. */
+static sljit_s32 peephole_decode(sljit_u8 *inst, sljit_uw len, struct peephole_inst *result)
+{
+	sljit_u8 *ptr = inst;
+	sljit_u8 *end = inst + len;
+	sljit_u8 rex = 0;
+	sljit_u8 opcode, modrm, reg, rm;
+	sljit_uw size;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	if ((*ptr & 0xf0) == REX) {
+		rex = *ptr++;
+		if (ptr >= end)
+			return 0;
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	result->inst = inst;
+	result->len = len;
+	result->rex = rex;
+	opcode = *ptr++;
+
+	if ((opcode & 0xf8) == MOV_r_i32) {
+		result->type = PEEPHOLE_MOV_RI;
+		result->reg = U8((opcode & 0x7) | ((rex & 0x1) << 3));
+		size = (rex & 0x8) ? 8 : 4;
+		return (sljit_uw)(end - ptr) == size;
+	}
+
+	if ((opcode != MOV_rm_r && opcode != MOV_r_rm && opcode != MOV_rm_i32) || ptr >= end)
+		return 0;
+
+	result->mem_offset = U8(ptr - inst);
+	modrm = *ptr++;
+	reg = U8(((modrm >> 3) & 0x7) | ((rex & 0x4) << 1));
+	rm = U8((modrm & 0x7) | ((rex & 0x1) << 3));
+
+	if ((modrm & 0xc0) == 0xc0) {
+		if (opcode == MOV_rm_i32) {
+			result->type = PEEPHOLE_MOV_RI;
+			result->reg = rm;
+			return (modrm & 0x38) == 0 && end - ptr == 4;
+		}
+
+		result->type = PEEPHOLE_MOV_RR;
+		result->reg = (opcode == MOV_rm_r) ? rm : reg;
+		result->src_reg = (opcode == MOV_rm_r) ? reg : rm;
+		return ptr == end;
+	}
+
+	if (opcode == MOV_rm_i32)
+		return 0;
+
+	result->type = (opcode == MOV_rm_r) ? PEEPHOLE_STORE : PEEPHOLE_LOAD;
+	result->reg = reg;
+	result->mem_regs = 0;
+	size = ((modrm & 0xc0) == 0x40) ? 1 : (((modrm & 0xc0) == 0x80) ? 4 : 0);
+
+	if ((modrm & 0x7) == 0x4) {
+		if (ptr >= end)
+			return 0;
+
+		modrm = *ptr++;
+		if ((modrm & 0x7) == 0x5 && size == 0)
+			size = 4;
+		else
+			result->mem_regs |= (sljit_u32)1 << ((modrm & 0x7) | ((rex & 0x1) << 3));
+
+		rm = U8(((modrm >> 3) & 0x7) | ((rex & 0x2) << 2));
+		if (rm != 0x4)
+			result->mem_regs |= (sljit_u32)1 << rm;
+	} else if ((modrm & 0xc7) == 0x5) {
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+		/* RIP relative addressing. */
+		return 0;
+#else /* !SLJIT_CONFIG_X86_64 */
+		size = 4;
+#endif /* SLJIT_CONFIG_X86_64 */
+	} else
+		result->mem_regs |= (sljit_u32)1 << rm;
+
+	return (sljit_uw)(end - ptr) == size;
+}
+
+static sljit_s32 peephole_self_move(struct peephole_inst *prev, struct peephole_inst *curr)
+{
+	SLJIT_UNUSED_ARG(prev);
+
+	if (curr->type != PEEPHOLE_MOV_RR || curr->reg != curr->src_reg)
+		return PEEPHOLE_NONE;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	/* A 32 bit move clears the upper 32 bit of the register. */
+	if (!(curr->rex & 0x8))
+		return PEEPHOLE_NONE;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	return PEEPHOLE_REMOVE_CURR;
+}
+
+static sljit_s32 peephole_reload(struct peephole_inst *prev, struct peephole_inst *curr)
+{
+	sljit_u8 *inst;
+	sljit_uw i;
+	sljit_u8 rex = 0;
+
+	if (prev == NULL || prev->type != PEEPHOLE_STORE || curr->type != PEEPHOLE_LOAD)
+		return PEEPHOLE_NONE;
+
+	/* The operand size and the memory operand must be the same. */
+	if (((prev->rex ^ curr->rex) & 0xb) != 0 || prev->len - prev->mem_offset != curr->len - curr->mem_offset
+			|| ((prev->inst[prev->mem_offset] ^ curr->inst[curr->mem_offset]) & 0xc7) != 0)
+		return PEEPHOLE_NONE;
+
+	for (i = curr->len - curr->mem_offset - 1; i > 0; i--)
+		if (prev->inst[prev->mem_offset + i] != curr->inst[curr->mem_offset + i])
+			return PEEPHOLE_NONE;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	if (prev->reg == curr->reg && (curr->rex & 0x8))
+		return PEEPHOLE_REMOVE_CURR;
+
+	rex = U8((curr->rex & 0x8) | ((prev->reg & 0x8) >> 1) | ((curr->reg & 0x8) >> 3));
+#else /* !SLJIT_CONFIG_X86_64 */
+	if (prev->reg == curr->reg)
+		return PEEPHOLE_REMOVE_CURR;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	/* Replace the load with a register to register move. */
+	if ((rex != 0 ? 3 : 2) > curr->len)
+		return PEEPHOLE_NONE;
+
+	inst = curr->inst;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	if (rex != 0)
+		*inst++ = U8(REX | rex);
+#endif /* SLJIT_CONFIG_X86_64 */
+	inst[0] = MOV_rm_r;
+	inst[1] = U8(MOD_REG | ((prev->reg & 0x7) << 3) | (curr->reg & 0x7));
+
+	curr->len = (sljit_uw)(inst + 2 - curr->inst);
+	curr->type = PEEPHOLE_MOV_RR;
+	curr->rex = rex;
+	curr->src_reg = prev->reg;
+	return PEEPHOLE_REPLACE_CURR;
+}
+
+static sljit_s32 peephole_dead_move(struct peephole_inst *prev, struct peephole_inst *curr)
+{
+	if (prev == NULL || (prev->type != PEEPHOLE_MOV_RR && prev->type != PEEPHOLE_MOV_RI) || curr->reg != prev->reg)
+		return PEEPHOLE_NONE;
+
+	/* The 32 bit forms also overwrite the whole register. */
+	switch (curr->type) {
+	case PEEPHOLE_MOV_RR:
+		if (curr->src_reg == prev->reg)
+			return PEEPHOLE_NONE;
+		break;
+	case PEEPHOLE_MOV_RI:
+		break;
+	case PEEPHOLE_LOAD:
+		if (curr->mem_regs & ((sljit_u32)1 << prev->reg))
+			return PEEPHOLE_NONE;
+		break;
+	default:
+		return PEEPHOLE_NONE;
+	}
+
+	return PEEPHOLE_REMOVE_PREV;
+}
+
+typedef sljit_s32 (*peephole_rule)(struct peephole_inst *prev, struct peephole_inst *curr);
+
+/* The order must follow the SLJIT_PEEPHOLE_* constants. */
+static const peephole_rule peephole_rules[SLJIT_PEEPHOLE_RULE_COUNT] = {
+	peephole_self_move,
+	peephole_reload,
+	peephole_dead_move,
+};
+
+/* The hand written short jumps (e.g. in emit_cmov_generic) encode the
+   distance of the target, so the instructions between a short jump and
+   its target must not be changed. Returns with a bitmap of these bytes,
+   or NULL if no such jumps are present. The buffers must be in the
+   original order (see: reverse_buf). */
+static sljit_u8 *peephole_find_short_jumps(struct sljit_compiler *compiler)
+{
+	struct sljit_memory_fragment *buf = compiler->buf;
+	struct sljit_label *label = compiler->labels;
+	struct sljit_jump *jump = compiler->jumps;
+	sljit_u8 *bitmap = NULL;
+	sljit_u8 *buf_ptr;
+	sljit_u8 *buf_end;
+	sljit_uw size = 0;
+	sljit_uw start, end;
+	sljit_uw len;
+
+	do {
+		buf_ptr = buf->memory;
+		buf_end = buf_ptr + buf->used_size;
+
+		while (buf_ptr < buf_end) {
+			len = *buf_ptr++;
+
+			if (len < SLJIT_INST_PATCH_ALIGN) {
+				if (len == 2 && ((buf_ptr[0] & 0xf0) == 0x70 || buf_ptr[0] == JMP_i8 || (buf_ptr[0] & 0xfc) == 0xe0)) {
+					if (bitmap == NULL) {
+						bitmap = (sljit_u8*)SLJIT_MALLOC((compiler->size + 7) >> 3, compiler->allocator_data);
+						PTR_FAIL_IF_NULL(bitmap);
+						SLJIT_ZEROMEM(bitmap, (compiler->size + 7) >> 3);
+					}
+
+					start = size + 2;
+					end = (sljit_uw)((sljit_sw)start + (sljit_s8)buf_ptr[1]);
+					if (end < start) {
+						start = end;
+						end = size + 2;
+					}
+
+					SLJIT_ASSERT(end <= compiler->size);
+					for (; start < end; start++)
+						bitmap[start >> 3] = U8(bitmap[start >> 3] | (1 << (start & 0x7)));
+				}
+
+				size += len;
+				buf_ptr += len;
+				continue;
+			}
+
+			switch (len) {
+			case SLJIT_INST_LABEL:
+				if (label->u.index >= SLJIT_LABEL_ALIGNED)
+					size += ((struct sljit_extended_label*)label)->data;
+				label = label->next;
+				break;
+			case SLJIT_INST_JUMP:
+				size += ((jump->flags >> TYPE_SHIFT) >= SLJIT_JUMP) ? JUMP_MAX_SIZE : CJUMP_MAX_SIZE;
+				SLJIT_FALLTHROUGH
+			case SLJIT_INST_MOV_ADDR:
+				jump = jump->next;
+				break;
+			case SLJIT_INST_PATCH_ALIGN:
+				size += buf_ptr[1];
+				buf_ptr += 2;
+				break;
+			}
+		}
+
+		buf = buf->next;
+	} while (buf);
+
+	return bitmap;
+}
+
+/* Applies the peephole rules to the buffered instruction stream. The
+   buffers must be in the original order (see: reverse_buf). */
+static sljit_s32 peephole_optimize(struct sljit_compiler *compiler)
+{
+	struct sljit_memory_fragment *buf = compiler->buf;
+	struct sljit_memory_fragment *prev_buf = NULL;
+	struct sljit_memory_fragment *next_buf;
+	struct sljit_label *label = compiler->labels;
+	struct sljit_jump *jump = compiler->jumps;
+	struct sljit_const *const_ = compiler->consts;
+	struct peephole_inst insts[2];
+	struct peephole_inst *prev;
+	struct peephole_inst *curr;
+	sljit_u8 *bitmap;
+	sljit_u8 *buf_ptr;
+	sljit_u8 *buf_end;
+	sljit_u8 *dst_ptr;
+	sljit_u8 *prev_ptr = NULL;
+	sljit_uw size = 0;
+	sljit_uw removed = 0;
+	sljit_uw len;
+	sljit_s32 i, action;
+
+	bitmap = peephole_find_short_jumps(compiler);
+	if (bitmap == NULL && compiler->error != SLJIT_SUCCESS)
+		return compiler->error;
+
+	do {
+		buf_ptr = buf->memory;
+		buf_end = buf_ptr + buf->used_size;
+		dst_ptr = buf_ptr;
+		/* Instructions are not combined across buffers. */
+		prev = NULL;
+
+		while (buf_ptr < buf_end) {
+			len = *buf_ptr;
+
+			if (len == SLJIT_INST_PATCH_ALIGN) {
+				size += buf_ptr[2];
+				SLJIT_MEMMOVE(dst_ptr, buf_ptr, 3);
+				dst_ptr += 3;
+				buf_ptr += 3;
+				prev = NULL;
+				continue;
+			}
+
+			if (len > SLJIT_INST_PATCH_ALIGN) {
+				switch (len) {
+				case SLJIT_INST_LABEL:
+					if (label->u.index >= SLJIT_LABEL_ALIGNED)
+						size += ((struct sljit_extended_label*)label)->data;
+					label->size -= removed;
+					label = label->next;
+					break;
+				case SLJIT_INST_JUMP:
+				case SLJIT_INST_MOV_ADDR:
+					if (len == SLJIT_INST_JUMP)
+						size += ((jump->flags >> TYPE_SHIFT) >= SLJIT_JUMP) ? JUMP_MAX_SIZE : CJUMP_MAX_SIZE;
+					jump->addr -= removed;
+					jump = jump->next;
+					break;
+				case SLJIT_INST_CONST_POOL:
+					break;
+				default:
+					const_->addr -= removed;
+					const_ = const_->next;
+					break;
+				}
+
+				*dst_ptr++ = *buf_ptr++;
+				prev = NULL;
+				continue;
+			}
+
+			curr = (prev == insts) ? insts + 1 : insts;
+			action = PEEPHOLE_NONE;
+
+			if ((bitmap == NULL || !(bitmap[size >> 3] & (1 << (size & 0x7))))
+					&& peephole_decode(buf_ptr + 1, len, curr)) {
+				for (i = 0; i < SLJIT_PEEPHOLE_RULE_COUNT; i++) {
+					action = peephole_rules[i](prev, curr);
+					if (action != PEEPHOLE_NONE) {
+						compiler->peephole_counts[i]++;
+						break;
+					}
+				}
+			} else
+				curr = NULL;
+
+			size += len;
+			buf_ptr += len + 1;
+
+			switch (action) {
+			case PEEPHOLE_REMOVE_CURR:
+				removed += len;
+				continue;
+			case PEEPHOLE_REMOVE_PREV:
+				removed += prev->len;
+				dst_ptr = prev_ptr;
+				break;
+			case PEEPHOLE_REPLACE_CURR:
+				removed += len - curr->len;
+				break;
+			}
+
+			prev_ptr = dst_ptr;
+			if (curr != NULL) {
+				*dst_ptr++ = U8(curr->len);
+				SLJIT_MEMMOVE(dst_ptr, curr->inst, curr->len);
+				curr->inst = dst_ptr;
+				dst_ptr += curr->len;
+			} else {
+				SLJIT_MEMMOVE(dst_ptr, buf_ptr - len - 1, len + 1);
+				dst_ptr += len + 1;
+			}
+			prev = curr;
+		}
+
+		next_buf = buf->next;
+		buf->used_size = (sljit_uw)(dst_ptr - buf->memory);
+
+		if (buf->used_size == 0) {
+			if (prev_buf != NULL)
+				prev_buf->next = next_buf;
+			else
+				compiler->buf = next_buf;
+			SLJIT_FREE(buf, compiler->allocator_data);
+		} else
+			prev_buf = buf;
+
+		buf = next_buf;
+	} while (buf);
+
+	SLJIT_ASSERT(!label && !jump && !const_);
+	SLJIT_ASSERT(size == compiler->size);
+
+	if (bitmap != NULL)
+		SLJIT_FREE(bitmap, compiler->allocator_data);
+
+	compiler->size -= removed;
+	return SLJIT_SUCCESS;
+}
+
 static void reduce_code_size(struct sljit_compiler *compiler)
 {
 	struct sljit_label *label;
@@ -924,10 +1665,17 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 	sljit_u8 *buf_ptr;
 	sljit_u8 *buf_end;
 	sljit_u8 len;
+	sljit_uw code_size;
 	sljit_sw executable_offset;
 #if (defined SLJIT_DEBUG && SLJIT_DEBUG)
 	sljit_uw addr;
 #endif /* SLJIT_DEBUG */
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	sljit_uw const_pool_start;
+	sljit_s32 pool_offset;
+	sljit_uw reloc_start = 0;
+	sljit_uw reloc_count = 0;
+#endif /* SLJIT_CONFIG_X86_64 */
 
 	struct sljit_label *label;
 	struct sljit_jump *jump;
@@ -936,13 +1684,35 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 	CHECK_ERROR_PTR();
 	CHECK_PTR(check_sljit_generate_code(compiler, options));
 
+	reverse_buf(compiler);
+
+	if (SLJIT_UNLIKELY(compiler->cold_regions != NULL))
+		PTR_FAIL_IF(move_cold_regions(compiler));
+
+	if (options & SLJIT_GENERATE_CODE_PEEPHOLE)
+		PTR_FAIL_IF(peephole_optimize(compiler));
+
 	reduce_code_size(compiler);
 
+	code_size = compiler->size;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	/* The constant pool is placed after the code. */
+	const_pool_start = (code_size + sizeof(sljit_uw) - 1) & ~(sljit_uw)(sizeof(sljit_uw) - 1);
+	if (compiler->const_pool_size > 0)
+		code_size = const_pool_start + compiler->const_pool_size;
+
+	if (options & SLJIT_GENERATE_CODE_PIC) {
+		/* The relocation table is placed after the constant pool. */
+		reloc_count = get_relocation_count(compiler);
+		reloc_start = (code_size + sizeof(sljit_u32) - 1) & ~(sljit_uw)(sizeof(sljit_u32) - 1);
+		code_size = reloc_start + (reloc_count + 1) * sizeof(sljit_u32);
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
 	/* Second code generation pass. */
-	code = (sljit_u8*)allocate_executable_memory(compiler->size, options, exec_allocator_data, &executable_offset);
+	code = (sljit_u8*)allocate_executable_memory(code_size, options, exec_allocator_data, &executable_offset);
 	PTR_FAIL_WITH_EXEC_IF(code);
 
-	reverse_buf(compiler);
 	buf = compiler->buf;
 
 	code_ptr = code;
@@ -956,13 +1726,17 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 		do {
 			len = *buf_ptr++;
 			SLJIT_ASSERT(len > 0);
-			if (len < SLJIT_INST_CONST) {
+			if (len < SLJIT_INST_PATCH_ALIGN) {
 				/* The code is already generated. */
 				SLJIT_MEMCPY(code_ptr, buf_ptr, len);
 				code_ptr += len;
 				buf_ptr += len;
 			} else {
 				switch (len) {
+				case SLJIT_INST_PATCH_ALIGN:
+					code_ptr = process_patch_align(code_ptr, buf_ptr);
+					buf_ptr += 2;
+					break;
 				case SLJIT_INST_LABEL:
 					if (label->u.index >= SLJIT_LABEL_ALIGNED)
 						code_ptr = process_extended_label(code_ptr, (struct sljit_extended_label*)label);
@@ -975,7 +1749,8 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 #if (defined SLJIT_DEBUG && SLJIT_DEBUG)
 					addr = (sljit_uw)code_ptr;
 #endif /* SLJIT_DEBUG */
-					if (!(jump->flags & SLJIT_REWRITABLE_JUMP))
+					/* Position independent code never uses relative jumps to absolute addresses. */
+					if (!(jump->flags & SLJIT_REWRITABLE_JUMP) && !((options & SLJIT_GENERATE_CODE_PIC) && (jump->flags & JUMP_ADDR)))
 						code_ptr = detect_near_jump_type(jump, code_ptr, code, executable_offset);
 					else {
 #if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
@@ -990,11 +1765,19 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 					break;
 				case SLJIT_INST_MOV_ADDR:
 #if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
-					code_ptr = generate_mov_addr_code(jump, code_ptr, code, executable_offset);
+					code_ptr = generate_mov_addr_code(jump, code_ptr, code, executable_offset, options & SLJIT_GENERATE_CODE_PIC);
 #endif /* SLJIT_CONFIG_X86_64 */
 					jump->addr = (sljit_uw)code_ptr;
 					jump = jump->next;
 					break;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+				case SLJIT_INST_CONST_POOL:
+					/* The displacement contains the offset of the data in the pool. */
+					SLJIT_MEMCPY(&pool_offset, code_ptr - sizeof(sljit_s32), sizeof(sljit_s32));
+					sljit_unaligned_store_s32(code_ptr - sizeof(sljit_s32),
+						(sljit_s32)(const_pool_start + (sljit_uw)pool_offset - (sljit_uw)(code_ptr - code)));
+					break;
+#endif /* SLJIT_CONFIG_X86_64 */
 				default:
 					SLJIT_ASSERT(len == SLJIT_INST_CONST);
 					const_->addr = (sljit_uw)code_ptr;
@@ -1013,12 +1796,28 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 	SLJIT_ASSERT(!const_);
 	SLJIT_ASSERT(code_ptr <= code + compiler->size);
 
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	if (compiler->const_pool_size > 0) {
+		const_pool_write(compiler, code + const_pool_start);
+		code_ptr = code + code_size;
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
 	jump = compiler->jumps;
 	while (jump) {
 		generate_jump_or_mov_addr(jump, executable_offset);
 		jump = jump->next;
 	}
 
+	sljit_write_switch_tables(compiler, executable_offset);
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	if (options & SLJIT_GENERATE_CODE_PIC) {
+		relocation_table_write(compiler, code, code + reloc_start, reloc_count);
+		code_ptr = code + code_size;
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
 	compiler->error = SLJIT_ERR_COMPILED;
 	compiler->executable_offset = executable_offset;
 	compiler->executable_size = (sljit_uw)(code_ptr - code);
@@ -1060,6 +1859,51 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 
 		return (cpu_feature_list & CPU_FEATURE_TZCNT) ? 1 : 2;
 
+	case SLJIT_HAS_POPCNT:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_POPCNT) ? 1 : 2;
+
+	case SLJIT_HAS_PDEP_PEXT:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_BMI2) != 0;
+
+	case SLJIT_HAS_FMA:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_FMA) ? 1 : 2;
+
+	case SLJIT_HAS_FROUND:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_SSE41) != 0;
+
+	case SLJIT_HAS_CRC32C:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_SSE42) ? 1 : 2;
+
+	case SLJIT_HAS_PREFETCH_WRITE:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_PREFETCHW) ? 1 : 2;
+
+	case SLJIT_HAS_CYCLE_COUNTER:
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		return (cpu_feature_list & CPU_FEATURE_INVARIANT_TSC) ? 1 : 2;
+
+	case SLJIT_HAS_THREAD_POINTER:
+		return 1;
+
 	case SLJIT_HAS_CMOV:
 		if (cpu_feature_list == 0)
 			get_cpu_features();
@@ -1636,6 +2480,23 @@ static sljit_s32 emit_prefetch(struct sljit_compiler *compiler, sljit_s32 op,
 	compiler->mode32 = 1;
 #endif
 
+	if (op >= SLJIT_PREFETCH_WRITE_L1) {
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		if (cpu_feature_list & CPU_FEATURE_PREFETCHW) {
+			/* Prefetchw has no cache level hints. */
+			inst = emit_x86_instruction(compiler, 2, 0, 0, src, srcw);
+			FAIL_IF(!inst);
+			inst[0] = GROUP_0F;
+			inst[1] = PREFETCHW;
+			inst[2] |= (1 << 3);
+			return SLJIT_SUCCESS;
+		}
+
+		op += SLJIT_PREFETCH_L1 - SLJIT_PREFETCH_WRITE_L1;
+	}
+
 	inst = emit_x86_instruction(compiler, 2, 0, 0, src, srcw);
 	FAIL_IF(!inst);
 	inst[0] = GROUP_0F;
@@ -1784,18 +2645,120 @@ static sljit_s32 emit_clz_ctz(struct sljit_compiler *compiler, sljit_s32 is_clz,
 	else
 		max = compiler->mode32 ? 32 : 64;
 
-	if (cpu_feature_list & CPU_FEATURE_CMOV) {
-		EMIT_MOV(compiler, TMP_REG2, 0, SLJIT_IMM, max);
-		FAIL_IF(emit_groupf(compiler, CMOVE_r_rm, dst_r, TMP_REG2, 0));
-	} else
-		FAIL_IF(emit_cmov_generic(compiler, SLJIT_EQUAL, dst_r, SLJIT_IMM, max));
+	if (cpu_feature_list & CPU_FEATURE_CMOV) {
+		EMIT_MOV(compiler, TMP_REG2, 0, SLJIT_IMM, max);
+		FAIL_IF(emit_groupf(compiler, CMOVE_r_rm, dst_r, TMP_REG2, 0));
+	} else
+		FAIL_IF(emit_cmov_generic(compiler, SLJIT_EQUAL, dst_r, SLJIT_IMM, max));
+
+	if (is_clz) {
+		inst = emit_x86_instruction(compiler, 1 | EX86_BIN_INS, SLJIT_IMM, max >> 1, dst_r, 0);
+		FAIL_IF(!inst);
+		*(inst + 1) |= XOR;
+	}
+#endif
+
+	if (dst & SLJIT_MEM)
+		EMIT_MOV(compiler, dst, dstw, TMP_REG1, 0);
+	return SLJIT_SUCCESS;
+}
+
+static sljit_s32 emit_popcnt_and(struct sljit_compiler *compiler,
+	sljit_s32 dst, sljit_sw dstw, sljit_uw mask)
+{
+	sljit_u8* inst;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	sljit_uw offset;
+
+	if (!compiler->mode32) {
+		SLJIT_ASSERT(FAST_IS_REG(dst));
+		FAIL_IF(const_pool_get_offset(compiler, mask, 1, &offset));
+		return emit_const_pool_load(compiler, offset, 0, U8(REX_W | ((reg_map[dst] <= 7) ? 0 : REX_R)), AND_r_rm, reg_lmap[dst]);
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	BINARY_IMM32(AND, (sljit_sw)mask, dst, dstw);
+	return SLJIT_SUCCESS;
+}
+
+static sljit_s32 emit_popcnt(struct sljit_compiler *compiler,
+	sljit_s32 dst, sljit_sw dstw,
+	sljit_s32 src, sljit_sw srcw)
+{
+	sljit_u8* inst;
+	sljit_s32 dst_r = FAST_IS_REG(dst) ? dst : TMP_REG1;
+	sljit_s32 tmp = TMP_REG1;
+	sljit_sw tmpw = 0;
+	sljit_uw all_ones = ~(sljit_uw)0;
+
+	SLJIT_ASSERT(cpu_feature_list != 0);
+
+	if (cpu_feature_list & CPU_FEATURE_POPCNT) {
+		FAIL_IF(emit_groupf(compiler, POPCNT_r_rm | EX86_PREF_F3, dst_r, src, srcw));
+
+		if (dst & SLJIT_MEM)
+			EMIT_MOV(compiler, dst, dstw, TMP_REG1, 0);
+		return SLJIT_SUCCESS;
+	}
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	tmp = TMP_REG2;
+	if (compiler->mode32)
+		all_ones = 0xffffffff;
+#else /* !SLJIT_CONFIG_X86_64 */
+	/* The memory destination is used as a temporary value. */
+	if (dst_r == TMP_REG1) {
+		tmp = dst;
+		tmpw = dstw;
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	/* The number of bits are summed in 2, 4 and 8 bit wide
+	   fields, and the bytes are added by a multiplication. */
+	EMIT_MOV(compiler, dst_r, 0, src, srcw);
+	EMIT_MOV(compiler, tmp, tmpw, dst_r, 0);
+
+	inst = emit_x86_instruction(compiler, 1 | EX86_SHIFT_INS, SLJIT_IMM, 1, tmp, tmpw);
+	FAIL_IF(!inst);
+	inst[1] |= SHR;
+
+	FAIL_IF(emit_popcnt_and(compiler, tmp, tmpw, all_ones / 3));
+
+	inst = emit_x86_instruction(compiler, 1, dst_r, 0, tmp, tmpw);
+	FAIL_IF(!inst);
+	*inst = SUB_r_rm;
+
+	EMIT_MOV(compiler, tmp, tmpw, dst_r, 0);
+
+	inst = emit_x86_instruction(compiler, 1 | EX86_SHIFT_INS, SLJIT_IMM, 2, tmp, tmpw);
+	FAIL_IF(!inst);
+	inst[1] |= SHR;
+
+	FAIL_IF(emit_popcnt_and(compiler, tmp, tmpw, all_ones / 5));
+	FAIL_IF(emit_popcnt_and(compiler, dst_r, 0, all_ones / 5));
+
+	inst = emit_x86_instruction(compiler, 1, dst_r, 0, tmp, tmpw);
+	FAIL_IF(!inst);
+	*inst = ADD_r_rm;
+
+	EMIT_MOV(compiler, tmp, tmpw, dst_r, 0);
+
+	inst = emit_x86_instruction(compiler, 1 | EX86_SHIFT_INS, SLJIT_IMM, 4, tmp, tmpw);
+	FAIL_IF(!inst);
+	inst[1] |= SHR;
+
+	inst = emit_x86_instruction(compiler, 1, dst_r, 0, tmp, tmpw);
+	FAIL_IF(!inst);
+	*inst = ADD_r_rm;
+
+	FAIL_IF(emit_popcnt_and(compiler, dst_r, 0, all_ones / 17));
 
-	if (is_clz) {
-		inst = emit_x86_instruction(compiler, 1 | EX86_BIN_INS, SLJIT_IMM, max >> 1, dst_r, 0);
-		FAIL_IF(!inst);
-		*(inst + 1) |= XOR;
-	}
-#endif
+	EMIT_MOV(compiler, tmp, tmpw, SLJIT_IMM, (sljit_sw)(all_ones / 255));
+	FAIL_IF(emit_groupf(compiler, IMUL_r_rm, dst_r, tmp, tmpw));
+
+	inst = emit_x86_instruction(compiler, 1 | EX86_SHIFT_INS, SLJIT_IMM, (all_ones == 0xffffffff) ? 24 : 56, dst_r, 0);
+	FAIL_IF(!inst);
+	inst[1] |= SHR;
 
 	if (dst & SLJIT_MEM)
 		EMIT_MOV(compiler, dst, dstw, TMP_REG1, 0);
@@ -1908,6 +2871,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op1(compiler, op, dst, dstw, src, srcw));
+	FOLD_OP1_OPERATION(compiler, op, dst, dstw, src, srcw);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src, srcw);
 
@@ -2026,6 +2990,8 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op1(struct sljit_compiler *compile
 	case SLJIT_CLZ:
 	case SLJIT_CTZ:
 		return emit_clz_ctz(compiler, (op == SLJIT_CLZ), dst, dstw, src, srcw);
+	case SLJIT_POPCNT:
+		return emit_popcnt(compiler, dst, dstw, src, srcw);
 	case SLJIT_REV:
 	case SLJIT_REV_U16:
 	case SLJIT_REV_S16:
@@ -2695,6 +3661,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2(struct sljit_compiler *compile
 {
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2(compiler, op, 0, dst, dstw, src1, src1w, src2, src2w));
+	FOLD_OP2_OPERATION(compiler, op, dst, dstw, src1, src1w, src2, src2w);
 	ADJUST_LOCAL_OFFSET(dst, dstw);
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
@@ -2805,16 +3772,108 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2u(struct sljit_compiler *compil
 	return emit_test_binary(compiler, src1, src1w, src2, src2w);
 }
 
+static sljit_s32 emit_crc32c(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_sw dstw,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	sljit_u8* inst;
+	sljit_s32 dst_r = TMP_REG1;
+	sljit_uw flags = EX86_PREF_F2;
+	sljit_s32 load_src2 = (src2 == SLJIT_IMM);
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	compiler->mode32 = GET_OPCODE(op) != SLJIT_CRC32C;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	switch (GET_OPCODE(op)) {
+	case SLJIT_CRC32C_U8:
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+		if (FAST_IS_REG(src2) && reg_map[src2] >= 4)
+			load_src2 = 1;
+#else /* !SLJIT_CONFIG_X86_32 */
+		flags |= EX86_REX;
+#endif /* SLJIT_CONFIG_X86_32 */
+		break;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	case SLJIT_CRC32C_U16:
+		/* The operand size prefix must be emitted before the instruction,
+		   so the address cannot be computed by the instruction emitter. */
+		if ((src2 & SLJIT_MEM) && !(src2 & OFFS_REG_MASK) && NOT_HALFWORD(src2w))
+			load_src2 = 1;
+		break;
+#endif /* SLJIT_CONFIG_X86_64 */
+	}
+
+	if (load_src2) {
+		if (FAST_IS_REG(dst_reg)) {
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+			if (src2 & SLJIT_MEM) {
+				FAIL_IF(emit_mov_half(compiler, 0, TMP_REG1, 0, src2, src2w));
+				compiler->mode32 = 1;
+			} else
+#endif /* SLJIT_CONFIG_X86_64 */
+				EMIT_MOV(compiler, TMP_REG1, 0, src2, src2w);
+
+			src2 = TMP_REG1;
+			src2w = 0;
+			dst_r = dst_reg;
+		}
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+		else {
+			/* Virtual register: its memory location holds the data. */
+			EMIT_MOV(compiler, TMP_REG1, 0, src1, src1w);
+			EMIT_MOV(compiler, dst_reg, dstw, src2, src2w);
+			src1 = TMP_REG1;
+			src2 = dst_reg;
+			src2w = dstw;
+		}
+#endif /* SLJIT_CONFIG_X86_32 */
+	} else if (FAST_IS_REG(dst_reg) && dst_reg != src2
+			&& !((src2 & SLJIT_MEM) && ((src2 & REG_MASK) == dst_reg || OFFS_REG(src2) == dst_reg)))
+		dst_r = dst_reg;
+
+	if (dst_r != src1)
+		EMIT_MOV(compiler, dst_r, 0, src1, src1w);
+
+	if (GET_OPCODE(op) == SLJIT_CRC32C_U16)
+		FAIL_IF(emit_byte(compiler, GROUP_66));
+
+	inst = emit_x86_instruction(compiler, 3 | flags, dst_r, 0, src2, src2w);
+	FAIL_IF(!inst);
+	inst[0] = GROUP_0F;
+	inst[1] = 0x38;
+	inst[2] = GET_OPCODE(op) == SLJIT_CRC32C_U8 ? CRC32_r_rm8 : CRC32_r_rm;
+
+	if (dst_r != dst_reg)
+		EMIT_MOV(compiler, dst_reg, dstw, TMP_REG1, 0);
+	return SLJIT_SUCCESS;
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst_reg,
 	sljit_s32 src1, sljit_sw src1w,
 	sljit_s32 src2, sljit_sw src2w)
 {
 	sljit_u8* inst;
+	sljit_s32 dst_r;
 	sljit_sw dstw = 0;
 
 	CHECK_ERROR();
 	CHECK(check_sljit_emit_op2r(compiler, op, dst_reg, src1, src1w, src2, src2w));
+
+	if (GET_OPCODE(op) >= SLJIT_CRC32C_U8) {
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		if (!(cpu_feature_list & CPU_FEATURE_SSE42) || (src1 == SLJIT_IMM && src2 == SLJIT_IMM))
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+			return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG1, 0);
+#else /* !SLJIT_CONFIG_X86_32 */
+			return emit_crc32c_generic(compiler, op, dst_reg, src1, src1w, src2, src2w, TMP_REG2, TMP_REG1);
+#endif /* SLJIT_CONFIG_X86_32 */
+	}
+
 	ADJUST_LOCAL_OFFSET(src1, src1w);
 	ADJUST_LOCAL_OFFSET(src2, src2w);
 
@@ -2832,6 +3891,39 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2r(struct sljit_compiler *compil
 		FAIL_IF(!inst);
 		*inst = ADD_rm_r;
 		return SLJIT_SUCCESS;
+	case SLJIT_PDEP:
+	case SLJIT_PEXT:
+		dst_r = FAST_IS_REG(dst_reg) ? dst_reg : TMP_REG1;
+
+		if (!FAST_IS_REG(src1)) {
+			EMIT_MOV(compiler, TMP_REG1, 0, src1, src1w);
+			src1 = TMP_REG1;
+		}
+
+		if (src2 == SLJIT_IMM) {
+			/* When dst_reg is the same as src1, src1 is not TMP_REG1. */
+			if (dst_reg == src1) {
+				EMIT_MOV(compiler, TMP_REG1, 0, SLJIT_IMM, src2w);
+				src2 = TMP_REG1;
+				src2w = 0;
+			} else {
+				EMIT_MOV(compiler, dst_reg, dstw, SLJIT_IMM, src2w);
+				src2 = dst_reg;
+				src2w = dstw;
+			}
+		}
+
+		FAIL_IF(emit_vex_instruction(compiler, (GET_OPCODE(op) == SLJIT_PDEP ? (PDEP_r_r_rm | EX86_PREF_F2) : (PEXT_r_r_rm | EX86_PREF_F3))
+			| VEX_OP_0F38 | VEX_AUTO_W, dst_r, src1, src2, src2w));
+
+		if (dst_r != dst_reg)
+			EMIT_MOV(compiler, dst_reg, dstw, TMP_REG1, 0);
+		return SLJIT_SUCCESS;
+	case SLJIT_CRC32C_U8:
+	case SLJIT_CRC32C_U16:
+	case SLJIT_CRC32C_U32:
+	case SLJIT_CRC32C:
+		return emit_crc32c(compiler, op, dst_reg, dstw, src1, src1w, src2, src2w);
 	}
 
 	return SLJIT_SUCCESS;
@@ -3028,6 +4120,42 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_shift_into(struct sljit_compiler *
 	return SLJIT_SUCCESS;
 }
 
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_bitfield(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_reg, sljit_s32 src_reg,
+	sljit_s32 start, sljit_s32 length)
+{
+	sljit_s32 bits = (op & SLJIT_32) ? 32 : (sljit_s32)(8 * sizeof(sljit_sw));
+	sljit_s32 src = src_reg;
+	sljit_sw srcw = 0;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_bitfield(compiler, op, dst_reg, src_reg, start, length));
+
+	SLJIT_ASSERT(cpu_feature_list != 0);
+
+	/* BEXTR is part of BMI1, which also introduced TZCNT. Fields
+	   starting at bit 0 or ending at the top bit need one instruction. */
+	if (GET_OPCODE(op) != SLJIT_EXTRACT_U || !(cpu_feature_list & CPU_FEATURE_TZCNT)
+			|| start == 0 || start + length == bits)
+		return emit_bitfield_generic(compiler, op, dst_reg, src_reg, start, length);
+
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+	if (dst_reg >= SLJIT_R3 && dst_reg <= SLJIT_S3)
+		return emit_bitfield_generic(compiler, op, dst_reg, src_reg, start, length);
+#endif /* SLJIT_CONFIG_X86_32 */
+
+	CHECK_EXTRA_REGS(src, srcw, (void)0);
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	compiler->mode32 = 1;
+#endif /* SLJIT_CONFIG_X86_64 */
+	EMIT_MOV(compiler, TMP_REG1, 0, SLJIT_IMM, start | (length << 8));
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	compiler->mode32 = op & SLJIT_32;
+#endif /* SLJIT_CONFIG_X86_64 */
+	return emit_vex_instruction(compiler, BEXTR_r_rm_r | VEX_OP_0F38 | VEX_AUTO_W, dst_reg, TMP_REG1, src, srcw);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op2_shift(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -3168,6 +4296,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_src(struct sljit_compiler *comp
 	case SLJIT_PREFETCH_L2:
 	case SLJIT_PREFETCH_L3:
 	case SLJIT_PREFETCH_ONCE:
+	case SLJIT_PREFETCH_WRITE_L1:
+	case SLJIT_PREFETCH_WRITE_L2:
+	case SLJIT_PREFETCH_WRITE_L3:
 		return emit_prefetch(compiler, op, src, srcw);
 	}
 
@@ -3188,6 +4319,10 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_dst(struct sljit_compiler *comp
 		return emit_fast_enter(compiler, dst, dstw);
 	case SLJIT_GET_RETURN_ADDRESS:
 		return sljit_emit_get_return_address(compiler, dst, dstw);
+	case SLJIT_GET_CYCLE_COUNTER:
+		return emit_get_cycle_counter(compiler, dst, dstw);
+	case SLJIT_GET_THREAD_POINTER:
+		return emit_get_thread_pointer(compiler, dst, dstw);
 	}
 
 	return SLJIT_SUCCESS;
@@ -3231,7 +4366,7 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_op_custom(struct sljit_compiler *c
 /* --------------------------------------------------------------------- */
 
 /* Alignment(3) + 4 * 16 bytes. */
-static sljit_u32 sse2_data[3 + (4 * 4)];
+static sljit_u32 sse2_data[3 + (6 * 4)];
 static sljit_u32 *sse2_buffer;
 
 static void init_compiler(void)
@@ -3249,6 +4384,10 @@ static void init_compiler(void)
 	sse2_buffer[9] = 0x80000000;
 	sse2_buffer[12] = 0xffffffff;
 	sse2_buffer[13] = 0x7fffffff;
+	/* The largest value below 0.5 in single and double precision. */
+	sse2_buffer[16] = 0x3effffff;
+	sse2_buffer[20] = 0xffffffff;
+	sse2_buffer[21] = 0x3fdfffff;
 }
 
 static sljit_s32 emit_groupf(struct sljit_compiler *compiler,
@@ -3422,6 +4561,45 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 		return SLJIT_SUCCESS;
 	}
 
+	if (GET_OPCODE(op) >= SLJIT_SQRT_F64) {
+		dst_r = FAST_IS_REG(dst) ? dst : TMP_FREG;
+
+		if (GET_OPCODE(op) == SLJIT_SQRT_F64)
+			FAIL_IF(emit_groupf(compiler, SQRTSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, dst_r, src, srcw));
+		else {
+			if (GET_OPCODE(op) == SLJIT_ROUND_F64) {
+				/* Computed as trunc(src + copysign(0.5 - ulp, src)). Adding
+				   the largest value below 0.5 rounds up the halfway cases,
+				   but never the values below them. */
+				FAIL_IF(emit_sse2_load(compiler, op & SLJIT_32, TMP_FREG, src, srcw));
+				FAIL_IF(emit_groupf(compiler, ANDPD_x_xm | EX86_SELECT_66(op) | EX86_SSE2, TMP_FREG, SLJIT_MEM0(), (sljit_sw)((op & SLJIT_32) ? sse2_buffer : sse2_buffer + 8)));
+				FAIL_IF(emit_groupf(compiler, ORPD_x_xm | EX86_SELECT_66(op) | EX86_SSE2, TMP_FREG, SLJIT_MEM0(), (sljit_sw)((op & SLJIT_32) ? sse2_buffer + 16 : sse2_buffer + 20)));
+				FAIL_IF(emit_groupf(compiler, ADDSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, TMP_FREG, src, srcw));
+				src = TMP_FREG;
+				srcw = 0;
+			}
+
+			FAIL_IF(emit_groupf_ext(compiler, ((op & SLJIT_32) ? ROUNDSS_x_xm_i8 : ROUNDSD_x_xm_i8) | EX86_PREF_66 | VEX_OP_0F3A | EX86_SSE2, dst_r, src, srcw));
+
+			/* The precision exception is suppressed (bit 3). */
+			switch (GET_OPCODE(op)) {
+			case SLJIT_FLOOR_F64:
+				FAIL_IF(emit_byte(compiler, 0x9));
+				break;
+			case SLJIT_CEIL_F64:
+				FAIL_IF(emit_byte(compiler, 0xa));
+				break;
+			default:
+				FAIL_IF(emit_byte(compiler, 0xb));
+				break;
+			}
+		}
+
+		if (dst_r == TMP_FREG)
+			return emit_sse2_store(compiler, op & SLJIT_32, dst, dstw, TMP_FREG);
+		return SLJIT_SUCCESS;
+	}
+
 	if (FAST_IS_REG(dst)) {
 		dst_r = (dst == src) ? TMP_FREG : dst;
 
@@ -3463,6 +4641,44 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop1(struct sljit_compiler *compil
 	return emit_sse2_store(compiler, op & SLJIT_32, dst, dstw, TMP_FREG);
 }
 
+static sljit_s32 emit_fminmax(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_r, sljit_s32 src, sljit_sw srcw)
+{
+	sljit_u8 *inst;
+	sljit_u8 *jump_inst1;
+	sljit_u8 *jump_inst2;
+	sljit_uw size1, size2;
+
+	/* MINSD / MAXSD selects src when the operands are unordered, which
+	   is only wrong when src is NaN, and dst_r is not. */
+	FAIL_IF(emit_groupf(compiler, UCOMISD_x_xm | EX86_SELECT_66(op) | EX86_SSE2, dst_r, src, srcw));
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 2);
+	FAIL_IF(!inst);
+	INC_SIZE(2);
+	inst[0] = JNP_i8;
+	jump_inst1 = inst;
+
+	size1 = compiler->size;
+
+	FAIL_IF(emit_groupf(compiler, UCOMISD_x_xm | EX86_SELECT_66(op) | EX86_SSE2, dst_r, dst_r, 0));
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 2);
+	FAIL_IF(!inst);
+	INC_SIZE(2);
+	inst[0] = JNP_i8;
+	jump_inst2 = inst;
+
+	size2 = compiler->size;
+
+	jump_inst1[1] = U8(size2 - size1);
+
+	FAIL_IF(emit_groupf(compiler, (GET_OPCODE(op) == SLJIT_MIN_F64 ? MINSD_x_xm : MAXSD_x_xm) | EX86_SELECT_F2_F3(op) | EX86_SSE2, dst_r, src, srcw));
+
+	jump_inst2[1] = U8(compiler->size - size2);
+	return SLJIT_SUCCESS;
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst, sljit_sw dstw,
 	sljit_s32 src1, sljit_sw src1w,
@@ -3515,6 +4731,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 	case SLJIT_DIV_F64:
 		FAIL_IF(emit_groupf(compiler, DIVSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, dst_r, src2, src2w));
 		break;
+
+	case SLJIT_MIN_F64:
+	case SLJIT_MAX_F64:
+		FAIL_IF(emit_fminmax(compiler, op, dst_r, src2, src2w));
+		break;
 	}
 
 	if (dst_r != dst)
@@ -3522,6 +4743,33 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2(struct sljit_compiler *compil
 	return SLJIT_SUCCESS;
 }
 
+static sljit_s32 emit_fmadd(struct sljit_compiler *compiler, sljit_s32 op,
+	sljit_s32 dst_freg,
+	sljit_s32 src1, sljit_sw src1w,
+	sljit_s32 src2, sljit_sw src2w)
+{
+	sljit_s32 is_add = GET_OPCODE(op) == SLJIT_MULADD_F64;
+
+	if (cpu_feature_list & CPU_FEATURE_FMA) {
+		if (src1 & SLJIT_MEM) {
+			FAIL_IF(emit_sse2_load(compiler, op & SLJIT_32, TMP_FREG, src1, src1w));
+			src1 = TMP_FREG;
+		}
+
+		return emit_vex_instruction(compiler, (is_add ? VFMADD231SD_x_x_xm : VFMSUB231SD_x_x_xm) | EX86_PREF_66 | VEX_OP_0F38
+			| ((op & SLJIT_32) ? 0 : VEX_W) | EX86_SSE2 | VEX_SSE2_OPV, dst_freg, src1, src2, src2w);
+	}
+
+	FAIL_IF(emit_sse2_load(compiler, op & SLJIT_32, TMP_FREG, src1, src1w));
+	FAIL_IF(emit_groupf(compiler, MULSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, TMP_FREG, src2, src2w));
+
+	if (is_add)
+		return emit_groupf(compiler, ADDSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, dst_freg, TMP_FREG, 0);
+
+	FAIL_IF(emit_groupf(compiler, SUBSD_x_xm | EX86_SELECT_F2_F3(op) | EX86_SSE2, TMP_FREG, dst_freg, 0));
+	return emit_sse2_load(compiler, op & SLJIT_32, dst_freg, TMP_FREG, 0);
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compiler, sljit_s32 op,
 	sljit_s32 dst_freg,
 	sljit_s32 src1, sljit_sw src1w,
@@ -3538,6 +4786,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fop2r(struct sljit_compiler *compi
 	compiler->mode32 = 1;
 #endif
 
+	if (GET_OPCODE(op) != SLJIT_COPYSIGN_F64)
+		return emit_fmadd(compiler, op, dst_freg, src1, src1w, src2, src2w);
+
 	if (dst_freg == src1) {
 		FAIL_IF(emit_sse2_load(compiler, op & SLJIT_32, TMP_FREG, src2, src2w));
 		pref = EX86_SELECT_66(op) | EX86_SSE2;
@@ -3663,6 +4914,27 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_label* sljit_emit_aligned_label(struct slj
 	return label;
 }
 
+/* The patchable field of a rewritable jump follows the opcode bytes (see: detect_far_jump_type). */
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+#define PATCH_JUMP_OFFSET(type) ((type) < SLJIT_JUMP ? 2 : 1)
+#else /* !SLJIT_CONFIG_X86_32 */
+#define PATCH_JUMP_OFFSET(type) ((type) < SLJIT_JUMP ? 4 : 2)
+#endif /* SLJIT_CONFIG_X86_32 */
+
+/* Reserves space for the NOPs which align the field at the given offset
+   to its natural alignment when SLJIT_ENTER_CONCURRENT_PATCH is set. */
+static sljit_u8 *emit_patch_align(struct sljit_compiler *compiler, sljit_uw offset, sljit_uw size)
+{
+	sljit_u8 *inst = (sljit_u8*)ensure_buf(compiler, 3);
+	PTR_FAIL_IF(!inst);
+
+	inst[0] = SLJIT_INST_PATCH_ALIGN;
+	inst[1] = U8(offset);
+	inst[2] = U8(size - 1);
+	compiler->size += size - 1;
+	return inst;
+}
+
 SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compiler *compiler, sljit_s32 type)
 {
 	sljit_u8 *inst;
@@ -3671,6 +4943,9 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_jump(struct sljit_compile
 	CHECK_ERROR_PTR();
 	CHECK_PTR(check_sljit_emit_jump(compiler, type));
 
+	if ((type & SLJIT_REWRITABLE_JUMP) && (compiler->options & SLJIT_ENTER_CONCURRENT_PATCH))
+		PTR_FAIL_IF(!emit_patch_align(compiler, PATCH_JUMP_OFFSET(type & 0xff), sizeof(sljit_sw)));
+
 	jump = (struct sljit_jump*)ensure_abuf(compiler, sizeof(struct sljit_jump));
 	PTR_FAIL_IF_NULL(jump);
 	set_jump(jump, compiler, (sljit_u32)((type & SLJIT_REWRITABLE_JUMP) | ((type & 0xff) << TYPE_SHIFT)));
@@ -3899,6 +5174,140 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_fselect(struct sljit_compiler *com
 	return SLJIT_SUCCESS;
 }
 
+/* Block copy and fill operations using rep movsb / rep stosb. The
+   arguments are moved into the fixed registers through the stack,
+   and the original values of these registers are restored later. */
+static sljit_s32 emit_rep_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	/* Destination: edi, source: esi (copy) or eax (fill), length: ecx. */
+	sljit_u8 fixed_regs[3] = { 7, 6, 1 };
+	sljit_s32 args[3];
+	sljit_sw argws[3];
+	sljit_s32 saved_regs = 0;
+	sljit_sw sp_offset = 0;
+	sljit_s32 i, j;
+	sljit_u8 *inst;
+
+	if (type & SLJIT_MEM_BLOCK_FILL) {
+		fixed_regs[1] = 0;
+		srcw &= 0xff;
+	}
+
+	args[0] = dst_reg;
+	argws[0] = 0;
+	args[1] = src;
+	argws[1] = srcw;
+	args[2] = len;
+	argws[2] = lenw;
+
+	for (i = 0; i < 3; i++)
+		CHECK_EXTRA_REGS(args[i], argws[i], (void)0);
+
+	for (i = 0; i < 3; i++) {
+		for (j = 0; j < 3; j++)
+			if (FAST_IS_REG(args[j]) && reg_map[args[j]] == fixed_regs[i])
+				break;
+
+		if (j >= 3) {
+			/* The value of the register must be preserved. */
+			FAIL_IF(emit_byte(compiler, U8(PUSH_r + fixed_regs[i])));
+			saved_regs |= 1 << i;
+			sp_offset += SSIZE_OF(sw);
+		}
+	}
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	compiler->mode32 = 1;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	for (i = 0; i < 3; i++) {
+		if (args[i] == SLJIT_IMM) {
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+			if (!IS_HALFWORD(argws[i])) {
+				FAIL_IF(emit_load_imm64(compiler, TMP_REG1, argws[i]));
+				compiler->mode32 = 1;
+				args[i] = TMP_REG1;
+				argws[i] = 0;
+			} else {
+#endif /* SLJIT_CONFIG_X86_64 */
+				inst = (sljit_u8*)ensure_buf(compiler, 1 + 1 + sizeof(sljit_s32));
+				FAIL_IF(!inst);
+				INC_SIZE(1 + sizeof(sljit_s32));
+				*inst++ = PUSH_i32;
+				sljit_unaligned_store_s32(inst, (sljit_s32)argws[i]);
+				sp_offset += SSIZE_OF(sw);
+				continue;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+			}
+#endif /* SLJIT_CONFIG_X86_64 */
+		}
+
+		if (args[i] & SLJIT_MEM)
+			argws[i] += sp_offset;
+
+		/* REX_W is not necessary (src is not immediate). */
+		inst = emit_x86_instruction(compiler, 1, 0, 0, args[i], argws[i]);
+		FAIL_IF(!inst);
+		inst[0] = GROUP_FF;
+		inst[1] |= PUSH_rm;
+		sp_offset += SSIZE_OF(sw);
+	}
+
+	inst = (sljit_u8*)ensure_buf(compiler, 1 + 5);
+	FAIL_IF(!inst);
+	INC_SIZE(5);
+	POP_REG(fixed_regs[2]);
+	POP_REG(fixed_regs[1]);
+	POP_REG(fixed_regs[0]);
+	inst[0] = GROUP_F3;
+	inst[1] = (type & SLJIT_MEM_BLOCK_FILL) ? STOS_B : MOVS_B;
+
+	for (i = 2; i >= 0; i--)
+		if (saved_regs & (1 << i))
+			FAIL_IF(emit_byte(compiler, U8(POP_r + fixed_regs[i])));
+
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_mem_block(struct sljit_compiler *compiler, sljit_s32 type,
+	sljit_s32 dst_reg,
+	sljit_s32 src, sljit_sw srcw,
+	sljit_s32 len, sljit_sw lenw)
+{
+	sljit_s32 vreg = 0;
+	sljit_sw unroll_limit;
+
+	CHECK_ERROR();
+	CHECK(check_sljit_emit_mem_block(compiler, type, dst_reg, src, srcw, len, lenw));
+
+	if (cpu_feature_list == 0)
+		get_cpu_features();
+
+	if (cpu_feature_list & CPU_FEATURE_SSE41)
+		vreg = TMP_FREG;
+
+	unroll_limit = (vreg != 0 ? 16 : SSIZE_OF(sw)) * 8;
+
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+	/* Virtual registers cannot be used as base registers, and
+	   there is no second temporary register for loop counters. */
+	if (len != SLJIT_IMM || lenw > unroll_limit
+			|| (dst_reg >= SLJIT_R3 && dst_reg <= SLJIT_S3)
+			|| (src >= SLJIT_R3 && src <= SLJIT_S3))
+		return emit_rep_mem_block(compiler, type, dst_reg, src, srcw, len, lenw);
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, 0, vreg);
+#else /* !SLJIT_CONFIG_X86_32 */
+	if ((cpu_feature_list & (CPU_FEATURE_ERMS | CPU_FEATURE_FSRM)) && (len != SLJIT_IMM || lenw > unroll_limit))
+		return emit_rep_mem_block(compiler, type, dst_reg, src, srcw, len, lenw);
+
+	return emit_mem_block_generic(compiler, type, dst_reg, src, srcw, len, lenw, TMP_REG1, TMP_REG2, vreg);
+#endif /* SLJIT_CONFIG_X86_32 */
+}
+
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_simd_mov(struct sljit_compiler *compiler, sljit_s32 type,
 	sljit_s32 vreg,
 	sljit_s32 srcdst, sljit_sw srcdstw)
@@ -3932,6 +5341,37 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_emit_simd_mov(struct sljit_compiler *co
 
 	if (!(srcdst & SLJIT_MEM))
 		alignment = reg_size;
+	else if ((type & SLJIT_SIMD_MEM_NON_TEMPORAL) && alignment >= reg_size) {
+		if (cpu_feature_list == 0)
+			get_cpu_features();
+
+		if (type & SLJIT_SIMD_STORE) {
+			if (!(type & SLJIT_SIMD_FLOAT))
+				op |= MOVNTDQ_m_x | EX86_PREF_66;
+			else if (elem_size == 2 || elem_size == 3)
+				op |= MOVNTPS_m_x | (elem_size == 3 ? EX86_PREF_66 : 0);
+			else
+				return SLJIT_ERR_UNSUPPORTED;
+		} else if (cpu_feature_list & (reg_size == 4 ? CPU_FEATURE_SSE41 : CPU_FEATURE_AVX2)) {
+			/* The streaming load does not depend on the element type. */
+			if ((type & SLJIT_SIMD_FLOAT) && elem_size != 2 && elem_size != 3)
+				return SLJIT_ERR_UNSUPPORTED;
+
+			op |= MOVNTDQA_x_m | VEX_OP_0F38 | EX86_PREF_66;
+		}
+
+		if (op & 0xff) {
+			if (type & SLJIT_SIMD_TEST)
+				return SLJIT_SUCCESS;
+
+			if ((op & VEX_256) || ((cpu_feature_list & CPU_FEATURE_AVX) && (compiler->options & SLJIT_ENTER_USE_VEX)))
+				return emit_vex_instruction(compiler, op, vreg, 0, srcdst, srcdstw);
+
+			if (op & VEX_OP_0F38)
+				return emit_groupf_ext(compiler, op, vreg, srcdst, srcdstw);
+			return emit_groupf(compiler, op, vreg, srcdst, srcdstw);
+		}
+	}
 
 	if (type & SLJIT_SIMD_FLOAT) {
 		if (elem_size == 2 || elem_size == 3) {
@@ -5257,8 +6697,10 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compi
 	sljit_sw init_value)
 {
 	sljit_u8 *inst;
+	sljit_u8 *align_inst = NULL;
 	struct sljit_const *const_;
 	sljit_s32 reg;
+	sljit_uw size = sizeof(sljit_s32);
 #if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
 	sljit_s32 dst_is_ereg = 0;
 #endif /* !SLJIT_CONFIG_X86_32 */
@@ -5273,6 +6715,17 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compi
 	PTR_FAIL_IF(!const_);
 	set_const(const_, compiler);
 
+	if (compiler->options & SLJIT_ENTER_CONCURRENT_PATCH) {
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+		if (op == SLJIT_MOV)
+			size = sizeof(sljit_sw);
+#endif /* SLJIT_CONFIG_X86_64 */
+		/* The offset is known after the instruction is emitted. */
+		align_inst = emit_patch_align(compiler, 0, size);
+		PTR_FAIL_IF(!align_inst);
+		const_->addr = compiler->size;
+	}
+
 	switch (GET_OPCODE(op)) {
 	case SLJIT_MOV_U8:
 #if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
@@ -5303,7 +6756,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compi
 		compiler->mode32 = 0;
 		reg = FAST_IS_REG(dst) ? dst : TMP_REG1;
 
-		if (emit_load_imm64(compiler, reg, init_value))
+		if (emit_mov_imm64(compiler, reg, init_value))
 			return NULL;
 		break;
 #endif /* SLJIT_CONFIG_X86_64 */
@@ -5318,6 +6771,10 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_const* sljit_emit_const(struct sljit_compi
 		break;
 	}
 
+	/* The patchable field is at the end of the instruction. */
+	if (align_inst != NULL)
+		align_inst[1] = U8(compiler->size - const_->addr - size);
+
 	inst = (sljit_u8*)ensure_buf(compiler, 1);
 	PTR_FAIL_IF(!inst);
 
@@ -5366,7 +6823,7 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	else
 		reg = (op != SLJIT_ADD_ABS_ADDR) ? dst : TMP_REG2;
 
-	PTR_FAIL_IF(emit_load_imm64(compiler, reg, 0));
+	PTR_FAIL_IF(emit_mov_imm64(compiler, reg, 0));
 	jump->addr = compiler->size;
 
 	if (reg_map[reg] >= 8)
@@ -5402,20 +6859,43 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_jump* sljit_emit_op_addr(struct sljit_comp
 	return jump;
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+/* Naturally aligned fields are updated by a single store, which
+   is atomic for the threads executing the code at the same time. */
+static SLJIT_INLINE void patch_store_sw(void *addr, sljit_sw value)
+{
+	if (((sljit_uw)addr & (sizeof(sljit_sw) - 1)) == 0)
+		*(volatile sljit_sw*)addr = value;
+	else
+		sljit_unaligned_store_sw(addr, value);
+}
+
+static SLJIT_INLINE void patch_store_s32(void *addr, sljit_s32 value)
+{
+	if (((sljit_uw)addr & (sizeof(sljit_s32) - 1)) == 0)
+		*(volatile sljit_s32*)addr = value;
+	else
+		sljit_unaligned_store_s32(addr, value);
+}
+
+static void patch_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	SLJIT_UNUSED_ARG(executable_offset);
 
-	SLJIT_UPDATE_WX_FLAGS((void*)addr, (void*)(addr + sizeof(sljit_uw)), 0);
+	PATCH_UPDATE_WX_FLAGS((void*)addr, (void*)(addr + sizeof(sljit_uw)), 0);
 #if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
-	sljit_unaligned_store_sw((void*)addr, (sljit_sw)(new_target - (addr + 4) - (sljit_uw)executable_offset));
+	patch_store_sw((void*)addr, (sljit_sw)(new_target - (addr + 4) - (sljit_uw)executable_offset));
 #else
-	sljit_unaligned_store_sw((void*)addr, (sljit_sw)new_target);
+	patch_store_sw((void*)addr, (sljit_sw)new_target);
 #endif
-	SLJIT_UPDATE_WX_FLAGS((void*)addr, (void*)(addr + sizeof(sljit_uw)), 1);
+	PATCH_UPDATE_WX_FLAGS((void*)addr, (void*)(addr + sizeof(sljit_uw)), 1);
 }
 
-SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_jump_addr(sljit_uw addr, sljit_uw new_target, sljit_sw executable_offset)
+{
+	patch_jump_addr(addr, new_target, executable_offset, 1);
+}
+
+static void patch_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset, sljit_s32 flush_cache)
 {
 	void *start_addr;
 	SLJIT_UNUSED_ARG(executable_offset);
@@ -5423,9 +6903,9 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 #if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
 	if (op == SLJIT_MOV) {
 		start_addr = (void*)(addr - sizeof(sljit_sw));
-		SLJIT_UPDATE_WX_FLAGS(start_addr, (void*)addr, 0);
-		sljit_unaligned_store_sw(start_addr, new_constant);
-		SLJIT_UPDATE_WX_FLAGS(start_addr, (void*)addr, 1);
+		PATCH_UPDATE_WX_FLAGS(start_addr, (void*)addr, 0);
+		patch_store_sw(start_addr, new_constant);
+		PATCH_UPDATE_WX_FLAGS(start_addr, (void*)addr, 1);
 		return;
 	}
 #endif
@@ -5439,7 +6919,12 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit
 			new_constant = (sljit_u8)new_constant;
 	}
 
-	SLJIT_UPDATE_WX_FLAGS(start_addr, (void*)addr, 0);
-	sljit_unaligned_store_s32(start_addr, (sljit_s32)new_constant);
-	SLJIT_UPDATE_WX_FLAGS(start_addr, (void*)addr, 1);
+	PATCH_UPDATE_WX_FLAGS(start_addr, (void*)addr, 0);
+	patch_store_s32(start_addr, (sljit_s32)new_constant);
+	PATCH_UPDATE_WX_FLAGS(start_addr, (void*)addr, 1);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_set_const(sljit_uw addr, sljit_s32 op, sljit_sw new_constant, sljit_sw executable_offset)
+{
+	patch_const(addr, op, new_constant, executable_offset, 1);
 }
@@ -0,0 +1,730 @@
+/*
+ *    Stack-less Just-In-Time compiler
+ *
+ *    Copyright Zoltan Herczeg (hzmester@freemail.hu). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright notice, this list of
+ *      conditions and the following disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *      of conditions and the following disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND CONTRIBUTORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER(S) OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define VIRT_OP1	0
+#define VIRT_OP2	1
+#define VIRT_LOAD	2
+#define VIRT_STORE	3
+#define VIRT_LABEL	4
+#define VIRT_JUMP	5
+#define VIRT_CMP	6
+#define VIRT_RETURN	7
+
+/* Location of a spilled virtual register. */
+#define VIRT_SPILL(slot)	(-1 - (slot))
+#define VIRT_SLOT(loc)		(-1 - (loc))
+
+struct sljit_virt_inst {
+	sljit_s32 type;
+	sljit_s32 op;
+	/* Destination register, base register of stores, or label. */
+	sljit_s32 dst;
+	sljit_s32 src1;
+	sljit_s32 src2;
+	sljit_s32 label;
+	sljit_sw src1w;
+	sljit_sw src2w;
+};
+
+struct sljit_virt_compiler {
+	struct sljit_compiler *compiler;
+	struct sljit_virt_inst *insts;
+	sljit_uw inst_count;
+	sljit_uw inst_size;
+	sljit_s32 error;
+	sljit_s32 arg_count;
+	sljit_s32 reg_count;
+	sljit_s32 label_count;
+	sljit_s32 spill_count;
+};
+
+/* Live range data used by sljit_virt_generate. */
+struct sljit_virt_ranges {
+	sljit_s32 *start;
+	sljit_s32 *end;
+	sljit_s32 *loc;
+	sljit_s32 *order;
+	sljit_s32 *label_pos;
+	/* Number of labels up to a given position. */
+	sljit_s32 *label_sum;
+	sljit_u8 *first_use;
+};
+
+SLJIT_API_FUNC_ATTRIBUTE struct sljit_virt_compiler* sljit_create_virt_compiler(struct sljit_compiler *compiler, sljit_s32 arg_count)
+{
+	struct sljit_virt_compiler *virt_compiler;
+
+	SLJIT_ASSERT(arg_count >= 0 && arg_count <= 4);
+
+	virt_compiler = (struct sljit_virt_compiler*)SLJIT_MALLOC(sizeof(struct sljit_virt_compiler), compiler->allocator_data);
+	if (!virt_compiler)
+		return NULL;
+
+	SLJIT_ZEROMEM(virt_compiler, sizeof(struct sljit_virt_compiler));
+	virt_compiler->compiler = compiler;
+	virt_compiler->arg_count = arg_count;
+	virt_compiler->reg_count = arg_count;
+	return virt_compiler;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_virt_compiler(struct sljit_virt_compiler *virt_compiler)
+{
+	void *allocator_data = virt_compiler->compiler->allocator_data;
+
+	SLJIT_UNUSED_ARG(allocator_data);
+
+	if (virt_compiler->insts)
+		SLJIT_FREE(virt_compiler->insts, allocator_data);
+	SLJIT_FREE(virt_compiler, allocator_data);
+}
+
+static struct sljit_virt_inst* virt_push_inst(struct sljit_virt_compiler *virt_compiler, sljit_s32 type, sljit_s32 op)
+{
+	struct sljit_virt_inst *inst;
+	sljit_uw size;
+	void *allocator_data = virt_compiler->compiler->allocator_data;
+
+	SLJIT_UNUSED_ARG(allocator_data);
+
+	if (virt_compiler->inst_count >= virt_compiler->inst_size) {
+		size = virt_compiler->inst_size == 0 ? 64 : virt_compiler->inst_size * 2;
+		inst = (struct sljit_virt_inst*)SLJIT_MALLOC(size * sizeof(struct sljit_virt_inst), allocator_data);
+
+		if (!inst) {
+			virt_compiler->error = SLJIT_ERR_ALLOC_FAILED;
+			return NULL;
+		}
+
+		if (virt_compiler->insts) {
+			SLJIT_MEMCPY(inst, virt_compiler->insts, virt_compiler->inst_count * sizeof(struct sljit_virt_inst));
+			SLJIT_FREE(virt_compiler->insts, allocator_data);
+		}
+
+		virt_compiler->insts = inst;
+		virt_compiler->inst_size = size;
+	}
+
+	inst = virt_compiler->insts + virt_compiler->inst_count++;
+	SLJIT_ZEROMEM(inst, sizeof(struct sljit_virt_inst));
+	inst->type = type;
+	inst->op = op;
+	inst->label = -1;
+	return inst;
+}
+
+static sljit_s32 virt_check_reg(struct sljit_virt_compiler *virt_compiler, sljit_s32 reg)
+{
+	if (reg < 0) {
+		virt_compiler->error = SLJIT_ERR_BAD_ARGUMENT;
+		return 0;
+	}
+
+	if (reg >= virt_compiler->reg_count)
+		virt_compiler->reg_count = reg + 1;
+	return 1;
+}
+
+static sljit_s32 virt_check_src(struct sljit_virt_compiler *virt_compiler, sljit_s32 src, sljit_sw srcw)
+{
+	if (src == SLJIT_IMM)
+		return 1;
+
+	if (src != SLJIT_VIRT_REG || srcw > 0x7fffffff) {
+		virt_compiler->error = SLJIT_ERR_BAD_ARGUMENT;
+		return 0;
+	}
+
+	return virt_check_reg(virt_compiler, (sljit_s32)srcw);
+}
+
+static sljit_s32 virt_check_label(struct sljit_virt_compiler *virt_compiler, sljit_s32 label)
+{
+	if (label < 0 || label >= virt_compiler->label_count) {
+		virt_compiler->error = SLJIT_ERR_BAD_ARGUMENT;
+		return 0;
+	}
+	return 1;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_op1(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src, sljit_sw srcw)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_reg(virt_compiler, dst) || !virt_check_src(virt_compiler, src, srcw))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_OP1, op);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->dst = dst;
+	inst->src1 = src;
+	inst->src1w = srcw;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_op2(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 src1, sljit_sw src1w, sljit_s32 src2, sljit_sw src2w)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_reg(virt_compiler, dst) || !virt_check_src(virt_compiler, src1, src1w)
+			|| !virt_check_src(virt_compiler, src2, src2w))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_OP2, op);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->dst = dst;
+	inst->src1 = src1;
+	inst->src1w = src1w;
+	inst->src2 = src2;
+	inst->src2w = src2w;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_load(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 dst, sljit_s32 base, sljit_sw offset)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_reg(virt_compiler, dst) || !virt_check_reg(virt_compiler, base))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_LOAD, op);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->dst = dst;
+	inst->src1 = SLJIT_VIRT_REG;
+	inst->src1w = base;
+	inst->src2w = offset;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_store(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 base, sljit_sw offset, sljit_s32 src, sljit_sw srcw)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_reg(virt_compiler, base) || !virt_check_src(virt_compiler, src, srcw))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_STORE, op);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->dst = base;
+	inst->src1 = src;
+	inst->src1w = srcw;
+	inst->src2w = offset;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_new_label(struct sljit_virt_compiler *virt_compiler)
+{
+	return virt_compiler->label_count++;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_emit_label(struct sljit_virt_compiler *virt_compiler, sljit_s32 label)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_label(virt_compiler, label))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_LABEL, 0);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->label = label;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_jump(struct sljit_virt_compiler *virt_compiler, sljit_s32 label)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_label(virt_compiler, label))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_JUMP, SLJIT_JUMP);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->label = label;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_cmp(struct sljit_virt_compiler *virt_compiler, sljit_s32 type,
+	sljit_s32 src1, sljit_sw src1w, sljit_s32 src2, sljit_sw src2w, sljit_s32 label)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_src(virt_compiler, src1, src1w) || !virt_check_src(virt_compiler, src2, src2w)
+			|| !virt_check_label(virt_compiler, label))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_CMP, type);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->src1 = src1;
+	inst->src1w = src1w;
+	inst->src2 = src2;
+	inst->src2w = src2w;
+	inst->label = label;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_return(struct sljit_virt_compiler *virt_compiler, sljit_s32 op,
+	sljit_s32 src, sljit_sw srcw)
+{
+	struct sljit_virt_inst *inst;
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	if (!virt_check_src(virt_compiler, src, srcw))
+		return virt_compiler->error;
+
+	inst = virt_push_inst(virt_compiler, VIRT_RETURN, op);
+	if (!inst)
+		return virt_compiler->error;
+
+	inst->src1 = src;
+	inst->src1w = srcw;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_get_spill_count(struct sljit_virt_compiler *virt_compiler)
+{
+	return virt_compiler->spill_count;
+}
+
+static void virt_touch(struct sljit_virt_ranges *ranges, sljit_s32 reg, sljit_s32 pos, sljit_s32 is_use)
+{
+	if (ranges->start[reg] < 0) {
+		ranges->start[reg] = pos;
+		ranges->first_use[reg] = (sljit_u8)is_use;
+	}
+	ranges->end[reg] = pos;
+}
+
+static void virt_compute_ranges(struct sljit_virt_compiler *virt_compiler, struct sljit_virt_ranges *ranges)
+{
+	struct sljit_virt_inst *inst = virt_compiler->insts;
+	sljit_s32 i, reg, pos, label_pos, inst_count = (sljit_s32)virt_compiler->inst_count;
+	sljit_s32 changed;
+
+	for (i = 0; i < virt_compiler->reg_count; i++)
+		ranges->start[i] = -1;
+
+	/* Arguments are defined at position 0, and the
+	   instructions are placed at positions starting from 1. */
+	for (i = 0; i < virt_compiler->arg_count; i++)
+		virt_touch(ranges, i, 0, 0);
+
+	ranges->label_sum[0] = 0;
+
+	for (i = 0; i < inst_count; i++, inst++) {
+		pos = i + 1;
+		ranges->label_sum[pos] = ranges->label_sum[i];
+
+		if (inst->type == VIRT_LABEL) {
+			ranges->label_pos[inst->label] = pos;
+			ranges->label_sum[pos]++;
+			continue;
+		}
+
+		/* Sources are used before the destination is set. */
+		if (inst->src1 == SLJIT_VIRT_REG)
+			virt_touch(ranges, (sljit_s32)inst->src1w, pos, 1);
+		if (inst->src2 == SLJIT_VIRT_REG)
+			virt_touch(ranges, (sljit_s32)inst->src2w, pos, 1);
+
+		if (inst->type == VIRT_STORE)
+			virt_touch(ranges, inst->dst, pos, 1);
+		else if (inst->type <= VIRT_LOAD)
+			virt_touch(ranges, inst->dst, pos, 0);
+	}
+
+	/* A value is live in the whole loop formed by a backward jump, if it
+	   is live before the loop, or its first access in the loop is not an
+	   unconditional definition. Extending a range may affect other loops. */
+	do {
+		changed = 0;
+		inst = virt_compiler->insts;
+
+		for (i = 0; i < inst_count; i++, inst++) {
+			if (inst->type != VIRT_JUMP && inst->type != VIRT_CMP)
+				continue;
+
+			pos = i + 1;
+			label_pos = ranges->label_pos[inst->label];
+
+			if (label_pos > pos)
+				continue;
+
+			for (reg = 0; reg < virt_compiler->reg_count; reg++) {
+				if (ranges->start[reg] < 0 || ranges->end[reg] < label_pos || ranges->start[reg] > pos)
+					continue;
+
+				if (ranges->start[reg] >= label_pos && !ranges->first_use[reg]
+						&& ranges->label_sum[ranges->start[reg]] == ranges->label_sum[label_pos])
+					continue;
+
+				if (ranges->start[reg] > label_pos) {
+					ranges->start[reg] = label_pos;
+					changed = 1;
+				}
+
+				if (ranges->end[reg] < pos) {
+					ranges->end[reg] = pos;
+					changed = 1;
+				}
+			}
+		}
+	} while (changed);
+}
+
+static sljit_s32 virt_get_pool(sljit_s32 *pool)
+{
+	sljit_s32 i, size = 0;
+
+	/* Scratch registers are preferred, since they are not saved by sljit_emit_enter. */
+	for (i = 0; i < SLJIT_NUMBER_OF_SCRATCH_REGISTERS; i++)
+		if (sljit_get_register_index(SLJIT_GP_REGISTER, SLJIT_R(i)) >= 0)
+			pool[size++] = SLJIT_R(i);
+
+	for (i = 0; i < SLJIT_NUMBER_OF_SAVED_REGISTERS; i++)
+		if (sljit_get_register_index(SLJIT_GP_REGISTER, SLJIT_S(i)) >= 0)
+			pool[size++] = SLJIT_S(i);
+
+	return size;
+}
+
+/* Assigns registers to the ranges, and returns with the number of spilled registers. */
+static sljit_s32 virt_linear_scan(struct sljit_virt_compiler *virt_compiler, struct sljit_virt_ranges *ranges,
+	sljit_s32 *pool, sljit_s32 pool_size)
+{
+	sljit_s32 active[SLJIT_NUMBER_OF_REGISTERS];
+	sljit_s32 active_count = 0;
+	sljit_u8 used[SLJIT_NUMBER_OF_REGISTERS];
+	sljit_s32 i, j, k, reg, victim, spill_count = 0;
+
+	SLJIT_ZEROMEM(used, sizeof(used));
+
+	for (i = 0; i < virt_compiler->reg_count; i++) {
+		reg = ranges->order[i];
+
+		if (ranges->start[reg] < 0)
+			break;
+
+		/* Expire old ranges. */
+		for (j = 0; j < active_count; j++) {
+			if (ranges->end[active[j]] < ranges->start[reg]) {
+				for (k = 0; pool[k] != ranges->loc[active[j]]; k++) {}
+				used[k] = 0;
+				active[j--] = active[--active_count];
+			}
+		}
+
+		for (k = 0; k < pool_size; k++)
+			if (!used[k])
+				break;
+
+		if (k < pool_size) {
+			used[k] = 1;
+			ranges->loc[reg] = pool[k];
+			active[active_count++] = reg;
+			continue;
+		}
+
+		/* Spill the range which ends last. */
+		victim = 0;
+		for (j = 1; j < active_count; j++)
+			if (ranges->end[active[j]] > ranges->end[active[victim]])
+				victim = j;
+
+		if (active_count > 0 && ranges->end[active[victim]] > ranges->end[reg]) {
+			ranges->loc[reg] = ranges->loc[active[victim]];
+			ranges->loc[active[victim]] = VIRT_SPILL(spill_count);
+			active[victim] = reg;
+		} else
+			ranges->loc[reg] = VIRT_SPILL(spill_count);
+
+		spill_count++;
+	}
+
+	return spill_count;
+}
+
+static void virt_get_arg(struct sljit_virt_ranges *ranges, sljit_s32 src, sljit_sw srcw,
+	sljit_s32 *arg, sljit_sw *argw)
+{
+	sljit_s32 loc;
+
+	if (src == SLJIT_IMM) {
+		*arg = SLJIT_IMM;
+		*argw = srcw;
+		return;
+	}
+
+	loc = ranges->loc[srcw];
+
+	if (loc > 0) {
+		*arg = loc;
+		*argw = 0;
+		return;
+	}
+
+	*arg = SLJIT_MEM1(SLJIT_SP);
+	*argw = (sljit_sw)VIRT_SLOT(loc) * SSIZE_OF(sw);
+}
+
+static sljit_s32 virt_get_base(struct sljit_compiler *compiler, struct sljit_virt_ranges *ranges,
+	sljit_s32 base, sljit_s32 tmp_reg)
+{
+	sljit_s32 loc = ranges->loc[base];
+
+	if (loc > 0)
+		return SLJIT_MEM1(loc);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, tmp_reg, 0, SLJIT_MEM1(SLJIT_SP), (sljit_sw)VIRT_SLOT(loc) * SSIZE_OF(sw));
+	return SLJIT_MEM1(tmp_reg);
+}
+
+static void virt_emit(struct sljit_virt_compiler *virt_compiler, struct sljit_virt_ranges *ranges,
+	struct sljit_label **labels, struct sljit_jump **jumps, sljit_s32 tmp_reg)
+{
+	struct sljit_compiler *compiler = virt_compiler->compiler;
+	struct sljit_virt_inst *inst = virt_compiler->insts;
+	struct sljit_jump *jump;
+	sljit_s32 dst, src1, src2;
+	sljit_sw dstw, src1w, src2w;
+	sljit_uw i;
+
+	for (i = 0; i < virt_compiler->inst_count; i++, inst++) {
+		jump = NULL;
+
+		switch (inst->type) {
+		case VIRT_OP1:
+			virt_get_arg(ranges, SLJIT_VIRT_REG, inst->dst, &dst, &dstw);
+			virt_get_arg(ranges, inst->src1, inst->src1w, &src1, &src1w);
+			sljit_emit_op1(compiler, inst->op, dst, dstw, src1, src1w);
+			break;
+		case VIRT_OP2:
+			virt_get_arg(ranges, SLJIT_VIRT_REG, inst->dst, &dst, &dstw);
+			virt_get_arg(ranges, inst->src1, inst->src1w, &src1, &src1w);
+			virt_get_arg(ranges, inst->src2, inst->src2w, &src2, &src2w);
+			sljit_emit_op2(compiler, inst->op, dst, dstw, src1, src1w, src2, src2w);
+			break;
+		case VIRT_LOAD:
+			virt_get_arg(ranges, SLJIT_VIRT_REG, inst->dst, &dst, &dstw);
+			src1 = virt_get_base(compiler, ranges, (sljit_s32)inst->src1w, tmp_reg);
+			sljit_emit_op1(compiler, inst->op, dst, dstw, src1, inst->src2w);
+			break;
+		case VIRT_STORE:
+			dst = virt_get_base(compiler, ranges, inst->dst, tmp_reg);
+			virt_get_arg(ranges, inst->src1, inst->src1w, &src1, &src1w);
+			sljit_emit_op1(compiler, inst->op, dst, inst->src2w, src1, src1w);
+			break;
+		case VIRT_LABEL:
+			labels[inst->label] = sljit_emit_label(compiler);
+			break;
+		case VIRT_JUMP:
+			jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+			break;
+		case VIRT_CMP:
+			virt_get_arg(ranges, inst->src1, inst->src1w, &src1, &src1w);
+			virt_get_arg(ranges, inst->src2, inst->src2w, &src2, &src2w);
+			jump = sljit_emit_cmp(compiler, inst->op, src1, src1w, src2, src2w);
+			break;
+		case VIRT_RETURN:
+			virt_get_arg(ranges, inst->src1, inst->src1w, &src1, &src1w);
+			sljit_emit_return(compiler, inst->op, src1, src1w);
+			break;
+		}
+
+		jumps[i] = jump;
+	}
+
+	inst = virt_compiler->insts;
+	for (i = 0; i < virt_compiler->inst_count; i++, inst++)
+		if (jumps[i] != NULL && labels[inst->label] != NULL)
+			sljit_set_label(jumps[i], labels[inst->label]);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_virt_generate(struct sljit_virt_compiler *virt_compiler)
+{
+	struct sljit_compiler *compiler = virt_compiler->compiler;
+	struct sljit_virt_ranges ranges;
+	struct sljit_label **labels;
+	struct sljit_jump **jumps;
+	sljit_s32 pool[SLJIT_NUMBER_OF_REGISTERS];
+	sljit_s32 i, reg, pool_size, tmp_reg, spill_count;
+	sljit_s32 scratches, saveds, arg_types;
+	sljit_s32 reg_count = virt_compiler->reg_count;
+	sljit_s32 label_count = virt_compiler->label_count;
+	sljit_uw inst_count = virt_compiler->inst_count;
+	sljit_uw size;
+	void *allocator_data = compiler->allocator_data;
+	sljit_u8 *ptr;
+
+	SLJIT_UNUSED_ARG(allocator_data);
+
+	if (virt_compiler->error)
+		return virt_compiler->error;
+
+	size = (sljit_uw)label_count * (sljit_uw)sizeof(struct sljit_label*) + inst_count * (sljit_uw)sizeof(struct sljit_jump*)
+		+ ((sljit_uw)reg_count * 4 + (sljit_uw)label_count + inst_count + 1) * (sljit_uw)sizeof(sljit_s32) + (sljit_uw)reg_count;
+	ptr = (sljit_u8*)SLJIT_MALLOC(size + 1, allocator_data);
+
+	if (!ptr) {
+		virt_compiler->error = SLJIT_ERR_ALLOC_FAILED;
+		return virt_compiler->error;
+	}
+
+	SLJIT_ZEROMEM(ptr, size);
+
+	labels = (struct sljit_label**)ptr;
+	jumps = (struct sljit_jump**)(labels + label_count);
+	ranges.start = (sljit_s32*)(jumps + inst_count);
+	ranges.end = ranges.start + reg_count;
+	ranges.loc = ranges.end + reg_count;
+	ranges.order = ranges.loc + reg_count;
+	ranges.label_pos = ranges.order + reg_count;
+	ranges.label_sum = ranges.label_pos + label_count;
+	ranges.first_use = (sljit_u8*)(ranges.label_sum + inst_count + 1);
+
+	for (i = 0; i < label_count; i++)
+		ranges.label_pos[i] = -1;
+
+	virt_compute_ranges(virt_compiler, &ranges);
+
+	for (i = 0; i < label_count; i++) {
+		if (ranges.label_pos[i] < 0) {
+			SLJIT_FREE(ptr, allocator_data);
+			virt_compiler->error = SLJIT_ERR_BAD_ARGUMENT;
+			return virt_compiler->error;
+		}
+	}
+
+	/* Order the ranges by their start position. Unused registers are moved to the end. */
+	reg = 0;
+	for (i = 0; i < reg_count; i++)
+		if (ranges.start[i] >= 0)
+			ranges.order[reg++] = i;
+	for (i = 0; i < reg_count; i++)
+		if (ranges.start[i] < 0)
+			ranges.order[reg++] = i;
+
+	for (i = 1; i < reg_count && ranges.start[ranges.order[i]] >= 0; i++) {
+		reg = ranges.order[i];
+		for (pool_size = i; pool_size > 0 && ranges.start[ranges.order[pool_size - 1]] > ranges.start[reg]; pool_size--)
+			ranges.order[pool_size] = ranges.order[pool_size - 1];
+		ranges.order[pool_size] = reg;
+	}
+
+	pool_size = virt_get_pool(pool);
+	SLJIT_ASSERT(pool_size > virt_compiler->arg_count);
+
+	/* Spilled base registers of memory accesses are loaded into a temporary register. */
+	tmp_reg = 0;
+	spill_count = virt_linear_scan(virt_compiler, &ranges, pool, pool_size);
+	if (spill_count > 0) {
+		tmp_reg = pool[--pool_size];
+		spill_count = virt_linear_scan(virt_compiler, &ranges, pool, pool_size);
+	}
+
+	scratches = virt_compiler->arg_count;
+	saveds = 0;
+
+	for (i = 0; i <= reg_count; i++) {
+		if (i < reg_count)
+			reg = (ranges.start[i] >= 0) ? ranges.loc[i] : 0;
+		else
+			reg = tmp_reg;
+
+		if (reg <= 0)
+			continue;
+
+		if (reg > SLJIT_NUMBER_OF_SCRATCH_REGISTERS) {
+			if (SLJIT_S0 - reg + 1 > saveds)
+				saveds = SLJIT_S0 - reg + 1;
+		} else if (reg > scratches)
+			scratches = reg;
+	}
+
+	arg_types = SLJIT_ARG_RETURN(SLJIT_ARG_TYPE_W);
+	for (i = 0; i < virt_compiler->arg_count; i++)
+		arg_types |= SLJIT_ARG_VALUE(SLJIT_ARG_TYPE_W_R, i + 1);
+
+	sljit_emit_enter(compiler, 0, arg_types, scratches, saveds, spill_count * SSIZE_OF(sw));
+
+	/* The target of an argument is never the source of a higher argument. */
+	for (i = virt_compiler->arg_count - 1; i >= 0; i--) {
+		reg = ranges.loc[i];
+		if (reg > 0 && reg == SLJIT_R(i))
+			continue;
+
+		if (reg > 0)
+			sljit_emit_op1(compiler, SLJIT_MOV, reg, 0, SLJIT_R(i), 0);
+		else
+			sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), (sljit_sw)VIRT_SLOT(reg) * SSIZE_OF(sw), SLJIT_R(i), 0);
+	}
+
+	virt_emit(virt_compiler, &ranges, labels, jumps, tmp_reg);
+
+	SLJIT_FREE(ptr, allocator_data);
+	virt_compiler->spill_count = spill_count;
+	return compiler->error;
+}
@@ -24,9 +24,6 @@
  * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#define SLJIT_GET_LABEL_INDEX(label) \
-	((label)->u.index < SLJIT_LABEL_ALIGNED ? (label)->u.index : ((struct sljit_extended_label*)(label))->index)
-
 SLJIT_API_FUNC_ATTRIBUTE sljit_uw sljit_get_label_index(struct sljit_label *label)
 {
 	return SLJIT_GET_LABEL_INDEX(label);
@@ -59,6 +56,7 @@ struct sljit_serialized_compiler {
 	sljit_uw aligned_label_count;
 	sljit_uw jump_count;
 	sljit_uw const_count;
+	sljit_uw cold_region_count;
 
 	sljit_s32 options;
 	sljit_s32 scratches;
@@ -76,6 +74,11 @@ struct sljit_serialized_compiler {
 	sljit_s32 args_size;
 #endif /* SLJIT_CONFIG_X86_32 */
 
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	sljit_uw const_pool_count;
+	sljit_uw const_pool_size;
+#endif /* SLJIT_CONFIG_X86_64 */
+
 #if ((defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32) && (defined __SOFTFP__)) \
 		|| (defined SLJIT_CONFIG_MIPS_32 && SLJIT_CONFIG_MIPS_32)
 	sljit_uw args_size;
@@ -118,13 +121,23 @@ struct sljit_serialized_const {
 	sljit_uw addr;
 };
 
+struct sljit_serialized_cold_region {
+	sljit_uw start;
+	sljit_uw end;
+};
+
+struct sljit_serialized_const_pool_entry {
+	sljit_uw value;
+	sljit_uw offset;
+};
+
 #define SLJIT_SERIALIZE_ALIGN(v) (((v) + sizeof(sljit_uw) - 1) & ~(sljit_uw)(sizeof(sljit_uw) - 1))
 #if (defined SLJIT_LITTLE_ENDIAN && SLJIT_LITTLE_ENDIAN)
 #define SLJIT_SERIALIZE_SIGNATURE 0x534c4a54
 #else /* !SLJIT_LITTLE_ENDIAN */
 #define SLJIT_SERIALIZE_SIGNATURE 0x544a4c53
 #endif /* SLJIT_LITTLE_ENDIAN */
-#define SLJIT_SERIALIZE_VERSION 1
+#define SLJIT_SERIALIZE_VERSION 3
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_uw* sljit_serialize_compiler(struct sljit_compiler *compiler,
 	sljit_s32 options, sljit_uw *size)
@@ -139,6 +152,12 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_uw* sljit_serialize_compiler(struct sljit_compile
 	struct sljit_serialized_aligned_label *serialized_aligned_label;
 	struct sljit_serialized_jump *serialized_jump;
 	struct sljit_serialized_const *serialized_const;
+	struct sljit_cold_region *cold_region;
+	struct sljit_serialized_cold_region *serialized_cold_region;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	struct sljit_const_pool_entry *const_pool_entry;
+	struct sljit_serialized_const_pool_entry *serialized_const_pool_entry;
+#endif /* SLJIT_CONFIG_X86_64 */
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
 		|| (defined SLJIT_DEBUG && SLJIT_DEBUG)
 	struct sljit_serialized_debug_info *serialized_debug_info;
@@ -152,6 +171,9 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_uw* sljit_serialize_compiler(struct sljit_compile
 		*size = 0;
 
 	PTR_FAIL_IF(compiler->error);
+	/* Switches and call stubs are not supported. */
+	PTR_FAIL_IF(compiler->switches != NULL);
+	PTR_FAIL_IF(compiler->call_stubs != NULL);
 
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
 		|| (defined SLJIT_DEBUG && SLJIT_DEBUG)
@@ -193,6 +215,20 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_uw* sljit_serialize_compiler(struct sljit_compile
 		const_ = const_->next;
 	}
 
+	cold_region = compiler->cold_regions;
+	while (cold_region != NULL) {
+		serialized_size += sizeof(struct sljit_serialized_cold_region);
+		cold_region = cold_region->next;
+	}
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	const_pool_entry = compiler->const_pool;
+	while (const_pool_entry != NULL) {
+		serialized_size += sizeof(struct sljit_serialized_const_pool_entry);
+		const_pool_entry = const_pool_entry->next;
+	}
+#endif /* SLJIT_CONFIG_X86_64 */
+
 	result = (sljit_u8*)SLJIT_MALLOC(serialized_size, compiler->allocator_data);
 	PTR_FAIL_IF_NULL(result);
 
@@ -302,6 +338,33 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_uw* sljit_serialize_compiler(struct sljit_compile
 	}
 	serialized_compiler->const_count = counter;
 
+	cold_region = compiler->cold_regions;
+	counter = 0;
+	while (cold_region != NULL) {
+		serialized_cold_region = (struct sljit_serialized_cold_region*)ptr;
+		serialized_cold_region->start = SLJIT_GET_LABEL_INDEX(cold_region->start);
+		serialized_cold_region->end = SLJIT_GET_LABEL_INDEX(cold_region->end);
+		ptr += sizeof(struct sljit_serialized_cold_region);
+		cold_region = cold_region->next;
+		counter++;
+	}
+	serialized_compiler->cold_region_count = counter;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	const_pool_entry = compiler->const_pool;
+	counter = 0;
+	while (const_pool_entry != NULL) {
+		serialized_const_pool_entry = (struct sljit_serialized_const_pool_entry*)ptr;
+		serialized_const_pool_entry->value = const_pool_entry->value;
+		serialized_const_pool_entry->offset = const_pool_entry->offset;
+		ptr += sizeof(struct sljit_serialized_const_pool_entry);
+		const_pool_entry = const_pool_entry->next;
+		counter++;
+	}
+	serialized_compiler->const_pool_count = counter;
+	serialized_compiler->const_pool_size = compiler->const_pool_size;
+#endif /* SLJIT_CONFIG_X86_64 */
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
 		|| (defined SLJIT_DEBUG && SLJIT_DEBUG)
 	if (!(options & SLJIT_SERIALIZE_IGNORE_DEBUG)) {
@@ -329,6 +392,12 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_compiler *sljit_deserialize_compiler(sljit
 	struct sljit_serialized_aligned_label *serialized_aligned_label;
 	struct sljit_serialized_jump *serialized_jump;
 	struct sljit_serialized_const *serialized_const;
+	struct sljit_serialized_cold_region *serialized_cold_region;
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	struct sljit_serialized_const_pool_entry *serialized_const_pool_entry;
+	struct sljit_const_pool_entry *const_pool_entry;
+	struct sljit_const_pool_entry *last_const_pool_entry;
+#endif /* SLJIT_CONFIG_X86_64 */
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
 		|| (defined SLJIT_DEBUG && SLJIT_DEBUG)
 	struct sljit_serialized_debug_info *serialized_debug_info;
@@ -343,6 +412,8 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_compiler *sljit_deserialize_compiler(sljit
 	struct sljit_jump *last_jump;
 	struct sljit_const *const_;
 	struct sljit_const *last_const;
+	struct sljit_cold_region *cold_region;
+	struct sljit_cold_region *last_cold_region;
 	sljit_u8 *ptr = (sljit_u8*)buffer;
 	sljit_u8 *end = ptr + size;
 	sljit_uw i, type, used_size, aligned_size;
@@ -536,9 +607,6 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_compiler *sljit_deserialize_compiler(sljit
 	}
 	compiler->last_jump = last_jump;
 
-	SLJIT_FREE(label_list, allocator_data);
-	label_list = NULL;
-
 	last_const = NULL;
 	i = serialized_compiler->const_count;
 	if ((sljit_uw)(end - ptr) < i * sizeof(struct sljit_serialized_const))
@@ -564,6 +632,70 @@ SLJIT_API_FUNC_ATTRIBUTE struct sljit_compiler *sljit_deserialize_compiler(sljit
 	}
 	compiler->last_const = last_const;
 
+	last_cold_region = NULL;
+	i = serialized_compiler->cold_region_count;
+	if ((sljit_uw)(end - ptr) < i * sizeof(struct sljit_serialized_cold_region))
+		goto error;
+
+	while (i > 0) {
+		cold_region = (struct sljit_cold_region*)ensure_abuf(compiler, sizeof(struct sljit_cold_region));
+		if (cold_region == NULL)
+			goto error;
+
+		serialized_cold_region = (struct sljit_serialized_cold_region*)ptr;
+		if (serialized_cold_region->start >= serialized_cold_region->end || serialized_cold_region->end >= label_count)
+			goto error;
+
+		cold_region->next = NULL;
+		cold_region->start = label_list[serialized_cold_region->start];
+		cold_region->end = label_list[serialized_cold_region->end];
+
+		if (last_cold_region != NULL)
+			last_cold_region->next = cold_region;
+		else
+			compiler->cold_regions = cold_region;
+		last_cold_region = cold_region;
+
+		ptr += sizeof(struct sljit_serialized_cold_region);
+		i--;
+	}
+	compiler->last_cold_region = last_cold_region;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	last_const_pool_entry = NULL;
+	i = serialized_compiler->const_pool_count;
+	if ((sljit_uw)(end - ptr) < i * sizeof(struct sljit_serialized_const_pool_entry))
+		goto error;
+
+	while (i > 0) {
+		const_pool_entry = (struct sljit_const_pool_entry*)ensure_abuf(compiler, sizeof(struct sljit_const_pool_entry));
+		if (const_pool_entry == NULL)
+			goto error;
+
+		serialized_const_pool_entry = (struct sljit_serialized_const_pool_entry*)ptr;
+		if (serialized_const_pool_entry->offset != CONST_POOL_UNUSED
+				&& serialized_const_pool_entry->offset >= serialized_compiler->const_pool_size)
+			goto error;
+
+		const_pool_entry->next = NULL;
+		const_pool_entry->value = serialized_const_pool_entry->value;
+		const_pool_entry->offset = serialized_const_pool_entry->offset;
+
+		if (last_const_pool_entry != NULL)
+			last_const_pool_entry->next = const_pool_entry;
+		else
+			compiler->const_pool = const_pool_entry;
+		last_const_pool_entry = const_pool_entry;
+
+		ptr += sizeof(struct sljit_serialized_const_pool_entry);
+		i--;
+	}
+	compiler->const_pool_size = serialized_compiler->const_pool_size;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	SLJIT_FREE(label_list, allocator_data);
+	label_list = NULL;
+
 #if (defined SLJIT_ARGUMENT_CHECKS && SLJIT_ARGUMENT_CHECKS) \
 		|| (defined SLJIT_DEBUG && SLJIT_DEBUG)
 	if ((sljit_uw)(end - ptr) < sizeof(struct sljit_serialized_debug_info))
@@ -342,3 +342,51 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_u8 *SLJIT_FUNC sljit_stack_resize(struct sljit_st
 #endif /* SLJIT_UTIL_SIMPLE_STACK_ALLOCATION */
 
 #endif /* SLJIT_UTIL_STACK */
+
+/* ------------------------------------------------------------------------ */
+/*  Thread local storage                                                    */
+/* ------------------------------------------------------------------------ */
+
+/* The thread pointer is read by the same instruction which is emitted
+   for SLJIT_GET_THREAD_POINTER. Windows and macOS do not use a fixed
+   offset for thread local variables, so they are not supported. */
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__APPLE__) \
+	&& !(defined SLJIT_CONFIG_UNSUPPORTED && SLJIT_CONFIG_UNSUPPORTED) \
+	&& !(defined SLJIT_CONFIG_ARM_V6 && SLJIT_CONFIG_ARM_V6)
+#define SLJIT_GET_THREAD_POINTER_SUPPORTED 1
+#endif
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_sw sljit_get_thread_local_offset(void *address)
+{
+#if (defined SLJIT_GET_THREAD_POINTER_SUPPORTED && SLJIT_GET_THREAD_POINTER_SUPPORTED)
+	void *tp;
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	__asm__ ("movq %%fs:0, %0" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+	__asm__ ("movl %%gs:0, %0" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_ARM_64 && SLJIT_CONFIG_ARM_64)
+	__asm__ ("mrs %0, tpidr_el0" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32)
+	__asm__ ("mrc p15, 0, %0, c13, c0, 3" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_PPC_64 && SLJIT_CONFIG_PPC_64)
+	__asm__ ("mr %0, 13" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_PPC_32 && SLJIT_CONFIG_PPC_32)
+	__asm__ ("mr %0, 2" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_MIPS && SLJIT_CONFIG_MIPS)
+	/* Emulated by the kernel on cpus before release 2. */
+	__asm__ (".set push\n.set mips32r2\nrdhwr %0, $29\n.set pop" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_RISCV && SLJIT_CONFIG_RISCV)
+	__asm__ ("mv %0, tp" : "=r" (tp));
+#elif (defined SLJIT_CONFIG_S390X && SLJIT_CONFIG_S390X)
+	__asm__ ("ear %0, %%a0\n\tsllg %0, %0, 32\n\tear %0, %%a1" : "=&r" (tp));
+#elif (defined SLJIT_CONFIG_LOONGARCH && SLJIT_CONFIG_LOONGARCH)
+	__asm__ ("move %0, $tp" : "=r" (tp));
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	return (sljit_sw)((sljit_u8*)address - (sljit_u8*)tp);
+#else /* !SLJIT_GET_THREAD_POINTER_SUPPORTED */
+	SLJIT_UNUSED_ARG(address);
+	return 0;
+#endif /* SLJIT_GET_THREAD_POINTER_SUPPORTED */
+}
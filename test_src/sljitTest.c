@@ -48,6 +48,10 @@
 #define COLOR_DEFAULT "\33[0m"
 #endif /* _WIN32 || _WIN64 */
 
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) && !(defined _WIN32 || defined _WIN64)
+#include <pthread.h>
+#endif /* SLJIT_CONFIG_X86 && !_WIN32 && !_WIN64 */
+
 union executable_code {
 	void* code;
 	sljit_sw (SLJIT_FUNC *func0)(void);
@@ -10500,6 +10504,2046 @@ static void test82(void)
 	successful_tests++;
 }
 
+static void test83(void)
+{
+	/* Test cold regions. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_label *loop_label;
+	struct sljit_label *cont_label;
+	struct sljit_label *cold_label1;
+	struct sljit_label *cold_label2;
+	struct sljit_label *done_label;
+	struct sljit_label *end_label;
+	struct sljit_jump *loop_jump;
+	struct sljit_jump *neg_jump;
+	struct sljit_jump *big_jump;
+	struct sljit_jump *done_jump;
+	struct sljit_jump *jump;
+	struct sljit_const *const_;
+	sljit_uw const_addr;
+	sljit_sw executable_offset;
+	sljit_sw buf[9];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test83\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	buf[0] = 5;
+	buf[1] = -3;
+	buf[2] = 7;
+	buf[3] = 1000;
+	buf[4] = -2;
+	buf[5] = 1;
+	for (i = 6; i < 9; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 5, 1, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R3, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R4, 0, SLJIT_IMM, 0);
+
+	loop_label = sljit_emit_label(compiler);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM2(SLJIT_S0, SLJIT_R1), SLJIT_WORD_SHIFT);
+	neg_jump = sljit_emit_cmp(compiler, SLJIT_SIG_LESS, SLJIT_R0, 0, SLJIT_IMM, 0);
+	big_jump = sljit_emit_cmp(compiler, SLJIT_SIG_GREATER, SLJIT_R0, 0, SLJIT_IMM, 100);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_R0, 0);
+	cont_label = sljit_emit_label(compiler);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 1);
+	loop_jump = sljit_emit_cmp(compiler, SLJIT_LESS, SLJIT_R1, 0, SLJIT_IMM, 6);
+	sljit_set_label(loop_jump, loop_label);
+	done_jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+
+	/* Cold region 1: negative numbers. */
+	cold_label1 = sljit_emit_label(compiler);
+	sljit_set_label(neg_jump, cold_label1);
+	sljit_emit_op2(compiler, SLJIT_SUB, SLJIT_R3, 0, SLJIT_R3, 0, SLJIT_R0, 0);
+	jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+	sljit_set_label(jump, cont_label);
+
+	/* Cold region 2: large numbers. */
+	cold_label2 = sljit_emit_label(compiler);
+	sljit_set_label(big_jump, cold_label2);
+	const_ = sljit_emit_const(compiler, SLJIT_MOV, SLJIT_R0, 0, 1);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R4, 0, SLJIT_R4, 0, SLJIT_R0, 0);
+	jump = sljit_emit_jump(compiler, SLJIT_JUMP);
+	sljit_set_label(jump, cont_label);
+
+	end_label = sljit_emit_label(compiler);
+	done_label = end_label;
+	sljit_set_label(done_jump, done_label);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_sw), SLJIT_R3, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_R4, 0);
+	sljit_emit_return_void(compiler);
+
+	sljit_set_cold_region(compiler, cold_label1, cold_label2);
+	sljit_set_cold_region(compiler, cold_label2, end_label);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	const_addr = sljit_get_const_addr(const_);
+	executable_offset = sljit_get_executable_offset(compiler);
+
+	if (IS_X86) {
+		FAILED(sljit_get_label_addr(cold_label1) <= sljit_get_label_addr(done_label), "test83 case 1 failed\n");
+		FAILED(sljit_get_label_addr(cold_label2) <= sljit_get_label_addr(cold_label1), "test83 case 2 failed\n");
+	}
+
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[6] != 13, "test83 case 3 failed\n");
+	FAILED(buf[7] != 5, "test83 case 4 failed\n");
+	FAILED(buf[8] != 1, "test83 case 5 failed\n");
+
+	sljit_set_const(const_addr, SLJIT_MOV, 10, executable_offset);
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[6] != 13, "test83 case 6 failed\n");
+	FAILED(buf[7] != 5, "test83 case 7 failed\n");
+	FAILED(buf[8] != 10, "test83 case 8 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test84(void)
+{
+	/* Test branch likelihood hints. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_label *loop_label;
+	struct sljit_jump *jump;
+	sljit_sw buf[5];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test84\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 5; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 3, 1, 0);
+
+	/* Count the odd numbers below 10. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0);
+	loop_label = sljit_emit_label(compiler);
+	sljit_emit_op2u(compiler, SLJIT_AND | SLJIT_SET_Z, SLJIT_R0, 0, SLJIT_IMM, 1);
+	jump = sljit_emit_jump(compiler, SLJIT_ZERO | SLJIT_JUMP_UNLIKELY);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 1);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 1);
+	jump = sljit_emit_cmp(compiler, SLJIT_LESS | SLJIT_JUMP_LIKELY, SLJIT_R0, 0, SLJIT_IMM, 10);
+	sljit_set_label(jump, loop_label);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R1, 0);
+
+	/* Count down from 7 to 0. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 7);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0);
+	loop_label = sljit_emit_label(compiler);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_R0, 0);
+	jump = sljit_emit_op2cmpz(compiler, SLJIT_SUB | SLJIT_JUMP_LIKELY, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 1);
+	sljit_set_label(jump, loop_label);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R1, 0);
+
+	/* Unlikely branches which are taken. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 100);
+	jump = sljit_emit_cmp(compiler, SLJIT_SIG_GREATER | SLJIT_32 | SLJIT_JUMP_UNLIKELY, SLJIT_R0, 0, SLJIT_IMM, 50);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_IMM, 1);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	jump = sljit_emit_op2cmpz(compiler, SLJIT_SUB | SLJIT_JUMP_IF_ZERO | SLJIT_JUMP_UNLIKELY, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 100);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_IMM, 1);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+
+	/* Likely branch which is not taken. */
+	jump = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL | SLJIT_JUMP_LIKELY, SLJIT_R0, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_IMM, 2);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[0] != 5, "test84 case 1 failed\n");
+	FAILED(buf[1] != 28, "test84 case 2 failed\n");
+	FAILED(buf[2] != -1, "test84 case 3 failed\n");
+	FAILED(buf[3] != -1, "test84 case 4 failed\n");
+	FAILED(buf[4] != 2, "test84 case 5 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test85(void)
+{
+	/* Test peephole optimizer. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_jump *jump;
+	sljit_sw buf[7];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test85\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 7; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 4, 1, 0);
+
+	/* Dead moves. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 5);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 7);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R3, 0, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R3, 0, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 6);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM2(SLJIT_S0, SLJIT_R1), SLJIT_WORD_SHIFT);
+
+	/* Store followed by a reload. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R2, 0, SLJIT_IMM, 1);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw));
+	sljit_emit_op2(compiler, SLJIT_SHL, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R2, 0, SLJIT_IMM, 1);
+
+	/* The 32 bit load clears the upper bits. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, -1);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV_U32, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R2, 0);
+
+	/* A label between the instructions prevents the optimization. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 9);
+	jump = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R1, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 10);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 11);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_R0, 0, SLJIT_R3, 0);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, SLJIT_GENERATE_CODE_PEEPHOLE, NULL);
+	CHECK(compiler);
+
+	if (IS_X86) {
+		FAILED(sljit_get_peephole_count(compiler, SLJIT_PEEPHOLE_RELOAD) < 3, "test85 case 1 failed\n");
+		FAILED(sljit_get_peephole_count(compiler, SLJIT_PEEPHOLE_DEAD_MOVE) < 2, "test85 case 2 failed\n");
+	}
+
+	sljit_free_compiler(compiler);
+
+	buf[6] = 100;
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[0] != 7, "test85 case 3 failed\n");
+	FAILED(buf[1] != 8, "test85 case 4 failed\n");
+	FAILED(buf[2] != 14, "test85 case 5 failed\n");
+#if IS_64BIT
+	FAILED(buf[4] != (sljit_sw)0xffffffff, "test85 case 6 failed\n");
+#else /* !IS_64BIT */
+	FAILED(buf[4] != -1, "test85 case 6 failed\n");
+#endif /* IS_64BIT */
+	FAILED(buf[5] != 111 + 100, "test85 case 7 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test86(void)
+{
+	/* Test constant folding. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_sw buf[14];
+	sljit_s32 ibuf[5];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test86\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 14; i++)
+		buf[i] = -1;
+	for (i = 0; i < 5; i++)
+		ibuf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS2V(P, P), 3, 2, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 1234);
+	/* buf[0] */
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_IMM, 5, SLJIT_IMM, 7);
+	/* buf[1] */
+	sljit_emit_op2(compiler, SLJIT_MUL, SLJIT_R1, 0, SLJIT_IMM, 1, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R1, 0);
+	/* buf[2] */
+	sljit_emit_op2(compiler, SLJIT_AND, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R0, 0, SLJIT_IMM, 0);
+	/* buf[3] */
+	sljit_emit_op2(compiler, SLJIT_OR, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_IMM, -1, SLJIT_R0, 0);
+	/* buf[4] */
+	sljit_emit_op2(compiler, SLJIT_SHL, SLJIT_R1, 0, SLJIT_R0, 0, SLJIT_IMM, 8 * sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R1, 0);
+	/* buf[5] */
+	sljit_emit_op2(compiler, SLJIT_ASHR, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_IMM, -64, SLJIT_IMM, 3);
+	/* buf[6] */
+	sljit_emit_op2(compiler, SLJIT_SUB, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_IMM, 0, SLJIT_R0, 0);
+	/* buf[7] */
+	sljit_emit_op2(compiler, SLJIT_XOR, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 0);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_sw), SLJIT_IMM, 0, SLJIT_R0, 0);
+	/* buf[8] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0);
+	sljit_emit_op2(compiler, SLJIT_ADD | SLJIT_SET_Z, SLJIT_R2, 0, SLJIT_R1, 0, SLJIT_IMM, 0);
+	sljit_emit_op_flags(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_ZERO);
+	/* buf[9] */
+	sljit_emit_op1(compiler, SLJIT_CLZ, SLJIT_MEM1(SLJIT_S0), 9 * sizeof(sljit_sw), SLJIT_IMM, 1);
+	/* buf[10] */
+	sljit_emit_op1(compiler, SLJIT_CTZ, SLJIT_R2, 0, SLJIT_IMM, 0x100);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 10 * sizeof(sljit_sw), SLJIT_R2, 0);
+	/* buf[11] */
+	sljit_emit_op1(compiler, SLJIT_REV_U16, SLJIT_MEM1(SLJIT_S0), 11 * sizeof(sljit_sw), SLJIT_IMM, 0x1234);
+	/* buf[12] */
+	sljit_emit_op1(compiler, SLJIT_REV_S16, SLJIT_MEM1(SLJIT_S0), 12 * sizeof(sljit_sw), SLJIT_IMM, 0x80);
+	/* buf[13] */
+	sljit_emit_op2(compiler, SLJIT_MSHL, SLJIT_MEM1(SLJIT_S0), 13 * sizeof(sljit_sw), SLJIT_IMM, 3, SLJIT_IMM, 8 * sizeof(sljit_sw) + 2);
+
+	/* ibuf[0] */
+	sljit_emit_op2(compiler, SLJIT_SUB32, SLJIT_MEM1(SLJIT_S1), 0, SLJIT_IMM, 3, SLJIT_IMM, 5);
+	/* ibuf[1] */
+	sljit_emit_op2(compiler, SLJIT_ROTR32, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_s32), SLJIT_IMM, 0x12345678, SLJIT_IMM, 8);
+	/* ibuf[2] */
+	sljit_emit_op2(compiler, SLJIT_LSHR32, SLJIT_MEM1(SLJIT_S1), 2 * sizeof(sljit_s32), SLJIT_IMM, -1, SLJIT_IMM, 4);
+	/* ibuf[3] */
+	sljit_emit_op1(compiler, SLJIT_REV32, SLJIT_MEM1(SLJIT_S1), 3 * sizeof(sljit_s32), SLJIT_IMM, 0x11223344);
+	/* ibuf[4] */
+	sljit_emit_op1(compiler, SLJIT_CLZ32, SLJIT_R2, 0, SLJIT_IMM, 0);
+	sljit_emit_op2(compiler, SLJIT_AND32, SLJIT_MEM1(SLJIT_S1), 4 * sizeof(sljit_s32), SLJIT_R2, 0, SLJIT_IMM, -1);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func2((sljit_sw)&buf, (sljit_sw)&ibuf);
+
+	FAILED(buf[0] != 12, "test86 case 1 failed\n");
+	FAILED(buf[1] != 1234, "test86 case 2 failed\n");
+	FAILED(buf[2] != 0, "test86 case 3 failed\n");
+	FAILED(buf[3] != -1, "test86 case 4 failed\n");
+	FAILED(buf[4] != 1234, "test86 case 5 failed\n");
+	FAILED(buf[5] != -8, "test86 case 6 failed\n");
+	FAILED(buf[6] != -1234, "test86 case 7 failed\n");
+	FAILED(buf[7] != 1234, "test86 case 8 failed\n");
+	FAILED(buf[8] != 1, "test86 case 9 failed\n");
+	FAILED(buf[9] != (sljit_sw)(8 * sizeof(sljit_sw) - 1), "test86 case 10 failed\n");
+	FAILED(buf[10] != 8, "test86 case 11 failed\n");
+	FAILED(buf[11] != 0x3412, "test86 case 12 failed\n");
+	FAILED(buf[12] != -0x8000, "test86 case 13 failed\n");
+	FAILED(buf[13] != 12, "test86 case 14 failed\n");
+	FAILED(ibuf[0] != -2, "test86 case 15 failed\n");
+	FAILED(ibuf[1] != 0x78123456, "test86 case 16 failed\n");
+	FAILED(ibuf[2] != 0x0fffffff, "test86 case 17 failed\n");
+	FAILED(ibuf[3] != 0x44332211, "test86 case 18 failed\n");
+	FAILED(ibuf[4] != 32, "test86 case 19 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test87(void)
+{
+	/* Test zero flag liveness. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_jump *jump;
+	struct sljit_label *label;
+	sljit_sw buf[7];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test87\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 7; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 3, 1, 0);
+
+	/* buf[0], buf[1] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 5);
+	sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_Z, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 5);
+	sljit_emit_op2(compiler, SLJIT_ADD | SLJIT_SET_Z, SLJIT_R1, 0, SLJIT_R0, 0, SLJIT_IMM, 3);
+	sljit_emit_op_flags(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_ZERO);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R1, 0);
+	/* buf[2] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 7);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_IMM, 1);
+	sljit_emit_op2(compiler, SLJIT_XOR | SLJIT_SET_Z, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 7);
+	jump = sljit_emit_jump(compiler, SLJIT_EQUAL);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_IMM, 2);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	/* buf[3] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x1200);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_IMM, 1);
+	sljit_emit_op2(compiler, SLJIT_AND32 | SLJIT_SET_Z, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 0xff00);
+	jump = sljit_emit_jump(compiler, SLJIT_NOT_EQUAL);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_IMM, 2);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	/* buf[4] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 10);
+	sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_Z, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 10);
+	/* The zero flag is also set by a jump to this label. */
+	label = sljit_emit_label(compiler);
+	sljit_set_current_flags(compiler, SLJIT_SET_Z);
+	jump = sljit_emit_jump(compiler, SLJIT_EQUAL);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 10);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 1);
+	jump = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 1);
+	sljit_emit_op2(compiler, SLJIT_SUB | SLJIT_SET_Z, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 0);
+	sljit_set_label(sljit_emit_jump(compiler, SLJIT_JUMP), label);
+	sljit_set_label(jump, sljit_emit_label(compiler));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0);
+	/* buf[5] */
+	sljit_emit_op2(compiler, SLJIT_OR | SLJIT_SET_Z, SLJIT_R2, 0, SLJIT_R0, 0, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 99);
+	sljit_emit_op_flags(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_EQUAL);
+	/* buf[6] */
+	sljit_emit_op2(compiler, SLJIT_SHL | SLJIT_SET_Z, SLJIT_R2, 0, SLJIT_R1, 0, SLJIT_IMM, 1);
+	sljit_emit_op2(compiler, SLJIT_LSHR | SLJIT_SET_Z, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 8);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_R2, 0, SLJIT_IMM, 100);
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[0] != 0, "test87 case 1 failed\n");
+	FAILED(buf[1] != 3, "test87 case 2 failed\n");
+	FAILED(buf[2] != 1, "test87 case 3 failed\n");
+	FAILED(buf[3] != 1, "test87 case 4 failed\n");
+	FAILED(buf[4] != 2, "test87 case 5 failed\n");
+	FAILED(buf[5] != 1, "test87 case 6 failed\n");
+	FAILED(buf[6] != 100, "test87 case 7 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test88(void)
+{
+	/* Test virtual register allocation. */
+	executable_code code;
+	executable_code code2;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_virt_compiler* virt_compiler;
+	sljit_sw buf[4];
+	sljit_s32 i, label, spill_count;
+
+	if (verbose)
+		printf("Run test88\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	buf[0] = -1;
+	buf[1] = -1;
+	buf[2] = 1000;
+	buf[3] = -1;
+
+	/* Small function without spilling: a * 3 + b. */
+	virt_compiler = sljit_create_virt_compiler(compiler, 2);
+	FAILED(!virt_compiler, "cannot create virtual register compiler\n");
+
+	sljit_virt_op2(virt_compiler, SLJIT_MUL, 2, SLJIT_VIRT_REG, 0, SLJIT_IMM, 3);
+	sljit_virt_op2(virt_compiler, SLJIT_ADD, 3, SLJIT_VIRT_REG, 2, SLJIT_VIRT_REG, 1);
+	sljit_virt_return(virt_compiler, SLJIT_MOV, SLJIT_VIRT_REG, 3);
+
+	FAILED(sljit_virt_generate(virt_compiler) != SLJIT_SUCCESS, "test88 case 1 failed\n");
+	spill_count = sljit_virt_get_spill_count(virt_compiler);
+	sljit_free_virt_compiler(virt_compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	FAILED(spill_count != 0, "test88 case 2 failed\n");
+	FAILED(code.func2(5, 7) != 22, "test88 case 3 failed\n");
+	sljit_free_code(code.code, NULL);
+
+	/* A loop where 24 values are live at the same time. */
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+	virt_compiler = sljit_create_virt_compiler(compiler, 2);
+	FAILED(!virt_compiler, "cannot create virtual register compiler\n");
+
+	for (i = 0; i < 24; i++)
+		sljit_virt_op1(virt_compiler, SLJIT_MOV, 2 + i, SLJIT_IMM, i + 1);
+	sljit_virt_op1(virt_compiler, SLJIT_MOV, 30, SLJIT_IMM, 0);
+	sljit_virt_op1(virt_compiler, SLJIT_MOV, 31, SLJIT_IMM, 0);
+
+	label = sljit_virt_new_label(virt_compiler);
+	sljit_virt_emit_label(virt_compiler, label);
+	for (i = 0; i < 24; i++)
+		sljit_virt_op2(virt_compiler, SLJIT_ADD, 30, SLJIT_VIRT_REG, 30, SLJIT_VIRT_REG, 2 + i);
+	/* Temporary value, which is not live across iterations. */
+	sljit_virt_op2(virt_compiler, SLJIT_SHL, 32, SLJIT_VIRT_REG, 31, SLJIT_IMM, 1);
+	sljit_virt_op2(virt_compiler, SLJIT_ADD, 30, SLJIT_VIRT_REG, 30, SLJIT_VIRT_REG, 32);
+	sljit_virt_op2(virt_compiler, SLJIT_ADD, 31, SLJIT_VIRT_REG, 31, SLJIT_IMM, 1);
+	sljit_virt_cmp(virt_compiler, SLJIT_LESS, SLJIT_VIRT_REG, 31, SLJIT_VIRT_REG, 1, label);
+
+	/* buf[0], buf[1] */
+	sljit_virt_store(virt_compiler, SLJIT_MOV, 0, 0, SLJIT_VIRT_REG, 30);
+	sljit_virt_store(virt_compiler, SLJIT_MOV, 0, sizeof(sljit_sw), SLJIT_VIRT_REG, 25);
+	/* buf[3] */
+	sljit_virt_load(virt_compiler, SLJIT_MOV, 33, 0, 2 * sizeof(sljit_sw));
+	sljit_virt_op2(virt_compiler, SLJIT_ADD, 33, SLJIT_VIRT_REG, 33, SLJIT_VIRT_REG, 25);
+	sljit_virt_store(virt_compiler, SLJIT_MOV, 0, 3 * sizeof(sljit_sw), SLJIT_VIRT_REG, 33);
+	sljit_virt_return(virt_compiler, SLJIT_MOV, SLJIT_VIRT_REG, 2);
+
+	FAILED(sljit_virt_generate(virt_compiler) != SLJIT_SUCCESS, "test88 case 4 failed\n");
+	spill_count = sljit_virt_get_spill_count(virt_compiler);
+	sljit_free_virt_compiler(virt_compiler);
+
+	code2.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	FAILED(spill_count == 0, "test88 case 5 failed\n");
+	FAILED(code2.func2((sljit_sw)&buf, 3) != 1, "test88 case 6 failed\n");
+	FAILED(buf[0] != 3 * 300 + 2 * (0 + 1 + 2), "test88 case 7 failed\n");
+	FAILED(buf[1] != 24, "test88 case 8 failed\n");
+	FAILED(buf[3] != 1024, "test88 case 9 failed\n");
+	sljit_free_code(code2.code, NULL);
+
+	/* Labels must be placed. */
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+	virt_compiler = sljit_create_virt_compiler(compiler, 0);
+	FAILED(!virt_compiler, "cannot create virtual register compiler\n");
+
+	label = sljit_virt_new_label(virt_compiler);
+	sljit_virt_jump(virt_compiler, label);
+	sljit_virt_return(virt_compiler, SLJIT_MOV, SLJIT_IMM, 0);
+	FAILED(sljit_virt_generate(virt_compiler) != SLJIT_ERR_BAD_ARGUMENT, "test88 case 10 failed\n");
+
+	sljit_free_virt_compiler(virt_compiler);
+	sljit_free_compiler(compiler);
+
+	successful_tests++;
+}
+
+static void test89(void)
+{
+	/* Test constant pool. */
+	executable_code code;
+	struct sljit_compiler* compiler;
+	sljit_uw *serialized_buffer;
+	sljit_uw serialized_size;
+	sljit_sw buf[5];
+	sljit_f64 dbuf[3];
+	sljit_f32 sbuf[2];
+	sljit_uw size[2];
+	sljit_sw wide = WCONST(0x123456789abc, 0x12345678);
+	sljit_s32 i, j;
+
+	if (verbose)
+		printf("Run test89\n");
+
+	for (i = 0; i < 5; i++)
+		buf[i] = -1;
+	for (i = 0; i < 3; i++)
+		dbuf[i] = -1.0;
+	sbuf[0] = -1.0;
+	sbuf[1] = -1.0;
+
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS3V(P, P, P), 3 | SLJIT_ENTER_FLOAT(3), 3, 0);
+
+	/* buf[0-3] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, wide);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, wide);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R1, 0, SLJIT_IMM, wide);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R2, 0);
+
+	if (sljit_has_cpu_feature(SLJIT_HAS_FPU)) {
+		/* dbuf[0-2] */
+		sljit_emit_fset64(compiler, SLJIT_FR0, 3.25);
+		sljit_emit_fset64(compiler, SLJIT_FR1, 3.25);
+		sljit_emit_fset64(compiler, SLJIT_FR2, -7.5);
+		sljit_emit_fop2(compiler, SLJIT_ADD_F64, SLJIT_FR0, 0, SLJIT_FR0, 0, SLJIT_FR1, 0);
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S1), 0, SLJIT_FR0, 0);
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_f64), SLJIT_FR2, 0);
+		sljit_emit_fset64(compiler, SLJIT_FR2, 0.0);
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S1), 2 * sizeof(sljit_f64), SLJIT_FR2, 0);
+		/* sbuf[0-1] */
+		sljit_emit_fset32(compiler, SLJIT_FR0, 1.5f);
+		sljit_emit_fset32(compiler, SLJIT_FR1, 1.5f);
+		sljit_emit_fop2(compiler, SLJIT_ADD_F32, SLJIT_FR0, 0, SLJIT_FR0, 0, SLJIT_FR1, 0);
+		sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S2), 0, SLJIT_FR0, 0);
+		sljit_emit_fset32(compiler, SLJIT_FR2, -0.25f);
+		sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S2), sizeof(sljit_f32), SLJIT_FR2, 0);
+	}
+
+	serialized_buffer = sljit_serialize_compiler(compiler, 0, &serialized_size);
+	FAILED(!serialized_buffer, "cannot serialize compiler\n");
+	sljit_free_compiler(compiler);
+
+	compiler = sljit_deserialize_compiler(serialized_buffer, serialized_size, 0, NULL);
+	SLJIT_FREE(serialized_buffer, NULL);
+	FAILED(!compiler, "cannot deserialize compiler\n");
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_IMM, wide);
+	/* buf[4] */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, wide + 1);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R0, 0);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func3((sljit_sw)&buf, (sljit_sw)&dbuf, (sljit_sw)&sbuf);
+	sljit_free_code(code.code, NULL);
+
+	FAILED(buf[0] != wide, "test89 case 1 failed\n");
+	FAILED(buf[1] != wide, "test89 case 2 failed\n");
+	FAILED(buf[2] != wide * 2, "test89 case 3 failed\n");
+	FAILED(buf[3] != wide, "test89 case 4 failed\n");
+	FAILED(buf[4] != wide + 1, "test89 case 5 failed\n");
+
+	if (sljit_has_cpu_feature(SLJIT_HAS_FPU)) {
+		FAILED(dbuf[0] != 6.5, "test89 case 6 failed\n");
+		FAILED(dbuf[1] != -7.5, "test89 case 7 failed\n");
+		FAILED(dbuf[2] != 0.0, "test89 case 8 failed\n");
+		FAILED(sbuf[0] != 3.0, "test89 case 9 failed\n");
+		FAILED(sbuf[1] != -0.25, "test89 case 10 failed\n");
+	}
+
+	/* Repeated constants must not generate more code than distinct constants. */
+	for (j = 0; j < 2; j++) {
+		compiler = sljit_create_compiler(NULL);
+		FAILED(!compiler, "cannot create compiler\n");
+
+		sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 1, 1, 0);
+
+		for (i = 0; i < 16; i++)
+			sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_IMM, wide + (j ? i : 0));
+
+		sljit_emit_return_void(compiler);
+
+		code.code = sljit_generate_code(compiler, 0, NULL);
+		CHECK(compiler);
+		size[j] = sljit_get_generated_code_size(compiler);
+		sljit_free_compiler(compiler);
+
+		code.func1((sljit_sw)&buf);
+		sljit_free_code(code.code, NULL);
+
+		FAILED(buf[0] != wide + (j ? 15 : 0), "test89 case 11 failed\n");
+	}
+
+	FAILED(size[0] > size[1], "test89 case 12 failed\n");
+
+	successful_tests++;
+}
+
+static void test90(void)
+{
+	/* Test division by constant. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	static const sljit_s32 ops[] = {
+		SLJIT_DIVMOD_UW, SLJIT_DIVMOD_UW, SLJIT_DIVMOD_UW, SLJIT_DIVMOD_UW, SLJIT_DIVMOD_UW, SLJIT_DIVMOD_UW, SLJIT_DIV_UW,
+		SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIVMOD_SW, SLJIT_DIV_SW,
+		SLJIT_DIVMOD_U32, SLJIT_DIVMOD_U32, SLJIT_DIVMOD_U32, SLJIT_DIVMOD_U32, SLJIT_DIV_U32,
+		SLJIT_DIVMOD_S32, SLJIT_DIVMOD_S32, SLJIT_DIVMOD_S32, SLJIT_DIVMOD_S32, SLJIT_DIVMOD_S32, SLJIT_DIV_S32,
+	};
+	sljit_sw divisors[sizeof(ops) / sizeof(ops[0])] = {
+		1, 16, 7, 10, -3, 0, 641,
+		1, -1, 8, -4, 7, -3, 0, 10,
+		7, 0x80000001, 64, 3, 10,
+		-1, 7, -3, 16, (sljit_sw)(sljit_s32)0x80000000, 641,
+	};
+	sljit_sw dividends[8] = {
+		0, 1, 100, -1, -100, 12345678, WCONST(0x7edcba9876543210, 0x76543210), 0
+	};
+	sljit_sw buf[(sizeof(ops) / sizeof(ops[0])) * 8 * 2];
+	sljit_s32 i, j, cases = (sljit_s32)(sizeof(ops) / sizeof(ops[0]));
+	sljit_sw x, d, q, r;
+
+	if (verbose)
+		printf("Run test90\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	/* Word sized top bit divisors, and the minimum value as a dividend. */
+	divisors[5] = (sljit_sw)(((sljit_uw)1 << (8 * sizeof(sljit_sw) - 1)) + 5);
+	divisors[13] = (sljit_sw)((sljit_uw)1 << (8 * sizeof(sljit_sw) - 1));
+	dividends[7] = (sljit_sw)((sljit_uw)1 << (8 * sizeof(sljit_sw) - 1));
+
+	for (i = 0; i < cases * 8 * 2; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS2V(P, P), 3, 2, 0);
+
+	for (i = 0; i < cases; i++) {
+		for (j = 0; j < 8; j++) {
+			sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_S1), j * (sljit_sw)sizeof(sljit_sw));
+			sljit_emit_div_imm(compiler, ops[i], divisors[i]);
+			sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), (i * 8 + j) * 2 * (sljit_sw)sizeof(sljit_sw), SLJIT_R0, 0);
+			sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), ((i * 8 + j) * 2 + 1) * (sljit_sw)sizeof(sljit_sw), SLJIT_R1, 0);
+		}
+	}
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func2((sljit_sw)&buf, (sljit_sw)&dividends);
+	sljit_free_code(code.code, NULL);
+
+	for (i = 0; i < cases; i++) {
+		for (j = 0; j < 8; j++) {
+			x = dividends[j];
+			d = divisors[i];
+
+			if (ops[i] & SLJIT_32) {
+				if (ops[i] == SLJIT_DIVMOD_U32 || ops[i] == SLJIT_DIV_U32) {
+					q = (sljit_sw)((sljit_u32)x / (sljit_u32)d);
+					r = (sljit_sw)((sljit_u32)x % (sljit_u32)d);
+				} else if ((sljit_s32)d == -1) {
+					q = (sljit_sw)((sljit_u32)0 - (sljit_u32)x);
+					r = 0;
+				} else {
+					q = (sljit_s32)x / (sljit_s32)d;
+					r = (sljit_s32)x % (sljit_s32)d;
+				}
+
+				if ((sljit_u32)buf[(i * 8 + j) * 2] != (sljit_u32)q
+						|| (((ops[i] & ~SLJIT_32) == SLJIT_DIVMOD_UW || (ops[i] & ~SLJIT_32) == SLJIT_DIVMOD_SW)
+							&& (sljit_u32)buf[(i * 8 + j) * 2 + 1] != (sljit_u32)r)) {
+					printf("test90 case %d failed\n", i * 8 + j + 1);
+					return;
+				}
+				continue;
+			}
+
+			if (ops[i] == SLJIT_DIVMOD_UW || ops[i] == SLJIT_DIV_UW) {
+				q = (sljit_sw)((sljit_uw)x / (sljit_uw)d);
+				r = (sljit_sw)((sljit_uw)x % (sljit_uw)d);
+			} else if (d == -1) {
+				q = (sljit_sw)((sljit_uw)0 - (sljit_uw)x);
+				r = 0;
+			} else {
+				q = x / d;
+				r = x % d;
+			}
+
+			if (buf[(i * 8 + j) * 2] != q
+					|| ((ops[i] == SLJIT_DIVMOD_UW || ops[i] == SLJIT_DIVMOD_SW) && buf[(i * 8 + j) * 2 + 1] != r)) {
+				printf("test90 case %d failed\n", i * 8 + j + 1);
+				return;
+			}
+		}
+	}
+
+	successful_tests++;
+}
+
+static void test91(void)
+{
+	/* Test switch statements. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_switch *switch_;
+	struct sljit_jump *jumps[8];
+	struct sljit_label *label;
+	static const sljit_sw dense[5] = { 3, 4, 5, 7, 8 };
+	static const sljit_sw sparse[7] = { -100000, -5, 0, 17, 1000, 65536, 1 << 30 };
+	static const sljit_sw inputs[12] = { 2, 3, 4, 6, 8, 9, -100000, -5, 0, 17, 65536, 1 << 30 };
+	sljit_sw expected, result;
+	sljit_s32 i, j;
+
+	if (verbose)
+		printf("Run test91\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, W), 3, 1, 0);
+
+	/* Jump table. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	switch_ = sljit_emit_switch(compiler, SLJIT_R0, 0, dense, 5);
+
+	for (i = 0; i <= 5; i++) {
+		label = sljit_emit_label(compiler);
+		sljit_set_switch_label(switch_, (sljit_uw)i, label);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 10 + i);
+		jumps[i] = sljit_emit_jump(compiler, SLJIT_JUMP);
+	}
+
+	label = sljit_emit_label(compiler);
+	for (i = 0; i <= 5; i++)
+		sljit_set_label(jumps[i], label);
+
+	/* Compare tree. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	switch_ = sljit_emit_switch(compiler, SLJIT_R0, 0, sparse, 7);
+
+	for (i = 0; i <= 7; i++) {
+		label = sljit_emit_label(compiler);
+		sljit_set_switch_label(switch_, (sljit_uw)i, label);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 20 + i);
+		jumps[i] = sljit_emit_jump(compiler, SLJIT_JUMP);
+	}
+
+	label = sljit_emit_label(compiler);
+	for (i = 0; i <= 7; i++)
+		sljit_set_label(jumps[i], label);
+
+	sljit_emit_op2(compiler, SLJIT_MUL, SLJIT_R0, 0, SLJIT_R2, 0, SLJIT_IMM, 100);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_R1, 0);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	for (i = 0; i < 12; i++) {
+		expected = 15 * 100;
+		for (j = 0; j < 5; j++)
+			if (inputs[i] == dense[j])
+				expected = (10 + j) * 100;
+
+		result = 27;
+		for (j = 0; j < 7; j++)
+			if (inputs[i] == sparse[j])
+				result = 20 + j;
+		expected += result;
+
+		if (code.func1(inputs[i]) != expected) {
+			printf("test91 case %d failed\n", i + 1);
+			sljit_free_code(code.code, NULL);
+			return;
+		}
+	}
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test92(void)
+{
+	/* Test inline caches. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_ic_site *site;
+	struct sljit_label *labels[4];
+	struct sljit_label *miss_label;
+	struct sljit_ic ic;
+	sljit_uw targets[4];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test92\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, W), 2, 1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	site = sljit_emit_ic_site(compiler, SLJIT_R0, SLJIT_R1);
+
+	for (i = 0; i < 4; i++) {
+		labels[i] = sljit_emit_label(compiler);
+		sljit_emit_return(compiler, SLJIT_MOV, SLJIT_IMM, i + 1);
+	}
+
+	miss_label = sljit_emit_label(compiler);
+	sljit_set_ic_miss_label(site, miss_label);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_IMM, -1);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	sljit_init_ic(&ic, site, compiler);
+	for (i = 0; i < 4; i++)
+		targets[i] = sljit_get_label_addr(labels[i]);
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func1(100) != -1, "test92 case 1 failed\n");
+
+	/* Monomorphic. */
+	FAILED(sljit_add_ic_key(&ic, 100, targets[0], NULL) != SLJIT_SUCCESS, "test92 case 2 failed\n");
+	FAILED(code.func1(100) != 1, "test92 case 3 failed\n");
+	FAILED(code.func1(200) != -1, "test92 case 4 failed\n");
+
+	/* Polymorphic. */
+	FAILED(sljit_add_ic_key(&ic, 200, targets[1], NULL) != SLJIT_SUCCESS, "test92 case 5 failed\n");
+	FAILED(sljit_add_ic_key(&ic, WCONST(0x123456789ab, 0x12345678), targets[2], NULL) != SLJIT_SUCCESS, "test92 case 6 failed\n");
+	FAILED(code.func1(100) != 1, "test92 case 7 failed\n");
+	FAILED(code.func1(200) != 2, "test92 case 8 failed\n");
+	FAILED(code.func1(WCONST(0x123456789ab, 0x12345678)) != 3, "test92 case 9 failed\n");
+	FAILED(code.func1(300) != -1, "test92 case 10 failed\n");
+
+	/* Megamorphic. */
+	for (i = 2; i < SLJIT_IC_MAX_STUBS; i++)
+		FAILED(sljit_add_ic_key(&ic, 1000 + i, targets[3], NULL) != SLJIT_SUCCESS, "test92 case 11 failed\n");
+	FAILED(sljit_add_ic_key(&ic, 300, targets[3], NULL) != SLJIT_ERR_UNSUPPORTED, "test92 case 12 failed\n");
+	FAILED(code.func1(1002) != 4, "test92 case 13 failed\n");
+	FAILED(code.func1(200) != 2, "test92 case 14 failed\n");
+	FAILED(code.func1(300) != -1, "test92 case 15 failed\n");
+
+	sljit_reset_ic(&ic, NULL);
+	FAILED(code.func1(100) != -1, "test92 case 16 failed\n");
+	FAILED(code.func1(200) != -1, "test92 case 17 failed\n");
+
+	FAILED(sljit_add_ic_key(&ic, 200, targets[3], NULL) != SLJIT_SUCCESS, "test92 case 18 failed\n");
+	FAILED(code.func1(200) != 4, "test92 case 19 failed\n");
+
+	sljit_reset_ic(&ic, NULL);
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) && !(defined _WIN32 || defined _WIN64)
+
+struct test93_data {
+	volatile sljit_s32 stop;
+	sljit_uw const_addr;
+	sljit_uw jump_addr;
+	sljit_uw targets[2];
+	sljit_sw values[2];
+	sljit_sw executable_offset;
+};
+
+static void *test93_patcher(void *arg)
+{
+	struct test93_data *data = (struct test93_data*)arg;
+	sljit_s32 i = 0;
+
+	while (!data->stop) {
+		sljit_set_const(data->const_addr, SLJIT_MOV, data->values[i], data->executable_offset);
+		sljit_set_jump_addr(data->jump_addr, data->targets[i], data->executable_offset);
+		i ^= 1;
+	}
+	return NULL;
+}
+
+#endif /* SLJIT_CONFIG_X86 && !_WIN32 && !_WIN64 */
+
+static void test93(void)
+{
+	/* Test concurrent code patching. */
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
+	executable_code code;
+	struct sljit_compiler* compiler;
+	struct sljit_const *const1;
+	struct sljit_const *const2;
+	struct sljit_jump *jump;
+	struct sljit_label *labels[2];
+	sljit_uw const1_addr, const2_addr, jump_addr, targets[2];
+	sljit_sw executable_offset;
+	sljit_sw values[2];
+#if !(defined _WIN32 || defined _WIN64)
+	struct test93_data data;
+	pthread_t thread;
+	sljit_sw result;
+	sljit_s32 i;
+#endif /* !_WIN32 && !_WIN64 */
+#endif /* SLJIT_CONFIG_X86 */
+
+	if (verbose)
+		printf("Run test93\n");
+
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
+	values[0] = WCONST(0x1000000010000000, 0x10001000);
+	values[1] = WCONST(0x2000000020000000, 0x20002000);
+
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, SLJIT_ENTER_CONCURRENT_PATCH, SLJIT_ARGS0(W), 2, 0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 5);
+	const1 = sljit_emit_const(compiler, SLJIT_MOV, SLJIT_R0, 0, values[0]);
+	sljit_emit_op2(compiler, SLJIT_ADD32, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_IMM, 1);
+	const2 = sljit_emit_const(compiler, SLJIT_MOV32, SLJIT_R1, 0, 7);
+	jump = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL | SLJIT_REWRITABLE_JUMP, SLJIT_R1, 0, SLJIT_IMM, 0);
+	labels[1] = sljit_emit_label(compiler);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 1);
+	labels[0] = sljit_emit_label(compiler);
+	sljit_set_label(jump, labels[0]);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	const1_addr = sljit_get_const_addr(const1);
+	const2_addr = sljit_get_const_addr(const2);
+	jump_addr = sljit_get_jump_addr(jump);
+	targets[0] = sljit_get_label_addr(labels[0]);
+	targets[1] = sljit_get_label_addr(labels[1]);
+	executable_offset = sljit_get_executable_offset(compiler);
+	sljit_free_compiler(compiler);
+
+	/* The patched fields must be naturally aligned. */
+	FAILED(((const1_addr - sizeof(sljit_sw)) & (sizeof(sljit_sw) - 1)) != 0, "test93 case 1 failed\n");
+	FAILED(((const2_addr - sizeof(sljit_s32)) & (sizeof(sljit_s32) - 1)) != 0, "test93 case 2 failed\n");
+	FAILED((jump_addr & (sizeof(sljit_sw) - 1)) != 0, "test93 case 3 failed\n");
+
+	FAILED(code.func0() != values[0], "test93 case 4 failed\n");
+	sljit_set_const(const1_addr, SLJIT_MOV, values[1], executable_offset);
+	sljit_set_jump_addr(jump_addr, targets[1], executable_offset);
+	FAILED(code.func0() != values[1] + 1, "test93 case 5 failed\n");
+
+#if !(defined _WIN32 || defined _WIN64)
+	data.stop = 0;
+	data.const_addr = const1_addr;
+	data.jump_addr = jump_addr;
+	data.targets[0] = targets[0];
+	data.targets[1] = targets[1];
+	data.values[0] = values[0];
+	data.values[1] = values[1];
+	data.executable_offset = executable_offset;
+
+	FAILED(pthread_create(&thread, NULL, test93_patcher, &data) != 0, "test93 case 6 failed\n");
+
+	for (i = 0; i < 200000; i++) {
+		result = code.func0();
+
+		if (result != values[0] && result != values[0] + 1 && result != values[1] && result != values[1] + 1)
+			break;
+	}
+
+	data.stop = 1;
+	pthread_join(thread, NULL);
+	FAILED(i != 200000, "test93 case 7 failed\n");
+#endif /* !_WIN32 && !_WIN64 */
+
+	sljit_free_code(code.code, NULL);
+#else /* !SLJIT_CONFIG_X86 */
+	if (verbose)
+		printf("concurrent patching is not supported, test93 skipped\n");
+#endif /* SLJIT_CONFIG_X86 */
+
+	successful_tests++;
+}
+
+static void test94(void)
+{
+	/* Test batch patching. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_const *consts[8];
+	struct sljit_jump *jump;
+	struct sljit_label *add_label;
+	struct sljit_label *skip_label;
+	struct sljit_patch patches[11];
+	sljit_sw executable_offset;
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test94\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS0(W), 2, 0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0);
+
+	for (i = 0; i < 8; i++) {
+		consts[i] = sljit_emit_const(compiler, (i & 0x1) ? SLJIT_MOV32 : SLJIT_MOV, SLJIT_R1, 0, i + 1);
+		sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_R1, 0);
+	}
+
+	jump = sljit_emit_jump(compiler, SLJIT_JUMP | SLJIT_REWRITABLE_JUMP);
+	add_label = sljit_emit_label(compiler);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 1000);
+	skip_label = sljit_emit_label(compiler);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+	sljit_set_label(jump, skip_label);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	executable_offset = sljit_get_executable_offset(compiler);
+
+	/* The entries are not in address order. */
+	for (i = 0; i < 8; i++) {
+		patches[i].addr = sljit_get_const_addr(consts[7 - i]);
+		patches[i].kind = ((7 - i) & 0x1) ? SLJIT_MOV32 : SLJIT_MOV;
+		patches[i].status = -1;
+		patches[i].value = (7 - i + 1) * 10;
+	}
+
+	patches[8].addr = 0;
+	patches[8].kind = SLJIT_MOV;
+	patches[8].status = -1;
+	patches[8].value = 0;
+
+	patches[9].addr = sljit_get_jump_addr(jump);
+	patches[9].kind = SLJIT_PATCH_JUMP_ADDR;
+	patches[9].status = -1;
+	patches[9].value = (sljit_sw)sljit_get_label_addr(add_label);
+
+	patches[10].addr = sljit_get_const_addr(consts[0]);
+	patches[10].kind = SLJIT_ADD;
+	patches[10].status = -1;
+	patches[10].value = 0;
+
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func0() != 36, "test94 case 1 failed\n");
+
+	FAILED(sljit_set_patches(patches, 11, executable_offset, NULL) != 2, "test94 case 2 failed\n");
+	FAILED(code.func0() != 1360, "test94 case 3 failed\n");
+
+	for (i = 0; i < 11; i++) {
+		if (i == 8 || i == 10) {
+			FAILED(patches[i].status != SLJIT_ERR_BAD_ARGUMENT, "test94 case 4 failed\n");
+		} else {
+			FAILED(patches[i].status != SLJIT_SUCCESS, "test94 case 5 failed\n");
+		}
+	}
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+static sljit_sw SLJIT_FUNC test95_add5(sljit_sw a)
+{
+	return a + 5;
+}
+#endif /* SLJIT_CONFIG_X86_64 */
+
+static void test95(void)
+{
+	/* Test position independent code. */
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	executable_code code;
+	struct sljit_compiler* compiler;
+	struct sljit_jump *rewritable_jump;
+	struct sljit_jump *jumps[5];
+	struct sljit_jump *mov_addr;
+	struct sljit_switch *switch_;
+	struct sljit_label *labels[2];
+	struct sljit_label *label;
+	static const sljit_sw values[4] = { 0, 1, 2, 3 };
+	sljit_u8 *old_code, *new_code;
+	sljit_uw code_size, old_addr, jump_offset, label_offset;
+	sljit_sw old_executable_offset, new_executable_offset;
+	sljit_u32 reloc_count;
+	sljit_s32 i;
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	if (verbose)
+		printf("Run test95\n");
+
+#if (defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64)
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, W), 3, 2, 0);
+
+	rewritable_jump = sljit_emit_jump(compiler, SLJIT_JUMP | SLJIT_REWRITABLE_JUMP);
+	labels[1] = sljit_emit_label(compiler);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_S1, 0, SLJIT_IMM, 1000);
+	jumps[0] = sljit_emit_jump(compiler, SLJIT_JUMP);
+	labels[0] = sljit_emit_label(compiler);
+	sljit_set_label(rewritable_jump, labels[0]);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_S1, 0, SLJIT_IMM, 2000);
+	sljit_set_label(jumps[0], sljit_emit_label(compiler));
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	switch_ = sljit_emit_switch(compiler, SLJIT_R0, 0, values, 4);
+
+	for (i = 0; i <= 4; i++) {
+		label = sljit_emit_label(compiler);
+		sljit_set_switch_label(switch_, (sljit_uw)i, label);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, (i < 4) ? 10 * (i + 1) : 0);
+		jumps[i] = sljit_emit_jump(compiler, SLJIT_JUMP);
+	}
+
+	label = sljit_emit_label(compiler);
+	for (i = 0; i <= 4; i++)
+		sljit_set_label(jumps[i], label);
+
+	mov_addr = sljit_emit_op_addr(compiler, SLJIT_MOV_ADDR, SLJIT_R1, 0);
+	sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_R1, 0);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_IMM, -1);
+
+	sljit_set_label(mov_addr, sljit_emit_label(compiler));
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_S1, 0, SLJIT_R2, 0);
+	sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS1(W, W), SLJIT_IMM, SLJIT_FUNC_ADDR(test95_add5));
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+
+	code.code = sljit_generate_code(compiler, SLJIT_GENERATE_CODE_PIC, NULL);
+	CHECK(compiler);
+
+	old_addr = (sljit_uw)code.code;
+	old_executable_offset = sljit_get_executable_offset(compiler);
+	old_code = (sljit_u8*)code.code - old_executable_offset;
+	code_size = sljit_get_generated_code_size(compiler);
+	jump_offset = sljit_get_jump_addr(rewritable_jump) - (sljit_uw)old_code;
+	label_offset = sljit_get_label_addr(labels[1]) - old_addr;
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func1(2) != 2035, "test95 case 1 failed\n");
+
+	/* One rewritable jump and four jump table entries. */
+	SLJIT_MEMCPY(&reloc_count, old_code + code_size - sizeof(sljit_u32), sizeof(sljit_u32));
+	FAILED(reloc_count != 5, "test95 case 2 failed\n");
+
+	new_code = (sljit_u8*)SLJIT_MALLOC_EXEC(code_size, NULL);
+
+	if (!new_code) {
+		printf("Cannot allocate executable memory\n");
+		sljit_free_code(code.code, NULL);
+		return;
+	}
+
+	new_executable_offset = SLJIT_EXEC_OFFSET(new_code);
+	SLJIT_MEMCPY(new_code, old_code, code_size);
+	sljit_relocate_code(new_code, code_size, old_addr, new_executable_offset);
+
+	/* The original code must not be used by the copy. */
+	sljit_free_code(code.code, NULL);
+	code.code = new_code + new_executable_offset;
+
+	FAILED(code.func1(0) != 2015, "test95 case 3 failed\n");
+	FAILED(code.func1(3) != 2045, "test95 case 4 failed\n");
+	FAILED(code.func1(7) != 2005, "test95 case 5 failed\n");
+
+	sljit_set_jump_addr((sljit_uw)new_code + jump_offset,
+		(sljit_uw)code.code + label_offset, new_executable_offset);
+
+	FAILED(code.func1(1) != 1025, "test95 case 6 failed\n");
+	FAILED(code.func1(-1) != 1005, "test95 case 7 failed\n");
+
+	sljit_free_code(code.code, NULL);
+#else /* !SLJIT_CONFIG_X86_64 */
+	if (verbose)
+		printf("position independent code is not supported, test95 skipped\n");
+#endif /* SLJIT_CONFIG_X86_64 */
+
+	successful_tests++;
+}
+
+static void test96(void)
+{
+	/* Test multi-function modules. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_jump *square_call;
+	struct sljit_jump *jump;
+	struct sljit_label *entries[3];
+	sljit_uw square_addr;
+	void *module_code;
+#if (defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+	struct sljit_function_context context;
+#endif /* SLJIT_INDIRECT_CALL */
+
+	if (verbose)
+		printf("Run test96\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	/* main(a) = square(a) + add1(a) * 1000 */
+	entries[0] = sljit_emit_function(compiler, 0, SLJIT_ARGS1(W, W), 2, 2, 0);
+	FAILED(!entries[0], "test96 case 1 failed\n");
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	/* Forward call. */
+	square_call = sljit_emit_call(compiler, SLJIT_CALL, SLJIT_ARGS1(W, W));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_S1, 0, SLJIT_RETURN_REG, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	jump = sljit_emit_call(compiler, SLJIT_CALL, SLJIT_ARGS1(W, W));
+	sljit_emit_op2(compiler, SLJIT_MUL, SLJIT_R0, 0, SLJIT_RETURN_REG, 0, SLJIT_IMM, 1000);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_S1, 0);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+
+	/* add1(a) = a + 1 */
+	entries[1] = sljit_emit_function(compiler, 0, SLJIT_ARGS1(W, W), 1, 1, 0);
+	sljit_set_label(jump, entries[1]);
+	sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R0, 0, SLJIT_S0, 0, SLJIT_IMM, 1);
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_R0, 0);
+
+	/* square(a) = add1(a * a) */
+	entries[2] = sljit_emit_function(compiler, 0, SLJIT_ARGS1(W, W), 1, 1, 2 * sizeof(sljit_sw));
+	sljit_set_label(square_call, entries[2]);
+	sljit_emit_op2(compiler, SLJIT_MUL, SLJIT_R0, 0, SLJIT_S0, 0, SLJIT_S0, 0);
+	/* Backward tail call. */
+	jump = sljit_emit_call(compiler, SLJIT_CALL | SLJIT_CALL_RETURN, SLJIT_ARGS1(W, W));
+	sljit_set_label(jump, entries[1]);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	FAILED((sljit_get_label_abs_addr(entries[1]) & 0xf) != 0, "test96 case 2 failed\n");
+	FAILED((sljit_get_label_abs_addr(entries[2]) & 0xf) != 0, "test96 case 3 failed\n");
+	square_addr = sljit_get_label_addr(entries[2]);
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func1(5) != 6026, "test96 case 4 failed\n");
+	FAILED(code.func1(-3) != -1990, "test96 case 5 failed\n");
+
+	module_code = code.code;
+	code.code = (void*)square_addr;
+#if (defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+	sljit_set_function_context(&code.code, &context, square_addr, (void*)SLJIT_FUNC_ADDR(sljit_set_function_context));
+#endif /* SLJIT_INDIRECT_CALL */
+	FAILED(code.func1(3) != 10, "test96 case 6 failed\n");
+
+	sljit_free_code(module_code, NULL);
+	successful_tests++;
+}
+
+static sljit_sw test97_f1(sljit_sw a, sljit_sw b)
+{
+	return a * 10 + b;
+}
+
+static sljit_sw test97_f2(sljit_sw a, sljit_sw b)
+{
+	return a * 100 + b;
+}
+
+static void test97(void)
+{
+	/* Test call stubs. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_call_stub *stub;
+	struct sljit_jump *jump;
+	struct sljit_label *label;
+	sljit_uw stub_addr;
+	sljit_sw executable_offset;
+
+	if (verbose)
+		printf("Run test97\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	stub = sljit_get_call_stub(compiler, SLJIT_FUNC_UADDR(test97_f1));
+	FAILED(!stub, "test97 case 1 failed\n");
+	FAILED(sljit_get_call_stub(compiler, SLJIT_FUNC_UADDR(test97_f1)) != stub, "test97 case 2 failed\n");
+	FAILED(sljit_get_call_stub(compiler, SLJIT_FUNC_UADDR(test97_f2)) == stub, "test97 case 3 failed\n");
+
+	/* f(a) = g(f1(f1(a, 1), 2)) */
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, W), 2, 1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 1);
+	sljit_emit_stub_call(compiler, SLJIT_CALL, SLJIT_ARGS2(W, W, W), stub);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 2);
+	sljit_emit_stub_call(compiler, SLJIT_CALL, SLJIT_ARGS2(W, W, W), stub);
+	jump = sljit_emit_call(compiler, SLJIT_CALL | SLJIT_CALL_RETURN, SLJIT_ARGS1(W, W));
+	sljit_emit_call_stubs(compiler);
+
+	/* g(a) = f1(a, 3) using the emitted stub */
+	label = sljit_emit_label(compiler);
+	sljit_set_label(jump, label);
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, W), 2, 1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_S0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 3);
+	sljit_emit_stub_call(compiler, SLJIT_CALL | SLJIT_CALL_RETURN, SLJIT_ARGS2(W, W, W), stub);
+	/* Nothing to emit. */
+	sljit_emit_call_stubs(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	executable_offset = sljit_get_executable_offset(compiler);
+	stub_addr = sljit_get_call_stub_addr(stub);
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func1(4) != 4123, "test97 case 4 failed\n");
+
+	sljit_set_jump_addr(stub_addr, SLJIT_FUNC_UADDR(test97_f2), executable_offset);
+	FAILED(code.func1(4) != 4010203, "test97 case 5 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test98(void)
+{
+	/* Test population count. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_sw buf[9];
+	sljit_s32 ibuf[3];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test98\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 9; i++)
+		buf[i] = -1;
+	buf[1] = 0x0f0f;
+
+	ibuf[0] = (sljit_s32)0x80000001;
+	ibuf[1] = -1;
+	ibuf[2] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS2V(P, P), 4, 2, 0);
+
+	sljit_emit_op1(compiler, SLJIT_POPCNT, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x1234567);
+	sljit_emit_op1(compiler, SLJIT_POPCNT, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_POPCNT32, SLJIT_R2, 0, SLJIT_IMM, -1);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_POPCNT32, SLJIT_R3, 0, SLJIT_MEM1(SLJIT_S1), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_R3, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, -1);
+	sljit_emit_op1(compiler, SLJIT_POPCNT32, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_s32), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_POPCNT, SLJIT_R1, 0, SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_POPCNT, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_sw), SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 2);
+	sljit_emit_op1(compiler, SLJIT_POPCNT32, SLJIT_MEM2(SLJIT_S1, SLJIT_R0), 2, SLJIT_MEM1(SLJIT_S1), 0);
+	sljit_emit_op1(compiler, SLJIT_POPCNT, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_IMM, 0x70f);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func2((sljit_sw)&buf, (sljit_sw)&ibuf);
+
+	FAILED(buf[2] != 8 * sizeof(sljit_sw), "test98 case 1 failed\n");
+	FAILED(buf[3] != 12, "test98 case 2 failed\n");
+	FAILED(buf[4] != 32, "test98 case 3 failed\n");
+	FAILED(buf[5] != 2, "test98 case 4 failed\n");
+	FAILED(ibuf[1] != 32, "test98 case 5 failed\n");
+	FAILED(buf[6] != 8, "test98 case 6 failed\n");
+	FAILED(buf[7] != 8, "test98 case 7 failed\n");
+	FAILED(ibuf[2] != 2, "test98 case 8 failed\n");
+	FAILED(buf[8] != 7, "test98 case 9 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test99(void)
+{
+	/* Test bit field operations. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_s32 has_pdep_pext = sljit_has_cpu_feature(SLJIT_HAS_PDEP_PEXT) == 1;
+	sljit_sw buf[14];
+	sljit_s32 ibuf[3];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test99\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 14; i++)
+		buf[i] = -1;
+	buf[12] = 0x0f0f;
+
+	for (i = 0; i < 3; i++)
+		ibuf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS2V(P, P), 5, 2, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x12345678);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_U, SLJIT_R1, SLJIT_R0, 8, 12);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R1, 0);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_U, SLJIT_R3, SLJIT_R0, 4, 4);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R3, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 0xf80);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_S, SLJIT_R2, SLJIT_R2, 4, 5);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x1234f00d);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_S32, SLJIT_R1, SLJIT_R1, 0, 16);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_S1), 0, SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R0, 0, SLJIT_IMM, (sljit_s32)0xf2345678);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_U32, SLJIT_R2, SLJIT_R0, 28, 4);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_s32), SLJIT_R2, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, -1);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 0);
+	sljit_emit_bitfield(compiler, SLJIT_INSERT, SLJIT_R1, SLJIT_R2, 4, 8);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R1, 0, SLJIT_IMM, 0x12345678);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R2, 0, SLJIT_IMM, 0xab);
+	sljit_emit_bitfield(compiler, SLJIT_INSERT32, SLJIT_R1, SLJIT_R2, 24, 8);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_S1), 2 * sizeof(sljit_s32), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x1000);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 0x13);
+	sljit_emit_bitfield(compiler, SLJIT_INSERT, SLJIT_R1, SLJIT_R2, 0, 4);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R4, 0, SLJIT_IMM, 0x5555);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x2);
+	sljit_emit_bitfield(compiler, SLJIT_INSERT, SLJIT_R4, SLJIT_R0, 8, 3);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_R4, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, -256);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_S, SLJIT_R1, SLJIT_R0, 8, 8 * sizeof(sljit_sw) - 8);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x1ff);
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_U, SLJIT_R0, SLJIT_R0, 0, 8);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_sw), SLJIT_R0, 0);
+
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, SLJIT_W(0x123456789abcdef0));
+	sljit_emit_bitfield(compiler, SLJIT_EXTRACT_U, SLJIT_R1, SLJIT_R0, 36, 20);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 0xabc);
+	sljit_emit_bitfield(compiler, SLJIT_INSERT, SLJIT_R0, SLJIT_R2, 40, 12);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 9 * sizeof(sljit_sw), SLJIT_R0, 0);
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+
+	if (has_pdep_pext) {
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x5);
+		sljit_emit_op2r(compiler, SLJIT_PDEP, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, 0xf0);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 10 * sizeof(sljit_sw), SLJIT_R1, 0);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x12345678);
+		sljit_emit_op2r(compiler, SLJIT_PEXT32, SLJIT_R3, SLJIT_R0, 0, SLJIT_IMM, 0xff00);
+		sljit_emit_op1(compiler, SLJIT_MOV_U32, SLJIT_R3, 0, SLJIT_R3, 0);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 11 * sizeof(sljit_sw), SLJIT_R3, 0);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0xab);
+		sljit_emit_op2r(compiler, SLJIT_PDEP, SLJIT_R0, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_S0), 12 * sizeof(sljit_sw));
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 13 * sizeof(sljit_sw), SLJIT_R0, 0);
+	}
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func2((sljit_sw)&buf, (sljit_sw)&ibuf);
+
+	FAILED(buf[0] != 0x456, "test99 case 1 failed\n");
+	FAILED(buf[1] != 0x7, "test99 case 2 failed\n");
+	FAILED(buf[2] != -8, "test99 case 3 failed\n");
+	FAILED(ibuf[0] != -4083, "test99 case 4 failed\n");
+	FAILED(ibuf[1] != 0xf, "test99 case 5 failed\n");
+	FAILED(buf[3] != ~(sljit_sw)0xff0, "test99 case 6 failed\n");
+	FAILED(ibuf[2] != (sljit_s32)0xab345678, "test99 case 7 failed\n");
+	FAILED(buf[4] != 0x1003, "test99 case 8 failed\n");
+	FAILED(buf[5] != 0x5255, "test99 case 9 failed\n");
+	FAILED(buf[6] != -1, "test99 case 10 failed\n");
+	FAILED(buf[7] != 0xff, "test99 case 11 failed\n");
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	FAILED(buf[8] != 0x34567, "test99 case 12 failed\n");
+	FAILED(buf[9] != SLJIT_W(0x123abc789abcdef0), "test99 case 13 failed\n");
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+
+	if (has_pdep_pext) {
+		FAILED(buf[10] != 0x50, "test99 case 14 failed\n");
+		FAILED(buf[11] != 0x56, "test99 case 15 failed\n");
+		FAILED(buf[13] != 0x0a0b, "test99 case 16 failed\n");
+	}
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test100(void)
+{
+	/* Test crc32c operations. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_sw buf[11];
+	sljit_u8 bbuf[10] = { '1', '2', '3', '4', '5', '6', '7', '8', '9', 0 };
+	sljit_u16 hbuf[2];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test100\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 11; i++)
+		buf[i] = -1;
+
+	hbuf[0] = 0x9a8b;
+	hbuf[1] = 0x1234;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS3V(P, P, P), 5, 3, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x12345678);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R1, SLJIT_R0, 0, SLJIT_IMM, 0xab);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R1, 0);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U16, SLJIT_R2, SLJIT_IMM, -1, SLJIT_MEM1(SLJIT_S2), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x87654321);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, (sljit_sw)0xdeadbeef);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U32, SLJIT_R0, SLJIT_R0, 0, SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 1);
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, SLJIT_W(0x0123456789abcdef));
+#else /* !SLJIT_64BIT_ARCHITECTURE */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, (sljit_sw)0x89abcdef);
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+	sljit_emit_op2r(compiler, SLJIT_CRC32C, SLJIT_R1, SLJIT_R0, 0, SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R0, SLJIT_IMM, (sljit_sw)0xa5a5a5a5, SLJIT_IMM, 0x5a);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R4, 0, SLJIT_IMM, -1);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R3, SLJIT_R4, 0, SLJIT_IMM, 0x3c7);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_sw), SLJIT_R3, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, (sljit_sw)0xffffffff);
+	for (i = 0; i < 9; i++)
+		sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R0, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_S1), i);
+	sljit_emit_op2(compiler, SLJIT_XOR, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, (sljit_sw)0xffffffff);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw), SLJIT_R0, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 1);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U16, SLJIT_R4, SLJIT_IMM, 0x11223344, SLJIT_MEM2(SLJIT_S2, SLJIT_R1), 1);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_sw), SLJIT_R4, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_S2, 0, SLJIT_IMM, 0x7788);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R2, SLJIT_IMM, (sljit_sw)0xfedcba98, SLJIT_S2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_R2, 0);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_R3, SLJIT_IMM, (sljit_sw)0xfedcba98, SLJIT_S2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 9 * sizeof(sljit_sw), SLJIT_R3, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, (sljit_sw)0xfedcba98);
+	sljit_emit_op2r(compiler, SLJIT_CRC32C_U8, SLJIT_S2, SLJIT_R0, 0, SLJIT_S2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 10 * sizeof(sljit_sw), SLJIT_S2, 0);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func3((sljit_sw)&buf, (sljit_sw)&bbuf, (sljit_sw)&hbuf);
+
+	FAILED(buf[0] != (sljit_sw)0xc0912609, "test100 case 1 failed\n");
+	FAILED(buf[1] != (sljit_sw)0xa5e4cdda, "test100 case 2 failed\n");
+	FAILED(buf[2] != (sljit_sw)0xa53a60b3, "test100 case 3 failed\n");
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+	FAILED(buf[3] != (sljit_sw)0xa0a4178e, "test100 case 4 failed\n");
+#else /* !SLJIT_64BIT_ARCHITECTURE */
+	FAILED(buf[3] != (sljit_sw)0x84519e92, "test100 case 4 failed\n");
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+	FAILED(buf[4] != (sljit_sw)0xadd8f6f4, "test100 case 5 failed\n");
+	FAILED(buf[5] != (sljit_sw)0xbac5ee81, "test100 case 6 failed\n");
+	FAILED(buf[6] != (sljit_sw)0xe3069283, "test100 case 7 failed\n");
+	FAILED(buf[7] != (sljit_sw)0x6d8fc878, "test100 case 8 failed\n");
+	FAILED(buf[8] != (sljit_sw)0x10a01bd5, "test100 case 9 failed\n");
+	FAILED(buf[9] != (sljit_sw)0x10a01bd5, "test100 case 10 failed\n");
+	FAILED(buf[10] != (sljit_sw)0x10a01bd5, "test100 case 11 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test101(void)
+{
+	/* Test non-temporal memory accesses. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_sw buf[10];
+	sljit_s32 i;
+
+	if (verbose)
+		printf("Run test101\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 10; i++)
+		buf[i] = 0;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1(W, P), 4, 1, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, -4678);
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL, SLJIT_R0, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R1, 0, SLJIT_IMM, 0x12345678);
+	sljit_emit_mem(compiler, SLJIT_MOV32 | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL, SLJIT_R1, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw));
+	sljit_emit_mem(compiler, SLJIT_MOV_U8 | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL, SLJIT_R1, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 3);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R3, 0, SLJIT_IMM, 8326);
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL | SLJIT_MEM_ALIGNED_32, SLJIT_R3, SLJIT_MEM2(SLJIT_S0, SLJIT_R2), SLJIT_WORD_SHIFT);
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL, SLJIT_REG_PAIR(SLJIT_R0, SLJIT_R3), SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_sw));
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_IMM, 6);
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_STORE | SLJIT_MEM_NON_TEMPORAL, SLJIT_REG_PAIR(SLJIT_R3, SLJIT_R0), SLJIT_MEM2(SLJIT_S0, SLJIT_R2), SLJIT_WORD_SHIFT);
+
+	if (sljit_has_cpu_feature(SLJIT_HAS_MEMORY_BARRIER))
+		sljit_emit_op0(compiler, SLJIT_MEMORY_BARRIER);
+
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_NON_TEMPORAL, SLJIT_R1, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_mem(compiler, SLJIT_MOV | SLJIT_MEM_NON_TEMPORAL, SLJIT_REG_PAIR(SLJIT_R0, SLJIT_R1), SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_sw));
+	sljit_emit_op2(compiler, SLJIT_SUB, SLJIT_RETURN_REG, 0, SLJIT_R0, 0, SLJIT_R1, 0);
+
+	sljit_emit_return(compiler, SLJIT_MOV, SLJIT_RETURN_REG, 0);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	FAILED(code.func1((sljit_sw)&buf) != 8326 + 4678, "test101 case 1 failed\n");
+	FAILED(buf[0] != -4678, "test101 case 2 failed\n");
+	FAILED(*(sljit_s32*)(buf + 1) != 0x12345678, "test101 case 3 failed\n");
+	FAILED(*(sljit_u8*)(buf + 2) != 0x78, "test101 case 4 failed\n");
+	FAILED(buf[3] != 8326, "test101 case 5 failed\n");
+	FAILED(buf[4] != -4678, "test101 case 6 failed\n");
+	FAILED(buf[5] != 8326, "test101 case 7 failed\n");
+	FAILED(buf[6] != 8326, "test101 case 8 failed\n");
+	FAILED(buf[7] != -4678, "test101 case 9 failed\n");
+	FAILED(buf[8] != -4678, "test101 case 10 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test102(void)
+{
+	/* Check prefetch for write instructions. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	struct sljit_label* labels[5];
+	sljit_up addr[5];
+	sljit_sw buf[4];
+	int i;
+
+	if (verbose)
+		printf("Run test102\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 4; i++)
+		buf[i] = -1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 3, 1, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 2);
+	labels[0] = sljit_emit_label(compiler);
+	/* Should never crash. */
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L1, SLJIT_MEM2(SLJIT_R0, SLJIT_R0), 2);
+	labels[1] = sljit_emit_label(compiler);
+#if IS_64BIT
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L2, SLJIT_MEM1(SLJIT_R0), SLJIT_W(0x1122334455667788));
+#else /* !IS_64BIT */
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L2, SLJIT_MEM1(SLJIT_R0), 0x11223344);
+#endif /* IS_64BIT */
+	labels[2] = sljit_emit_label(compiler);
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L3, SLJIT_MEM0(), 0);
+	labels[3] = sljit_emit_label(compiler);
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L1, SLJIT_MEM2(SLJIT_S0, SLJIT_R1), SLJIT_WORD_SHIFT);
+	labels[4] = sljit_emit_label(compiler);
+	sljit_emit_op_src(compiler, SLJIT_PREFETCH_WRITE_L2, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw));
+
+	/* Prefetches must not modify registers. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R1, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM2(SLJIT_S0, SLJIT_R1), SLJIT_WORD_SHIFT, SLJIT_IMM, 6031);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+
+	for (i = 0; i < 5; i++)
+		addr[i] = sljit_get_label_addr(labels[i]);
+
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	if (sljit_has_cpu_feature(SLJIT_HAS_PREFETCH_WRITE) || sljit_has_cpu_feature(SLJIT_HAS_PREFETCH)) {
+		FAILED(addr[0] == addr[1], "test102 case 1 failed\n");
+		FAILED(addr[1] == addr[2], "test102 case 2 failed\n");
+		FAILED(addr[2] == addr[3], "test102 case 3 failed\n");
+		FAILED(addr[3] == addr[4], "test102 case 4 failed\n");
+	} else {
+		FAILED(addr[0] != addr[1], "test102 case 1 failed\n");
+		FAILED(addr[1] != addr[2], "test102 case 2 failed\n");
+		FAILED(addr[2] != addr[3], "test102 case 3 failed\n");
+		FAILED(addr[3] != addr[4], "test102 case 4 failed\n");
+	}
+
+	FAILED(buf[0] != 0, "test102 case 5 failed\n");
+	FAILED(buf[1] != 2, "test102 case 6 failed\n");
+	FAILED(buf[2] != 6031, "test102 case 7 failed\n");
+	FAILED(buf[3] != -1, "test102 case 8 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test103(void)
+{
+	/* Check block copy and fill operations. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_sw dst_words[2560 / sizeof(sljit_sw)];
+	sljit_sw src_words[2560 / sizeof(sljit_sw)];
+	sljit_u8 expected[2560];
+	sljit_u8 *dst = (sljit_u8*)dst_words;
+	sljit_u8 *src = (sljit_u8*)src_words;
+	sljit_sw result[1];
+	sljit_s32 regs[3];
+	int i, j;
+
+	/* Type, destination offset, source offset or fill value, length, length is a register. */
+	static const sljit_sw cases[][5] = {
+		{ SLJIT_MEM_BLOCK_COPY, 1, 0, 0, 0 },
+		{ SLJIT_MEM_BLOCK_COPY, 3, 1, 7, 0 },
+		{ SLJIT_MEM_BLOCK_COPY, 16, 5, 31, 0 },
+		{ SLJIT_MEM_BLOCK_COPY, 64, 0, 100, 0 },
+		{ SLJIT_MEM_BLOCK_COPY, 200, 7, 300, 0 },
+		{ SLJIT_MEM_BLOCK_COPY, 520, 3, 1037, 1 },
+		{ SLJIT_MEM_BLOCK_COPY, 1570, 2, 5, 1 },
+		{ SLJIT_MEM_BLOCK_FILL, 1580, 0x1a5, 13, 0 },
+		{ SLJIT_MEM_BLOCK_FILL, 1600, 0x3c77, 333, 1 },
+		{ SLJIT_MEM_BLOCK_FILL | SLJIT_MEM_BLOCK_ALIGNED_32, 1944, 0x5e, 200, 0 },
+		{ SLJIT_MEM_BLOCK_COPY | SLJIT_MEM_BLOCK_ALIGNED_32, 2152, 8, 100, 1 },
+		{ SLJIT_MEM_BLOCK_COPY, 2260, 0, 0, 1 },
+		{ SLJIT_MEM_BLOCK_FILL, 2264, 0xc3, 45, 0 },
+		{ SLJIT_MEM_BLOCK_FILL, 2320, 0, 31, 1 },
+		{ SLJIT_MEM_BLOCK_COPY, 2360, 11, 129, 0 },
+	};
+
+	if (verbose)
+		printf("Run test103\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 2560; i++) {
+		dst[i] = 0xcd;
+		src[i] = (sljit_u8)(i * 7 + 3);
+		expected[i] = 0xcd;
+	}
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS3V(P, P, P), 6, 3, 0);
+
+	for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+		/* Rotate the registers used by the operations. */
+		if (i % 3 == 0) {
+			regs[0] = SLJIT_R0;
+			regs[1] = SLJIT_R1;
+			regs[2] = SLJIT_R2;
+		} else if (i % 3 == 1) {
+			regs[0] = SLJIT_R4;
+			regs[1] = SLJIT_R3;
+			regs[2] = SLJIT_R5;
+		} else {
+			regs[0] = SLJIT_R2;
+			regs[1] = SLJIT_R0;
+			regs[2] = SLJIT_R1;
+		}
+
+		sljit_emit_op2(compiler, SLJIT_ADD, regs[0], 0, SLJIT_S0, 0, SLJIT_IMM, cases[i][1]);
+
+		if (cases[i][0] & SLJIT_MEM_BLOCK_FILL) {
+			memset(expected + cases[i][1], (int)(cases[i][2] & 0xff), (size_t)cases[i][3]);
+
+			if (i & 0x1)
+				sljit_emit_op1(compiler, SLJIT_MOV, regs[1], 0, SLJIT_IMM, cases[i][2]);
+		} else {
+			memcpy(expected + cases[i][1], src + cases[i][2], (size_t)cases[i][3]);
+			sljit_emit_op2(compiler, SLJIT_ADD, regs[1], 0, SLJIT_S1, 0, SLJIT_IMM, cases[i][2]);
+		}
+
+		if (cases[i][4])
+			sljit_emit_op1(compiler, SLJIT_MOV, regs[2], 0, SLJIT_IMM, cases[i][3]);
+
+		sljit_emit_mem_block(compiler, (sljit_s32)cases[i][0], regs[0],
+			((cases[i][0] & SLJIT_MEM_BLOCK_FILL) && !(i & 0x1)) ? SLJIT_IMM : regs[1], cases[i][2],
+			cases[i][4] ? regs[2] : SLJIT_IMM, cases[i][3]);
+	}
+
+	/* Other registers must be preserved. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S2), 0, SLJIT_IMM, 0x12345);
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	result[0] = 0;
+	code.func3((sljit_sw)dst, (sljit_sw)src, (sljit_sw)result);
+
+	for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+		for (j = -1; j <= cases[i][3]; j++) {
+			if (dst[cases[i][1] + j] != expected[cases[i][1] + j]) {
+				printf("test103 case %d failed\n", i + 1);
+				sljit_free_code(code.code, NULL);
+				return;
+			}
+		}
+	}
+
+	FAILED(memcmp(dst, expected, sizeof(expected)) != 0, "test103 case 16 failed\n");
+	FAILED(result[0] != 0x12345, "test103 case 17 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test104(void)
+{
+	/* Check cycle counter read. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_uw buf[6];
+	sljit_s32 has_counter = sljit_has_cpu_feature(SLJIT_HAS_CYCLE_COUNTER);
+	int i;
+
+	if (verbose)
+		printf("Run test104\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 6; i++)
+		buf[i] = 1;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 3, 1, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 0x1234);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x5678);
+	sljit_emit_op_dst(compiler, SLJIT_GET_CYCLE_COUNTER, SLJIT_R2, 0);
+	sljit_emit_op_dst(compiler, SLJIT_GET_CYCLE_COUNTER, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_uw));
+	/* Other registers must be preserved. */
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_uw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_uw), SLJIT_R1, 0);
+	sljit_emit_op_dst(compiler, SLJIT_GET_CYCLE_COUNTER, SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_R2, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_uw), SLJIT_R0, 0);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	if (!has_counter) {
+		FAILED(buf[0] != 0, "test104 case 1 failed\n");
+		FAILED(buf[1] != 0, "test104 case 2 failed\n");
+		FAILED(buf[2] != 0, "test104 case 3 failed\n");
+	} else {
+		FAILED(buf[0] == 0 && buf[1] == 0 && buf[2] == 0, "test104 case 1 failed\n");
+#if IS_64BIT
+		/* The 64 bit counters are unlikely to wrap around. */
+		FAILED(buf[0] > buf[1], "test104 case 2 failed\n");
+		FAILED(buf[1] > buf[2], "test104 case 3 failed\n");
+#endif /* IS_64BIT */
+	}
+
+	FAILED(buf[3] != 0x1234, "test104 case 4 failed\n");
+	FAILED(buf[4] != 0x5678, "test104 case 5 failed\n");
+	FAILED(buf[5] != 1, "test104 case 6 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__APPLE__)
+#define TEST105_THREAD_LOCAL 1
+static __thread sljit_sw test105_thread_local;
+#endif /* __GNUC__ && !_WIN32 && !__APPLE__ */
+
+static void test105(void)
+{
+	/* Check thread pointer read. */
+	executable_code code;
+	struct sljit_compiler* compiler;
+	sljit_sw buf[5];
+	sljit_sw offset = 0;
+	int i;
+
+	if (verbose)
+		printf("Run test105\n");
+
+	if (!sljit_has_cpu_feature(SLJIT_HAS_THREAD_POINTER)) {
+		if (verbose)
+			printf("thread pointer is not supported, test105 skipped\n");
+		successful_tests++;
+		return;
+	}
+
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 5; i++)
+		buf[i] = -1;
+
+#if (defined TEST105_THREAD_LOCAL && TEST105_THREAD_LOCAL)
+	test105_thread_local = 0x3456;
+	offset = sljit_get_thread_local_offset(&test105_thread_local);
+#endif /* TEST105_THREAD_LOCAL */
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS1V(P), 3, 1, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, 0x1234);
+	sljit_emit_op_dst(compiler, SLJIT_GET_THREAD_POINTER, SLJIT_R0, 0);
+	sljit_emit_op_dst(compiler, SLJIT_GET_THREAD_POINTER, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_sw), SLJIT_R0, 0);
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_sw), SLJIT_R1, 0);
+
+	if (offset != 0) {
+		/* Increase the thread local variable. */
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R0), offset);
+		sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 1);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_R0), offset, SLJIT_R2, 0);
+		sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_sw), SLJIT_R2, 0);
+	}
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)&buf);
+
+	FAILED(buf[0] == 0 || buf[0] == -1, "test105 case 1 failed\n");
+	FAILED(buf[1] != buf[0], "test105 case 2 failed\n");
+	FAILED(buf[2] != 0x1234, "test105 case 3 failed\n");
+	FAILED(buf[4] != -1, "test105 case 4 failed\n");
+
+#if (defined TEST105_THREAD_LOCAL && TEST105_THREAD_LOCAL)
+	if (offset != 0) {
+		FAILED(buf[3] != 0x3457, "test105 case 5 failed\n");
+		FAILED(test105_thread_local != 0x3457, "test105 case 6 failed\n");
+	}
+#endif /* TEST105_THREAD_LOCAL */
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
 #include "sljitTestCall.h"
 #include "sljitTestFloat.h"
 #include "sljitTestSimd.h"
@@ -10601,6 +12645,29 @@ int sljit_test(int argc, char* argv[])
 	test80();
 	test81();
 	test82();
+	test83();
+	test84();
+	test85();
+	test86();
+	test87();
+	test88();
+	test89();
+	test90();
+	test91();
+	test92();
+	test93();
+	test94();
+	test95();
+	test96();
+	test97();
+	test98();
+	test99();
+	test100();
+	test101();
+	test102();
+	test103();
+	test104();
+	test105();
 
 	if (verbose)
 		printf("---- Call tests ----\n");
@@ -10645,10 +12712,12 @@ int sljit_test(int argc, char* argv[])
 		test_float21();
 		test_float22();
 		test_float23();
+		test_float24();
+		test_float25();
 	} else {
 		if (verbose)
 			printf("no fpu available, fpu tests are skipped\n");
-		successful_tests += 23;
+		successful_tests += 25;
 	}
 
 	if (sljit_has_cpu_feature(SLJIT_HAS_SIMD)) {
@@ -10665,10 +12734,11 @@ int sljit_test(int argc, char* argv[])
 		test_simd9();
 		test_simd10();
 		test_simd11();
+		test_simd12();
 	} else {
 		if (verbose)
 			printf("no simd available, simd tests are skipped\n");
-		successful_tests += 11;
+		successful_tests += 12;
 	}
 
 	if (verbose)
@@ -10689,7 +12759,7 @@ int sljit_test(int argc, char* argv[])
 	sljit_free_unused_memory_exec();
 #endif /* SLJIT_EXECUTABLE_ALLOCATOR */
 
-#	define TEST_COUNT 138
+#	define TEST_COUNT 164
 
 	printf("SLJIT tests: ");
 	if (successful_tests == TEST_COUNT)
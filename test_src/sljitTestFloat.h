@@ -3057,3 +3057,279 @@ static void test_float23(void)
 	sljit_free_code(code.code, NULL);
 	successful_tests++;
 }
+
+static void test_float24(void)
+{
+	/* Test fused multiply-add. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_s32 i;
+	sljit_s32 has_fma = sljit_has_cpu_feature(SLJIT_HAS_FMA);
+	sljit_f64 dbuf[15];
+	sljit_f32 sbuf[7];
+
+	if (verbose)
+		printf("Run test_float24\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 15; i++)
+		dbuf[i] = 123.0;
+
+	for (i = 0; i < 7; i++)
+		sbuf[i] = 123.0f;
+
+	dbuf[0] = 3.5;
+	dbuf[1] = -2.25;
+	dbuf[2] = 10.0;
+	/* The exact product of dbuf[4] * dbuf[4] is 1 + 2^-26 + 2^-54. */
+	dbuf[3] = 1.0 + 1.0 / 67108864.0;
+	dbuf[4] = 1.0 + 1.0 / 134217728.0;
+
+	sbuf[0] = 1.5f;
+	sbuf[1] = -4.0f;
+	sbuf[2] = 0.25f;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS2V(P, P), 1 | SLJIT_ENTER_FLOAT(6), 2, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR1, 0, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_f64));
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_f64));
+	sljit_emit_fop2r(compiler, SLJIT_MULADD_F64, SLJIT_FR2, SLJIT_FR0, 0, SLJIT_FR1, 0);
+	/* dbuf[5] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_f64), SLJIT_FR2, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR3, 0, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_f64));
+	sljit_emit_fop2r(compiler, SLJIT_MULSUB_F64, SLJIT_FR3, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_f64));
+	/* dbuf[6] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_f64), SLJIT_FR3, 0);
+
+	sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 2 * sizeof(sljit_f64));
+	sljit_emit_fop2r(compiler, SLJIT_MULADD_F64, SLJIT_FR1, SLJIT_MEM1(SLJIT_S0), 0, SLJIT_MEM2(SLJIT_S0, SLJIT_R0), 0);
+	/* dbuf[7] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_f64), SLJIT_FR1, 0);
+
+	sljit_emit_fop2r(compiler, SLJIT_MULADD_F64, SLJIT_FR0, SLJIT_FR0, 0, SLJIT_FR0, 0);
+	/* dbuf[8] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_f64), SLJIT_FR0, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR4, 0, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_f64));
+	sljit_emit_fop2r(compiler, SLJIT_MULSUB_F64, SLJIT_FR4, SLJIT_MEM0(), (sljit_sw)(dbuf + 2), SLJIT_FR4, 0);
+	/* dbuf[9] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 9 * sizeof(sljit_f64), SLJIT_FR4, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR5, 0, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_f64));
+	sljit_emit_fop2r(compiler, SLJIT_MULSUB_F64, SLJIT_FR5, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_f64), SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_f64));
+	/* dbuf[10] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 10 * sizeof(sljit_f64), SLJIT_FR5, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR5, 0, SLJIT_MEM1(SLJIT_S1), 2 * sizeof(sljit_f32));
+	sljit_emit_fop2r(compiler, SLJIT_MULADD_F32, SLJIT_FR5, SLJIT_MEM1(SLJIT_S1), 0, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_f32));
+	/* sbuf[3] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S1), 3 * sizeof(sljit_f32), SLJIT_FR5, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S1), 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR3, 0, SLJIT_MEM1(SLJIT_S1), sizeof(sljit_f32));
+	sljit_emit_fop2r(compiler, SLJIT_MULSUB_F32, SLJIT_FR2, SLJIT_FR3, 0, SLJIT_FR2, 0);
+	/* sbuf[4] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S1), 4 * sizeof(sljit_f32), SLJIT_FR2, 0);
+
+	sljit_emit_fop2r(compiler, SLJIT_MULADD_F32, SLJIT_FR3, SLJIT_FR3, 0, SLJIT_MEM0(), (sljit_sw)(sbuf + 2));
+	/* sbuf[5] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S1), 5 * sizeof(sljit_f32), SLJIT_FR3, 0);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func2((sljit_sw)&dbuf, (sljit_sw)&sbuf);
+	FAILED(dbuf[5] != 2.125, "test_float24 case 1 failed\n");
+	FAILED(dbuf[6] != -17.875, "test_float24 case 2 failed\n");
+	FAILED(dbuf[7] != 32.75, "test_float24 case 3 failed\n");
+	FAILED(dbuf[8] != 15.75, "test_float24 case 4 failed\n");
+	FAILED(dbuf[9] != -20.25, "test_float24 case 5 failed\n");
+	if (has_fma == 1) {
+		FAILED(dbuf[10] != 1.0 / 18014398509481984.0, "test_float24 case 6 failed\n");
+	} else {
+		FAILED(dbuf[10] != 0.0, "test_float24 case 6 failed\n");
+	}
+	FAILED(sbuf[3] != -5.75f, "test_float24 case 7 failed\n");
+	FAILED(sbuf[4] != -7.5f, "test_float24 case 8 failed\n");
+	FAILED(sbuf[5] != -5.0f, "test_float24 case 9 failed\n");
+	FAILED(sbuf[6] != 123.0f, "test_float24 case 10 failed\n");
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
+
+static void test_float25(void)
+{
+	/* Test square root, minimum, maximum and rounding. */
+	executable_code code;
+	struct sljit_compiler* compiler = sljit_create_compiler(NULL);
+	sljit_s32 i, j;
+	sljit_s32 has_fround = sljit_has_cpu_feature(SLJIT_HAS_FROUND);
+	sljit_f64 dbuf[14];
+	sljit_f32 sbuf[10];
+	sljit_f64 dround[8 + 4 * 8];
+	sljit_f32 sround[4 + 4 * 4];
+	static const sljit_s32 round_ops[4] = { SLJIT_FLOOR_F64, SLJIT_CEIL_F64, SLJIT_TRUNC_F64, SLJIT_ROUND_F64 };
+	static const sljit_f64 dround_expected[4 * 8] = {
+		2.0, -3.0, 0.0, -1.0, 3.0, -7.0, 4503599627370497.0, -0.0,
+		3.0, -2.0, 1.0, -0.0, 4.0, -7.0, 4503599627370497.0, -0.0,
+		2.0, -2.0, 0.0, -0.0, 3.0, -7.0, 4503599627370497.0, -0.0,
+		3.0, -3.0, 0.0, -0.0, 4.0, -7.0, 4503599627370497.0, -0.0,
+	};
+	static const sljit_f32 sround_expected[4 * 4] = {
+		2.0f, -2.0f, 0.0f, -1.0f,
+		3.0f, -1.0f, 1.0f, -0.0f,
+		2.0f, -1.0f, 0.0f, -0.0f,
+		3.0f, -2.0f, 0.0f, -1.0f,
+	};
+
+	if (verbose)
+		printf("Run test_float25\n");
+
+	FAILED(!compiler, "cannot create compiler\n");
+
+	for (i = 0; i < 14; i++)
+		dbuf[i] = 123.0;
+	for (i = 0; i < 10; i++)
+		sbuf[i] = 123.0f;
+	for (i = 0; i < 8 + 4 * 8; i++)
+		dround[i] = 123.0;
+	for (i = 0; i < 4 + 4 * 4; i++)
+		sround[i] = 123.0f;
+
+	dbuf[0] = 2.25;
+	dbuf[1] = -1.0;
+	dbuf[2] = 2.5;
+	dbuf[3] = -2.5;
+	sbuf[0] = 6.25f;
+	sbuf[1] = -3.5f;
+
+	dround[0] = 2.5;
+	dround[1] = -2.5;
+	/* The largest value below 0.5. */
+	dround[2] = 0.49999999999999994;
+	dround[3] = -0.3;
+	dround[4] = 3.75;
+	dround[5] = -7.0;
+	dround[6] = 4503599627370497.0;
+	dround[7] = -0.0;
+
+	sround[0] = 2.5f;
+	sround[1] = -1.5f;
+	sround[2] = 0.49999997f;
+	sround[3] = -0.75f;
+
+	sljit_emit_enter(compiler, 0, SLJIT_ARGS3V(P, P, P), 1 | SLJIT_ENTER_FLOAT(6), 3, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_SQRT_F64, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S0), 0);
+	/* dbuf[4] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 4 * sizeof(sljit_f64), SLJIT_FR0, 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR1, 0, SLJIT_MEM1(SLJIT_S0), sizeof(sljit_f64));
+	/* dbuf[5] */
+	sljit_emit_fop1(compiler, SLJIT_SQRT_F64, SLJIT_MEM1(SLJIT_S0), 5 * sizeof(sljit_f64), SLJIT_FR1, 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S2), 0);
+	sljit_emit_fop1(compiler, SLJIT_SQRT_F32, SLJIT_FR2, 0, SLJIT_FR2, 0);
+	/* sbuf[2] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S2), 2 * sizeof(sljit_f32), SLJIT_FR2, 0);
+
+	/* FR1 is NaN. */
+	sljit_emit_fop1(compiler, SLJIT_SQRT_F64, SLJIT_FR1, 0, SLJIT_FR1, 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_f64));
+	sljit_emit_fop2(compiler, SLJIT_MIN_F64, SLJIT_FR3, 0, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_f64));
+	/* dbuf[6] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 6 * sizeof(sljit_f64), SLJIT_FR3, 0);
+	/* dbuf[7] */
+	sljit_emit_fop2(compiler, SLJIT_MAX_F64, SLJIT_MEM1(SLJIT_S0), 7 * sizeof(sljit_f64), SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_f64), SLJIT_FR2, 0);
+	sljit_emit_fop2(compiler, SLJIT_MIN_F64, SLJIT_FR4, 0, SLJIT_FR1, 0, SLJIT_FR2, 0);
+	/* dbuf[8] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 8 * sizeof(sljit_f64), SLJIT_FR4, 0);
+	sljit_emit_fop2(compiler, SLJIT_MAX_F64, SLJIT_FR2, 0, SLJIT_FR2, 0, SLJIT_FR1, 0);
+	/* dbuf[9] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 9 * sizeof(sljit_f64), SLJIT_FR2, 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR5, 0, SLJIT_FR1, 0);
+	sljit_emit_fop2(compiler, SLJIT_MAX_F64, SLJIT_FR5, 0, SLJIT_FR1, 0, SLJIT_FR5, 0);
+	/* dbuf[10] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 10 * sizeof(sljit_f64), SLJIT_FR5, 0);
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_f64));
+	sljit_emit_fop2(compiler, SLJIT_MIN_F64, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S0), 2 * sizeof(sljit_f64), SLJIT_FR0, 0);
+	/* dbuf[11] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 11 * sizeof(sljit_f64), SLJIT_FR0, 0);
+
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S2), 0);
+	sljit_emit_fop2(compiler, SLJIT_MIN_F32, SLJIT_FR3, 0, SLJIT_FR0, 0, SLJIT_MEM1(SLJIT_S2), sizeof(sljit_f32));
+	/* sbuf[3] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S2), 3 * sizeof(sljit_f32), SLJIT_FR3, 0);
+	/* sbuf[4] */
+	sljit_emit_fop2(compiler, SLJIT_MAX_F32, SLJIT_MEM1(SLJIT_S2), 4 * sizeof(sljit_f32), SLJIT_MEM1(SLJIT_S2), sizeof(sljit_f32), SLJIT_FR0, 0);
+	sljit_emit_fop1(compiler, SLJIT_CONV_F32_FROM_F64, SLJIT_FR1, 0, SLJIT_FR1, 0);
+	sljit_emit_fop2(compiler, SLJIT_MAX_F32, SLJIT_FR1, 0, SLJIT_FR1, 0, SLJIT_FR0, 0);
+	/* sbuf[5] */
+	sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM1(SLJIT_S2), 5 * sizeof(sljit_f32), SLJIT_FR1, 0);
+
+	if (has_fround) {
+		for (i = 0; i < 4; i++) {
+			for (j = 0; j < 8; j++)
+				sljit_emit_fop1(compiler, round_ops[i], SLJIT_MEM1(SLJIT_S1), (8 + i * 8 + j) * (sljit_sw)sizeof(sljit_f64), SLJIT_MEM1(SLJIT_S1), j * (sljit_sw)sizeof(sljit_f64));
+
+			for (j = 0; j < 4; j++) {
+				sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_FR0, 0, SLJIT_MEM0(), (sljit_sw)(sround + j));
+				sljit_emit_fop1(compiler, round_ops[i] | SLJIT_32, SLJIT_FR(j & 0x1), 0, SLJIT_FR0, 0);
+				sljit_emit_fop1(compiler, SLJIT_MOV_F32, SLJIT_MEM0(), (sljit_sw)(sround + 4 + i * 4 + j), SLJIT_FR(j & 0x1), 0);
+			}
+		}
+
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR2, 0, SLJIT_MEM1(SLJIT_S0), 3 * sizeof(sljit_f64));
+		sljit_emit_fop1(compiler, SLJIT_ROUND_F64, SLJIT_FR2, 0, SLJIT_FR2, 0);
+		/* dbuf[12] */
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 12 * sizeof(sljit_f64), SLJIT_FR2, 0);
+		sljit_emit_fop1(compiler, SLJIT_FLOOR_F64, SLJIT_FR3, 0, SLJIT_FR4, 0);
+		/* dbuf[13] */
+		sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_S0), 13 * sizeof(sljit_f64), SLJIT_FR3, 0);
+	}
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func3((sljit_sw)&dbuf, (sljit_sw)&dround, (sljit_sw)&sbuf);
+
+	FAILED(dbuf[4] != 1.5, "test_float25 case 1 failed\n");
+	FAILED(dbuf[5] == dbuf[5], "test_float25 case 2 failed\n");
+	FAILED(sbuf[2] != 2.5f, "test_float25 case 3 failed\n");
+	FAILED(dbuf[6] != -2.5, "test_float25 case 4 failed\n");
+	FAILED(dbuf[7] != 2.5, "test_float25 case 5 failed\n");
+	FAILED(dbuf[8] != 2.5, "test_float25 case 6 failed\n");
+	FAILED(dbuf[9] != 2.5, "test_float25 case 7 failed\n");
+	FAILED(dbuf[10] == dbuf[10], "test_float25 case 8 failed\n");
+	FAILED(dbuf[11] != -2.5, "test_float25 case 9 failed\n");
+	FAILED(sbuf[3] != -3.5f, "test_float25 case 10 failed\n");
+	FAILED(sbuf[4] != 6.25f, "test_float25 case 11 failed\n");
+	FAILED(sbuf[5] != 6.25f, "test_float25 case 12 failed\n");
+
+	if (has_fround) {
+		for (i = 0; i < 4 * 8; i++) {
+			/* The sign of zero results is checked by division. */
+			FAILED(dround[8 + i] != dround_expected[i] || (dround_expected[i] == 0.0 && 1.0 / dround[8 + i] != 1.0 / dround_expected[i]),
+				"test_float25 case 13 failed\n");
+		}
+
+		for (i = 0; i < 4 * 4; i++) {
+			FAILED(sround[4 + i] != sround_expected[i] || (sround_expected[i] == 0.0f && 1.0f / sround[4 + i] != 1.0f / sround_expected[i]),
+				"test_float25 case 14 failed\n");
+		}
+
+		FAILED(dbuf[12] != -3.0, "test_float25 case 15 failed\n");
+		FAILED(dbuf[13] != 2.0, "test_float25 case 16 failed\n");
+	}
+
+	sljit_free_code(code.code, NULL);
+	successful_tests++;
+}
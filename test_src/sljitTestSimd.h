@@ -2718,5 +2718,68 @@ static void test_simd11(void)
 	successful_tests++;
 }
 
+static void test_simd12(void)
+{
+	/* Test simd non-temporal data transfer. */
+	executable_code code;
+	struct sljit_compiler* compiler;
+	sljit_s32 options = 0;
+	sljit_s32 i, type;
+	sljit_u8* buf;
+	sljit_u8 data[63 + 256];
+
+	if (verbose)
+		printf("Run test_simd12\n");
+
+	SIMD_RUN_START
+
+	/* Buffer is 64 byte aligned. */
+	buf = (sljit_u8*)(((sljit_sw)data + (sljit_sw)63) & ~(sljit_sw)63);
+
+	for (i = 0; i < 256; i++)
+		buf[i] = 0xaa;
+
+	simd_set(buf + 0, 62, 16);
+	simd_set(buf + 32, 219, 16);
+
+	compiler = sljit_create_compiler(NULL);
+	FAILED(!compiler, "cannot create compiler\n");
+
+	sljit_emit_enter(compiler, options, SLJIT_ARGS1V(P), 2 | SLJIT_ENTER_VECTOR(3), 2, 0);
+
+	type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_8 | SLJIT_SIMD_MEM_ALIGNED_128 | SLJIT_SIMD_MEM_NON_TEMPORAL;
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_LOAD | type, SLJIT_VR0, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_STORE | type, SLJIT_VR0, SLJIT_MEM1(SLJIT_S0), 64);
+
+	type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_FLOAT | SLJIT_SIMD_ELEM_32 | SLJIT_SIMD_MEM_ALIGNED_128 | SLJIT_SIMD_MEM_NON_TEMPORAL;
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_LOAD | type, SLJIT_VR1, SLJIT_MEM1(SLJIT_S0), 32);
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_STORE | type, SLJIT_VR1, SLJIT_MEM1(SLJIT_S0), 96);
+
+	/* The hint is ignored for unaligned accesses. */
+	type = SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_8 | SLJIT_SIMD_MEM_UNALIGNED | SLJIT_SIMD_MEM_NON_TEMPORAL;
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_LOAD | type, SLJIT_VR2, SLJIT_MEM1(SLJIT_S0), 0);
+	sljit_emit_simd_mov(compiler, SLJIT_SIMD_STORE | type, SLJIT_VR2, SLJIT_MEM1(SLJIT_S0), 129);
+
+	if (sljit_has_cpu_feature(SLJIT_HAS_MEMORY_BARRIER))
+		sljit_emit_op0(compiler, SLJIT_MEMORY_BARRIER);
+
+	sljit_emit_return_void(compiler);
+
+	code.code = sljit_generate_code(compiler, 0, NULL);
+	CHECK(compiler);
+	sljit_free_compiler(compiler);
+
+	code.func1((sljit_sw)buf);
+	sljit_free_code(code.code, NULL);
+
+	FAILED(!check_simd_mov(buf + 64, 62, 16), "test_simd12 case 1 failed\n");
+	FAILED(!check_simd_mov(buf + 96, 219, 16), "test_simd12 case 2 failed\n");
+	FAILED(!check_simd_mov(buf + 129, 62, 16), "test_simd12 case 3 failed\n");
+
+	SIMD_RUN_END
+
+	successful_tests++;
+}
+
 #undef SIMD_RUN_START
 #undef SIMD_RUN_END